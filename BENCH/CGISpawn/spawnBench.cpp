@@ -0,0 +1,102 @@
+/**
+ * @brief	fork + execve vs posix_spawn latency
+ * @details	worker 처럼 RSS 가 큰 프로세스에서 CGI 하나를 띄우는 데 걸리는 시간을 비교한다.
+ *			spawn 부터 waitpid 로 reap 할 때까지를 잰다.
+ *
+ *	usage: ./spawnBench [rss MB = 512] [iterations = 200] [program = /usr/bin/true]
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <spawn.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern char**	environ;
+
+static long	now() {
+	struct timeval	tv;
+
+	gettimeofday(&tv, NULL);
+	return (tv.tv_sec * 1000000L + tv.tv_usec);
+}
+
+static bool	runFork(char** argv) {
+	const pid_t	pid = fork();
+
+	if (pid < 0) {
+		return false;
+	}
+	if (pid == 0) {
+		execve(argv[0], argv, environ);
+		_exit(127);
+	}
+	return (waitpid(pid, NULL, 0) == pid);
+}
+
+static bool	runSpawn(char** argv) {
+	pid_t	pid;
+
+	if (posix_spawn(&pid, argv[0], NULL, NULL, argv, environ) != 0) {
+		return false;
+	}
+	return (waitpid(pid, NULL, 0) == pid);
+}
+
+static void	report(const char* name, std::vector<long>& samples) {
+	long	total = 0;
+
+	std::sort(samples.begin(), samples.end());
+	for (std::size_t i = 0; i < samples.size(); i++) {
+		total += samples[i];
+	}
+	std::printf("%-12s avg %8ld us   p50 %8ld us   p99 %8ld us   max %8ld us\n",
+		name,
+		total / static_cast<long>(samples.size()),
+		samples[samples.size() / 2],
+		samples[samples.size() * 99 / 100],
+		samples.back());
+}
+
+int	main(int ac, char** av) {
+	const std::size_t	rssMB = (ac > 1) ? std::strtoul(av[1], NULL, 10) : 512;
+	const int			iterations = (ac > 2) ? std::atoi(av[2]) : 200;
+	char*				argv[2] = { const_cast<char*>((ac > 3) ? av[3] : "/usr/bin/true"), NULL };
+
+	if (iterations <= 0) {
+		std::fprintf(stderr, "Error: wrong argument\n");
+		return (1);
+	}
+
+	// worker 의 heap 을 흉내낸다. 실제로 page 를 만지지 않으면 page table 이 생기지 않는다.
+	const std::size_t	rssSize = rssMB * 1024 * 1024;
+	char*				rss = new char[rssSize];
+	std::memset(rss, 1, rssSize);
+
+	std::vector<long>	forkSamples;
+	std::vector<long>	spawnSamples;
+	for (int i = 0; i < iterations; i++) {
+		long	start = now();
+		if (!runFork(argv)) {
+			std::perror("fork");
+			return (1);
+		}
+		forkSamples.push_back(now() - start);
+
+		start = now();
+		if (!runSpawn(argv)) {
+			std::perror("posix_spawn");
+			return (1);
+		}
+		spawnSamples.push_back(now() - start);
+	}
+
+	std::printf("rss %lu MB, %d iterations, %s\n", static_cast<unsigned long>(rssMB), iterations, argv[0]);
+	report("fork+execve", forkSamples);
+	report("posix_spawn", spawnSamples);
+	delete [] rss;
+	return (0);
+}
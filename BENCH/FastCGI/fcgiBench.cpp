@@ -0,0 +1,87 @@
+/**
+ * @brief	FastCGI request latency: 연결을 매번 새로 여는 경우 vs keepalive 로 재사용하는 경우
+ * @details	fastcgi_pass 의 connection pool 이 아끼는 비용 (connect + accept + close) 을 잰다.
+ *
+ *	usage: ./fcgiBench [address = 127.0.0.1:1025] [iterations = 10000]
+ */
+#include "fcgiCommon.hpp"
+#include <sys/time.h>
+
+static long	now() {
+	struct timeval	tv;
+
+	gettimeofday(&tv, NULL);
+	return (tv.tv_sec * 1000000L + tv.tv_usec);
+}
+
+static int	connectTo(const Address& addr) {
+	const int	fd = socket(addr.m_Addr.ss_family, SOCK_STREAM, 0);
+
+	if (fd < 0 || connect(fd, reinterpret_cast<const struct sockaddr*>(&addr.m_Addr), addr.m_Len) < 0) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		return (-1);
+	}
+	return (fd);
+}
+
+static bool	request(const int& fd, const bool& keepConn) {
+	static const char	params[] = "\x0e\x03REQUEST_METHODGET\x0b\x01SCRIPT_NAME/";
+	const char			begin[8] = { 0, 1, static_cast<char>(keepConn ? 1 : 0), 0, 0, 0, 0, 0 };
+	std::string			out;
+	std::string			content;
+	int					type;
+	unsigned short		requestId;
+
+	appendRecord(out, FCGI_BEGIN_REQUEST, 1, begin, sizeof(begin));
+	appendRecord(out, FCGI_PARAMS, 1, params, sizeof(params) - 1);
+	appendRecord(out, FCGI_PARAMS, 1, NULL, 0);
+	appendRecord(out, FCGI_STDIN, 1, NULL, 0);
+	if (!writeFull(fd, out.data(), out.size())) {
+		return false;
+	}
+	while (readRecord(fd, type, requestId, content)) {
+		if (type == FCGI_END_REQUEST) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int	main(int argc, char** argv) {
+	const std::string	address = (argc > 1) ? argv[1] : "127.0.0.1:1025";
+	const int			iterations = (argc > 2) ? std::atoi(argv[2]) : 10000;
+	Address				addr;
+
+	if (!parseAddress(address, addr)) {
+		std::fprintf(stderr, "invalid address: %s\n", address.c_str());
+		return 1;
+	}
+
+	long	start = now();
+	for (int i = 0; i < iterations; i++) {
+		const int	fd = connectTo(addr);
+		if (fd < 0 || !request(fd, false)) {
+			std::perror("fcgiBench: connect per request");
+			return 1;
+		}
+		close(fd);
+	}
+	const long	fresh = now() - start;
+
+	const int	fd = connectTo(addr);
+	start = now();
+	for (int i = 0; i < iterations; i++) {
+		if (fd < 0 || !request(fd, true)) {
+			std::perror("fcgiBench: keepalive");
+			return 1;
+		}
+	}
+	const long	keepalive = now() - start;
+	close(fd);
+
+	std::printf("%-20s %10.2f us/request\n", "connect per request", static_cast<double>(fresh) / iterations);
+	std::printf("%-20s %10.2f us/request\n", "keepalive", static_cast<double>(keepalive) / iterations);
+	return 0;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * @brief	fcgiResponder / fcgiBench 공통 (blocking socket 용 record 입출력)
+ */
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netdb.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+enum {
+	FCGI_BEGIN_REQUEST = 1,
+	FCGI_END_REQUEST = 3,
+	FCGI_PARAMS = 4,
+	FCGI_STDIN = 5,
+	FCGI_STDOUT = 6
+};
+
+struct Address {
+	struct sockaddr_storage	m_Addr;
+	socklen_t				m_Len;
+};
+
+/**
+ *	"host:port" | "unix:/path"
+ */
+inline bool	parseAddress(const std::string& address, Address& out) {
+	std::memset(&out, 0, sizeof(out));
+	if (address.compare(0, 5, "unix:") == 0) {
+		struct sockaddr_un*	addr = reinterpret_cast<struct sockaddr_un*>(&out.m_Addr);
+		const std::string	path = address.substr(5);
+		if (path.empty() || path.size() >= sizeof(addr->sun_path)) {
+			return false;
+		}
+		addr->sun_family = AF_UNIX;
+		std::memcpy(addr->sun_path, path.c_str(), path.size() + 1);
+		out.m_Len = sizeof(struct sockaddr_un);
+		return true;
+	}
+
+	const std::size_t	colonPos = address.rfind(':');
+	struct addrinfo		hints;
+	struct addrinfo*	result = NULL;
+	if (colonPos == std::string::npos) {
+		return false;
+	}
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	if (getaddrinfo(address.substr(0, colonPos).c_str(), address.substr(colonPos + 1).c_str(), &hints, &result) != 0) {
+		return false;
+	}
+	std::memcpy(&out.m_Addr, result->ai_addr, result->ai_addrlen);
+	out.m_Len = result->ai_addrlen;
+	freeaddrinfo(result);
+	return true;
+}
+
+inline bool	readFull(const int& fd, char* buf, std::size_t size) {
+	while (size > 0) {
+		const ssize_t	readSize = read(fd, buf, size);
+		if (readSize <= 0) {
+			if (readSize < 0 && errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		buf += readSize;
+		size -= readSize;
+	}
+	return true;
+}
+
+inline bool	writeFull(const int& fd, const char* buf, std::size_t size) {
+	while (size > 0) {
+		const ssize_t	writeSize = write(fd, buf, size);
+		if (writeSize <= 0) {
+			if (writeSize < 0 && errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		buf += writeSize;
+		size -= writeSize;
+	}
+	return true;
+}
+
+inline void	appendRecord(std::string& out, const int& type, const unsigned short& requestId, const char* data, const std::size_t& size) {
+	const char	header[8] = {
+		1, static_cast<char>(type),
+		static_cast<char>(requestId >> 8), static_cast<char>(requestId & 0xff),
+		static_cast<char>(size >> 8), static_cast<char>(size & 0xff),
+		0, 0
+	};
+	out.append(header, sizeof(header));
+	out.append(data, size);
+}
+
+/**
+ * @return	false 면 연결이 끊겼다.
+ */
+inline bool	readRecord(const int& fd, int& type, unsigned short& requestId, std::string& content) {
+	unsigned char	header[8];
+	char			padding[256];
+
+	if (!readFull(fd, reinterpret_cast<char*>(header), sizeof(header))) {
+		return false;
+	}
+	type = header[1];
+	requestId = static_cast<unsigned short>((header[2] << 8) | header[3]);
+	content.resize((header[4] << 8) | header[5]);
+	if (!content.empty() && !readFull(fd, &content[0], content.size())) {
+		return false;
+	}
+	return (readFull(fd, padding, header[6]));
+}
@@ -0,0 +1,95 @@
+/**
+ * @brief	벤치마크용 FastCGI responder
+ * @details	PARAMS / STDIN 을 끝까지 읽고, body size byte 짜리 text/plain 응답을 보낸다.
+ *			FCGI_KEEP_CONN 이 있으면 연결을 닫지 않고 다음 request 를 기다린다.
+ *			같은 listen socket 을 process 개의 자식이 나눠서 accept 한다.
+ *
+ *	usage: ./fcgiResponder [address = 127.0.0.1:1025] [body size = 64] [process = 4]
+ *
+ *	e.g.	./fcgiResponder 127.0.0.1:1025 &
+ *			(webserv: location / { fastcgi_pass 127.0.0.1:1025; })
+ *			ab -k -c 64 -n 100000 http://127.0.0.1:80/
+ */
+#include "fcgiCommon.hpp"
+#include <csignal>
+#include <sstream>
+#include <algorithm>
+#include <sys/wait.h>
+
+static void	serve(const int& fd, const std::string& body) {
+	std::string		content;
+	int				type;
+	unsigned short	requestId;
+	bool			keepConn = false;
+	bool			stdinDone = false;
+
+	while (readRecord(fd, type, requestId, content)) {
+		if (type == FCGI_BEGIN_REQUEST) {
+			keepConn = (content.size() >= 3 && (content[2] & 1));
+			stdinDone = false;
+			continue;
+		}
+		if (type != FCGI_STDIN || !content.empty() || stdinDone) {
+			continue;
+		}
+		stdinDone = true;
+
+		std::stringstream	head;
+		head << "Content-Type: text/plain\r\nContent-Length: " << body.size() << "\r\n\r\n";
+
+		const std::string	output = head.str() + body;
+		const char			endBody[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		std::string			response;
+
+		for (std::size_t pos = 0; pos < output.size(); pos += 65535) {
+			appendRecord(response, FCGI_STDOUT, requestId, output.data() + pos, std::min<std::size_t>(output.size() - pos, 65535));
+		}
+		appendRecord(response, FCGI_STDOUT, requestId, NULL, 0);
+		appendRecord(response, FCGI_END_REQUEST, requestId, endBody, sizeof(endBody));
+		if (!writeFull(fd, response.data(), response.size()) || !keepConn) {
+			break;
+		}
+	}
+	close(fd);
+}
+
+int	main(int argc, char** argv) {
+	const std::string	address = (argc > 1) ? argv[1] : "127.0.0.1:1025";
+	const std::size_t	bodySize = (argc > 2) ? std::strtoul(argv[2], NULL, 10) : 64;
+	const int			processes = (argc > 3) ? std::atoi(argv[3]) : 4;
+	Address				addr;
+
+	if (!parseAddress(address, addr)) {
+		std::fprintf(stderr, "invalid address: %s\n", address.c_str());
+		return 1;
+	}
+	if (addr.m_Addr.ss_family == AF_UNIX) {
+		unlink(reinterpret_cast<struct sockaddr_un*>(&addr.m_Addr)->sun_path);
+	}
+
+	const int	listenFd = socket(addr.m_Addr.ss_family, SOCK_STREAM, 0);
+	const int	on = 1;
+	setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	if (listenFd < 0 || bind(listenFd, reinterpret_cast<struct sockaddr*>(&addr.m_Addr), addr.m_Len) < 0
+			|| listen(listenFd, SOMAXCONN) < 0) {
+		std::perror("fcgiResponder");
+		return 1;
+	}
+	signal(SIGPIPE, SIG_IGN);
+
+	const std::string	body(bodySize, 'x');
+	for (int i = 0; i < processes; i++) {
+		if (fork() == 0) {
+			while (true) {
+				const int	fd = accept(listenFd, NULL, NULL);
+				if (fd >= 0) {
+					serve(fd, body);
+				}
+			}
+		}
+	}
+	std::printf("fcgiResponder: %s, body %zu bytes, %d processes\n", address.c_str(), bodySize, processes);
+	while (wait(NULL) > 0) {
+	}
+	return 0;
+}
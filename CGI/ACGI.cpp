@@ -0,0 +1,292 @@
+#include "ACGI.hpp"
+#include "../HTTP/Chunked.hpp"
+#include "../HTTP/HTTPStatus.hpp"
+#include "../Cache/CacheZone.hpp"
+#include "../Cache/MicroCache.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+#include "../Server/Client/Client.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+ACGI::ACGI(Client& client)
+  : m_Client(&client),
+	m_HeaderDone(false),
+	m_Chunked(false),
+	m_HeadRequest(false),
+	m_Micro(NULL),
+	m_MicroKey(0),
+	m_MicroTtl(0),
+	m_MicroExpect(0)
+{}
+
+ACGI::ACGI()
+  : m_Client(NULL),
+	m_HeaderDone(false),
+	m_Chunked(false),
+	m_HeadRequest(false),
+	m_Micro(NULL),
+	m_MicroKey(0),
+	m_MicroTtl(0),
+	m_MicroExpect(0)
+{}
+
+ACGI::~ACGI() {}
+
+/**
+ * @brief	연결을 재사용할 때 (FastCGI keepalive) 새 응답을 받을 준비를 한다.
+ */
+void	ACGI::reset(Client* client) {
+	m_Client = client;
+	m_Header.clear();
+	m_HeaderDone = false;
+	m_Chunked = false;
+	m_HeadRequest = false;
+	endMicrocache(false);
+}
+
+/**
+ * @brief	RFC 3875 4.1. Request Meta-Variables 중 request 마다 달라지는 것
+ * @details	나머지는 CGIEnv template (location 별) 에 미리 만들어져 있다.
+ *			script 는 root + path 의 앞부분 (Client::scriptFile) 이다. 그 앞부분이 SCRIPT_NAME, 나머지가 PATH_INFO 다.
+ */
+void	ACGI::environment(const std::string& script, CGIEnv& env) const {
+	const HTTP::Request&			request = m_Client->getRequest();
+	const HTTP::Request::headerMap&	headers = request.getHeaders();
+	const std::string&				path = request.getPath();
+	const std::size_t				rootSize = m_Client->getLocation()->getRoot().size();
+	const std::size_t				nameSize = (script.size() > rootSize) ? std::min(script.size() - rootSize, path.size()) : path.size();
+
+	env.add("SERVER_PROTOCOL", request.getVersion());
+	env.add("REQUEST_METHOD", request.getMethod());
+	env.add("REQUEST_URI", request.getTarget());
+	env.add("SCRIPT_NAME", path.substr(0, nameSize));
+	env.add("SCRIPT_FILENAME", script);
+	env.add("PATH_INFO", path.substr(nameSize));
+	env.add("QUERY_STRING", request.getQuery());
+	env.add("REMOTE_ADDR", m_Client->getRemoteAddr());
+
+	for (HTTP::Request::headerMap::const_iterator it = headers.begin(); it != headers.end(); ++it) {
+		if (it->first == "content-length") {
+			env.add("CONTENT_LENGTH", it->second);
+			continue;
+		}
+		if (it->first == "content-type") {
+			env.add("CONTENT_TYPE", it->second);
+			continue;
+		}
+		std::string	name = "HTTP_" + it->first;
+		for (std::size_t i = 5; i < name.size(); i++) {
+			name[i] = (name[i] == '-') ? '_' : std::toupper(name[i]);
+		}
+		env.add(name.c_str(), it->second);
+	}
+}
+
+/**
+ * @brief	CGI 출력을 읽는 대로 넘긴다. header 가 끝나기 전까지는 모아서 파싱한다.
+ * @return	false 면 잘못된 응답 (502)
+ */
+bool	ACGI::output(const char* data, const std::size_t& size) {
+	if (m_Client == NULL) {
+		return true;
+	}
+	if (m_HeaderDone) {
+		sendBody(data, size);
+		return true;
+	}
+	m_Header.append(data, size);
+	return (parseHeader());
+}
+
+/**
+ * @brief	CGI 출력이 끝났을 때. chunked 면 마지막 chunk 를 보낸다. (HEAD 는 body 가 없으므로 보내지 않는다)
+ * @return	header 까지는 받았는지 (아니면 502)
+ */
+bool	ACGI::outputEnd() {
+	if (m_HeaderDone && m_Chunked && !m_HeadRequest && m_Client != NULL) {
+		m_Client->send("0\r\n\r\n", 5);
+	}
+	endMicrocache(m_HeaderDone);
+	return (m_HeaderDone);
+}
+
+/**
+ * @brief	CGI header -> HTTP response header (RFC 3875 6.3.)
+ * @return	false 면 잘못된 응답 (502)
+ */
+bool	ACGI::parseHeader() {
+	std::size_t	headerEnd = m_Header.find("\r\n\r\n");
+	std::size_t	bodyStart = headerEnd + 4;
+	const std::size_t	lfEnd = m_Header.find("\n\n");
+
+	if (lfEnd != std::string::npos && (headerEnd == std::string::npos || lfEnd < headerEnd)) {
+		headerEnd = lfEnd;
+		bodyStart = lfEnd + 2;
+	}
+	if (headerEnd == std::string::npos) {
+		return (m_Header.size() <= E_CGI::MAX_HEADER_SIZE);
+	}
+
+	std::string	status;
+	std::string	fields;
+	std::string	cacheControl;
+	bool		hasLocation = false;
+	bool		hasLength = false;
+	bool		storable = true;
+	std::size_t	length = 0;
+	std::size_t	pos = 0;
+
+	while (pos < headerEnd) {
+		std::size_t	lineEnd = m_Header.find('\n', pos);
+		if (lineEnd == std::string::npos || lineEnd > headerEnd) {
+			lineEnd = headerEnd;
+		}
+		std::string	line = m_Header.substr(pos, lineEnd - pos);
+		pos = lineEnd + 1;
+		if (!line.empty() && line[line.size() - 1] == '\r') {
+			line.erase(line.size() - 1);
+		}
+
+		const std::size_t	colonPos = line.find(':');
+		if (colonPos == std::string::npos || colonPos == 0) {
+			return false;
+		}
+		std::string	name = line.substr(0, colonPos);
+		for (std::size_t i = 0; i < name.size(); i++) {
+			name[i] = std::tolower(name[i]);
+		}
+		std::size_t	valueStart = colonPos + 1;
+		while (valueStart < line.size() && (line[valueStart] == ' ' || line[valueStart] == '\t')) {
+			valueStart++;
+		}
+
+		if (name == "status") {
+			status = line.substr(valueStart);
+			continue;
+		}
+		hasLocation |= (name == "location");
+		if (name == "content-length") {
+			hasLength = true;
+			length = std::strtoul(line.c_str() + valueStart, NULL, 10);
+		} else if (name == "cache-control") {
+			std::string	value = line.substr(valueStart);
+			for (std::size_t i = 0; i < value.size(); i++) {
+				value[i] = std::tolower(value[i]);
+			}
+			cacheControl += value + ",";
+		} else if (name == "set-cookie" || name == "vary") {
+			storable = false;
+		}
+		fields += line + "\r\n";
+	}
+
+	if (status.empty()) {
+		status = hasLocation ? "302 Found" : "200 OK";
+	} else if (status.find(' ') == std::string::npos) {
+		const char*	reason = HTTP::reasonPhrase(static_cast<unsigned short>(std::atoi(status.c_str())));
+		status += std::string(" ") + (reason ? reason : "");
+	}
+	// HTTP/1.0 client 는 chunked 를 모르므로 연결 종료로 body 끝을 알린다.
+	const bool	closeDelimited = !hasLength && m_Client->getRequest().getVersion() == "HTTP/1.0";
+	m_Chunked = !hasLength && !closeDelimited;
+	if (closeDelimited) {
+		m_Client->closeAfterResponse();
+	}
+
+	const std::string	lines = "HTTP/1.1 " + status + "\r\nServer: webserv\r\n" + fields;
+	const std::string	head = lines + (m_Chunked ? "Transfer-Encoding: chunked\r\n" : "") + "\r\n";
+	m_HeaderDone = true;
+	m_HeadRequest = (m_Client->getRequest().getMethod() == "HEAD");
+	m_Client->send(head.data(), head.size());
+	if (storable) {
+		startMicrocache(std::atoi(status.c_str()), cacheControl, hasLength ? length : std::string::npos, lines);
+	}
+	if (bodyStart < m_Header.size()) {
+		sendBody(m_Header.data() + bodyStart, m_Header.size() - bodyStart);
+	}
+	m_Header.clear();
+	return true;
+}
+
+/**
+ * @brief	header 뒤의 CGI 출력. HEAD 면 header 만 보내고 body 는 버린다. (RFC 9110 9.3.2)
+ */
+void	ACGI::sendBody(const char* data, const std::size_t& size) {
+	if (size == 0 || m_HeadRequest) {
+		return ;
+	}
+	collect(data, size);
+	if (!m_Chunked) {
+		m_Client->send(data, size);
+		return ;
+	}
+
+	std::string	chunk;
+	HTTP::appendChunk(chunk, data, size);
+	m_Client->send(chunk.data(), chunk.size());
+}
+
+/**
+ * @brief	microcache 에 저장 중이면 chunk 로 감싸기 전의 body 를 모은다. (chunk 하나에 안 들어가면 그만 모은다)
+ */
+void	ACGI::collect(const char* data, const std::size_t& size) {
+	if (m_Micro == NULL) {
+		return ;
+	}
+	if (m_MicroHead.size() + m_MicroData.size() + size > MicroCache::maxSize()) {
+		endMicrocache(false);
+		return ;
+	}
+	m_MicroData.append(data, size);
+}
+
+/**
+ * @brief	microcache location 의 GET 응답 (200 / 301 / 302) 이면 모으기 시작한다.
+ * @details	HEAD 는 CGI 가 body 를 보내지 않을 수 있으므로 저장하지 않는다. (hit 은 GET 응답에서 header 만 보낸다)
+ *			Set-Cookie / Vary 가 있거나 Cache-Control 이 no-store / no-cache / private / max-age=0 이면 저장하지 않는다.
+ *			max-age 가 valid 보다 짧으면 max-age 동안만 둔다.
+ * @param	expect	Content-Length 가 있으면 body 크기, 없으면 npos. (CGI 가 덜 보내고 끝났으면 저장하지 않는다)
+ * @param	head	빈 줄과 Transfer-Encoding 을 뺀 응답 header
+ */
+void	ACGI::startMicrocache(const int& status, const std::string& cacheControl, const std::size_t& expect, const std::string& head) {
+	MicroCache*			zone = MicroCache::find(m_Client->getLocation());
+	const std::string&	method = m_Client->getRequest().getMethod();
+
+	if (zone == NULL || method != "GET" || (status != 200 && status != 301 && status != 302)) {
+		return ;
+	}
+	const unsigned int&	valid = m_Client->getLocation()->getMicrocache().m_Valid;
+	m_MicroTtl = std::min(valid, CacheZone::maxAge(cacheControl, valid));
+	if (m_MicroTtl == 0 || head.size() > MicroCache::maxSize()) {
+		return ;
+	}
+	m_Micro = zone;
+	m_MicroKey = CacheZone::hash64(MicroCache::key(*m_Client));
+	m_MicroExpect = expect;
+	m_MicroHead = head;
+}
+
+/**
+ * @brief	응답이 끝까지 왔으면 zone 에 넣는다. 길이를 몰랐던 (chunked / 연결 종료로 보낸) 응답은 Content-Length 를 붙인다.
+ */
+void	ACGI::endMicrocache(const bool& commit) {
+	if (m_Micro == NULL) {
+		return ;
+	}
+	if (commit && (m_MicroExpect == std::string::npos || m_MicroData.size() == m_MicroExpect)) {
+		std::stringstream	head;
+
+		head << m_MicroHead;
+		if (m_MicroExpect == std::string::npos) {
+			head << "Content-Length: " << m_MicroData.size() << "\r\n";
+		}
+		head << "\r\n";
+		m_Micro->insert(m_MicroKey, EventLoop::now() + m_MicroTtl, head.str() + m_MicroData, head.str().size());
+	}
+	m_Micro = NULL;
+	m_MicroHead.clear();
+	m_MicroData.clear();
+}
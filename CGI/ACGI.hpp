@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../Server/Client/AResponder.hpp"
+#include "CGIEnv.hpp"
+#include <string>
+
+class Client;
+class MicroCache;
+
+namespace E_CGI {
+	const std::size_t	READ_SIZE = 65536;
+	const std::size_t	MAX_HEADER_SIZE = 8192;
+	const std::size_t	ENV_RESERVE = 2048;
+}
+
+/**
+ * @brief	Client 가 보는 CGI 응답 하나
+ * @details	CGIProcess (request 마다 새 프로세스), CGIPoolRequest (pool 의 상주 프로세스),
+ *			FastCGIConnection (fastcgi_pass) 의 공통 부분.
+ *			CGI 출력 (RFC 3875 6.) 을 HTTP 응답으로 바꿔서 Client 에게 넘기는 일은 여기서 한다. (HEAD 면 header 만)
+ *			microcache location 이면 body 를 모아 두었다가 응답이 끝나면 Content-Length 를 붙인 응답으로 zone 에 넣는다.
+ *			(chunked 로 저장하지 않으므로 hit 은 HTTP/1.0 client 에게도 그대로 보낼 수 있다)
+ */
+class ACGI : public AResponder {
+protected:
+	Client*			m_Client;
+	std::string		m_Header;
+	bool			m_HeaderDone;
+	bool			m_Chunked;
+	bool			m_HeadRequest;
+	MicroCache*		m_Micro;
+	unsigned long	m_MicroKey;
+	unsigned int	m_MicroTtl;
+	std::size_t		m_MicroExpect;
+	std::string		m_MicroHead;
+	std::string		m_MicroData;
+
+	ACGI();
+
+	void	reset(Client* client);
+	void	environment(const std::string& script, CGIEnv& env) const;
+	bool	output(const char* data, const std::size_t& size);
+	bool	outputEnd();
+	bool	parseHeader();
+	void	sendBody(const char* data, const std::size_t& size);
+	void	collect(const char* data, const std::size_t& size);
+	void	startMicrocache(const int& status, const std::string& cacheControl, const std::size_t& expect, const std::string& head);
+	void	endMicrocache(const bool& commit);
+
+private:
+	ACGI(const ACGI& other);
+	ACGI& operator=(const ACGI& other);
+
+public:
+	ACGI(Client& client);
+	virtual ~ACGI();
+};
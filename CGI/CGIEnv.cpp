@@ -0,0 +1,100 @@
+#include "CGIEnv.hpp"
+#include <sstream>
+
+CGIEnv::templateMap	CGIEnv::m_Templates;
+
+CGIEnv::CGIEnv() {}
+
+CGIEnv::CGIEnv(const CGIEnv& other) {
+	*this = other;
+}
+
+CGIEnv&	CGIEnv::operator=(const CGIEnv& other) {
+	if (this != &other) {
+		m_Block = other.m_Block;
+		m_Offsets = other.m_Offsets;
+		m_Pointers.clear();
+		if (!other.m_Pointers.empty()) {
+			freeze();
+		}
+	}
+	return (*this);
+}
+
+CGIEnv::~CGIEnv() {}
+
+void	CGIEnv::reserve(const std::size_t& size) {
+	m_Block.reserve(size);
+}
+
+void	CGIEnv::add(const char* key, const std::string& value) {
+	m_Offsets.push_back(m_Block.size());
+	m_Block += key;
+	m_Block += '=';
+	m_Block += value;
+	m_Block += '\0';
+}
+
+/**
+ * @brief	m_Block 이 더 이상 바뀌지 않을 때 포인터 목록을 만든다.
+ */
+void	CGIEnv::freeze() {
+	m_Pointers.clear();
+	m_Pointers.reserve(m_Offsets.size());
+	for (std::vector<std::size_t>::const_iterator it = m_Offsets.begin(); it != m_Offsets.end(); ++it) {
+		m_Pointers.push_back(&m_Block[*it]);
+	}
+}
+
+void	CGIEnv::exportTo(std::vector<char*>& envp) const {
+	if (!m_Pointers.empty()) {
+		envp.insert(envp.end(), m_Pointers.begin(), m_Pointers.end());
+		return ;
+	}
+	for (std::vector<std::size_t>::const_iterator it = m_Offsets.begin(); it != m_Offsets.end(); ++it) {
+		envp.push_back(const_cast<char*>(m_Block.data() + *it));
+	}
+}
+
+std::size_t	CGIEnv::size() const {
+	return (m_Offsets.size());
+}
+
+const std::string&	CGIEnv::getBlock() const {
+	return (m_Block);
+}
+
+void	CGIEnv::prepareLocation(const CONF::ServerBlock& server, const CONF::LocationBlock& location, const std::string&, void* context) {
+	if (!location.getCgi().empty() || !location.getFastcgi_pass().empty()) {
+		const std::map<std::string, std::string>&	envMap = static_cast<const CONF::MainBlock*>(context)->getEnvMap();
+		CGIEnv										env;
+		std::stringstream							port;
+
+		port << server.getPort();
+		for (std::map<std::string, std::string>::const_iterator it = envMap.begin(); it != envMap.end(); ++it) {
+			env.add(it->first.c_str(), it->second);
+		}
+		env.add("GATEWAY_INTERFACE", "CGI/1.1");
+		env.add("SERVER_SOFTWARE", "webserv");
+		env.add("SERVER_NAME", server.getServerNames().empty() ? "" : *server.getServerNames().begin());
+		env.add("SERVER_PORT", port.str());
+		env.add("DOCUMENT_ROOT", location.getRoot());
+		env.add("REDIRECT_STATUS", "200");
+
+		CGIEnv&	stored = m_Templates[&location];
+		stored = env;
+		stored.freeze();
+	}
+}
+
+/**
+ * @brief	cgi / fastcgi_pass 가 설정된 모든 location 의 template 을 만든다. (fork 전에 한 번)
+ */
+void	CGIEnv::prepare(const CONF::MainBlock& mainBlock) {
+	mainBlock.getHTTPBlock().visitLocations(NULL, prepareLocation, const_cast<CONF::MainBlock*>(&mainBlock));
+}
+
+const CGIEnv*	CGIEnv::find(const CONF::LocationBlock* location) {
+	const templateMap::const_iterator	it = m_Templates.find(location);
+	return (it != m_Templates.end() ? &it->second : NULL);
+}
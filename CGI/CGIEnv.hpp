@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief	CGI environment block ("KEY=VALUE\0KEY=VALUE\0...")
+ * @details	location 마다 바뀌지 않는 변수 (GATEWAY_INTERFACE, SERVER_*, DOCUMENT_ROOT, env 지시어)
+ *			는 MasterProcess 가 fork 전에 template 으로 만들어 둔다.
+ *			request 마다는 template 의 포인터를 그대로 envp 에 복사하고,
+ *			request 별 변수만 새로 채운다.
+ */
+class CGIEnv {
+private:
+	typedef std::map<const CONF::LocationBlock*, CGIEnv>	templateMap;
+
+	std::string					m_Block;
+	std::vector<std::size_t>	m_Offsets;
+	std::vector<char*>			m_Pointers;
+
+	static templateMap			m_Templates;
+
+	static void	prepareLocation(const CONF::ServerBlock& server, const CONF::LocationBlock& location, const std::string& name, void* context);
+
+public:
+	CGIEnv();
+	CGIEnv(const CGIEnv& other);
+	CGIEnv& operator=(const CGIEnv& other);
+	~CGIEnv();
+
+	void			reserve(const std::size_t& size);
+	void			add(const char* key, const std::string& value);
+	void			freeze();
+	void			exportTo(std::vector<char*>& envp) const;
+	std::size_t		size() const;
+	const std::string&	getBlock() const;
+
+	static void				prepare(const CONF::MainBlock& mainBlock);
+	static const CGIEnv*	find(const CONF::LocationBlock* location);
+};
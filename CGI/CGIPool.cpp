@@ -0,0 +1,164 @@
+#include "CGIPool.hpp"
+#include "CGIPoolMember.hpp"
+#include "CGIPoolRequest.hpp"
+#include <algorithm>
+
+CGIPool::poolMap	CGIPool::m_Pools;
+
+CGIPool::CGIPool(EventLoop& loop, const CONF::LocationBlock& location)
+  : m_Loop(loop),
+	m_Location(location),
+	m_Config(location.getCgiPool())
+{
+	m_Loop.addTimer(reinterpret_cast<uintptr_t>(this), E_CGI_POOL::TICK, this);
+	tick();
+}
+
+/**
+ * @details	기다리던 request 는 502 로 끝내고, member 프로그램은 죽여서 reap 한다.
+ */
+CGIPool::~CGIPool() {
+	m_Loop.removeTimer(reinterpret_cast<uintptr_t>(this));
+	while (!m_Queue.empty()) {
+		CGIPoolRequest*	request = m_Queue.front();
+		m_Queue.pop_front();
+		request->onComplete(false);
+		delete request;
+	}
+	while (!m_Members.empty()) {
+		m_Members.front()->shutdown();
+	}
+}
+
+/**
+ * @brief	worker 안에서 location 마다 하나. 첫 request 가 올 때 만든다.
+ */
+CGIPool&	CGIPool::get(EventLoop& loop, const CONF::LocationBlock& location) {
+	const poolMap::iterator	it = m_Pools.find(&location);
+	if (it != m_Pools.end()) {
+		return (*it->second);
+	}
+	CGIPool*	pool = new CGIPool(loop, location);
+	m_Pools.insert(std::make_pair(&location, pool));
+	return (*pool);
+}
+
+/**
+ * @brief	worker 가 끝날 때. (EventLoop 이 지워지기 전에)
+ */
+void	CGIPool::destroy() {
+	for (poolMap::iterator it = m_Pools.begin(); it != m_Pools.end(); ++it) {
+		delete it->second;
+	}
+	m_Pools.clear();
+}
+
+CGIPoolMember*	CGIPool::spawn() {
+	CGIPoolMember*	member = new CGIPoolMember(*this, m_Loop);
+
+	if (!member->start(m_Location.getCgi(), CGIEnv::find(&m_Location))) {
+		delete member;
+		return (NULL);
+	}
+	m_Members.push_back(member);
+	return (member);
+}
+
+bool	CGIPool::isFull() const {
+	return (m_Idle.empty() && m_Members.size() >= m_Config.m_Max && m_Queue.size() >= m_Config.m_Queue);
+}
+
+/**
+ * @return	NULL 이면 프로그램을 띄울 수 없다. (502)
+ */
+ACGI*	CGIPool::submit(Client& client, const std::string& script) {
+	CGIPoolRequest*	request = new CGIPoolRequest(*this, client, script);
+	CGIPoolMember*	member = NULL;
+
+	if (!m_Idle.empty()) {
+		member = m_Idle.back();
+		m_Idle.pop_back();
+	} else if (m_Members.size() < m_Config.m_Max) {
+		member = spawn();
+	}
+	if (member != NULL) {
+		request->attach(member);
+		return (request);
+	}
+	if (m_Members.empty() || m_Queue.size() >= m_Config.m_Queue) {
+		delete request;
+		return (NULL);
+	}
+	m_Queue.push_back(request);
+	return (request);
+}
+
+/**
+ * @brief	client 가 먼저 끊겼을 때. request 는 여기서 delete 된다.
+ * @details	이미 실행 중인 request 는 중간에 멈출 방법이 없으므로 member 를 죽인다. (TICK 에 다시 채운다)
+ */
+void	CGIPool::cancel(CGIPoolRequest* request) {
+	CGIPoolMember*	member = request->getMember();
+
+	if (member == NULL) {
+		const std::deque<CGIPoolRequest*>::iterator	it = std::find(m_Queue.begin(), m_Queue.end(), request);
+		if (it != m_Queue.end()) {
+			m_Queue.erase(it);
+		}
+	} else {
+		member->terminate();
+	}
+	delete request;
+}
+
+/**
+ * @brief	응답 하나를 끝낸 member. 기다리는 request 가 있으면 바로 맡긴다.
+ * @details	idle 은 LIFO 로 꺼내 쓰므로, 앞쪽에 남은 member 가 가장 오래 논 member 다.
+ */
+void	CGIPool::onIdle(CGIPoolMember* member) {
+	if (!m_Queue.empty()) {
+		CGIPoolRequest*	request = m_Queue.front();
+		m_Queue.pop_front();
+		request->attach(member);
+		return ;
+	}
+	m_Idle.push_back(member);
+}
+
+void	CGIPool::onDead(CGIPoolMember* member) {
+	m_Members.remove(member);
+
+	const std::vector<CGIPoolMember*>::iterator	it = std::find(m_Idle.begin(), m_Idle.end(), member);
+	if (it != m_Idle.end()) {
+		m_Idle.erase(it);
+	}
+}
+
+void	CGIPool::tick() {
+	const std::time_t	now = std::time(NULL);
+
+	while (m_Members.size() > m_Config.m_Min && !m_Idle.empty()
+			&& now - m_Idle.front()->getIdleSince() >= E_CGI_POOL::IDLE_TIMEOUT) {
+		m_Idle.front()->terminate();
+	}
+	while (m_Members.size() < m_Config.m_Max && (m_Members.size() < m_Config.m_Min || !m_Queue.empty())) {
+		CGIPoolMember*	member = spawn();
+		if (member == NULL) {
+			break;
+		}
+		onIdle(member);
+	}
+	// 프로그램을 하나도 띄울 수 없으면 기다리는 request 는 502 로 끝낸다.
+	while (m_Members.empty() && !m_Queue.empty()) {
+		CGIPoolRequest*	request = m_Queue.front();
+		m_Queue.pop_front();
+		request->onComplete(false);
+		delete request;
+	}
+}
+
+void	CGIPool::handleEvent(const struct kevent& event) {
+	if (event.filter == EVFILT_TIMER) {
+		tick();
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../Parser/ConfParser/ConfData/ConfLocationBlock.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+#include "CGIPoolFrame.hpp"
+#include <ctime>
+#include <deque>
+#include <list>
+#include <map>
+#include <vector>
+
+class ACGI;
+class Client;
+class CGIPoolMember;
+class CGIPoolRequest;
+
+namespace E_CGI_POOL {
+	const int			TICK = 1000;
+	const std::time_t	IDLE_TIMEOUT = 30;
+}
+
+/**
+ * @brief	location 하나의 상주 CGI 프로세스 pool (worker process 마다 따로 가진다)
+ * @details	cgi_pool min max [queue]; 가 있는 location 은 request 마다 프로세스를 띄우지 않고,
+ *			cgi 지시어의 프로그램을 미리 띄워 두고 돌려 쓴다.
+ *			(cgi 프로그램은 stdin / stdout 으로 E_CGI_POOL frame 을 주고받아야 한다. (CGIPoolFrame.hpp)
+ *			 보통 CGI script 는 cgi 에 cgi_pool_adapter 를 두고 쓴다.
+ *			 location 의 CGIEnv template 은 프로세스 environment 로 한 번만 넘어간다.)
+ *			- idle member 가 있으면 바로 맡기고, 없으면 max 까지 늘린다.
+ *			- max 까지 다 바쁘면 queue 에 넣고, queue 까지 차면 503 을 돌려준다.
+ *			- TICK 마다 IDLE_TIMEOUT 넘게 놀고 있는 member 를 min 까지 줄이고,
+ *			  죽은 member 는 min 까지 다시 채운다.
+ *			pool 은 worker 가 끝날 때 destroy() 로 지운다. (member 프로그램도 죽인다)
+ */
+class CGIPool : public AEventHandler {
+private:
+	typedef std::map<const CONF::LocationBlock*, CGIPool*>	poolMap;
+
+	EventLoop&						m_Loop;
+	const CONF::LocationBlock&		m_Location;
+	const CONF::cgiPoolData&		m_Config;
+
+	std::list<CGIPoolMember*>		m_Members;
+	std::vector<CGIPoolMember*>		m_Idle;
+	std::deque<CGIPoolRequest*>		m_Queue;
+
+	static poolMap					m_Pools;
+
+	CGIPool(const CGIPool& other);
+	CGIPool& operator=(const CGIPool& other);
+
+	CGIPoolMember*	spawn();
+	void			tick();
+
+public:
+	CGIPool(EventLoop& loop, const CONF::LocationBlock& location);
+	virtual ~CGIPool();
+
+	bool	isFull() const;
+	ACGI*	submit(Client& client, const std::string& script);
+	void	cancel(CGIPoolRequest* request);
+	void	onIdle(CGIPoolMember* member);
+	void	onDead(CGIPoolMember* member);
+
+	void	handleEvent(const struct kevent& event);
+
+	static CGIPool&	get(EventLoop& loop, const CONF::LocationBlock& location);
+	static void		destroy();
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief	cgi_pool protocol: webserv 와 상주 프로그램이 stdin / stdout (socketpair 하나) 으로 주고받는 frame
+ * @details	frame = type (1 byte) + payload length (4 byte, big endian) + payload. payload 는 MAX_PAYLOAD 를 넘지 않는다.
+ *			request 하나는 이렇게 흘러간다. 프로그램은 한 번에 request 하나만 받는다.
+ *			webserv -> 프로그램
+ *			- PARAMS	request 별 CGI 변수 ("KEY=VALUE\0KEY=VALUE\0..."). request 의 첫 frame 이다.
+ *						location 마다 같은 변수 (GATEWAY_INTERFACE, SERVER_*, env 지시어) 는 프로그램의 environment 에 이미 있다.
+ *			- STDIN		request body. 길이 0 인 STDIN 이 body 끝이다. (body 가 없어도 하나는 온다)
+ *			프로그램 -> webserv
+ *			- STDOUT	일반 CGI 와 같은 출력 (CGI header + body). 여러 frame 으로 나눠도 된다.
+ *			- END		응답 끝. 프로그램은 다음 PARAMS 를 기다린다.
+ *			그 밖의 type 이나 request 밖의 frame 은 protocol 위반이다. (webserv 가 프로그램을 죽이고 502)
+ *			보통 CGI 프로그램은 cgi_pool_adapter (CGI/PoolAdapter) 를 끼워서 쓴다.
+ */
+namespace E_CGI_POOL {
+	enum E_FRAME {
+		PARAMS = 1,
+		STDIN = 2,
+		STDOUT = 3,
+		END = 4
+	};
+	const std::size_t	HEADER_SIZE = 5;
+	const std::size_t	MAX_PAYLOAD = 65536;
+}
@@ -0,0 +1,300 @@
+#include "CGIPoolMember.hpp"
+#include "CGIPool.hpp"
+#include "CGIPoolRequest.hpp"
+#include "../Log/LogFile.hpp"
+#include "../Server/Client/Client.hpp"
+
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+CGIPoolMember::CGIPoolMember(CGIPool& pool, EventLoop& loop)
+  : m_Pool(pool),
+	m_Loop(loop),
+	m_Pid(-1),
+	m_Socket(-1),
+	m_SendOffset(0),
+	m_WriteEnabled(false),
+	m_OutputPaused(false),
+	m_Request(NULL),
+	m_IdleSince(0),
+	m_Exited(false)
+{}
+
+CGIPoolMember::~CGIPoolMember() {
+	closeSocket();
+}
+
+/**
+ * @details	socket 하나를 stdin / stdout 양쪽에 붙인다.
+ *			worker 가 무시하는 signal 은 CGIProcess::spawn 처럼 기본값으로 되돌린다.
+ *			request 별 변수는 PARAMS frame 으로 가므로 environment 는 location template 뿐이다.
+ */
+bool	CGIPoolMember::spawn(const std::string& program, const CGIEnv* templateEnv, const int& childEnd) {
+	std::vector<char*>	envp;
+
+	if (templateEnv != NULL) {
+		envp.reserve(templateEnv->size() + 1);
+		templateEnv->exportTo(envp);
+	}
+	envp.push_back(NULL);
+
+	char*	argv[2] = { const_cast<char*>(program.c_str()), NULL };
+
+	posix_spawn_file_actions_t	actions;
+	posix_spawnattr_t			attr;
+	sigset_t					defaultSignals;
+
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, childEnd, STDIN_FILENO);
+	posix_spawn_file_actions_adddup2(&actions, childEnd, STDOUT_FILENO);
+	posix_spawn_file_actions_addclose(&actions, childEnd);
+
+	posix_spawnattr_init(&attr);
+	sigemptyset(&defaultSignals);
+	sigaddset(&defaultSignals, SIGPIPE);
+	sigaddset(&defaultSignals, E_LOG_FILE::REOPEN_SIGNAL);
+	posix_spawnattr_setsigdefault(&attr, &defaultSignals);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+
+	const int	error = posix_spawn(&m_Pid, argv[0], &actions, &attr, argv, &envp[0]);
+
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attr);
+	if (error != 0) {
+		m_Pid = -1;
+		return false;
+	}
+	return true;
+}
+
+bool	CGIPoolMember::start(const std::string& program, const CGIEnv* templateEnv) {
+	int	pair[2];
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) < 0) {
+		return false;
+	}
+	fcntl(pair[0], F_SETFD, FD_CLOEXEC);
+	const bool	spawned = spawn(program, templateEnv, pair[1]);
+
+	close(pair[1]);
+	m_Socket = pair[0];
+	if (!spawned) {
+		return false;
+	}
+
+	fcntl(m_Socket, F_SETFL, O_NONBLOCK);
+	m_IdleSince = std::time(NULL);
+	m_Loop.addRead(m_Socket, this);
+	m_Loop.addWrite(m_Socket, this);
+	m_Loop.addProcess(m_Pid, this);
+	return true;
+}
+
+void	CGIPoolMember::handleEvent(const struct kevent& event) {
+	if (event.filter == EVFILT_PROC) {
+		onExit();
+	} else if (m_Socket < 0) {
+		return ;
+	} else if (event.filter == EVFILT_WRITE) {
+		onWrite();
+	} else if (event.filter == EVFILT_READ) {
+		onRead();
+	}
+}
+
+void	CGIPoolMember::assign(CGIPoolRequest* request) {
+	m_Request = request;
+}
+
+void	CGIPoolMember::frame(const unsigned char& type, const char* data, const std::size_t& size) {
+	if (m_Socket < 0) {
+		return ;
+	}
+	const char	header[E_CGI_POOL::HEADER_SIZE] = {
+		static_cast<char>(type),
+		static_cast<char>((size >> 24) & 0xff),
+		static_cast<char>((size >> 16) & 0xff),
+		static_cast<char>((size >> 8) & 0xff),
+		static_cast<char>(size & 0xff)
+	};
+
+	m_SendBuffer.append(header, sizeof(header));
+	m_SendBuffer.append(data, size);
+	if (!m_WriteEnabled) {
+		m_Loop.enableWrite(m_Socket, this);
+		m_WriteEnabled = true;
+	}
+}
+
+void	CGIPoolMember::onWrite() {
+	const ssize_t	writeSize = ::send(m_Socket, m_SendBuffer.data() + m_SendOffset, m_SendBuffer.size() - m_SendOffset, 0);
+
+	if (writeSize < 0) {
+		return ;
+	}
+	m_SendOffset += writeSize;
+	if (m_SendOffset == m_SendBuffer.size()) {
+		m_SendBuffer.clear();
+		m_SendOffset = 0;
+		m_Loop.disableWrite(m_Socket, this);
+		m_WriteEnabled = false;
+	}
+	if (m_Request != NULL) {
+		m_Request->onInputDrained();
+	}
+}
+
+void	CGIPoolMember::onRead() {
+	char			buf[E_CGI::READ_SIZE];
+	const ssize_t	readSize = recv(m_Socket, buf, sizeof(buf), 0);
+
+	if (readSize < 0) {
+		return ;
+	}
+	if (readSize == 0) {
+		die();
+		return ;
+	}
+	m_RecvBuffer.append(buf, readSize);
+
+	std::size_t	pos = 0;
+	while (m_RecvBuffer.size() - pos >= E_CGI_POOL::HEADER_SIZE) {
+		const unsigned char*	header = reinterpret_cast<const unsigned char*>(m_RecvBuffer.data() + pos);
+		const std::size_t		size = (static_cast<std::size_t>(header[1]) << 24) | (header[2] << 16) | (header[3] << 8) | header[4];
+
+		if (size > E_CGI_POOL::MAX_PAYLOAD) {
+			die();
+			return ;
+		}
+		if (m_RecvBuffer.size() - pos - E_CGI_POOL::HEADER_SIZE < size) {
+			break;
+		}
+		if (!onFrame(header[0], m_RecvBuffer.data() + pos + E_CGI_POOL::HEADER_SIZE, size)) {
+			die();
+			return ;
+		}
+		pos += E_CGI_POOL::HEADER_SIZE + size;
+	}
+	m_RecvBuffer.erase(0, pos);
+
+	Client*	client = (m_Request != NULL) ? m_Request->getClient() : NULL;
+	if (client != NULL && client->getPendingOutput() > E_CLIENT::HIGH_WATERMARK && !m_OutputPaused) {
+		m_Loop.disableRead(m_Socket, this);
+		m_OutputPaused = true;
+	}
+}
+
+/**
+ * @return	false 면 protocol 위반 (member 를 버린다)
+ */
+bool	CGIPoolMember::onFrame(const unsigned char& type, const char* data, const std::size_t& size) {
+	if (m_Request == NULL) {
+		return false;
+	}
+	switch (type) {
+		case E_CGI_POOL::STDOUT:
+			return (m_Request->onOutput(data, size));
+		case E_CGI_POOL::END:
+			finishRequest(true);
+			m_IdleSince = std::time(NULL);
+			m_Pool.onIdle(this);
+			return true;
+	}
+	return false;
+}
+
+void	CGIPoolMember::finishRequest(const bool& success) {
+	CGIPoolRequest*	request = m_Request;
+
+	m_Request = NULL;
+	resumeOutput();
+	request->onComplete(success);
+	delete request;
+}
+
+void	CGIPoolMember::resumeOutput() {
+	if (m_OutputPaused && m_Socket >= 0) {
+		m_Loop.enableRead(m_Socket, this);
+		m_OutputPaused = false;
+	}
+}
+
+void	CGIPoolMember::onExit() {
+	int	status;
+
+	waitpid(m_Pid, &status, WNOHANG);
+	m_Exited = true;
+	if (m_Socket >= 0) {
+		die();
+		return ;
+	}
+	m_Loop.release(this);
+}
+
+/**
+ * @brief	프로그램이 끊겼거나 protocol 을 어겼다. 맡고 있던 request 는 502 로 끝난다.
+ */
+void	CGIPoolMember::die() {
+	if (m_Request != NULL) {
+		finishRequest(false);
+	}
+	terminate();
+}
+
+/**
+ * @brief	pool 에서 빼고 프로그램을 죽인다. 자식이 reap 되면 release 된다.
+ */
+void	CGIPoolMember::terminate() {
+	if (m_Socket < 0) {
+		return ;
+	}
+	m_Request = NULL;
+	if (!m_Exited && m_Pid > 0) {
+		kill(m_Pid, SIGKILL);
+	}
+	closeSocket();
+	m_Pool.onDead(this);
+	if (m_Exited) {
+		m_Loop.release(this);
+	}
+}
+
+/**
+ * @brief	pool 을 지울 때. 맡은 request 는 502 로 끝내고, 자식을 죽여서 바로 reap 한다. (EventLoop 이 더 돌지 않으므로)
+ */
+void	CGIPoolMember::shutdown() {
+	if (m_Request != NULL) {
+		finishRequest(false);
+	}
+	const bool	exited = m_Exited;
+	terminate();
+	if (!exited && m_Pid > 0) {
+		waitpid(m_Pid, NULL, 0);
+		m_Exited = true;
+		m_Loop.release(this);
+	}
+}
+
+void	CGIPoolMember::closeSocket() {
+	if (m_Socket >= 0) {
+		m_Loop.forget(m_Socket);
+		close(m_Socket);
+		m_Socket = -1;
+	}
+	m_SendBuffer.clear();
+	m_SendOffset = 0;
+	m_RecvBuffer.clear();
+}
+
+const std::time_t&	CGIPoolMember::getIdleSince() const {
+	return (m_IdleSince);
+}
+
+std::size_t	CGIPoolMember::getPendingInput() const {
+	return (m_SendBuffer.size() - m_SendOffset);
+}
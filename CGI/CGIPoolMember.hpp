@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../Server/EventLoop/EventLoop.hpp"
+#include <ctime>
+#include <string>
+
+class CGIPool;
+class CGIPoolRequest;
+class CGIEnv;
+
+/**
+ * @brief	cgi_pool 의 상주 프로세스 하나
+ * @details	socketpair 한쪽 끝을 자식의 stdin / stdout 으로 붙이고, 그 위로 frame 을 주고받는다.
+ *			한 번에 request 하나만 맡는다. (m_Request 가 NULL 이면 idle)
+ *			socket 이 끊기거나 자식이 죽으면 pool 에서 빠지고, 자식이 reap 된 뒤에 release 된다.
+ */
+class CGIPoolMember : public AEventHandler {
+private:
+	CGIPool&			m_Pool;
+	EventLoop&			m_Loop;
+	pid_t				m_Pid;
+	int					m_Socket;
+
+	std::string			m_SendBuffer;
+	std::size_t			m_SendOffset;
+	bool				m_WriteEnabled;
+	std::string			m_RecvBuffer;
+	bool				m_OutputPaused;
+
+	CGIPoolRequest*		m_Request;
+	std::time_t			m_IdleSince;
+	bool				m_Exited;
+
+	CGIPoolMember(const CGIPoolMember& other);
+	CGIPoolMember& operator=(const CGIPoolMember& other);
+
+	bool	spawn(const std::string& program, const CGIEnv* templateEnv, const int& childEnd);
+	void	onWrite();
+	void	onRead();
+	bool	onFrame(const unsigned char& type, const char* data, const std::size_t& size);
+	void	onExit();
+	void	finishRequest(const bool& success);
+	void	die();
+	void	closeSocket();
+
+public:
+	CGIPoolMember(CGIPool& pool, EventLoop& loop);
+	virtual ~CGIPoolMember();
+
+	bool				start(const std::string& program, const CGIEnv* templateEnv);
+	void				assign(CGIPoolRequest* request);
+	void				frame(const unsigned char& type, const char* data, const std::size_t& size);
+	void				resumeOutput();
+	void				terminate();
+	void				shutdown();
+
+	const std::time_t&	getIdleSince() const;
+	std::size_t			getPendingInput() const;
+
+	void				handleEvent(const struct kevent& event);
+};
@@ -0,0 +1,106 @@
+#include "CGIPoolRequest.hpp"
+#include "CGIPool.hpp"
+#include "CGIPoolMember.hpp"
+#include "../Server/Client/Client.hpp"
+#include <algorithm>
+
+CGIPoolRequest::CGIPoolRequest(CGIPool& pool, Client& client, const std::string& script)
+  : ACGI(client),
+	m_Pool(pool),
+	m_Member(NULL),
+	m_BodyDone(false)
+{
+	CGIEnv	env;
+
+	env.reserve(E_CGI::ENV_RESERVE);
+	environment(script, env);
+	m_Params = env.getBlock();
+}
+
+CGIPoolRequest::~CGIPoolRequest() {}
+
+/**
+ * @brief	member 가 배정됐을 때. 그동안 모아 둔 body 까지 한 번에 넘긴다.
+ */
+void	CGIPoolRequest::attach(CGIPoolMember* member) {
+	m_Member = member;
+	m_Member->assign(this);
+	m_Member->frame(E_CGI_POOL::PARAMS, m_Params.data(), m_Params.size());
+	m_Params.clear();
+	sendStdin(m_Body.data(), m_Body.size());
+	m_Body.clear();
+	if (m_BodyDone) {
+		m_Member->frame(E_CGI_POOL::STDIN, NULL, 0);
+	}
+}
+
+void	CGIPoolRequest::sendStdin(const char* data, const std::size_t& size) {
+	for (std::size_t pos = 0; pos < size; pos += E_CGI_POOL::MAX_PAYLOAD) {
+		m_Member->frame(E_CGI_POOL::STDIN, data + pos, std::min(size - pos, E_CGI_POOL::MAX_PAYLOAD));
+	}
+}
+
+bool	CGIPoolRequest::onOutput(const char* data, const std::size_t& size) {
+	return (output(data, size));
+}
+
+/**
+ * @brief	member 가 END frame 을 받았거나 (success) 죽었을 때. 이 뒤에 delete 된다.
+ */
+void	CGIPoolRequest::onComplete(const bool& success) {
+	const bool	done = success && outputEnd();
+	Client*		client = m_Client;
+
+	m_Client = NULL;
+	m_Member = NULL;
+	if (client != NULL) {
+		done ? client->responseDone() : client->sendError(502);
+	}
+}
+
+void	CGIPoolRequest::onInputDrained() {
+	if (m_Client != NULL && getPendingInput() < E_CLIENT::LOW_WATERMARK) {
+		m_Client->resumeRead();
+	}
+}
+
+void	CGIPoolRequest::writeBody(const char* data, const std::size_t& size) {
+	if (m_Member != NULL) {
+		sendStdin(data, size);
+	} else {
+		m_Body.append(data, size);
+	}
+}
+
+void	CGIPoolRequest::endBody() {
+	m_BodyDone = true;
+	if (m_Member != NULL) {
+		m_Member->frame(E_CGI_POOL::STDIN, NULL, 0);
+	}
+}
+
+void	CGIPoolRequest::resumeOutput() {
+	if (m_Member != NULL) {
+		m_Member->resumeOutput();
+	}
+}
+
+/**
+ * @brief	client 가 먼저 끊겼을 때 Client 에서 호출한다. 이 호출 뒤에 this 는 delete 되어 있다.
+ */
+void	CGIPoolRequest::detach() {
+	m_Client = NULL;
+	m_Pool.cancel(this);
+}
+
+Client*	CGIPoolRequest::getClient() const {
+	return (m_Client);
+}
+
+CGIPoolMember*	CGIPoolRequest::getMember() const {
+	return (m_Member);
+}
+
+std::size_t	CGIPoolRequest::getPendingInput() const {
+	return (m_Member != NULL ? m_Member->getPendingInput() : m_Body.size());
+}
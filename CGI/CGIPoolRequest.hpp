@@ -0,0 +1,46 @@
+#pragma once
+
+#include "ACGI.hpp"
+#include <string>
+
+class CGIPool;
+class CGIPoolMember;
+
+/**
+ * @brief	cgi_pool 로 보내진 request 하나
+ * @details	member 가 배정되기 전 (queue 에서 대기 중) 에 들어온 body 는 m_Body 에 모아 두었다가,
+ *			배정되는 순간 PARAMS frame 뒤에 STDIN frame 으로 한꺼번에 넘긴다.
+ *			배정된 뒤에는 body 가 바로 member 의 socket 버퍼로 간다.
+ *			삭제는 CGIPool 이 한다. (응답이 끝났을 때, 또는 detach 됐을 때)
+ */
+class CGIPoolRequest : public ACGI {
+private:
+	CGIPool&		m_Pool;
+	CGIPoolMember*	m_Member;
+	std::string		m_Params;
+	std::string		m_Body;
+	bool			m_BodyDone;
+
+	CGIPoolRequest(const CGIPoolRequest& other);
+	CGIPoolRequest& operator=(const CGIPoolRequest& other);
+
+	void	sendStdin(const char* data, const std::size_t& size);
+
+public:
+	CGIPoolRequest(CGIPool& pool, Client& client, const std::string& script);
+	virtual ~CGIPoolRequest();
+
+	void		attach(CGIPoolMember* member);
+	bool		onOutput(const char* data, const std::size_t& size);
+	void		onComplete(const bool& success);
+	void		onInputDrained();
+
+	void		writeBody(const char* data, const std::size_t& size);
+	void		endBody();
+	void		resumeOutput();
+	void		detach();
+
+	Client*			getClient() const;
+	CGIPoolMember*	getMember() const;
+	std::size_t		getPendingInput() const;
+};
@@ -0,0 +1,314 @@
+#include "CGIProcess.hpp"
+#include "../Log/LogFile.hpp"
+#include "../Server/Client/Client.hpp"
+
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+CGIProcess::CGIProcess(EventLoop& loop, Client& client)
+  : ACGI(client),
+	m_Loop(loop),
+	m_Pid(-1),
+	m_In(-1),
+	m_Out(-1),
+	m_InOffset(0),
+	m_InputDone(false),
+	m_InWriteEnabled(false),
+	m_OutputPaused(false),
+	m_Exited(false),
+	m_ReadTimeout(client.getLocation()->getCgi_read_timeout()),
+	m_TimerArmed(false)
+{}
+
+CGIProcess::~CGIProcess() {
+	closeIn();
+	closeOut();
+}
+
+/**
+ * @brief	posix_spawn 으로 CGI 를 실행한다.
+ * @details	worker 의 RSS 가 클수록 fork() 는 page table 복사 비용이 커진다.
+ *			posix_spawn 은 vfork 처럼 주소 공간을 복사하지 않고 바로 exec 한다.
+ *			worker 가 무시하는 SIGPIPE 와 REOPEN_SIGNAL (kqueue 로만 받는다) 은 exec 후에도 상속되므로 기본값으로 되돌린다.
+ */
+bool	CGIProcess::spawn(const std::string& interpreter, const std::string& script, int inPipe[2], int outPipe[2]) {
+	const CGIEnv*		templateEnv = CGIEnv::find(m_Client->getLocation());
+	CGIEnv				requestEnv;
+	std::vector<char*>	envp;
+
+	requestEnv.reserve(E_CGI::ENV_RESERVE);
+	environment(script, requestEnv);
+	envp.reserve((templateEnv != NULL ? templateEnv->size() : 0) + requestEnv.size() + 1);
+	if (templateEnv != NULL) {
+		templateEnv->exportTo(envp);
+	}
+	requestEnv.exportTo(envp);
+	envp.push_back(NULL);
+
+	char*	argv[3] = { const_cast<char*>(interpreter.c_str()), const_cast<char*>(script.c_str()), NULL };
+
+	posix_spawn_file_actions_t	actions;
+	posix_spawnattr_t			attr;
+	sigset_t					defaultSignals;
+
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, inPipe[0], STDIN_FILENO);
+	posix_spawn_file_actions_adddup2(&actions, outPipe[1], STDOUT_FILENO);
+	posix_spawn_file_actions_addclose(&actions, inPipe[0]);
+	posix_spawn_file_actions_addclose(&actions, outPipe[1]);
+
+	const std::size_t	slashPos = script.rfind('/');
+	const std::string	directory = (slashPos != std::string::npos) ? script.substr(0, slashPos + 1) : "";
+	if (!directory.empty()) {
+		posix_spawn_file_actions_addchdir_np(&actions, directory.c_str());
+	}
+
+	posix_spawnattr_init(&attr);
+	sigemptyset(&defaultSignals);
+	sigaddset(&defaultSignals, SIGPIPE);
+	sigaddset(&defaultSignals, E_LOG_FILE::REOPEN_SIGNAL);
+	posix_spawnattr_setsigdefault(&attr, &defaultSignals);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+
+	const int	error = posix_spawn(&m_Pid, argv[0], &actions, &attr, argv, &envp[0]);
+
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attr);
+	if (error != 0) {
+		m_Pid = -1;
+		return false;
+	}
+	return true;
+}
+
+bool	CGIProcess::start(const std::string& interpreter, const std::string& script) {
+	int	inPipe[2];
+	int	outPipe[2];
+
+	if (pipe(inPipe) < 0) {
+		return false;
+	}
+	if (pipe(outPipe) < 0) {
+		close(inPipe[0]);
+		close(inPipe[1]);
+		return false;
+	}
+	// 부모 쪽 끝은 자식에게 상속되면 안 된다. (stdin EOF 가 오지 않는다)
+	fcntl(inPipe[1], F_SETFD, FD_CLOEXEC);
+	fcntl(outPipe[0], F_SETFD, FD_CLOEXEC);
+	const bool	spawned = spawn(interpreter, script, inPipe, outPipe);
+
+	close(inPipe[0]);
+	close(outPipe[1]);
+	m_In = inPipe[1];
+	m_Out = outPipe[0];
+	if (!spawned) {
+		return false;
+	}
+
+	fcntl(m_In, F_SETFL, O_NONBLOCK);
+	fcntl(m_Out, F_SETFL, O_NONBLOCK);
+	m_Loop.addRead(m_Out, this);
+	m_Loop.addWrite(m_In, this);
+	m_Loop.addProcess(m_Pid, this);
+	armTimer();
+	return true;
+}
+
+void	CGIProcess::handleEvent(const struct kevent& event) {
+	if (event.filter == EVFILT_TIMER) {
+		m_TimerArmed = false;
+		onTimeout();
+	} else if (event.filter == EVFILT_PROC) {
+		onExit();
+	} else if (event.filter == EVFILT_WRITE && static_cast<int>(event.ident) == m_In) {
+		onStdin();
+	} else if (event.filter == EVFILT_READ && static_cast<int>(event.ident) == m_Out) {
+		onStdout();
+	}
+}
+
+/**
+ *			stdin (request body)
+ */
+void	CGIProcess::writeBody(const char* data, const std::size_t& size) {
+	if (m_In < 0) {
+		return ;
+	}
+	m_InBuffer.append(data, size);
+	if (!m_InWriteEnabled) {
+		m_Loop.enableWrite(m_In, this);
+		m_InWriteEnabled = true;
+	}
+}
+
+void	CGIProcess::endBody() {
+	m_InputDone = true;
+	if (getPendingInput() == 0) {
+		closeIn();
+	}
+}
+
+void	CGIProcess::onStdin() {
+	const ssize_t	writeSize = write(m_In, m_InBuffer.data() + m_InOffset, m_InBuffer.size() - m_InOffset);
+
+	if (writeSize < 0) {
+		// 자식이 stdin 을 닫았다. 남은 body 는 버린다.
+		closeIn();
+		if (m_Client != NULL) {
+			m_Client->resumeRead();
+		}
+		return ;
+	}
+	m_InOffset += writeSize;
+	if (m_InOffset == m_InBuffer.size()) {
+		m_InBuffer.clear();
+		m_InOffset = 0;
+		m_Loop.disableWrite(m_In, this);
+		m_InWriteEnabled = false;
+		if (m_InputDone) {
+			closeIn();
+		}
+	}
+	if (m_Client != NULL && getPendingInput() < E_CLIENT::LOW_WATERMARK) {
+		m_Client->resumeRead();
+	}
+}
+
+/**
+ *			stdout (response)
+ */
+void	CGIProcess::onStdout() {
+	char			buf[E_CGI::READ_SIZE];
+	const ssize_t	readSize = read(m_Out, buf, sizeof(buf));
+
+	if (readSize < 0) {
+		return ;
+	}
+	if (readSize == 0) {
+		finish(outputEnd());
+		return ;
+	}
+	armTimer();
+	if (!output(buf, readSize)) {
+		finish(false);
+		return ;
+	}
+
+	if (m_Client != NULL && m_Client->getPendingOutput() > E_CLIENT::HIGH_WATERMARK && !m_OutputPaused) {
+		m_Loop.disableRead(m_Out, this);
+		m_OutputPaused = true;
+	}
+}
+
+void	CGIProcess::resumeOutput() {
+	if (m_OutputPaused && m_Out >= 0) {
+		m_Loop.enableRead(m_Out, this);
+		m_OutputPaused = false;
+	}
+}
+
+void	CGIProcess::onExit() {
+	int	status;
+
+	waitpid(m_Pid, &status, WNOHANG);
+	m_Exited = true;
+	if (m_Client == NULL && m_Out < 0) {
+		m_Loop.release(this);
+	}
+}
+
+/**
+ * @brief	read timeout. 다시 걸면 처음부터 센다. (EV_ONESHOT)
+ */
+void	CGIProcess::armTimer() {
+	m_Loop.addTimeout(reinterpret_cast<uintptr_t>(this), m_ReadTimeout, this);
+	m_TimerArmed = true;
+}
+
+void	CGIProcess::disarmTimer() {
+	if (m_TimerArmed) {
+		m_Loop.removeTimer(reinterpret_cast<uintptr_t>(this));
+		m_TimerArmed = false;
+	}
+}
+
+/**
+ * @brief	read timeout 동안 stdout 에 아무것도 오지 않았다. 자식을 죽이고 reap 되면 release 된다.
+ */
+void	CGIProcess::onTimeout() {
+	Client*	client = m_Client;
+
+	if (m_Out < 0) {
+		return ;
+	}
+	if (!m_Exited && m_Pid > 0) {
+		kill(m_Pid, SIGKILL);
+	}
+	closeIn();
+	closeOut();
+	endMicrocache(false);
+	m_Client = NULL;
+	if (client != NULL) {
+		m_HeaderDone ? client->abort() : client->sendError(504);
+	}
+	if (m_Exited) {
+		m_Loop.release(this);
+	}
+}
+
+void	CGIProcess::closeIn() {
+	if (m_In >= 0) {
+		m_Loop.forget(m_In);
+		close(m_In);
+		m_In = -1;
+	}
+	m_InBuffer.clear();
+	m_InOffset = 0;
+}
+
+void	CGIProcess::closeOut() {
+	if (m_Out >= 0) {
+		m_Loop.forget(m_Out);
+		close(m_Out);
+		m_Out = -1;
+	}
+}
+
+void	CGIProcess::finish(const bool& success) {
+	Client*	client = m_Client;
+
+	disarmTimer();
+	closeIn();
+	closeOut();
+	m_Client = NULL;
+	if (client != NULL) {
+		success ? client->responseDone() : client->sendError(502);
+	}
+	if (m_Exited) {
+		m_Loop.release(this);
+	}
+}
+
+/**
+ * @brief	client 가 먼저 끊겼을 때 Client 에서 호출한다.
+ */
+void	CGIProcess::detach() {
+	disarmTimer();
+	m_Client = NULL;
+	if (!m_Exited && m_Pid > 0) {
+		kill(m_Pid, SIGKILL);
+	}
+	closeIn();
+	closeOut();
+	if (m_Exited || m_Pid <= 0) {
+		m_Loop.release(this);
+	}
+}
+
+std::size_t	CGIProcess::getPendingInput() const {
+	return (m_InBuffer.size() - m_InOffset);
+}
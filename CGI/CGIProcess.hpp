@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../Server/EventLoop/EventLoop.hpp"
+#include "ACGI.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @brief	CGI/1.1 (RFC 3875) 실행
+ * @details	stdin / stdout pipe 를 non-blocking 으로 만들어 worker 의 EventLoop 에 등록한다.
+ *			- request body 는 Client 가 받는 대로 writeBody() 로 들어와서 stdin 으로 흘러간다.
+ *			- stdout 은 CGI header 를 파싱한 뒤, Content-Length 가 없으면 chunked 로 감싸서
+ *			  읽는 대로 Client 에게 넘긴다.
+ *			- client 가 먼저 끊기면 detach() 로 자식을 죽이고, 자식이 reap 되면 스스로 release 된다.
+ *			- stdout 에서 read timeout (cgi_read_timeout) 동안 아무것도 오지 않으면 자식을 죽이고
+ *			  header 전이면 504, 뒤면 client 연결을 끊는다.
+ */
+class CGIProcess : public AEventHandler, public ACGI {
+private:
+	EventLoop&		m_Loop;
+	pid_t			m_Pid;
+	int				m_In;
+	int				m_Out;
+
+	std::string		m_InBuffer;
+	std::size_t		m_InOffset;
+	bool			m_InputDone;
+	bool			m_InWriteEnabled;
+
+	bool			m_OutputPaused;
+	bool			m_Exited;
+	unsigned int	m_ReadTimeout;
+	bool			m_TimerArmed;
+
+	CGIProcess(const CGIProcess& other);
+	CGIProcess& operator=(const CGIProcess& other);
+
+	bool	spawn(const std::string& interpreter, const std::string& script, int inPipe[2], int outPipe[2]);
+
+	void	onStdin();
+	void	onStdout();
+	void	onExit();
+	void	onTimeout();
+	void	armTimer();
+	void	disarmTimer();
+	void	closeIn();
+	void	closeOut();
+	void	finish(const bool& success);
+
+public:
+	CGIProcess(EventLoop& loop, Client& client);
+	virtual ~CGIProcess();
+
+	bool		start(const std::string& interpreter, const std::string& script);
+	void		writeBody(const char* data, const std::size_t& size);
+	void		endBody();
+	void		resumeOutput();
+	void		detach();
+
+	std::size_t	getPendingInput() const;
+
+	void		handleEvent(const struct kevent& event);
+};
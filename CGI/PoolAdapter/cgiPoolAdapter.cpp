@@ -0,0 +1,202 @@
+#include "../CGIPoolFrame.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern char**	environ;
+
+/**
+ * @brief	cgi_pool 의 frame (CGIPoolFrame.hpp) 을 보통 CGI 실행으로 바꿔 주는 adapter
+ * @details	cgi_pool location 의 cgi 에 이 프로그램을 두면, pool member 마다 하나씩 상주하면서
+ *			request 마다 SCRIPT_FILENAME 을 CGI/1.1 (RFC 3875) 대로 실행한다.
+ *			- PARAMS 는 script 의 environment 가 된다. (adapter 의 environment 보다 먼저 둔다)
+ *			- STDIN frame 은 임시 파일에 모았다가 script 의 stdin 으로 준다. (body 와 출력이 서로 막히지 않게)
+ *			- script 의 stdout 은 읽는 대로 STDOUT frame 으로, 끝나면 END 를 보낸다.
+ *			script 는 그대로 exec 한다. (#! 줄) environment 에 CGI_POOL_INTERPRETER 가 있으면 그 프로그램으로 실행한다.
+ *			(main 블록의 env 지시어로 넘긴다)
+ *			adapter 는 frame 을 보여 주는 참고 구현이기도 하다. interpreter 안에서 이 loop 를 직접 돌리면
+ *			request 마다 프로세스를 띄우지 않는다.
+ *
+ *	usage:	location /cgi/ { cgi /path/to/cgi_pool_adapter; cgi_pool 2 8; }	(make adapter)
+ */
+
+static bool	readFull(const int& fd, char* buf, const std::size_t& size) {
+	std::size_t	total = 0;
+
+	while (total < size) {
+		const ssize_t	readSize = read(fd, buf + total, size - total);
+		if (readSize < 0 && errno == EINTR) {
+			continue;
+		}
+		if (readSize <= 0) {
+			return false;
+		}
+		total += readSize;
+	}
+	return true;
+}
+
+static bool	writeFull(const int& fd, const char* data, const std::size_t& size) {
+	std::size_t	total = 0;
+
+	while (total < size) {
+		const ssize_t	writeSize = write(fd, data + total, size - total);
+		if (writeSize < 0 && errno == EINTR) {
+			continue;
+		}
+		if (writeSize <= 0) {
+			return false;
+		}
+		total += writeSize;
+	}
+	return true;
+}
+
+static bool	readFrame(unsigned char& type, std::string& payload) {
+	unsigned char	header[E_CGI_POOL::HEADER_SIZE];
+
+	if (!readFull(STDIN_FILENO, reinterpret_cast<char*>(header), sizeof(header))) {
+		return false;
+	}
+	const std::size_t	size = (static_cast<std::size_t>(header[1]) << 24) | (header[2] << 16) | (header[3] << 8) | header[4];
+
+	if (size > E_CGI_POOL::MAX_PAYLOAD) {
+		return false;
+	}
+	type = header[0];
+	payload.resize(size);
+	return (size == 0 || readFull(STDIN_FILENO, &payload[0], size));
+}
+
+static bool	writeFrame(const unsigned char& type, const char* data, const std::size_t& size) {
+	const char	header[E_CGI_POOL::HEADER_SIZE] = {
+		static_cast<char>(type),
+		static_cast<char>((size >> 24) & 0xff),
+		static_cast<char>((size >> 16) & 0xff),
+		static_cast<char>((size >> 8) & 0xff),
+		static_cast<char>(size & 0xff)
+	};
+
+	return (writeFull(STDOUT_FILENO, header, sizeof(header)) && (size == 0 || writeFull(STDOUT_FILENO, data, size)));
+}
+
+/**
+ * @brief	PARAMS ("KEY=VALUE\0...") + adapter 의 environment. 같은 KEY 는 앞의 것 (PARAMS) 이 쓰인다.
+ */
+static void	buildEnvironment(std::string& params, std::vector<char*>& envp, std::string& script) {
+	for (std::size_t pos = 0; pos < params.size(); pos += std::strlen(&params[pos]) + 1) {
+		char*	entry = &params[pos];
+
+		if (std::strncmp(entry, "SCRIPT_FILENAME=", 16) == 0) {
+			script = entry + 16;
+		}
+		envp.push_back(entry);
+	}
+	for (char** it = environ; *it != NULL; ++it) {
+		envp.push_back(*it);
+	}
+	envp.push_back(NULL);
+}
+
+/**
+ * @brief	script 를 실행하고 stdout 을 STDOUT frame 으로 넘긴다.
+ * @return	false 면 webserv 와의 연결이 끊겼다.
+ */
+static bool	run(std::string& params, std::FILE* body) {
+	std::vector<char*>	envp;
+	std::string			script;
+	int					outPipe[2];
+
+	buildEnvironment(params, envp, script);
+	if (script.empty() || pipe(outPipe) < 0) {
+		return (writeFrame(E_CGI_POOL::END, NULL, 0));
+	}
+
+	const char*	interpreter = std::getenv("CGI_POOL_INTERPRETER");
+	const pid_t	pid = fork();
+
+	if (pid == 0) {
+		const std::size_t	slashPos = script.rfind('/');
+		char*				argv[3] = { NULL, NULL, NULL };
+
+		if (interpreter != NULL && *interpreter != '\0') {
+			argv[0] = const_cast<char*>(interpreter);
+			argv[1] = const_cast<char*>(script.c_str());
+		} else {
+			argv[0] = const_cast<char*>(script.c_str());
+		}
+		dup2(fileno(body), STDIN_FILENO);
+		dup2(outPipe[1], STDOUT_FILENO);
+		close(outPipe[0]);
+		close(outPipe[1]);
+		if (slashPos != std::string::npos && chdir(script.substr(0, slashPos + 1).c_str()) < 0) {
+			_exit(127);
+		}
+		execve(argv[0], argv, &envp[0]);
+		_exit(127);
+	}
+	close(outPipe[1]);
+
+	char	buf[E_CGI_POOL::MAX_PAYLOAD];
+	bool	connected = true;
+	ssize_t	readSize;
+
+	while (pid > 0 && (readSize = read(outPipe[0], buf, sizeof(buf))) != 0) {
+		if (readSize < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		if (connected && !writeFrame(E_CGI_POOL::STDOUT, buf, readSize)) {
+			// 출력은 끝까지 읽어서 script 가 막히지 않게 한다.
+			connected = false;
+		}
+	}
+	close(outPipe[0]);
+	if (pid > 0) {
+		waitpid(pid, NULL, 0);
+	}
+	return (connected && writeFrame(E_CGI_POOL::END, NULL, 0));
+}
+
+int	main() {
+	unsigned char	type;
+	std::string		params;
+	std::string		payload;
+
+	// webserv 가 socket 을 닫으면 (pool 이 줄거나 worker 가 끝나면) 조용히 끝난다.
+	while (readFrame(type, params)) {
+		if (type != E_CGI_POOL::PARAMS) {
+			return 1;
+		}
+		std::FILE*	body = std::tmpfile();
+
+		if (body == NULL) {
+			return 1;
+		}
+		while (readFrame(type, payload) && type == E_CGI_POOL::STDIN && !payload.empty()) {
+			std::fwrite(payload.data(), 1, payload.size(), body);
+		}
+		if (type != E_CGI_POOL::STDIN || !payload.empty()) {
+			std::fclose(body);
+			return 1;
+		}
+		std::fflush(body);
+		std::rewind(body);
+
+		const bool	connected = run(params, body);
+
+		std::fclose(body);
+		if (!connected) {
+			return 1;
+		}
+	}
+	return 0;
+}
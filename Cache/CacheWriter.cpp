@@ -0,0 +1,115 @@
+#include "CacheWriter.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @param	lifetime	m_Expire / m_StaleUpdate / m_StaleError / m_Chunked 만 본다.
+ */
+CacheWriter::CacheWriter(CacheZone& zone, const std::string& key, const CacheEntry& lifetime)
+  : m_Zone(zone),
+	m_CacheKey(key),
+	m_Key(CacheZone::hash64(key)),
+	m_Fd(-1)
+{
+	// version 은 zone 안에서 겹치지 않으므로 같은 key 를 여러 worker 가 동시에 써도 임시 이름이 다르다.
+	m_Entry.m_Version = m_Zone.nextVersion();
+	m_TempPath = m_Zone.path(m_Key, m_Entry.m_Version) + ".tmp";
+	m_Entry.m_Expire = lifetime.m_Expire;
+	m_Entry.m_StaleUpdate = lifetime.m_StaleUpdate;
+	m_Entry.m_StaleError = lifetime.m_StaleError;
+	m_Entry.m_Chunked = lifetime.m_Chunked;
+	m_Entry.m_Size = 0;
+	m_Entry.m_DataStart = sizeof(CacheFileHeader) + key.size();
+	m_Entry.m_HeaderSize = 0;
+}
+
+CacheWriter::~CacheWriter() {
+	abort();
+}
+
+bool	CacheWriter::writeAll(const char* data, const std::size_t& size) {
+	std::size_t	written = 0;
+
+	while (written < size) {
+		const ssize_t	writeSize = ::write(m_Fd, data + written, size - written);
+		if (writeSize <= 0) {
+			return false;
+		}
+		written += writeSize;
+	}
+	return true;
+}
+
+/**
+ * @brief	임시 파일을 만들고 파일 header + key + 응답 header 를 쓴다.
+ * @details	levels directory 가 아직 없으면 만들고 한 번 더 연다.
+ */
+bool	CacheWriter::open(const std::string& head) {
+	CacheFileHeader	header;
+
+	m_Fd = ::open(m_TempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if (m_Fd < 0 && errno == ENOENT && m_Zone.makeDirectory(m_Key)) {
+		m_Fd = ::open(m_TempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	}
+	if (m_Fd < 0) {
+		return false;
+	}
+	fcntl(m_Fd, F_SETFD, FD_CLOEXEC);
+	header.m_Magic = E_CACHE::FILE_MAGIC;
+	header.m_KeySize = m_CacheKey.size();
+	header.m_HeaderSize = head.size();
+	header.m_Version = m_Entry.m_Version;
+	header.m_Chunked = m_Entry.m_Chunked;
+	header.m_Key = m_Key;
+	header.m_Expire = m_Entry.m_Expire;
+	header.m_StaleUpdate = m_Entry.m_StaleUpdate;
+	header.m_StaleError = m_Entry.m_StaleError;
+	m_Entry.m_HeaderSize = head.size();
+	if (!writeAll(reinterpret_cast<const char*>(&header), sizeof(header))
+			|| !writeAll(m_CacheKey.data(), m_CacheKey.size())) {
+		abort();
+		return false;
+	}
+	write(head.data(), head.size());
+	return (m_Fd >= 0);
+}
+
+void	CacheWriter::write(const char* data, const std::size_t& size) {
+	if (m_Fd < 0) {
+		return ;
+	}
+	if (!writeAll(data, size)) {
+		abort();
+		return ;
+	}
+	m_Entry.m_Size += size;
+}
+
+/**
+ * @brief	응답이 끝까지 왔다. 이 version 의 이름으로 rename 한 뒤 index 를 바꾼다.
+ * @details	옛 version 의 파일은 index 에서 바뀐 뒤에 지우므로 (CacheZone::insert) 옛 entry 로 새 파일을 여는 일은 없다.
+ */
+void	CacheWriter::commit() {
+	if (m_Fd < 0) {
+		return ;
+	}
+	::close(m_Fd);
+	m_Fd = -1;
+	if (std::rename(m_TempPath.c_str(), m_Zone.path(m_Key, m_Entry.m_Version).c_str()) != 0) {
+		unlink(m_TempPath.c_str());
+		return ;
+	}
+	m_Zone.insert(m_Key, m_Entry);
+}
+
+void	CacheWriter::abort() {
+	if (m_Fd < 0) {
+		return ;
+	}
+	::close(m_Fd);
+	m_Fd = -1;
+	unlink(m_TempPath.c_str());
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CacheZone.hpp"
+#include <string>
+
+/**
+ * @brief	upstream 응답 하나를 cache 파일로 쓰는 중
+ * @details	client 에게 보내는 byte (응답 header + body) 를 그대로 임시 파일에 쓰고,
+ *			응답이 끝까지 오면 이 version 의 이름으로 rename 한 뒤 index 에 넣는다.
+ *			중간에 실패하면 임시 파일을 지운다. (index 에는 없으므로 다른 worker 는 보지 못한다)
+ *			디스크 쓰기는 blocking 이지만 page cache 에만 쓰므로 짧다.
+ */
+class CacheWriter {
+private:
+	CacheZone&		m_Zone;
+	std::string		m_CacheKey;
+	unsigned long	m_Key;
+	std::string		m_TempPath;
+	int				m_Fd;
+	CacheEntry		m_Entry;
+
+	CacheWriter(const CacheWriter& other);
+	CacheWriter& operator=(const CacheWriter& other);
+
+	bool	writeAll(const char* data, const std::size_t& size);
+
+public:
+	CacheWriter(CacheZone& zone, const std::string& key, const CacheEntry& lifetime);
+	~CacheWriter();
+
+	bool	open(const std::string& head);
+	void	write(const char* data, const std::size_t& size);
+	void	commit();
+	void	abort();
+};
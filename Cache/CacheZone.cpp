@@ -0,0 +1,507 @@
+#include "CacheZone.hpp"
+#include "../Server/Client/Client.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+#include "../utils/SpinLock.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CacheZone::zoneMap		CacheZone::m_Zones;
+CacheZone::locationMap	CacheZone::m_Locations;
+
+CacheZone::CacheZone()
+  : m_Header(NULL),
+	m_Locks(NULL),
+	m_Nodes(NULL),
+	m_Buckets(NULL),
+	m_Capacity(0)
+{}
+
+CacheZone::CacheZone(const CacheZone& other) {
+	*this = other;
+}
+
+CacheZone&	CacheZone::operator=(const CacheZone& other) {
+	if (this != &other) {
+		m_Name = other.m_Name;
+		m_Config = other.m_Config;
+		m_Header = other.m_Header;
+		m_Locks = other.m_Locks;
+		m_Nodes = other.m_Nodes;
+		m_Buckets = other.m_Buckets;
+		m_Capacity = other.m_Capacity;
+	}
+	return (*this);
+}
+
+CacheZone::~CacheZone() {}
+
+/**
+ *			index (m_Header->m_Lock 을 잡고 부를 것)
+ */
+unsigned int	CacheZone::lookupNode(const unsigned long& key) const {
+	unsigned int	index = m_Buckets[key % m_Capacity];
+
+	while (index != E_CACHE::NIL && m_Nodes[index].m_Key != key) {
+		index = m_Nodes[index].m_HashNext;
+	}
+	return (index);
+}
+
+void	CacheZone::unlinkLru(const unsigned int& index) {
+	CacheNode&	node = m_Nodes[index];
+
+	(node.m_LruPrev != E_CACHE::NIL) ? m_Nodes[node.m_LruPrev].m_LruNext = node.m_LruNext : m_Header->m_LruHead = node.m_LruNext;
+	(node.m_LruNext != E_CACHE::NIL) ? m_Nodes[node.m_LruNext].m_LruPrev = node.m_LruPrev : m_Header->m_LruTail = node.m_LruPrev;
+	node.m_LruPrev = E_CACHE::NIL;
+	node.m_LruNext = E_CACHE::NIL;
+}
+
+void	CacheZone::pushLru(const unsigned int& index) {
+	CacheNode&	node = m_Nodes[index];
+
+	node.m_LruPrev = E_CACHE::NIL;
+	node.m_LruNext = m_Header->m_LruHead;
+	(m_Header->m_LruHead != E_CACHE::NIL) ? m_Nodes[m_Header->m_LruHead].m_LruPrev = index : m_Header->m_LruTail = index;
+	m_Header->m_LruHead = index;
+}
+
+void	CacheZone::removeNode(const unsigned int& index) {
+	CacheNode&		node = m_Nodes[index];
+	unsigned int*	link = &m_Buckets[node.m_Key % m_Capacity];
+
+	while (*link != index) {
+		link = &m_Nodes[*link].m_HashNext;
+	}
+	*link = node.m_HashNext;
+	unlinkLru(index);
+	m_Header->m_TotalSize -= node.m_Entry.m_DataStart + node.m_Entry.m_Size;
+	m_Header->m_Count--;
+	node.m_HashNext = m_Header->m_Free;
+	m_Header->m_Free = index;
+}
+
+/**
+ * @brief	hit 이면 entry 를 복사해 주고 LRU 맨 앞으로 옮긴다. 만료 여부는 부르는 쪽이 본다.
+ */
+bool	CacheZone::lookup(const unsigned long& key, CacheEntry& entry) {
+	ft::SpinLock		lock(&m_Header->m_Lock);
+	const unsigned int	index = lookupNode(key);
+
+	if (index == E_CACHE::NIL) {
+		return false;
+	}
+	entry = m_Nodes[index].m_Entry;
+	m_Nodes[index].m_Accessed = EventLoop::now();
+	unlinkLru(index);
+	pushLru(index);
+	return true;
+}
+
+/**
+ * @brief	새 응답을 index 에 넣는다. 같은 key 가 있으면 덮어쓴다. (파일은 이미 rename 되어 있다)
+ * @details	덮어쓴 옛 version 의 파일과, 빈 node 가 없어서 뺀 LRU 끝 항목의 파일은 lock 을 놓은 뒤에 지운다.
+ *			옛 파일을 이미 연 worker 는 지운 뒤에도 끝까지 보낸다.
+ */
+void	CacheZone::insert(const unsigned long& key, const CacheEntry& entry) {
+	std::string	victim;
+
+	{
+		ft::SpinLock	lock(&m_Header->m_Lock);
+		unsigned int	index = lookupNode(key);
+
+		if (index != E_CACHE::NIL) {
+			const CacheEntry&	old = m_Nodes[index].m_Entry;
+			if (old.m_Version != entry.m_Version) {
+				victim = path(key, old.m_Version);
+			}
+			m_Header->m_TotalSize -= old.m_DataStart + old.m_Size;
+			unlinkLru(index);
+		} else {
+			if (m_Header->m_Free == E_CACHE::NIL) {
+				const CacheNode&	tail = m_Nodes[m_Header->m_LruTail];
+				victim = path(tail.m_Key, tail.m_Entry.m_Version);
+				removeNode(m_Header->m_LruTail);
+			}
+			index = m_Header->m_Free;
+			m_Header->m_Free = m_Nodes[index].m_HashNext;
+			m_Nodes[index].m_Key = key;
+			m_Nodes[index].m_HashNext = m_Buckets[key % m_Capacity];
+			m_Buckets[key % m_Capacity] = index;
+			m_Header->m_Count++;
+		}
+		m_Nodes[index].m_Entry = entry;
+		m_Nodes[index].m_Accessed = EventLoop::now();
+		m_Header->m_TotalSize += entry.m_DataStart + entry.m_Size;
+		pushLru(index);
+	}
+	if (!victim.empty()) {
+		unlink(victim.c_str());
+	}
+}
+
+/**
+ * @brief	index 의 항목이 아직 그 version 이면 뺀다. (그 사이에 새 응답으로 바뀌었으면 그대로 둔다)
+ */
+void	CacheZone::remove(const unsigned long& key, const unsigned int& version) {
+	ft::SpinLock		lock(&m_Header->m_Lock);
+	const unsigned int	index = lookupNode(key);
+
+	if (index != E_CACHE::NIL && m_Nodes[index].m_Entry.m_Version == version) {
+		removeNode(index);
+	}
+}
+
+/**
+ * @brief	새로 쓸 cache 파일의 version. zone 안에서 겹치지 않는다.
+ */
+unsigned int	CacheZone::nextVersion() {
+	ft::SpinLock	lock(&m_Header->m_Lock);
+
+	return (++m_Header->m_Version);
+}
+
+/**
+ * @brief	key 를 upstream 에서 가져오는 request 가 된다.
+ * @details	slot 을 찾지 못하면 (LOCK_PROBE 안이 모두 다른 key) coalescing 없이 그냥 가져가게 한다.
+ * @return	false 면 다른 request 가 이미 가져오는 중이다.
+ */
+bool	CacheZone::lock(const unsigned long& key, const unsigned int& timeout) {
+	ft::SpinLock			guard(&m_Header->m_Lock);
+	const unsigned long&	now = EventLoop::now();
+	CacheLockSlot*			freeSlot = NULL;
+
+	for (unsigned int i = 0; i < E_CACHE::LOCK_PROBE; i++) {
+		CacheLockSlot&	slot = m_Locks[(key + i) % E_CACHE::LOCK_SLOTS];
+
+		if (slot.m_Deadline > now) {
+			if (slot.m_Key == key) {
+				return false;
+			}
+		} else if (freeSlot == NULL) {
+			freeSlot = &slot;
+		}
+	}
+	if (freeSlot != NULL) {
+		freeSlot->m_Key = key;
+		freeSlot->m_Deadline = now + timeout;
+	}
+	return true;
+}
+
+void	CacheZone::unlock(const unsigned long& key) {
+	ft::SpinLock	guard(&m_Header->m_Lock);
+
+	for (unsigned int i = 0; i < E_CACHE::LOCK_PROBE; i++) {
+		CacheLockSlot&	slot = m_Locks[(key + i) % E_CACHE::LOCK_SLOTS];
+
+		if (slot.m_Key == key && slot.m_Deadline != 0) {
+			slot.m_Deadline = 0;
+			return ;
+		}
+	}
+}
+
+/**
+ * @brief	key hash (16진수 16자리) 의 끝에서부터 levels 만큼 잘라 directory 로 쓴다.
+ * @details	파일 이름은 key hash 16자리 - version 8자리 (E_CACHE::NAME_SIZE) 이다.
+ */
+std::string	CacheZone::path(const unsigned long& key, const unsigned int& version) const {
+	const char	digits[] = "0123456789abcdef";
+	char		hex[16];
+	char		suffix[8];
+	std::string	result = m_Config.m_Path;
+	std::size_t	pos = sizeof(hex);
+
+	for (std::size_t i = 0; i < sizeof(hex); i++) {
+		hex[i] = digits[(key >> ((sizeof(hex) - 1 - i) * 4)) & 0xf];
+	}
+	for (std::size_t i = 0; i < sizeof(suffix); i++) {
+		suffix[i] = digits[(version >> ((sizeof(suffix) - 1 - i) * 4)) & 0xf];
+	}
+	for (std::vector<unsigned int>::const_iterator it = m_Config.m_Levels.begin(); it != m_Config.m_Levels.end(); ++it) {
+		pos -= *it;
+		result += "/" + std::string(hex + pos, *it);
+	}
+	return (result + "/" + std::string(hex, sizeof(hex)) + "-" + std::string(suffix, sizeof(suffix)));
+}
+
+/**
+ * @brief	levels directory 는 처음 저장할 때 만든다.
+ */
+bool	CacheZone::makeDirectory(const unsigned long& key) const {
+	const std::string	file = path(key, 0);
+	std::size_t			slashPos = m_Config.m_Path.size();
+
+	while ((slashPos = file.find('/', slashPos + 1)) != std::string::npos) {
+		if (mkdir(file.substr(0, slashPos).c_str(), 0700) < 0 && errno != EEXIST) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief	nginx 의 기본 key ($proxy_host$request_uri) 와 같다.
+ */
+std::string	CacheZone::key(const Client& client) {
+	const CONF::proxyPassData&	pass = client.getLocation()->getProxy_pass();
+	std::stringstream			key;
+
+	key << pass.m_Host << ":" << pass.m_Port << client.getRequest().getTarget();
+	return (key.str());
+}
+
+/**
+ * @brief	hit 에서 연 파일이 index 의 entry 그대로이고 (version) request 의 key 를 저장한 것인지 본다.
+ * @details	key 는 64bit hash 로만 찾으므로 hash 가 같은 다른 key 의 응답을 보내지 않으려면 파일의 key 와 비교해야 한다.
+ */
+bool	CacheZone::verify(const int& fd, const std::string& key, const CacheEntry& entry) {
+	CacheFileHeader	header;
+	std::string		stored(key.size(), '\0');
+
+	if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) || header.m_Magic != E_CACHE::FILE_MAGIC
+			|| header.m_Version != entry.m_Version || header.m_KeySize != key.size() || sizeof(header) + key.size() != entry.m_DataStart) {
+		return false;
+	}
+	return (key.empty() || (pread(fd, &stored[0], key.size(), sizeof(header)) == static_cast<ssize_t>(key.size()) && stored == key));
+}
+
+/**
+ * @brief	FNV-1a 64 + murmur3 fmix64
+ */
+unsigned long	CacheZone::hash64(const std::string& key) {
+	unsigned long	hash = 14695981039346656037UL;
+
+	for (std::size_t i = 0; i < key.size(); i++) {
+		hash ^= static_cast<unsigned char>(key[i]);
+		hash *= 1099511628211UL;
+	}
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdUL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53UL;
+	hash ^= hash >> 33;
+	return (hash);
+}
+
+/**
+ * @brief	응답을 얼마나 (ms) 저장할지. s-maxage > max-age > valid 순서로 본다.
+ * @param	cacheControl	소문자로 바꾼 Cache-Control 값
+ * @return	0 이면 저장하지 않는다.
+ */
+unsigned int	CacheZone::maxAge(const std::string& cacheControl, const unsigned int& valid) {
+	if (cacheControl.find("no-store") != std::string::npos || cacheControl.find("no-cache") != std::string::npos
+			|| cacheControl.find("private") != std::string::npos) {
+		return (0);
+	}
+	return (seconds(cacheControl, "s-maxage", seconds(cacheControl, "max-age", valid)));
+}
+
+/**
+ * @brief	Cache-Control 의 "name=초" 를 ms 로. 없으면 fallback. (1년에서 자른다)
+ */
+unsigned int	CacheZone::seconds(const std::string& cacheControl, const std::string& name, const unsigned int& fallback) {
+	std::size_t	pos = cacheControl.find(name + "=");
+
+	while (pos != std::string::npos && pos > 0 && cacheControl[pos - 1] != ',' && cacheControl[pos - 1] != ' ') {
+		pos = cacheControl.find(name + "=", pos + 1);
+	}
+	if (pos == std::string::npos) {
+		return (fallback);
+	}
+	const unsigned long	value = std::strtoul(cacheControl.c_str() + pos + name.size() + 1, NULL, 10);
+	return (value > 86400UL * 365 ? 86400U * 365 * 1000 : static_cast<unsigned int>(value * 1000));
+}
+
+/**
+ *			setup (master, fork 전)
+ */
+
+/**
+ * @brief	keys_zone 크기 안에 header + node 배열 + bucket 배열을 만든다. lock slot 은 따로 더한다.
+ */
+void	CacheZone::map() {
+	m_Capacity = m_Config.m_ZoneSize / (sizeof(CacheNode) + sizeof(unsigned int));
+	if (m_Capacity == 0) {
+		throw std::runtime_error("proxy_cache_path: keys_zone " + m_Name + " is too small");
+	}
+	const std::size_t	size = E_CACHE::CACHE_LINE + E_CACHE::LOCK_SLOTS * sizeof(CacheLockSlot)
+								+ m_Capacity * (sizeof(CacheNode) + sizeof(unsigned int));
+	void*				region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_ANON | MAP_SHARED, -1, 0);
+
+	if (region == MAP_FAILED) {
+		throw std::runtime_error("CacheZone::prepare(): mmap failed");
+	}
+	m_Header = static_cast<CacheZoneHeader*>(region);
+	m_Locks = reinterpret_cast<CacheLockSlot*>(static_cast<char*>(region) + E_CACHE::CACHE_LINE);
+	m_Nodes = reinterpret_cast<CacheNode*>(m_Locks + E_CACHE::LOCK_SLOTS);
+	m_Buckets = reinterpret_cast<unsigned int*>(m_Nodes + m_Capacity);
+
+	m_Header->m_Lock = 0;
+	m_Header->m_Free = 0;
+	m_Header->m_LruHead = E_CACHE::NIL;
+	m_Header->m_LruTail = E_CACHE::NIL;
+	m_Header->m_Count = 0;
+	m_Header->m_Version = 0;
+	m_Header->m_TotalSize = 0;
+	for (unsigned int i = 0; i < m_Capacity; i++) {
+		m_Nodes[i].m_HashNext = (i + 1 < m_Capacity) ? i + 1 : E_CACHE::NIL;
+		m_Nodes[i].m_LruPrev = E_CACHE::NIL;
+		m_Nodes[i].m_LruNext = E_CACHE::NIL;
+		m_Buckets[i] = E_CACHE::NIL;
+	}
+}
+
+/**
+ * @brief	지난번에 저장된 파일로 index 를 다시 만든다. 모르는 파일 (저장하다 만 임시 파일 등) 은 지운다.
+ * @details	같은 key 의 파일이 여럿 남았으면 (옛 파일을 지우기 전에 멈춤) version 이 큰 것만 남긴다.
+ */
+void	CacheZone::load(const std::string& directory, const std::size_t& depth) {
+	DIR*	dir = opendir(directory.c_str());
+
+	if (dir == NULL) {
+		return ;
+	}
+	for (struct dirent* entry = readdir(dir); entry != NULL; entry = readdir(dir)) {
+		const std::string	name(entry->d_name);
+		const std::string	path = directory + "/" + name;
+
+		if (name == "." || name == "..") {
+			continue;
+		}
+		if (depth < m_Config.m_Levels.size()) {
+			if (name.size() == m_Config.m_Levels[depth]) {
+				load(path, depth + 1);
+			}
+			continue;
+		}
+		loadFile(path, name);
+	}
+	closedir(dir);
+}
+
+void	CacheZone::loadFile(const std::string& path, const std::string& name) {
+	CacheFileHeader	header;
+	CacheEntry		entry;
+	struct stat		status;
+	const int		fd = open(path.c_str(), O_RDONLY);
+	bool			valid = false;
+
+	if (fd < 0) {
+		return ;
+	}
+	if (name.size() == E_CACHE::NAME_SIZE && read(fd, &header, sizeof(header)) == static_cast<ssize_t>(sizeof(header))
+			&& fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && header.m_Magic == E_CACHE::FILE_MAGIC
+			&& header.m_KeySize < E_CACHE::LOAD_SIZE && this->path(header.m_Key, header.m_Version) == path
+			&& !(lookup(header.m_Key, entry) && entry.m_Version > header.m_Version)) {
+		entry.m_Expire = header.m_Expire;
+		entry.m_StaleUpdate = header.m_StaleUpdate;
+		entry.m_StaleError = header.m_StaleError;
+		entry.m_DataStart = sizeof(header) + header.m_KeySize;
+		entry.m_HeaderSize = header.m_HeaderSize;
+		entry.m_Version = header.m_Version;
+		entry.m_Chunked = (header.m_Chunked != 0);
+		if (m_Header->m_Version < header.m_Version) {
+			m_Header->m_Version = header.m_Version;
+		}
+		if (static_cast<unsigned long>(status.st_size) >= entry.m_DataStart + entry.m_HeaderSize) {
+			entry.m_Size = status.st_size - entry.m_DataStart;
+			insert(header.m_Key, entry);
+			valid = true;
+		}
+	}
+	close(fd);
+	if (!valid) {
+		unlink(path.c_str());
+	}
+}
+
+void	CacheZone::prepareLocation(const CONF::ServerBlock&, const CONF::LocationBlock& location, const std::string&, void*) {
+	const CONF::proxyCacheData&	cache = location.getProxy_cache();
+
+	if (!cache.m_Zone.empty()) {
+		const zoneMap::iterator	it = m_Zones.find(cache.m_Zone);
+		if (it == m_Zones.end()) {
+			throw std::runtime_error("proxy_cache: unknown cache zone " + cache.m_Zone);
+		}
+		m_Locations[&location] = &it->second;
+	}
+}
+
+/**
+ * @brief	proxy_cache_path 마다 공유 index 를 만들고 디스크에 남은 파일을 읽어 들인다. (fork 전에 한 번)
+ */
+void	CacheZone::prepare(const CONF::MainBlock& mainBlock) {
+	const CONF::HTTPBlock&				http = mainBlock.getHTTPBlock();
+	const CONF::HTTPBlock::cachePathMap&	paths = http.getProxy_cache_path();
+
+	EventLoop::updateTime();
+	for (CONF::HTTPBlock::cachePathMap::const_iterator it = paths.begin(); it != paths.end(); ++it) {
+		if (mkdir(it->second.m_Path.c_str(), 0700) < 0 && errno != EEXIST) {
+			throw std::runtime_error("proxy_cache_path: cannot create " + it->second.m_Path);
+		}
+		CacheZone&	zone = m_Zones[it->first];
+		zone.m_Name = it->first;
+		zone.m_Config = it->second;
+		zone.map();
+		zone.load(zone.m_Config.m_Path, 0);
+	}
+
+	http.visitLocations(NULL, prepareLocation, NULL);
+}
+
+CacheZone*	CacheZone::find(const CONF::LocationBlock* location) {
+	const locationMap::const_iterator	it = m_Locations.find(location);
+	return (it != m_Locations.end() ? it->second : NULL);
+}
+
+bool	CacheZone::empty() {
+	return (m_Zones.empty());
+}
+
+/**
+ *			cache manager (master)
+ */
+
+/**
+ * @brief	LRU 끝에서부터 inactive 가 지났거나 max_size 를 넘는 만큼 index 에서 뺀다.
+ */
+void	CacheZone::evict(std::vector<std::string>& victims, const unsigned long& now) {
+	ft::SpinLock	lock(&m_Header->m_Lock);
+
+	while (m_Header->m_LruTail != E_CACHE::NIL) {
+		const CacheNode&	node = m_Nodes[m_Header->m_LruTail];
+		const bool			inactive = (m_Config.m_Inactive > 0 && node.m_Accessed + m_Config.m_Inactive <= now);
+		const bool			oversize = (m_Config.m_MaxSize > 0 && m_Header->m_TotalSize > m_Config.m_MaxSize);
+
+		if (!inactive && !oversize) {
+			break ;
+		}
+		victims.push_back(path(node.m_Key, node.m_Entry.m_Version));
+		removeNode(m_Header->m_LruTail);
+	}
+}
+
+/**
+ * @brief	master 가 MANAGER_INTERVAL 마다 부른다. 파일은 lock 을 놓은 뒤에 지운다.
+ * @details	이미 파일을 열어 둔 worker 는 unlink 뒤에도 끝까지 보낼 수 있다.
+ */
+void	CacheZone::manage() {
+	EventLoop::updateTime();
+	for (zoneMap::iterator it = m_Zones.begin(); it != m_Zones.end(); ++it) {
+		std::vector<std::string>	victims;
+
+		it->second.evict(victims, EventLoop::now());
+		for (std::vector<std::string>::const_iterator victim = victims.begin(); victim != victims.end(); ++victim) {
+			unlink(victim->c_str());
+		}
+	}
+}
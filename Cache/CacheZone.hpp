@@ -0,0 +1,156 @@
+#pragma once
+
+#include "../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+class Client;
+
+namespace E_CACHE {
+	const std::size_t	CACHE_LINE = 64;
+	const unsigned int	NIL = 0xffffffff;
+	const unsigned int	FILE_MAGIC = 0x77636834;
+	const unsigned int	MANAGER_INTERVAL = 1000;
+	const std::size_t	LOAD_SIZE = 4096;
+	const std::size_t	NAME_SIZE = 16 + 1 + 8;
+	const unsigned int	LOCK_SLOTS = 1024;
+	const unsigned int	LOCK_PROBE = 8;
+	const unsigned int	LOCK_POLL = 50;
+}
+
+/**
+ * @brief	cache 파일 맨 앞의 고정 크기 header
+ * @details	파일은 [CacheFileHeader][key][응답 header][응답 body] 순서이다.
+ *			worker 는 index 를 보고 header 와 key 가 맞는지만 확인한 뒤 응답 부분 ([m_DataStart, 끝)) 을 그대로 sendfile 한다.
+ *			시작할 때 디스크에 남은 파일로 index 를 다시 만들 때도 읽는다.
+ */
+struct CacheFileHeader {
+	unsigned int	m_Magic;
+	unsigned int	m_KeySize;
+	unsigned int	m_HeaderSize;
+	unsigned int	m_Version;
+	unsigned int	m_Chunked;
+	unsigned long	m_Key;
+	unsigned long	m_Expire;
+	unsigned long	m_StaleUpdate;
+	unsigned long	m_StaleError;
+};
+
+/**
+ * @brief	cache 된 응답 하나의 정보 (index 에서 복사해 나온다)
+ * @details	m_Size 는 응답 header + body 의 크기. m_HeaderSize 만큼 보내면 HEAD 응답이 된다.
+ *			m_Version 은 파일 이름에 들어가므로 같은 key 의 새 응답은 다른 파일이 된다.
+ *			m_Chunked 면 body 가 chunked 로 저장되어 있으므로 HTTP/1.0 client 에게는 보내지 않는다.
+ *			만료 시각 뒤에도 m_StaleUpdate 전까지는 새로 가져오는 동안, m_StaleError 전까지는 upstream 이 실패하면 보낸다.
+ */
+struct CacheEntry {
+	unsigned long	m_Expire;
+	unsigned long	m_StaleUpdate;
+	unsigned long	m_StaleError;
+	unsigned long	m_Size;
+	unsigned int	m_DataStart;
+	unsigned int	m_HeaderSize;
+	unsigned int	m_Version;
+	bool			m_Chunked;
+};
+
+/**
+ * @brief	공유 메모리 안의 index node
+ * @details	node 끼리는 포인터 대신 배열 index 로 잇는다. (hash chain, LRU 목록, free 목록)
+ */
+struct CacheNode {
+	unsigned long	m_Key;
+	unsigned long	m_Accessed;
+	CacheEntry		m_Entry;
+	unsigned int	m_HashNext;
+	unsigned int	m_LruPrev;
+	unsigned int	m_LruNext;
+};
+
+/**
+ * @brief	upstream 에서 가져오는 중인 key (cache lock)
+ * @details	m_Deadline 이 지나면 가져오던 쪽이 죽은 것으로 보고 다른 request 가 가져갈 수 있다.
+ */
+struct CacheLockSlot {
+	unsigned long	m_Key;
+	unsigned long	m_Deadline;
+};
+
+struct CacheZoneHeader {
+	volatile int	m_Lock;
+	unsigned int	m_Free;
+	unsigned int	m_LruHead;
+	unsigned int	m_LruTail;
+	unsigned int	m_Count;
+	unsigned int	m_Version;
+	unsigned long	m_TotalSize;
+};
+
+/**
+ * @brief	proxy_cache_path 하나 (keys_zone)
+ * @details	응답은 path 아래에 key hash 이름의 파일로 저장하고,
+ *			key hash -> (만료 시각, 크기, 응답 시작 위치) 는 fork 전에 만든 공유 메모리의 hash table 에 둔다.
+ *			hit 이면 worker 는 index 를 한 번 보고 open + sendfile 만 한다. (디스크에서 metadata 를 읽지 않는다)
+ *			- 모든 worker 가 같은 index 를 보므로 한 worker 가 저장한 응답을 다른 worker 가 바로 쓴다.
+ *			- index 가 가득 차면 저장하는 worker 가 LRU 끝의 항목을 지운다.
+ *			- inactive 동안 안 쓰인 항목과 max_size 를 넘는 만큼은 master 의 cache manager 가 LRU 순으로 지운다.
+ *			- 파일 이름은 key 의 64bit hash 와 version 이다. 새 응답은 새 파일에 쓰고 index 를 바꾼 뒤에 옛 파일을 지운다.
+ *			  그래서 index 에서 옛 entry 를 본 worker 가 새 파일을 옛 크기로 보내는 일이 없다. (옛 파일이 지워졌으면 miss)
+ *			- hit 이면 파일에 저장된 key 를 request 의 key 와 비교한다. (hash 가 같은 다른 key 는 보내지 않는다)
+ *			- cache lock: 같은 key 의 miss 가 동시에 여러 개 오면 lock slot 을 잡은 request 하나만 upstream 으로 간다.
+ *			  slot 은 key 로 hash 한 고정 크기 배열이라 index 에 빈 node 를 만들지 않는다.
+ */
+class CacheZone {
+private:
+	typedef std::map<std::string, CacheZone>					zoneMap;
+	typedef std::map<const CONF::LocationBlock*, CacheZone*>	locationMap;
+
+	std::string				m_Name;
+	CONF::cachePathData		m_Config;
+	CacheZoneHeader*		m_Header;
+	CacheLockSlot*			m_Locks;
+	CacheNode*				m_Nodes;
+	unsigned int*			m_Buckets;
+	unsigned int			m_Capacity;
+
+	static zoneMap			m_Zones;
+	static locationMap		m_Locations;
+
+	unsigned int	lookupNode(const unsigned long& key) const;
+	void			unlinkLru(const unsigned int& index);
+	void			pushLru(const unsigned int& index);
+	void			removeNode(const unsigned int& index);
+	void			map();
+	void			load(const std::string& directory, const std::size_t& depth);
+	void			loadFile(const std::string& path, const std::string& name);
+	void			evict(std::vector<std::string>& victims, const unsigned long& now);
+
+	static void		prepareLocation(const CONF::ServerBlock& server, const CONF::LocationBlock& location, const std::string& name, void* context);
+
+public:
+	CacheZone();
+	CacheZone(const CacheZone& other);
+	CacheZone& operator=(const CacheZone& other);
+	~CacheZone();
+
+	bool			lookup(const unsigned long& key, CacheEntry& entry);
+	void			insert(const unsigned long& key, const CacheEntry& entry);
+	void			remove(const unsigned long& key, const unsigned int& version);
+	std::string		path(const unsigned long& key, const unsigned int& version) const;
+	unsigned int	nextVersion();
+	bool			makeDirectory(const unsigned long& key) const;
+	bool			lock(const unsigned long& key, const unsigned int& timeout);
+	void			unlock(const unsigned long& key);
+
+	static std::string		key(const Client& client);
+	static unsigned long	hash64(const std::string& key);
+	static bool				verify(const int& fd, const std::string& key, const CacheEntry& entry);
+	static unsigned int		maxAge(const std::string& cacheControl, const unsigned int& valid);
+	static unsigned int		seconds(const std::string& cacheControl, const std::string& name, const unsigned int& fallback);
+
+	static void			prepare(const CONF::MainBlock& mainBlock);
+	static CacheZone*	find(const CONF::LocationBlock* location);
+	static bool			empty();
+	static void			manage();
+};
@@ -0,0 +1,340 @@
+#include "FileCache.hpp"
+#include "CacheZone.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+#include "../utils/SeqLock.hpp"
+#include "../utils/SpinLock.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <unistd.h>
+
+CONF::fileCacheData		FileCache::m_Config;
+FileCache::extensionMap	FileCache::m_Extensions;
+std::string				FileCache::m_DefaultType;
+FileCacheHeader*		FileCache::m_Header = NULL;
+unsigned char*			FileCache::m_Sketch = NULL;
+FileSlot*				FileCache::m_Slots = NULL;
+ShmZone*				FileCache::m_Zone = NULL;
+
+/**
+ *			TinyLFU
+ */
+
+/**
+ * @brief	64bit hash 를 16bit 씩 잘라 줄마다 다른 칸을 센다.
+ * @details	lock 없이 센다. 다른 worker 와 겹치면 하나 덜 셀 뿐이다.
+ */
+void	FileCache::increment(const unsigned long& hash) {
+	for (unsigned int row = 0; row < E_FILE_CACHE::SKETCH_DEPTH; row++) {
+		unsigned char&	counter = m_Sketch[row * E_FILE_CACHE::SKETCH_WIDTH + ((hash >> (row * 16)) & (E_FILE_CACHE::SKETCH_WIDTH - 1))];
+		if (counter < E_FILE_CACHE::SKETCH_MAX) {
+			counter++;
+		}
+	}
+	if (__sync_add_and_fetch(&m_Header->m_Additions, 1) == E_FILE_CACHE::SKETCH_SAMPLE) {
+		for (std::size_t i = 0; i < E_FILE_CACHE::SKETCH_DEPTH * E_FILE_CACHE::SKETCH_WIDTH; i++) {
+			m_Sketch[i] >>= 1;
+		}
+		__sync_sub_and_fetch(&m_Header->m_Additions, E_FILE_CACHE::SKETCH_SAMPLE / 2);
+	}
+}
+
+unsigned char	FileCache::frequency(const unsigned long& hash) {
+	unsigned char	result = E_FILE_CACHE::SKETCH_MAX;
+
+	for (unsigned int row = 0; row < E_FILE_CACHE::SKETCH_DEPTH; row++) {
+		result = std::min(result, m_Sketch[row * E_FILE_CACHE::SKETCH_WIDTH + ((hash >> (row * 16)) & (E_FILE_CACHE::SKETCH_WIDTH - 1))]);
+	}
+	return (result);
+}
+
+/**
+ *			slot (쓰기는 zone lock 을 잡고)
+ */
+
+/**
+ * @brief	set 에서 key 를 넣을 자리. 같은 key, 빈 자리, 가장 오래 안 쓰인 자리 순.
+ */
+unsigned int	FileCache::victim(const unsigned long& key) {
+	const unsigned int	first = (key % m_Header->m_Sets) * E_FILE_CACHE::WAYS;
+	unsigned int		result = first;
+
+	for (unsigned int index = first; index < first + E_FILE_CACHE::WAYS; index++) {
+		const FileSlot&	slot = m_Slots[index];
+		if (slot.m_Data != E_SHM_SLAB::NIL && slot.m_Key == key) {
+			return (index);
+		}
+		if (slot.m_Data == E_SHM_SLAB::NIL) {
+			result = index;
+		} else if (m_Slots[result].m_Data != E_SHM_SLAB::NIL && slot.m_Accessed < m_Slots[result].m_Accessed) {
+			result = index;
+		}
+	}
+	return (result);
+}
+
+/**
+ * @brief	slab 에 자리를 만든다. clock hand 부터 EVICT_SAMPLE 개를 보고 가장 덜 쓰인 항목이 candidate 보다 덜 쓰였으면 내보낸다.
+ */
+bool	FileCache::evict(const unsigned char& candidate) {
+	const unsigned int	slots = m_Header->m_Sets * E_FILE_CACHE::WAYS;
+	unsigned int		found = E_SHM_SLAB::NIL;
+	unsigned char		lowest = candidate;
+
+	for (unsigned int i = 0; i < E_FILE_CACHE::EVICT_SAMPLE; i++) {
+		const unsigned int	index = m_Header->m_Hand;
+		m_Header->m_Hand = (index + 1) % slots;
+		if (m_Slots[index].m_Data == E_SHM_SLAB::NIL) {
+			continue ;
+		}
+		const unsigned char	freq = frequency(m_Slots[index].m_Key);
+		if (freq < lowest) {
+			lowest = freq;
+			found = index;
+		}
+	}
+	if (found == E_SHM_SLAB::NIL) {
+		return false;
+	}
+	release(found);
+	return true;
+}
+
+/**
+ * @brief	자리를 비우고 chunk 를 돌려준다. seq 를 먼저 올리므로 이 chunk 를 읽던 worker 는 다시 읽는다.
+ */
+void	FileCache::release(const unsigned int& index) {
+	FileSlot&			slot = m_Slots[index];
+	const unsigned int	data = slot.m_Data;
+
+	if (data == E_SHM_SLAB::NIL) {
+		return ;
+	}
+	{
+		ft::SeqLock::WriteGuard	guard(&slot.m_Seq);
+		slot.m_Data = E_SHM_SLAB::NIL;
+	}
+	m_Zone->free(data);
+}
+
+void	FileCache::remove(const unsigned int& index, const unsigned long& key) {
+	ft::SpinLock	lock(m_Zone->lock());
+
+	if (m_Slots[index].m_Key == key) {
+		release(index);
+	}
+}
+
+/**
+ *			worker
+ */
+
+/**
+ * @brief	seqlock 으로 자리 하나를 읽는다.
+ * @details	복사하는 동안 다른 worker 가 자리를 바꿨을 수 있으므로 길이는 slab 범위 안인지 먼저 보고,
+ *			다 복사한 뒤 seq 가 그대로일 때만 믿는다.
+ * @return	path 의 항목이고 head (body 가 NULL 이 아니면 body 까지) 를 다 복사했으면 true
+ */
+bool	FileCache::readSlot(const unsigned int& index, const std::string& path, const unsigned long& key,
+							FileSlot& meta, std::string& head, std::string* body) {
+	const FileSlot&	slot = m_Slots[index];
+
+	for (unsigned int attempt = 0; attempt < E_FILE_CACHE::READ_RETRY; attempt++) {
+		const unsigned int	begin = ft::SeqLock::readBegin(&slot.m_Seq);
+		bool				match;
+
+		meta.m_Data = slot.m_Data;
+		meta.m_Key = slot.m_Key;
+		meta.m_Checked = slot.m_Checked;
+		meta.m_Mtime = slot.m_Mtime;
+		meta.m_Size = slot.m_Size;
+		meta.m_Inode = slot.m_Inode;
+		meta.m_PathSize = slot.m_PathSize;
+		meta.m_HeadSize = slot.m_HeadSize;
+		meta.m_BodySize = slot.m_BodySize;
+		match = (meta.m_Data != E_SHM_SLAB::NIL && meta.m_Key == key && meta.m_PathSize == path.size()
+				 && m_Zone->contains(meta.m_Data, static_cast<std::size_t>(meta.m_PathSize) + meta.m_HeadSize + meta.m_BodySize));
+		if (match) {
+			const char*	data = static_cast<const char*>(m_Zone->address(meta.m_Data));
+			match = (path.compare(0, path.size(), data, meta.m_PathSize) == 0);
+			if (match) {
+				head.assign(data + meta.m_PathSize, meta.m_HeadSize);
+				if (body != NULL) {
+					body->assign(data + meta.m_PathSize + meta.m_HeadSize, meta.m_BodySize);
+				}
+			}
+		}
+		if (!ft::SeqLock::readRetry(&slot.m_Seq, begin)) {
+			return (match);
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief	요청을 sketch 에 세고, 공유 메모리에 있으면 head / body 로 복사한다. (headOnly 면 body 는 두지 않는다)
+ * @details	valid 가 지났으면 stat 으로 파일이 바뀌었는지 보고, 바뀌었으면 버린다. (호출한 쪽이 다시 읽는다)
+ */
+bool	FileCache::find(const std::string& path, std::string& head, std::string& body, const bool& headOnly) {
+	if (m_Header == NULL) {
+		return false;
+	}
+	const unsigned long	key = CacheZone::hash64(path);
+	const unsigned int	first = (key % m_Header->m_Sets) * E_FILE_CACHE::WAYS;
+	FileSlot			meta;
+
+	increment(key);
+	for (unsigned int index = first; index < first + E_FILE_CACHE::WAYS; index++) {
+		if (!readSlot(index, path, key, meta, head, headOnly ? NULL : &body)) {
+			continue ;
+		}
+		const unsigned long	now = EventLoop::now();
+		if (now >= meta.m_Checked + m_Config.m_Valid) {
+			struct stat	status;
+			if (stat(path.c_str(), &status) < 0 || status.st_mtime != meta.m_Mtime
+					|| status.st_size != meta.m_Size || status.st_ino != meta.m_Inode) {
+				remove(index, key);
+				return false;
+			}
+			ft::SpinLock	lock(m_Zone->lock());
+			if (m_Slots[index].m_Data == meta.m_Data && m_Slots[index].m_Key == key) {
+				ft::SeqLock::WriteGuard	guard(&m_Slots[index].m_Seq);
+				m_Slots[index].m_Checked = now;
+			}
+		}
+		m_Slots[index].m_Accessed = now;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief	방금 연 파일을 읽어서 head / body 로 돌려주고, TinyLFU 가 받으면 공유 메모리에도 올린다.
+ * @return	max_file 보다 크거나 다 읽지 못했으면 false (호출한 쪽이 sendfile 로 보낸다)
+ */
+bool	FileCache::insert(const std::string& path, const int& fd, const struct stat& status, std::string& head, std::string& body) {
+	const std::size_t	size = static_cast<std::size_t>(status.st_size);
+
+	if (m_Header == NULL || size > m_Config.m_MaxFile) {
+		return false;
+	}
+	head = header(path, status);
+	body.assign(size, '\0');
+	std::size_t	total = 0;
+	while (total < size) {
+		const ssize_t	readSize = pread(fd, &body[total], size - total, total);
+		if (readSize <= 0) {
+			return false;
+		}
+		total += readSize;
+	}
+
+	const std::size_t	chunkSize = path.size() + head.size() + body.size();
+	const unsigned long	key = CacheZone::hash64(path);
+	const unsigned char	candidate = frequency(key);
+	if (chunkSize > ShmZone::maxSize()) {
+		return true;
+	}
+
+	ft::SpinLock		lock(m_Zone->lock());
+	const unsigned int	index = victim(key);
+	FileSlot&			slot = m_Slots[index];
+
+	if (slot.m_Data != E_SHM_SLAB::NIL && slot.m_Key != key && frequency(slot.m_Key) >= candidate) {
+		return true;
+	}
+	release(index);
+	unsigned int	data = m_Zone->allocate(chunkSize);
+	while (data == E_SHM_SLAB::NIL && evict(candidate)) {
+		data = m_Zone->allocate(chunkSize);
+	}
+	if (data == E_SHM_SLAB::NIL) {
+		return true;
+	}
+	char*	chunk = static_cast<char*>(m_Zone->address(data));
+	std::memcpy(chunk, path.data(), path.size());
+	std::memcpy(chunk + path.size(), head.data(), head.size());
+	std::memcpy(chunk + path.size() + head.size(), body.data(), body.size());
+
+	ft::SeqLock::WriteGuard	guard(&slot.m_Seq);
+	slot.m_Data = data;
+	slot.m_Key = key;
+	slot.m_Checked = EventLoop::now();
+	slot.m_Accessed = slot.m_Checked;
+	slot.m_Mtime = status.st_mtime;
+	slot.m_Size = status.st_size;
+	slot.m_Inode = status.st_ino;
+	slot.m_PathSize = path.size();
+	slot.m_HeadSize = head.size();
+	slot.m_BodySize = body.size();
+	return true;
+}
+
+/**
+ * @brief	200 응답 header (Content-Type 은 http 블록의 mime types, 없으면 default_type)
+ */
+std::string	FileCache::header(const std::string& path, const struct stat& status) {
+	const std::size_t	dotPos = path.rfind('.');
+	std::string			type = m_DefaultType;
+	std::stringstream	head;
+
+	if (dotPos != std::string::npos && path.find('/', dotPos) == std::string::npos) {
+		const extensionMap::const_iterator	it = m_Extensions.find(path.substr(dotPos + 1));
+		type = (it != m_Extensions.end()) ? it->second : m_DefaultType;
+	}
+	head << "HTTP/1.1 200 OK\r\nServer: webserv\r\nContent-Type: " << type
+		 << "\r\nContent-Length: " << status.st_size
+		 << "\r\nLast-Modified: " << httpDate(status.st_mtime) << "\r\n\r\n";
+	return (head.str());
+}
+
+/**
+ * @brief	IMF-fixdate (RFC 9110 5.6.7.)
+ */
+std::string	FileCache::httpDate(const time_t& time) {
+	char	buf[32];
+
+	std::strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", std::gmtime(&time));
+	return (buf);
+}
+
+/**
+ *			setup (master, fork 전)
+ */
+
+/**
+ * @brief	ShmZone "file_cache" 를 만들고 reserve 영역에 [header][sketch][slot 배열] 을 둔다. file_cache 가 없으면 (size 0) 아무것도 만들지 않는다.
+ */
+void	FileCache::prepare(const CONF::MainBlock& mainBlock) {
+	const CONF::HTTPBlock&									http = mainBlock.getHTTPBlock();
+	const std::map<std::string, std::vector<std::string> >&	types = http.getMime_types();
+
+	m_Config = http.getFile_cache();
+	m_DefaultType = http.getDefault_type();
+	for (std::map<std::string, std::vector<std::string> >::const_iterator it = types.begin(); it != types.end(); ++it) {
+		for (std::vector<std::string>::const_iterator ext = it->second.begin(); ext != it->second.end(); ++ext) {
+			m_Extensions[*ext] = it->first;
+		}
+	}
+	if (m_Config.m_Size == 0) {
+		return ;
+	}
+
+	const std::size_t	sets = std::max<std::size_t>(1, m_Config.m_Size / E_FILE_CACHE::BYTES_PER_SLOT / E_FILE_CACHE::WAYS);
+	const std::size_t	headerSize = (sizeof(FileCacheHeader) + sizeof(unsigned long) - 1) / sizeof(unsigned long) * sizeof(unsigned long);
+	const std::size_t	sketchSize = E_FILE_CACHE::SKETCH_DEPTH * E_FILE_CACHE::SKETCH_WIDTH;
+
+	m_Zone = &ShmZone::create("file_cache", m_Config.m_Size, headerSize + sketchSize + sets * E_FILE_CACHE::WAYS * sizeof(FileSlot));
+	m_Header = static_cast<FileCacheHeader*>(m_Zone->data());
+	m_Sketch = static_cast<unsigned char*>(m_Zone->data()) + headerSize;
+	m_Slots = reinterpret_cast<FileSlot*>(m_Sketch + sketchSize);
+
+	m_Header->m_Sets = sets;
+	m_Header->m_Hand = 0;
+	m_Header->m_Additions = 0;
+	for (std::size_t i = 0; i < sets * E_FILE_CACHE::WAYS; i++) {
+		m_Slots[i].m_Seq = 0;
+		m_Slots[i].m_Data = E_SHM_SLAB::NIL;
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include "../Shm/ShmZone.hpp"
+#include <ctime>
+#include <map>
+#include <string>
+#include <sys/stat.h>
+
+namespace E_FILE_CACHE {
+	const unsigned int	SKETCH_DEPTH = 4;
+	const std::size_t	SKETCH_WIDTH = 16384;
+	const unsigned char	SKETCH_MAX = 15;
+	const unsigned long	SKETCH_SAMPLE = SKETCH_WIDTH * 8;
+	const unsigned int	WAYS = 4;
+	const std::size_t	BYTES_PER_SLOT = 2048;
+	const unsigned int	READ_RETRY = 4;
+	const unsigned int	EVICT_SAMPLE = 8;
+}
+
+/**
+ * @brief	공유 메모리에 올린 정적 파일 하나의 자리
+ * @details	m_Data 는 slab chunk 이고, 안에 [path][200 응답 header][body] 가 붙어 있다. (NIL 이면 빈 자리)
+ *			m_Seq 는 이 자리의 seqlock 이다. m_Accessed 만 lock 없이 고친다. (LRU 근사)
+ */
+struct FileSlot {
+	volatile unsigned int	m_Seq;
+	unsigned int			m_Data;
+	unsigned long			m_Key;
+	unsigned long			m_Checked;
+	unsigned long			m_Accessed;
+	time_t					m_Mtime;
+	off_t					m_Size;
+	ino_t					m_Inode;
+	unsigned int			m_PathSize;
+	unsigned int			m_HeadSize;
+	unsigned int			m_BodySize;
+};
+
+struct FileCacheHeader {
+	unsigned int			m_Sets;
+	unsigned int			m_Hand;
+	volatile unsigned long	m_Additions;
+};
+
+/**
+ * @brief	작은 정적 파일 cache (모든 worker 가 공유)
+ * @details	file_cache max_file 이하의 파일을 200 응답 header 와 함께 fork 전에 만든 공유 메모리에 두고, hit 이면 writev 한 번으로 보낸다.
+ *			worker 가 늘어도 파일은 한 벌만 올라가므로 cache 메모리는 file_cache size 그대로다.
+ *			file_cache valid 안에서는 파일을 전혀 보지 않고, 지나면 stat 한 번으로 mtime / 크기 / inode 가 그대로인지 본다.
+ *			- zone 은 ShmZone "file_cache" 이다. reserve 영역에 [header][sketch][slot 배열] 을 두고, 내용은 slab chunk 에 둔다.
+ *			- 자리 (FileSlot) 는 path hash 로 WAYS 개짜리 set 을 고르는 set-associative 배열이다.
+ *			- 읽기는 잠그지 않는다. 자리마다 seqlock 으로 복사하는 동안 바뀌지 않았는지 보고, 바뀌었으면 다시 읽는다. (READ_RETRY 번 실패하면 miss)
+ *			- 쓰기 (넣기 / 내보내기) 는 zone lock 하나로 한 번에 하나씩.
+ *			- TinyLFU: 모든 요청을 공유 count-min sketch (15 에서 멈추는 counter) 로 센다.
+ *			  set 이 가득 찼거나 slab 에 자리가 없을 때 새 파일이 내보낼 항목보다 자주 요청되지 않았으면 넣지 않는다.
+ *			  sketch 는 lock 없이 세므로 worker 끼리 겹치면 가끔 하나씩 덜 센다. (빈도 비교에는 충분하다)
+ *			- sketch 는 SKETCH_SAMPLE 번 셀 때마다 반으로 줄여서 오래된 빈도를 잊는다.
+ */
+class FileCache {
+private:
+	typedef std::map<std::string, std::string>	extensionMap;
+
+	static CONF::fileCacheData	m_Config;
+	static extensionMap			m_Extensions;
+	static std::string			m_DefaultType;
+	static FileCacheHeader*		m_Header;
+	static unsigned char*		m_Sketch;
+	static FileSlot*			m_Slots;
+	static ShmZone*				m_Zone;
+
+	FileCache();
+	FileCache(const FileCache& other);
+	FileCache& operator=(const FileCache& other);
+	~FileCache();
+
+	static void				increment(const unsigned long& hash);
+	static unsigned char	frequency(const unsigned long& hash);
+	static bool				readSlot(const unsigned int& index, const std::string& path, const unsigned long& key,
+								FileSlot& meta, std::string& head, std::string* body);
+	static unsigned int		victim(const unsigned long& key);
+	static bool				evict(const unsigned char& candidate);
+	static void				release(const unsigned int& index);
+	static void				remove(const unsigned int& index, const unsigned long& key);
+	static std::string		httpDate(const time_t& time);
+
+public:
+	static void			prepare(const CONF::MainBlock& mainBlock);
+
+	static bool			find(const std::string& path, std::string& head, std::string& body, const bool& headOnly);
+	static bool			insert(const std::string& path, const int& fd, const struct stat& status, std::string& head, std::string& body);
+	static std::string	header(const std::string& path, const struct stat& status);
+};
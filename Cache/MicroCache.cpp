@@ -0,0 +1,286 @@
+#include "MicroCache.hpp"
+#include "../Server/Client/Client.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+#include "../utils/SpinLock.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+MicroCache::zoneMap		MicroCache::m_Zones;
+MicroCache::locationMap	MicroCache::m_Locations;
+
+MicroCache::MicroCache()
+  : m_Zone(NULL),
+	m_Header(NULL),
+	m_Buckets(NULL),
+	m_BucketCount(0),
+	m_Locks(NULL)
+{}
+
+MicroCache::MicroCache(const MicroCache& other) {
+	*this = other;
+}
+
+MicroCache&	MicroCache::operator=(const MicroCache& other) {
+	if (this != &other) {
+		m_Name = other.m_Name;
+		m_Zone = other.m_Zone;
+		m_Header = other.m_Header;
+		m_Buckets = other.m_Buckets;
+		m_BucketCount = other.m_BucketCount;
+		m_Locks = other.m_Locks;
+	}
+	return (*this);
+}
+
+MicroCache::~MicroCache() {}
+
+/**
+ *			bucket (zone lock 을 잡고 부를 것)
+ */
+
+MicroChunk*	MicroCache::chunk(const unsigned int& ref) const {
+	return (static_cast<MicroChunk*>(m_Zone->address(ref)));
+}
+
+/**
+ * @return	만료되지 않은 항목. 없으면 NIL
+ */
+unsigned int	MicroCache::lookupChunk(const unsigned long& key, const unsigned long& now) const {
+	unsigned int	ref = m_Buckets[key % m_BucketCount];
+
+	while (ref != E_SHM_SLAB::NIL) {
+		const MicroChunk*	entry = chunk(ref);
+		if (entry->m_Key == key && entry->m_Expire > now) {
+			return (ref);
+		}
+		ref = entry->m_Next;
+	}
+	return (E_SHM_SLAB::NIL);
+}
+
+/**
+ * @brief	hash chain 에서 빼고 slab 에 돌려준다.
+ */
+void	MicroCache::unlinkChunk(const unsigned int& ref) {
+	MicroChunk*		entry = chunk(ref);
+	unsigned int*	link = &m_Buckets[entry->m_Key % m_BucketCount];
+
+	while (*link != E_SHM_SLAB::NIL && *link != ref) {
+		link = &chunk(*link)->m_Next;
+	}
+	if (*link == ref) {
+		*link = entry->m_Next;
+	}
+	m_Zone->free(ref);
+}
+
+/**
+ * @brief	slab 에서 받고, 없으면 만료된 항목을 치운 뒤 한 번 더 받는다.
+ */
+unsigned int	MicroCache::allocate(const std::size_t& size, const unsigned long& now) {
+	const unsigned int	ref = m_Zone->allocate(size);
+
+	if (ref != E_SHM_SLAB::NIL || !sweep(now)) {
+		return (ref);
+	}
+	return (m_Zone->allocate(size));
+}
+
+/**
+ * @brief	모든 bucket 을 돌며 만료된 항목을 지운다. 가득 찬 zone 에 insert 가 몰려도 ms 당 한 번만 돈다.
+ * @return	하나라도 지웠는지
+ */
+bool	MicroCache::sweep(const unsigned long& now) {
+	bool	freed = false;
+
+	if (m_Header->m_Swept == now) {
+		return false;
+	}
+	m_Header->m_Swept = now;
+	for (unsigned int bucket = 0; bucket < m_BucketCount; bucket++) {
+		unsigned int	ref = m_Buckets[bucket];
+		while (ref != E_SHM_SLAB::NIL) {
+			const unsigned int	next = chunk(ref)->m_Next;
+			if (chunk(ref)->m_Expire <= now) {
+				unlinkChunk(ref);
+				freed = true;
+			}
+			ref = next;
+		}
+	}
+	return (freed);
+}
+
+/**
+ *			worker
+ */
+
+/**
+ * @brief	만료되지 않은 응답이 있으면 response 로, 그중 응답 header 의 길이를 headerSize 로 복사한다.
+ * @details	다른 worker 가 같은 chunk 를 덮어쓸 수 있으므로 lock 안에서 복사한다.
+ */
+bool	MicroCache::lookup(const unsigned long& key, std::string& response, std::size_t& headerSize) {
+	ft::SpinLock		lock(m_Zone->lock());
+	const unsigned int	ref = lookupChunk(key, EventLoop::now());
+
+	if (ref == E_SHM_SLAB::NIL) {
+		return false;
+	}
+	const MicroChunk*	entry = chunk(ref);
+	response.assign(reinterpret_cast<const char*>(entry + 1), entry->m_Size);
+	headerSize = entry->m_HeaderSize;
+	return true;
+}
+
+/**
+ * @brief	응답 (header + body) 을 expire 까지 저장한다. 같은 key 의 옛 항목은 지운다.
+ * @param	headerSize	response 앞의 응답 header 길이
+ */
+void	MicroCache::insert(const unsigned long& key, const unsigned long& expire, const std::string& response, const std::size_t& headerSize) {
+	if (response.size() > maxSize() || headerSize > response.size()) {
+		return ;
+	}
+	ft::SpinLock		lock(m_Zone->lock());
+	unsigned int		ref = m_Buckets[key % m_BucketCount];
+
+	while (ref != E_SHM_SLAB::NIL) {
+		const unsigned int	next = chunk(ref)->m_Next;
+		if (chunk(ref)->m_Key == key) {
+			unlinkChunk(ref);
+		}
+		ref = next;
+	}
+	ref = allocate(sizeof(MicroChunk) + response.size(), EventLoop::now());
+	if (ref == E_SHM_SLAB::NIL) {
+		return ;
+	}
+	MicroChunk*		entry = chunk(ref);
+	unsigned int&	bucket = m_Buckets[key % m_BucketCount];
+	entry->m_Key = key;
+	entry->m_Expire = expire;
+	entry->m_Size = response.size();
+	entry->m_HeaderSize = headerSize;
+	std::memcpy(entry + 1, response.data(), response.size());
+	entry->m_Next = bucket;
+	bucket = ref;
+}
+
+/**
+ * @brief	backend 에서 가져올 차례를 잡는다. (CacheZone::lock 과 같다)
+ * @param	timeout	이 시간이 지나도 unlock 되지 않으면 가져오던 쪽이 죽은 것으로 본다.
+ * @return	false 면 다른 request 가 가져오는 중이다. slot 이 모자라면 잡지 않고 true 다.
+ */
+bool	MicroCache::lock(const unsigned long& key, const unsigned int& timeout) {
+	ft::SpinLock			guard(m_Zone->lock());
+	const unsigned long&	now = EventLoop::now();
+	CacheLockSlot*			freeSlot = NULL;
+
+	for (unsigned int i = 0; i < E_CACHE::LOCK_PROBE; i++) {
+		CacheLockSlot&	slot = m_Locks[(key + i) % E_CACHE::LOCK_SLOTS];
+
+		if (slot.m_Deadline > now) {
+			if (slot.m_Key == key) {
+				return false;
+			}
+		} else if (freeSlot == NULL) {
+			freeSlot = &slot;
+		}
+	}
+	if (freeSlot != NULL) {
+		freeSlot->m_Key = key;
+		freeSlot->m_Deadline = now + timeout;
+	}
+	return true;
+}
+
+void	MicroCache::unlock(const unsigned long& key) {
+	ft::SpinLock	guard(m_Zone->lock());
+
+	for (unsigned int i = 0; i < E_CACHE::LOCK_PROBE; i++) {
+		CacheLockSlot&	slot = m_Locks[(key + i) % E_CACHE::LOCK_SLOTS];
+
+		if (slot.m_Key == key && slot.m_Deadline != 0) {
+			slot.m_Deadline = 0;
+			return ;
+		}
+	}
+}
+
+/**
+ * @brief	method + host + URI + 설정한 header 값
+ */
+std::string	MicroCache::key(const Client& client) {
+	const HTTP::Request&				request = client.getRequest();
+	const std::vector<std::string>&	headers = client.getLocation()->getMicrocache().m_Headers;
+	std::string						key = request.getMethod() + " " + request.getHeader("host") + request.getTarget();
+
+	for (std::vector<std::string>::const_iterator it = headers.begin(); it != headers.end(); ++it) {
+		key += "\n" + request.getHeader(*it);
+	}
+	return (key);
+}
+
+std::size_t	MicroCache::maxSize() {
+	return (ShmZone::maxSize() - sizeof(MicroChunk));
+}
+
+/**
+ *			setup (master, fork 전)
+ */
+
+/**
+ * @brief	"microcache_zone:" + name 으로 ShmZone 을 만들고 reserve 영역에 [header][lock slot 배열][bucket 배열] 을 둔다.
+ * @details	bucket 은 가장 작은 chunk 4개에 하나 꼴로 둔다.
+ */
+void	MicroCache::map(const std::size_t& size) {
+	const std::size_t	buckets = size / E_SHM_SLAB::MIN_CHUNK / 4;
+
+	m_Zone = &ShmZone::create("microcache_zone:" + m_Name, size,
+		sizeof(MicroZoneHeader) + E_CACHE::LOCK_SLOTS * sizeof(CacheLockSlot) + buckets * sizeof(unsigned int));
+	m_Header = static_cast<MicroZoneHeader*>(m_Zone->data());
+	m_Locks = reinterpret_cast<CacheLockSlot*>(m_Header + 1);
+	m_Buckets = reinterpret_cast<unsigned int*>(m_Locks + E_CACHE::LOCK_SLOTS);
+	m_BucketCount = buckets;
+	m_Header->m_Swept = 0;
+	for (std::size_t i = 0; i < buckets; i++) {
+		m_Buckets[i] = E_SHM_SLAB::NIL;
+	}
+	std::memset(m_Locks, 0, E_CACHE::LOCK_SLOTS * sizeof(CacheLockSlot));
+}
+
+void	MicroCache::prepareLocation(const CONF::ServerBlock&, const CONF::LocationBlock& location, const std::string&, void*) {
+	const CONF::microcacheData&	micro = location.getMicrocache();
+
+	if (!micro.m_Zone.empty()) {
+		const zoneMap::iterator	it = m_Zones.find(micro.m_Zone);
+		if (it == m_Zones.end()) {
+			throw std::runtime_error("microcache: unknown microcache zone " + micro.m_Zone);
+		}
+		if (location.getCgi().empty() && location.getFastcgi_pass().empty()) {
+			throw std::runtime_error("microcache: zone " + micro.m_Zone + " is used outside a cgi / fastcgi_pass location");
+		}
+		m_Locations[&location] = &it->second;
+	}
+}
+
+/**
+ * @brief	microcache_zone 마다 공유 메모리를 만든다. (fork 전에 한 번)
+ */
+void	MicroCache::prepare(const CONF::MainBlock& mainBlock) {
+	const CONF::HTTPBlock&						http = mainBlock.getHTTPBlock();
+	const CONF::HTTPBlock::microcacheZoneMap&	zones = http.getMicrocache_zone();
+
+	for (CONF::HTTPBlock::microcacheZoneMap::const_iterator it = zones.begin(); it != zones.end(); ++it) {
+		MicroCache&	zone = m_Zones[it->first];
+		zone.m_Name = it->first;
+		zone.map(it->second);
+	}
+
+	http.visitLocations(NULL, prepareLocation, NULL);
+}
+
+MicroCache*	MicroCache::find(const CONF::LocationBlock* location) {
+	const locationMap::const_iterator	it = m_Locations.find(location);
+	return (it != m_Locations.end() ? it->second : NULL);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CacheZone.hpp"
+#include "../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include "../Shm/ShmZone.hpp"
+#include <map>
+#include <string>
+
+class Client;
+
+/**
+ * @brief	slab chunk 맨 앞의 header. 뒤에 응답 (header + body) 이 그대로 붙는다.
+ * @details	같은 bucket 의 chunk 끼리는 ShmZone ref 로 잇는다.
+ *			m_HeaderSize 만큼 보내면 HEAD 응답이 된다. (CacheEntry 와 같다)
+ */
+struct MicroChunk {
+	unsigned long	m_Key;
+	unsigned long	m_Expire;
+	unsigned int	m_Size;
+	unsigned int	m_HeaderSize;
+	unsigned int	m_Next;
+};
+
+struct MicroZoneHeader {
+	unsigned long	m_Swept;
+};
+
+/**
+ * @brief	microcache_zone 하나
+ * @details	CGI / FastCGI 응답을 짧은 시간 (기본 1초) 동안 fork 전에 만든 공유 메모리 (ShmZone) 에 통째로 둔다.
+ *			같은 응답이 초당 수천 번 와도 backend 는 valid 마다 한 번만 실행된다. (모든 worker 가 같은 zone 을 본다)
+ *			zone 의 reserve 영역에 hash bucket 을 두고, 응답은 slab chunk 하나에 넣는다.
+ *			- PAGE_SIZE 를 넘는 응답은 저장하지 않는다.
+ *			- slab 에 자리가 없으면 만료된 항목을 모두 치우고 (ms 당 한 번까지) 다시 받는다.
+ *			  chunk 가 모두 비면 page 는 slab 으로 돌아가서 다른 크기 class 가 쓴다.
+ *			- 그래도 자리가 없으면 저장하지 않는다. (TTL 이 짧으므로 곧 자리가 난다)
+ *			- 같은 key 의 miss 가 동시에 여러 개 오면 lock slot 을 잡은 request 하나만 backend 로 간다. (CacheZone 의 cache lock)
+ *			  나머지는 valid 동안 응답이 들어오기를 기다렸다가, 그래도 없으면 각자 backend 로 간다.
+ */
+class MicroCache {
+private:
+	typedef std::map<std::string, MicroCache>					zoneMap;
+	typedef std::map<const CONF::LocationBlock*, MicroCache*>	locationMap;
+
+	std::string			m_Name;
+	ShmZone*			m_Zone;
+	MicroZoneHeader*	m_Header;
+	unsigned int*		m_Buckets;
+	unsigned int		m_BucketCount;
+	CacheLockSlot*		m_Locks;
+
+	static zoneMap		m_Zones;
+	static locationMap	m_Locations;
+
+	MicroChunk*		chunk(const unsigned int& ref) const;
+	unsigned int	lookupChunk(const unsigned long& key, const unsigned long& now) const;
+	void			unlinkChunk(const unsigned int& ref);
+	unsigned int	allocate(const std::size_t& size, const unsigned long& now);
+	bool			sweep(const unsigned long& now);
+	void			map(const std::size_t& size);
+
+	static void			prepareLocation(const CONF::ServerBlock& server, const CONF::LocationBlock& location, const std::string& name, void* context);
+
+public:
+	MicroCache();
+	MicroCache(const MicroCache& other);
+	MicroCache& operator=(const MicroCache& other);
+	~MicroCache();
+
+	bool		lookup(const unsigned long& key, std::string& response, std::size_t& headerSize);
+	void		insert(const unsigned long& key, const unsigned long& expire, const std::string& response, const std::size_t& headerSize);
+	bool		lock(const unsigned long& key, const unsigned int& timeout);
+	void		unlock(const unsigned long& key);
+
+	static std::string	key(const Client& client);
+	static std::size_t	maxSize();
+
+	static void			prepare(const CONF::MainBlock& mainBlock);
+	static MicroCache*	find(const CONF::LocationBlock* location);
+};
@@ -0,0 +1,344 @@
+#include "FastCGIConnection.hpp"
+#include "FastCGIRecord.hpp"
+#include "FastCGIUpstream.hpp"
+#include "../Log/LogFile.hpp"
+#include "../Server/Client/Client.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+FastCGIConnection::FastCGIConnection(EventLoop& loop, FastCGIUpstream& upstream)
+  : ACGI(),
+	m_Loop(loop),
+	m_Upstream(upstream),
+	m_Socket(-1),
+	m_Connecting(false),
+	m_SendOffset(0),
+	m_WriteEnabled(false),
+	m_OutputPaused(false),
+	m_Busy(false),
+	m_Requests(0),
+	m_Received(false),
+	m_ReadTimeout(0),
+	m_TimerArmed(false)
+{}
+
+FastCGIConnection::~FastCGIConnection() {
+	if (m_Socket >= 0) {
+		m_Loop.forget(m_Socket);
+		::close(m_Socket);
+	}
+}
+
+bool	FastCGIConnection::open() {
+	m_Socket = m_Upstream.connect(m_Connecting);
+	if (m_Socket < 0) {
+		return false;
+	}
+	m_Loop.addRead(m_Socket, this);
+	m_Loop.addWrite(m_Socket, this);
+	if (m_Connecting) {
+		m_Loop.enableWrite(m_Socket, this);
+		m_WriteEnabled = true;
+	}
+	return true;
+}
+
+/**
+ * @brief	BEGIN_REQUEST + PARAMS (location template + request 변수) 를 한 번에 보낸다.
+ */
+void	FastCGIConnection::begin(Client& client, const std::string& script) {
+	const CGIEnv*	templateEnv;
+	CGIEnv			requestEnv;
+	std::string		params;
+	std::string		records;
+
+	reset(&client);
+	m_Busy = true;
+	m_Requests++;
+	m_Received = false;
+	m_ReadTimeout = client.getLocation()->getFastcgi_read_timeout();
+	templateEnv = CGIEnv::find(client.getLocation());
+	requestEnv.reserve(E_CGI::ENV_RESERVE);
+	environment(script, requestEnv);
+	if (templateEnv != NULL) {
+		FastCGI::appendParams(params, templateEnv->getBlock());
+	}
+	FastCGI::appendParams(params, requestEnv.getBlock());
+
+	records.reserve(E_FASTCGI::HEADER_SIZE * 4 + params.size() + 8);
+	FastCGI::appendBeginRequest(records, E_FASTCGI::KEEP_CONN);
+	FastCGI::appendStream(records, E_FASTCGI::PARAMS, params.data(), params.size());
+	FastCGI::appendRecord(records, E_FASTCGI::PARAMS, NULL, 0);
+	send(records);
+	armTimer();
+}
+
+/**
+ * @brief	버퍼가 비어 있으면 바로 보내 보고, 남은 것만 쌓는다.
+ */
+void	FastCGIConnection::send(const std::string& records) {
+	std::size_t	sent = 0;
+
+	if (m_Socket < 0) {
+		return ;
+	}
+	if (!m_Connecting && m_SendOffset == m_SendBuffer.size()) {
+		m_SendBuffer.clear();
+		m_SendOffset = 0;
+
+		const ssize_t	writeSize = ::send(m_Socket, records.data(), records.size(), 0);
+		sent = (writeSize > 0) ? static_cast<std::size_t>(writeSize) : 0;
+	}
+	if (sent < records.size()) {
+		m_SendBuffer.append(records, sent, std::string::npos);
+		if (!m_WriteEnabled) {
+			m_Loop.enableWrite(m_Socket, this);
+			m_WriteEnabled = true;
+		}
+	}
+}
+
+void	FastCGIConnection::writeBody(const char* data, const std::size_t& size) {
+	std::string	records;
+
+	if (size == 0) {
+		return ;
+	}
+	records.reserve(size + (size / E_FASTCGI::MAX_CONTENT + 1) * E_FASTCGI::HEADER_SIZE);
+	FastCGI::appendStream(records, E_FASTCGI::STDIN, data, size);
+	send(records);
+}
+
+void	FastCGIConnection::endBody() {
+	std::string	records;
+
+	FastCGI::appendRecord(records, E_FASTCGI::STDIN, NULL, 0);
+	send(records);
+}
+
+/**
+ * @brief	read timeout. 다시 걸면 처음부터 센다. (EV_ONESHOT)
+ */
+void	FastCGIConnection::armTimer() {
+	m_Loop.addTimeout(reinterpret_cast<uintptr_t>(this), m_ReadTimeout, this);
+	m_TimerArmed = true;
+}
+
+void	FastCGIConnection::disarmTimer() {
+	if (m_TimerArmed) {
+		m_Loop.removeTimer(reinterpret_cast<uintptr_t>(this));
+		m_TimerArmed = false;
+	}
+}
+
+void	FastCGIConnection::handleEvent(const struct kevent& event) {
+	if (event.filter == EVFILT_TIMER) {
+		m_TimerArmed = false;
+		onTimeout();
+		return ;
+	}
+	if (m_Socket < 0) {
+		return ;
+	}
+	if (event.filter == EVFILT_WRITE) {
+		m_Connecting ? onConnect() : onWrite();
+	} else if (event.filter == EVFILT_READ) {
+		onRead();
+	}
+}
+
+void	FastCGIConnection::onConnect() {
+	int			error = 0;
+	socklen_t	length = sizeof(error);
+
+	if (getsockopt(m_Socket, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0) {
+		finish(false, false);
+		return ;
+	}
+	m_Connecting = false;
+	onWrite();
+}
+
+void	FastCGIConnection::onWrite() {
+	if (m_SendOffset < m_SendBuffer.size()) {
+		const ssize_t	writeSize = ::send(m_Socket, m_SendBuffer.data() + m_SendOffset, m_SendBuffer.size() - m_SendOffset, 0);
+		if (writeSize < 0) {
+			return ;
+		}
+		m_SendOffset += writeSize;
+	}
+	if (m_SendOffset == m_SendBuffer.size()) {
+		m_SendBuffer.clear();
+		m_SendOffset = 0;
+		m_Loop.disableWrite(m_Socket, this);
+		m_WriteEnabled = false;
+	}
+	if (m_Client != NULL && getPendingInput() < E_CLIENT::LOW_WATERMARK) {
+		m_Client->resumeRead();
+	}
+}
+
+void	FastCGIConnection::onRead() {
+	char			buf[E_CGI::READ_SIZE];
+	const ssize_t	readSize = recv(m_Socket, buf, sizeof(buf), 0);
+
+	if (readSize < 0) {
+		return ;
+	}
+	if (!m_Busy) {
+		// idle 연결을 upstream 이 닫았다.
+		close();
+		return ;
+	}
+	if (readSize == 0) {
+		onEof();
+		return ;
+	}
+	m_Received = true;
+	armTimer();
+	m_RecvBuffer.append(buf, readSize);
+
+	std::size_t	pos = 0;
+	while (m_Busy && m_RecvBuffer.size() - pos >= E_FASTCGI::HEADER_SIZE) {
+		const FastCGI::Header	header = FastCGI::parseHeader(m_RecvBuffer.data() + pos);
+		const std::size_t		recordSize = E_FASTCGI::HEADER_SIZE + header.m_ContentLength + header.m_PaddingLength;
+
+		if (m_RecvBuffer.size() - pos < recordSize) {
+			break;
+		}
+		const char*	content = m_RecvBuffer.data() + pos + E_FASTCGI::HEADER_SIZE;
+		pos += recordSize;
+		if (header.m_RequestId != E_FASTCGI::REQUEST_ID) {
+			continue;
+		}
+		if (!onRecord(header.m_Type, content, header.m_ContentLength)) {
+			finish(false, false);
+			return ;
+		}
+	}
+	if (m_Socket < 0) {
+		return ;
+	}
+	m_RecvBuffer.erase(0, pos);
+
+	if (m_Client != NULL && m_Client->getPendingOutput() > E_CLIENT::HIGH_WATERMARK && !m_OutputPaused) {
+		m_Loop.disableRead(m_Socket, this);
+		m_OutputPaused = true;
+	}
+}
+
+/**
+ * @return	false 면 잘못된 응답 (502)
+ */
+bool	FastCGIConnection::onRecord(const unsigned char& type, const char* data, const std::size_t& size) {
+	switch (type) {
+		case E_FASTCGI::STDOUT:
+			return (output(data, size));
+		case E_FASTCGI::STDERR:
+			LogFile::error("fastcgi " + m_Upstream.getAddress() + ": " + std::string(data, size));
+			return true;
+		case E_FASTCGI::END_REQUEST:
+			if (size < 8 || static_cast<unsigned char>(data[4]) != E_FASTCGI::REQUEST_COMPLETE) {
+				return false;
+			}
+			finish(true, true);
+			return true;
+	}
+	return true;
+}
+
+/**
+ * @brief	응답이 끝나기 전에 upstream 이 끊겼다.
+ * @details	idle 로 있던 연결이 한 byte 도 받기 전에 끊겼으면 upstream 이 keepalive 를 먼저 닫은 것이다.
+ *			다시 보내도 되는 request (body 없음, POST / PATCH 아님) 면 새 연결로 한 번 다시 보낸다. (ProxyConnection 과 같다)
+ */
+void	FastCGIConnection::onEof() {
+	Client*	client = m_Client;
+
+	if (client == NULL || m_Requests < 2 || m_Received) {
+		finish(false, false);
+		return ;
+	}
+	const HTTP::Request&	request = client->getRequest();
+	if (request.getContentLength() != 0 || request.isChunked() || request.getMethod() == "POST" || request.getMethod() == "PATCH") {
+		finish(false, false);
+		return ;
+	}
+	reset(NULL);
+	m_Busy = false;
+	close();
+	client->retryFastcgi();
+}
+
+/**
+ * @brief	read timeout 동안 upstream 에서 아무것도 오지 않았다. 진행 중인 request 는 되돌릴 수 없으므로 연결을 닫는다.
+ */
+void	FastCGIConnection::onTimeout() {
+	Client*		client = m_Client;
+	const bool	headerSent = m_HeaderDone;
+
+	if (!m_Busy) {
+		return ;
+	}
+	reset(NULL);
+	m_Busy = false;
+	close();
+	if (client != NULL) {
+		headerSent ? client->abort() : client->sendError(504);
+	}
+}
+
+/**
+ * @brief	응답이 끝났을 때. keep 이면 client 에게 알리기 전에 idle 로 돌려서
+ *			같은 client 의 다음 request 가 바로 이 연결을 쓸 수 있게 한다.
+ */
+void	FastCGIConnection::finish(const bool& success, const bool& keep) {
+	const bool	done = success && outputEnd();
+	Client*		client = m_Client;
+
+	disarmTimer();
+	reset(NULL);
+	m_Busy = false;
+	resumeOutput();
+	if (!(keep && m_SendOffset == m_SendBuffer.size() && m_Upstream.keep(this))) {
+		close();
+	}
+	if (client != NULL) {
+		done ? client->responseDone() : client->sendError(502);
+	}
+}
+
+void	FastCGIConnection::resumeOutput() {
+	if (m_OutputPaused && m_Socket >= 0) {
+		m_Loop.enableRead(m_Socket, this);
+		m_OutputPaused = false;
+	}
+}
+
+/**
+ * @brief	client 가 먼저 끊겼을 때 Client 에서 호출한다.
+ */
+void	FastCGIConnection::detach() {
+	reset(NULL);
+	m_Busy = false;
+	close();
+}
+
+void	FastCGIConnection::close() {
+	disarmTimer();
+	if (m_Socket >= 0) {
+		m_Loop.forget(m_Socket);
+		::close(m_Socket);
+		m_Socket = -1;
+	}
+	m_SendBuffer.clear();
+	m_SendOffset = 0;
+	m_RecvBuffer.clear();
+	m_Upstream.forget(this);
+	m_Loop.release(this);
+}
+
+std::size_t	FastCGIConnection::getPendingInput() const {
+	return (m_SendBuffer.size() - m_SendOffset);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../CGI/ACGI.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+#include <string>
+
+class FastCGIUpstream;
+
+/**
+ * @brief	FastCGI upstream 연결 하나 (fastcgi_pass)
+ * @details	한 번에 request 하나를 FCGI_KEEP_CONN 으로 보내고, END_REQUEST 를 받으면
+ *			FastCGIUpstream 의 idle 목록으로 돌아가 다음 request 에 다시 쓰인다.
+ *			- request body 는 받는 대로 STDIN record 로 감싸서 socket 으로 바로 보낸다.
+ *			- STDOUT record 는 recv 버퍼에서 복사 없이 ACGI::output 으로 넘긴다.
+ *			- client 가 먼저 끊기면 진행 중인 request 를 되돌릴 수 없으므로 연결을 닫는다.
+ *			- fastcgi_read_timeout 동안 아무것도 오지 않으면 504 다.
+ *			- idle 로 있던 연결이 응답 전에 끊기면 (upstream 이 먼저 닫았다) 새 연결로 한 번 다시 보낸다.
+ */
+class FastCGIConnection : public AEventHandler, public ACGI {
+private:
+	EventLoop&			m_Loop;
+	FastCGIUpstream&	m_Upstream;
+	int					m_Socket;
+	bool				m_Connecting;
+
+	std::string			m_SendBuffer;
+	std::size_t			m_SendOffset;
+	bool				m_WriteEnabled;
+	std::string			m_RecvBuffer;
+	bool				m_OutputPaused;
+	bool				m_Busy;
+	unsigned int		m_Requests;
+	bool				m_Received;
+	unsigned int		m_ReadTimeout;
+	bool				m_TimerArmed;
+
+	FastCGIConnection(const FastCGIConnection& other);
+	FastCGIConnection& operator=(const FastCGIConnection& other);
+
+	void	send(const std::string& records);
+	void	armTimer();
+	void	disarmTimer();
+	void	onConnect();
+	void	onWrite();
+	void	onRead();
+	bool	onRecord(const unsigned char& type, const char* data, const std::size_t& size);
+	void	onEof();
+	void	onTimeout();
+	void	finish(const bool& success, const bool& keep);
+	void	close();
+
+public:
+	FastCGIConnection(EventLoop& loop, FastCGIUpstream& upstream);
+	virtual ~FastCGIConnection();
+
+	bool		open();
+	void		begin(Client& client, const std::string& script);
+
+	void		writeBody(const char* data, const std::size_t& size);
+	void		endBody();
+	void		resumeOutput();
+	void		detach();
+
+	std::size_t	getPendingInput() const;
+
+	void		handleEvent(const struct kevent& event);
+};
@@ -0,0 +1,91 @@
+#include "FastCGIRecord.hpp"
+#include <algorithm>
+
+/**
+ * @brief	content 하나를 record 하나로 붙인다. (size <= MAX_CONTENT)
+ * @details	padding 은 선택 사항이라 쓰지 않는다.
+ */
+void	FastCGI::appendRecord(std::string& out, const unsigned char& type, const char* data, const std::size_t& size) {
+	const char	header[E_FASTCGI::HEADER_SIZE] = {
+		static_cast<char>(E_FASTCGI::VERSION),
+		static_cast<char>(type),
+		static_cast<char>((E_FASTCGI::REQUEST_ID >> 8) & 0xff),
+		static_cast<char>(E_FASTCGI::REQUEST_ID & 0xff),
+		static_cast<char>((size >> 8) & 0xff),
+		static_cast<char>(size & 0xff),
+		0,
+		0
+	};
+
+	out.append(header, sizeof(header));
+	out.append(data, size);
+}
+
+/**
+ * @brief	stream (PARAMS, STDIN) 을 MAX_CONTENT 단위 record 로 나눠 붙인다.
+ * @details	size 가 0 이면 stream 끝을 알리는 빈 record 하나를 붙인다.
+ */
+void	FastCGI::appendStream(std::string& out, const unsigned char& type, const char* data, const std::size_t& size) {
+	if (size == 0) {
+		appendRecord(out, type, NULL, 0);
+		return ;
+	}
+	for (std::size_t pos = 0; pos < size; pos += E_FASTCGI::MAX_CONTENT) {
+		appendRecord(out, type, data + pos, std::min(size - pos, E_FASTCGI::MAX_CONTENT));
+	}
+}
+
+void	FastCGI::appendBeginRequest(std::string& out, const unsigned char& flags) {
+	const char	body[8] = {
+		static_cast<char>((E_FASTCGI::RESPONDER >> 8) & 0xff),
+		static_cast<char>(E_FASTCGI::RESPONDER & 0xff),
+		static_cast<char>(flags),
+		0, 0, 0, 0, 0
+	};
+
+	appendRecord(out, E_FASTCGI::BEGIN_REQUEST, body, sizeof(body));
+}
+
+void	FastCGI::appendLength(std::string& out, const std::size_t& length) {
+	if (length < 128) {
+		out += static_cast<char>(length);
+		return ;
+	}
+	out += static_cast<char>(((length >> 24) & 0x7f) | 0x80);
+	out += static_cast<char>((length >> 16) & 0xff);
+	out += static_cast<char>((length >> 8) & 0xff);
+	out += static_cast<char>(length & 0xff);
+}
+
+/**
+ * @brief	CGIEnv block ("KEY=VALUE\0...") 을 name-value pair 로 바꿔 붙인다. (record 로 나누기 전)
+ */
+void	FastCGI::appendParams(std::string& out, const std::string& envBlock) {
+	std::size_t	pos = 0;
+
+	while (pos < envBlock.size()) {
+		std::size_t			end = envBlock.find('\0', pos);
+		if (end == std::string::npos) {
+			end = envBlock.size();
+		}
+		const std::size_t	equalPos = envBlock.find('=', pos);
+		if (equalPos != std::string::npos && equalPos < end) {
+			appendLength(out, equalPos - pos);
+			appendLength(out, end - equalPos - 1);
+			out.append(envBlock, pos, equalPos - pos);
+			out.append(envBlock, equalPos + 1, end - equalPos - 1);
+		}
+		pos = end + 1;
+	}
+}
+
+FastCGI::Header	FastCGI::parseHeader(const char* data) {
+	const unsigned char*	p = reinterpret_cast<const unsigned char*>(data);
+	Header					header;
+
+	header.m_Type = p[1];
+	header.m_RequestId = static_cast<unsigned short>((p[2] << 8) | p[3]);
+	header.m_ContentLength = static_cast<std::size_t>((p[4] << 8) | p[5]);
+	header.m_PaddingLength = p[6];
+	return (header);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+
+/**
+ * @brief	FastCGI Specification 1.0
+ * @details	record = header (8 byte) + content (최대 65535 byte) + padding
+ *			header = version, type, requestId (2), contentLength (2), paddingLength, reserved
+ */
+namespace E_FASTCGI {
+	const unsigned char		VERSION = 1;
+	enum E_TYPE {
+		BEGIN_REQUEST = 1,
+		ABORT_REQUEST = 2,
+		END_REQUEST = 3,
+		PARAMS = 4,
+		STDIN = 5,
+		STDOUT = 6,
+		STDERR = 7
+	};
+	const unsigned short	RESPONDER = 1;
+	const unsigned char		KEEP_CONN = 1;
+	const unsigned char		REQUEST_COMPLETE = 0;
+
+	const std::size_t		HEADER_SIZE = 8;
+	const std::size_t		MAX_CONTENT = 65535;
+	const unsigned short	REQUEST_ID = 1;
+}
+
+namespace FastCGI {
+	struct Header {
+		unsigned char	m_Type;
+		unsigned short	m_RequestId;
+		std::size_t		m_ContentLength;
+		std::size_t		m_PaddingLength;
+	};
+
+	void	appendRecord(std::string& out, const unsigned char& type, const char* data, const std::size_t& size);
+	void	appendStream(std::string& out, const unsigned char& type, const char* data, const std::size_t& size);
+	void	appendBeginRequest(std::string& out, const unsigned char& flags);
+	void	appendLength(std::string& out, const std::size_t& length);
+	void	appendParams(std::string& out, const std::string& envBlock);
+	Header	parseHeader(const char* data);
+}
@@ -0,0 +1,89 @@
+#include "FastCGIUpstream.hpp"
+#include "FastCGIConnection.hpp"
+
+#include <algorithm>
+
+FastCGIUpstream::upstreamMap	FastCGIUpstream::m_Upstreams;
+
+FastCGIUpstream::FastCGIUpstream() {}
+
+FastCGIUpstream::FastCGIUpstream(const std::string& address) : m_Address(address) {}
+
+FastCGIUpstream::FastCGIUpstream(const FastCGIUpstream& other) {
+	*this = other;
+}
+
+FastCGIUpstream&	FastCGIUpstream::operator=(const FastCGIUpstream& other) {
+	if (this != &other) {
+		m_Address = other.m_Address;
+		m_Idle = other.m_Idle;
+	}
+	return (*this);
+}
+
+FastCGIUpstream::~FastCGIUpstream() {}
+
+void	FastCGIUpstream::prepareLocation(const CONF::ServerBlock&, const CONF::LocationBlock& location, const std::string&, void*) {
+	const std::string&	address = location.getFastcgi_pass();
+
+	if (!address.empty() && m_Upstreams.find(address) == m_Upstreams.end()) {
+		m_Upstreams.insert(std::make_pair(address, FastCGIUpstream(address)));
+	}
+}
+
+/**
+ * @brief	fastcgi_pass 가 설정된 모든 주소를 해석한다. (fork 전에 한 번)
+ */
+void	FastCGIUpstream::prepare(const CONF::MainBlock& mainBlock) {
+	mainBlock.getHTTPBlock().visitLocations(NULL, prepareLocation, NULL);
+}
+
+FastCGIUpstream*	FastCGIUpstream::find(const std::string& address) {
+	const upstreamMap::iterator	it = m_Upstreams.find(address);
+	return (it != m_Upstreams.end() ? &it->second : NULL);
+}
+
+int	FastCGIUpstream::connect(bool& inProgress) const {
+	return (m_Address.connect(inProgress));
+}
+
+/**
+ * @brief	가장 최근에 돌려받은 idle 연결부터 쓴다. 없거나 fresh 면 새로 연결한다.
+ * @details	fresh 는 idle 연결이 끊겨서 다시 보낼 때 쓴다. (남은 idle 연결도 이미 닫혔을 수 있다)
+ */
+FastCGIConnection*	FastCGIUpstream::acquire(EventLoop& loop, const bool& fresh) {
+	if (!fresh && !m_Idle.empty()) {
+		FastCGIConnection*	connection = m_Idle.back();
+		m_Idle.pop_back();
+		return (connection);
+	}
+
+	FastCGIConnection*	connection = new FastCGIConnection(loop, *this);
+	if (!connection->open()) {
+		delete connection;
+		return (NULL);
+	}
+	return (connection);
+}
+
+/**
+ * @return	false 면 idle 이 이미 가득 찼다. (연결을 닫는다)
+ */
+bool	FastCGIUpstream::keep(FastCGIConnection* connection) {
+	if (m_Idle.size() >= E_FASTCGI_UPSTREAM::KEEPALIVE) {
+		return false;
+	}
+	m_Idle.push_back(connection);
+	return true;
+}
+
+void	FastCGIUpstream::forget(FastCGIConnection* connection) {
+	const std::vector<FastCGIConnection*>::iterator	it = std::find(m_Idle.begin(), m_Idle.end(), connection);
+	if (it != m_Idle.end()) {
+		m_Idle.erase(it);
+	}
+}
+
+const std::string&	FastCGIUpstream::getAddress() const {
+	return (m_Address.getAddress());
+}
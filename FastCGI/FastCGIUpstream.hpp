@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../FileDescriptor/Socket/SocketAddress.hpp"
+#include "../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+class FastCGIConnection;
+
+namespace E_FASTCGI_UPSTREAM {
+	const std::size_t	KEEPALIVE = 16;
+}
+
+/**
+ * @brief	fastcgi_pass 주소 하나 ("host:port" 또는 "unix:/path")
+ * @details	주소는 MasterProcess 가 fork 전에 한 번 해석해 둔다. (worker 에서 DNS 로 막히지 않도록)
+ *			worker 마다 응답을 끝낸 연결을 KEEPALIVE 개까지 idle 로 들고 있다가 다음 request 에 다시 쓴다.
+ */
+class FastCGIUpstream {
+private:
+	typedef std::map<std::string, FastCGIUpstream>	upstreamMap;
+
+	SocketAddress					m_Address;
+	std::vector<FastCGIConnection*>	m_Idle;
+
+	static upstreamMap				m_Upstreams;
+
+	static void	prepareLocation(const CONF::ServerBlock& server, const CONF::LocationBlock& location, const std::string& name, void* context);
+
+public:
+	FastCGIUpstream();
+	FastCGIUpstream(const std::string& address);
+	FastCGIUpstream(const FastCGIUpstream& other);
+	FastCGIUpstream& operator=(const FastCGIUpstream& other);
+	~FastCGIUpstream();
+
+	FastCGIConnection*	acquire(EventLoop& loop, const bool& fresh);
+	bool				keep(FastCGIConnection* connection);
+	void				forget(FastCGIConnection* connection);
+	int					connect(bool& inProgress) const;
+
+	const std::string&	getAddress() const;
+
+	static void				prepare(const CONF::MainBlock& mainBlock);
+	static FastCGIUpstream*	find(const std::string& address);
+};
@@ -3,6 +3,8 @@
 
 ClientSocket::ClientSocket() : FileDescriptor(0) {}
 
+ClientSocket::ClientSocket(const int& fd) : FileDescriptor(fd) {}
+
 ClientSocket::ClientSocket(const ClientSocket& other) : FileDescriptor(other.getFd()) {}
 
 ClientSocket&	ClientSocket::operator=(const ClientSocket& other) {
@@ -9,6 +9,7 @@ private:
 
 public:
 	ClientSocket();
+	ClientSocket(const int& fd);
 	ClientSocket(const ClientSocket& other);
 	ClientSocket&	operator=(const ClientSocket& other);
 	virtual ~ClientSocket();
@@ -1,8 +1,39 @@
 #include "ServerSocket.hpp"
+#include <arpa/inet.h>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdexcept>
 #include <sys/socket.h>
 
 ServerSocket::ServerSocket() : FileDescriptor(0) {}
 
+/**
+ * @brief	non-blocking listen socket
+ * @param ip:	빈 문자열이면 INADDR_ANY
+ */
+ServerSocket::ServerSocket(const std::string& ip, const unsigned short& port) : FileDescriptor(socket(AF_INET, SOCK_STREAM, 0)) {
+	if (this->m_Fd < 0) {
+		throw std::runtime_error("ServerSocket: socket() failed");
+	}
+
+	const int	reuse = 1;
+	setsockopt(this->m_Fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	struct sockaddr_in	addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = ip.empty() ? htonl(INADDR_ANY) : inet_addr(ip.c_str());
+
+	if (bind(this->m_Fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0
+			|| listen(this->m_Fd, SOMAXCONN) < 0
+			|| fcntl(this->m_Fd, F_SETFL, O_NONBLOCK) < 0
+			|| fcntl(this->m_Fd, F_SETFD, FD_CLOEXEC) < 0) {
+		throw std::runtime_error("ServerSocket: cannot listen on " + ip);
+	}
+}
+
 ServerSocket::ServerSocket(const ServerSocket& other) : FileDescriptor(other.getFd()) {}
 
 ServerSocket&	ServerSocket::operator=(const ServerSocket& other) {
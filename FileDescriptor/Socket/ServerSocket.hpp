@@ -1,6 +1,7 @@
 #pragma once
 
 #include <sys/socket.h>
+#include <string>
 
 #include "../FileDescriptor.hpp"
 
@@ -9,7 +10,8 @@ private:
 
 public:
 	ServerSocket();
+	ServerSocket(const std::string& ip, const unsigned short& port);
 	ServerSocket(const ServerSocket& other);
 	ServerSocket&	operator=(const ServerSocket& other);
 	virtual ~ServerSocket();
-};
\ No newline at end of file
+};
@@ -0,0 +1,93 @@
+#include "SocketAddress.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <stdexcept>
+#include <sys/un.h>
+#include <unistd.h>
+
+SocketAddress::SocketAddress() : m_SockAddrLen(0) {
+	std::memset(&m_SockAddr, 0, sizeof(m_SockAddr));
+}
+
+SocketAddress::SocketAddress(const std::string& address) : m_Address(address), m_SockAddrLen(0) {
+	std::memset(&m_SockAddr, 0, sizeof(m_SockAddr));
+	resolve();
+}
+
+SocketAddress::SocketAddress(const SocketAddress& other) {
+	*this = other;
+}
+
+SocketAddress&	SocketAddress::operator=(const SocketAddress& other) {
+	if (this != &other) {
+		m_Address = other.m_Address;
+		m_SockAddr = other.m_SockAddr;
+		m_SockAddrLen = other.m_SockAddrLen;
+	}
+	return (*this);
+}
+
+SocketAddress::~SocketAddress() {}
+
+void	SocketAddress::resolve() {
+	if (m_Address.compare(0, 5, "unix:") == 0) {
+		struct sockaddr_un*	addr = reinterpret_cast<struct sockaddr_un*>(&m_SockAddr);
+		const std::string	path = m_Address.substr(5);
+
+		if (path.empty() || path.size() >= sizeof(addr->sun_path)) {
+			throw std::runtime_error("SocketAddress: invalid unix socket path \"" + path + "\"");
+		}
+		addr->sun_family = AF_UNIX;
+		std::memcpy(addr->sun_path, path.c_str(), path.size() + 1);
+		m_SockAddrLen = sizeof(struct sockaddr_un);
+		return ;
+	}
+
+	const std::size_t	colonPos = m_Address.rfind(':');
+	if (colonPos == std::string::npos) {
+		throw std::runtime_error("SocketAddress: no port in \"" + m_Address + "\"");
+	}
+	const std::string	host = m_Address.substr(0, colonPos);
+	const std::string	port = m_Address.substr(colonPos + 1);
+	struct addrinfo		hints;
+	struct addrinfo*	result = NULL;
+
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || result == NULL) {
+		throw std::runtime_error("SocketAddress: cannot resolve \"" + m_Address + "\"");
+	}
+	std::memcpy(&m_SockAddr, result->ai_addr, result->ai_addrlen);
+	m_SockAddrLen = result->ai_addrlen;
+	freeaddrinfo(result);
+}
+
+/**
+ * @return	non-blocking socket (연결 중일 수 있다), 실패하면 -1
+ */
+int	SocketAddress::connect(bool& inProgress) const {
+	const int	fd = socket(m_SockAddr.ss_family, SOCK_STREAM, 0);
+
+	inProgress = false;
+	if (fd < 0) {
+		return (-1);
+	}
+	fcntl(fd, F_SETFL, O_NONBLOCK);
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	if (::connect(fd, reinterpret_cast<const struct sockaddr*>(&m_SockAddr), m_SockAddrLen) < 0) {
+		if (errno != EINPROGRESS) {
+			close(fd);
+			return (-1);
+		}
+		inProgress = true;
+	}
+	return (fd);
+}
+
+const std::string&	SocketAddress::getAddress() const {
+	return (m_Address);
+}
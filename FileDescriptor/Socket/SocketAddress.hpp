@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <sys/socket.h>
+
+/**
+ * @brief	upstream 주소 ("host:port" 또는 "unix:/path")
+ * @details	host 는 생성할 때 getaddrinfo 로 한 번만 해석한다. (fork 전에 만들 것)
+ */
+class SocketAddress {
+private:
+	std::string					m_Address;
+	struct sockaddr_storage		m_SockAddr;
+	socklen_t					m_SockAddrLen;
+
+	void	resolve();
+
+public:
+	SocketAddress();
+	SocketAddress(const std::string& address);
+	SocketAddress(const SocketAddress& other);
+	SocketAddress&	operator=(const SocketAddress& other);
+	~SocketAddress();
+
+	int					connect(bool& inProgress) const;
+	const std::string&	getAddress() const;
+};
@@ -0,0 +1,134 @@
+#include "Chunked.hpp"
+#include <algorithm>
+
+/**
+ * @brief	data 를 chunk 하나로 감싸서 붙인다. (size 가 0 이면 아무것도 하지 않는다)
+ */
+void	HTTP::appendChunk(std::string& out, const char* data, const std::size_t& size) {
+	if (size == 0) {
+		return ;
+	}
+
+	static const char	hex[] = "0123456789abcdef";
+	char				sizeLine[20];
+	std::size_t			len = sizeof(sizeLine);
+
+	sizeLine[--len] = '\n';
+	sizeLine[--len] = '\r';
+	for (std::size_t n = size; n > 0; n >>= 4) {
+		sizeLine[--len] = hex[n & 0xf];
+	}
+	out.reserve(out.size() + sizeof(sizeLine) - len + size + 2);
+	out.append(sizeLine + len, sizeof(sizeLine) - len);
+	out.append(data, size);
+	out.append("\r\n", 2);
+}
+
+HTTP::ChunkedScanner::ChunkedScanner() : m_State(E_CHUNKED::SIZE), m_Left(0) {}
+
+HTTP::ChunkedScanner::~ChunkedScanner() {}
+
+void	HTTP::ChunkedScanner::clear() {
+	m_State = E_CHUNKED::SIZE;
+	m_Left = 0;
+	m_Line.clear();
+}
+
+std::size_t	HTTP::ChunkedScanner::scan(const char* data, const std::size_t& size) {
+	return (run(data, size, NULL));
+}
+
+std::size_t	HTTP::ChunkedScanner::decode(const char* data, const std::size_t& size, std::string& out) {
+	return (run(data, size, &out));
+}
+
+/**
+ * @brief	chunk-size [ chunk-ext ] (CRLF 는 뗀 줄)
+ * @details	chunk-size = 1*HEXDIG, chunk-ext = *( BWS ";" BWS ext-name [ BWS "=" BWS ext-val ) ] (RFC 9112 7.1.1.)
+ *			ext 는 보지 않지만, size 뒤에는 BWS 다음 ';' 만 올 수 있다.
+ */
+bool	HTTP::ChunkedScanner::parseSize(const std::string& line, std::size_t& size) {
+	std::size_t	pos = 0;
+
+	size = 0;
+	for (; pos < line.size(); pos++) {
+		const char	c = line[pos];
+		int			digit;
+
+		if (c >= '0' && c <= '9') {
+			digit = c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			digit = c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			digit = c - 'A' + 10;
+		} else {
+			break ;
+		}
+		if (size > (E_CHUNKED::MAX_SIZE >> 4)) {
+			return false;
+		}
+		size = (size << 4) | digit;
+	}
+	if (pos == 0 || size > E_CHUNKED::MAX_SIZE) {
+		return false;
+	}
+	while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t')) {
+		pos++;
+	}
+	return (pos == line.size() || line[pos] == ';');
+}
+
+std::size_t	HTTP::ChunkedScanner::run(const char* data, const std::size_t& size, std::string* out) {
+	std::size_t	pos = 0;
+
+	while (pos < size && m_State != E_CHUNKED::DONE && m_State != E_CHUNKED::ERROR) {
+		if (m_State == E_CHUNKED::DATA) {
+			const std::size_t	length = std::min(m_Left, size - pos);
+			if (out != NULL) {
+				out->append(data + pos, length);
+			}
+			pos += length;
+			m_Left -= length;
+			m_State = (m_Left == 0) ? E_CHUNKED::DATA_CR : E_CHUNKED::DATA;
+			continue;
+		}
+
+		const char	c = data[pos++];
+		if (m_State == E_CHUNKED::DATA_CR) {
+			m_State = (c == '\r') ? E_CHUNKED::DATA_LF : E_CHUNKED::ERROR;
+			continue;
+		}
+		if (m_State == E_CHUNKED::DATA_LF) {
+			m_State = (c == '\n') ? E_CHUNKED::SIZE : E_CHUNKED::ERROR;
+			continue;
+		}
+		if (c != '\n') {
+			m_Line += c;
+			if (m_Line.size() > E_CHUNKED::MAX_LINE) {
+				m_State = E_CHUNKED::ERROR;
+			}
+			continue;
+		}
+		// 줄 끝은 CRLF 만. (LF 만 있거나 CR 이 줄 안에 있으면 다른 parser 와 줄을 다르게 나눌 수 있다)
+		if (m_Line.empty() || m_Line.find('\r') != m_Line.size() - 1) {
+			m_State = E_CHUNKED::ERROR;
+			continue;
+		}
+		m_Line.erase(m_Line.size() - 1);
+		if (m_State == E_CHUNKED::SIZE) {
+			m_State = !parseSize(m_Line, m_Left) ? E_CHUNKED::ERROR : (m_Left == 0) ? E_CHUNKED::TRAILER : E_CHUNKED::DATA;
+		} else if (m_Line.empty()) {
+			m_State = E_CHUNKED::DONE;
+		}
+		m_Line.clear();
+	}
+	return (pos);
+}
+
+bool	HTTP::ChunkedScanner::isDone() const {
+	return (m_State == E_CHUNKED::DONE);
+}
+
+bool	HTTP::ChunkedScanner::isError() const {
+	return (m_State == E_CHUNKED::ERROR);
+}
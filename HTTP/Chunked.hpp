@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+
+namespace E_CHUNKED {
+	enum E_STATE {
+		SIZE = 0,
+		DATA,
+		DATA_CR,
+		DATA_LF,
+		TRAILER,
+		DONE,
+		ERROR
+	};
+	const std::size_t	MAX_LINE = 4096;
+	const std::size_t	MAX_SIZE = 0xffffffffUL;
+}
+
+namespace HTTP {
+	void	appendChunk(std::string& out, const char* data, const std::size_t& size);
+
+	/**
+	 * @brief	chunked body (RFC 9112 7.1.) 를 그대로 흘려보내면서 끝만 찾는다.
+	 * @details	내용은 바꾸지 않는다. scan() 은 이번 data 중 메시지에 속하는 byte 수를 돌려준다.
+	 *			decode() 는 같은 일을 하면서 chunk-data 만 out 에 붙인다. (chunked request body 를 CGI / FastCGI 에 넘길 때)
+	 *			앞뒤의 다른 parser 와 body 끝을 다르게 볼 수 있는 것 (request smuggling) 은 모두 ERROR 다.
+	 *			- chunk-size 는 HEXDIG 만 (부호, 0x, 공백으로 시작하면 안 된다), MAX_SIZE 까지
+	 *			- 줄 끝과 chunk-data 뒤는 CRLF 만
+	 */
+	class ChunkedScanner {
+	private:
+		unsigned char	m_State;
+		std::size_t		m_Left;
+		std::string		m_Line;
+
+		std::size_t		run(const char* data, const std::size_t& size, std::string* out);
+
+		static bool		parseSize(const std::string& line, std::size_t& size);
+
+	public:
+		ChunkedScanner();
+		~ChunkedScanner();
+
+		void			clear();
+		std::size_t		scan(const char* data, const std::size_t& size);
+		std::size_t		decode(const char* data, const std::size_t& size, std::string& out);
+		bool			isDone() const;
+		bool			isError() const;
+	};
+}
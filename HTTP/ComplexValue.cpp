@@ -0,0 +1,129 @@
+#include "ComplexValue.hpp"
+#include <cctype>
+#include <stdexcept>
+
+HTTP::ComplexValue::ComplexValue() {}
+
+HTTP::ComplexValue::ComplexValue(const std::string& pattern) {
+	compile(pattern);
+}
+
+HTTP::ComplexValue::ComplexValue(const ComplexValue& other) : m_Ops(other.m_Ops) {}
+
+HTTP::ComplexValue&	HTTP::ComplexValue::operator=(const ComplexValue& other) {
+	if (this != &other) {
+		m_Ops = other.m_Ops;
+	}
+	return (*this);
+}
+
+HTTP::ComplexValue::~ComplexValue() {}
+
+void	HTTP::ComplexValue::push(const unsigned char& type, const std::string& value) {
+	// 이어지는 literal 은 하나로 합친다.
+	if (type == E_COMPLEX_VALUE::LITERAL && !m_Ops.empty() && m_Ops.back().m_Type == E_COMPLEX_VALUE::LITERAL) {
+		m_Ops.back().m_Value += value;
+		return ;
+	}
+	Op	op;
+	op.m_Type = type;
+	op.m_Value = value;
+	m_Ops.push_back(op);
+}
+
+/**
+ * @throw	std::runtime_error	모르는 변수 이름 / 닫히지 않은 ${
+ */
+void	HTTP::ComplexValue::compile(const std::string& pattern) {
+	std::size_t	pos = 0;
+
+	m_Ops.clear();
+	while (pos < pattern.size()) {
+		const std::size_t	dollarPos = pattern.find('$', pos);
+		if (dollarPos != pos) {
+			push(E_COMPLEX_VALUE::LITERAL, pattern.substr(pos, dollarPos - pos));
+			if (dollarPos == std::string::npos) {
+				break;
+			}
+		}
+
+		std::size_t	nameStart = dollarPos + 1;
+		std::size_t	nameEnd;
+		const bool	braced = (nameStart < pattern.size() && pattern[nameStart] == '{');
+		if (braced) {
+			nameStart++;
+			nameEnd = pattern.find('}', nameStart);
+			if (nameEnd == std::string::npos) {
+				throw std::runtime_error("unterminated variable: " + pattern);
+			}
+		} else {
+			nameEnd = nameStart;
+			while (nameEnd < pattern.size() && (std::isalnum(static_cast<int>(pattern[nameEnd])) || pattern[nameEnd] == '_')) {
+				nameEnd++;
+			}
+		}
+
+		std::string	name = pattern.substr(nameStart, nameEnd - nameStart);
+		for (std::size_t i = 0; i < name.size(); i++) {
+			name[i] = std::tolower(name[i]);
+		}
+		if (name == "remote_addr") {
+			push(E_COMPLEX_VALUE::REMOTE_ADDR, "");
+		} else if (name == "request_method") {
+			push(E_COMPLEX_VALUE::REQUEST_METHOD, "");
+		} else if (name == "request_uri") {
+			push(E_COMPLEX_VALUE::REQUEST_URI, "");
+		} else if (name == "uri") {
+			push(E_COMPLEX_VALUE::URI, "");
+		} else if (name == "args") {
+			push(E_COMPLEX_VALUE::ARGS, "");
+		} else if (name == "host") {
+			push(E_COMPLEX_VALUE::HOST, "");
+		} else if (name.compare(0, 5, "http_") == 0 && name.size() > 5) {
+			// $http_user_agent -> "user-agent" (Request 는 header 이름을 소문자로 저장한다)
+			std::string	header = name.substr(5);
+			for (std::size_t i = 0; i < header.size(); i++) {
+				header[i] = (header[i] == '_') ? '-' : header[i];
+			}
+			push(E_COMPLEX_VALUE::HTTP_HEADER, header);
+		} else {
+			throw std::runtime_error("unknown variable: $" + name);
+		}
+		pos = braced ? nameEnd + 1 : nameEnd;
+	}
+}
+
+void	HTTP::ComplexValue::evaluate(std::string& out, const Request& request, const std::string& remoteAddr) const {
+	for (std::vector<Op>::const_iterator it = m_Ops.begin(); it != m_Ops.end(); ++it) {
+		switch (it->m_Type) {
+			case E_COMPLEX_VALUE::LITERAL:
+				out += it->m_Value;
+				break;
+			case E_COMPLEX_VALUE::REMOTE_ADDR:
+				out += remoteAddr;
+				break;
+			case E_COMPLEX_VALUE::REQUEST_METHOD:
+				out += request.getMethod();
+				break;
+			case E_COMPLEX_VALUE::REQUEST_URI:
+				out += request.getTarget();
+				break;
+			case E_COMPLEX_VALUE::URI:
+				out += request.getPath();
+				break;
+			case E_COMPLEX_VALUE::ARGS:
+				out += request.getQuery();
+				break;
+			case E_COMPLEX_VALUE::HOST:
+				out += request.getHeader("host");
+				break;
+			case E_COMPLEX_VALUE::HTTP_HEADER:
+				out += request.getHeader(it->m_Value);
+				break;
+		}
+	}
+}
+
+bool	HTTP::ComplexValue::empty() const {
+	return (m_Ops.empty());
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Request.hpp"
+#include <string>
+#include <vector>
+
+namespace E_COMPLEX_VALUE {
+	enum E_OP {
+		LITERAL = 0,
+		REMOTE_ADDR,
+		REQUEST_METHOD,
+		REQUEST_URI,
+		URI,
+		ARGS,
+		HOST,
+		HTTP_HEADER
+	};
+}
+
+namespace HTTP {
+	/**
+	 * @brief	"$변수" 가 섞인 설정 값 (e.g. hash $remote_addr; hash $host$request_uri;)
+	 * @details	설정을 읽을 때 literal / 변수 op 목록으로 한 번만 나눠 두고,
+	 *			request 마다는 op 를 순서대로 이어 붙이기만 한다.
+	 *			- $remote_addr $request_method $request_uri $uri $args $host $http_<name>
+	 *			- 변수 이름은 ${name} 로 감쌀 수 있다.
+	 */
+	class ComplexValue {
+	private:
+		struct Op {
+			unsigned char	m_Type;
+			std::string		m_Value;
+		};
+
+		std::vector<Op>		m_Ops;
+
+		void	push(const unsigned char& type, const std::string& value);
+
+	public:
+		ComplexValue();
+		ComplexValue(const std::string& pattern);
+		ComplexValue(const ComplexValue& other);
+		ComplexValue& operator=(const ComplexValue& other);
+		~ComplexValue();
+
+		void	compile(const std::string& pattern);
+		void	evaluate(std::string& out, const Request& request, const std::string& remoteAddr) const;
+		bool	empty() const;
+	};
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace HTTP {
+	/**
+	 * @brief	status code -> reason phrase (RFC 9110 15.)
+	 * @return	NULL if the code is not a registered status code
+	 */
+	const char*	reasonPhrase(const unsigned short& statusCode);
+}
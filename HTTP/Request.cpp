@@ -0,0 +1,263 @@
+#include "Request.hpp"
+#include <cctype>
+
+HTTP::Request::Request() : m_ContentLength(0), m_Chunked(false), m_HeaderSize(0) {}
+
+HTTP::Request::Request(const Request& other) {
+	*this = other;
+}
+
+HTTP::Request&	HTTP::Request::operator=(const Request& other) {
+	if (this != &other) {
+		m_Method = other.m_Method;
+		m_Target = other.m_Target;
+		m_Path = other.m_Path;
+		m_Query = other.m_Query;
+		m_Version = other.m_Version;
+		m_Headers = other.m_Headers;
+		m_ContentLength = other.m_ContentLength;
+		m_Chunked = other.m_Chunked;
+		m_HeaderSize = other.m_HeaderSize;
+	}
+	return (*this);
+}
+
+HTTP::Request::~Request() {}
+
+void	HTTP::Request::clear() {
+	m_Method.clear();
+	m_Target.clear();
+	m_Path.clear();
+	m_Query.clear();
+	m_Version.clear();
+	m_Headers.clear();
+	m_ContentLength = 0;
+	m_Chunked = false;
+	m_HeaderSize = 0;
+}
+
+/**
+ * @brief	".." segment 가 있는지 (root 뒤에 그대로 붙이면 root 밖을 가리킬 수 있다)
+ */
+bool	HTTP::Request::dotSegment(const std::string& path) {
+	std::size_t	start = 0;
+
+	while (start < path.size()) {
+		std::size_t	end = path.find('/', start);
+		if (end == std::string::npos) {
+			end = path.size();
+		}
+		if (end - start == 2 && path.compare(start, 2, "..") == 0) {
+			return true;
+		}
+		start = end + 1;
+	}
+	return false;
+}
+
+/**
+ *	Content-Length = 1*DIGIT
+ *	부호, 공백, 빈 값은 받지 않는다. 같은 header 가 여러 번 오면 ", " 로 이어져 있으므로 ERROR 가 된다.
+ */
+bool	HTTP::Request::parseLength(const std::string& value, std::size_t& length) {
+	std::size_t	result = 0;
+
+	if (value.empty()) {
+		return false;
+	}
+	for (std::size_t i = 0; i < value.size(); i++) {
+		if (value[i] < '0' || value[i] > '9') {
+			return false;
+		}
+		result = result * 10 + (value[i] - '0');
+		if (result > E_REQUEST::MAX_CONTENT_LENGTH) {
+			return false;
+		}
+	}
+	length = result;
+	return true;
+}
+
+/**
+ *	request-line = method SP request-target SP HTTP-version
+ *	path 에 ".." segment 가 있으면 받지 않는다. (정적 파일, CGI script, fastcgi SCRIPT_FILENAME 모두 root + path 이므로)
+ */
+bool	HTTP::Request::requestLine(const std::string& line) {
+	const std::size_t	firstSP = line.find(' ');
+	const std::size_t	secondSP = (firstSP == std::string::npos) ? std::string::npos : line.find(' ', firstSP + 1);
+
+	if (firstSP == 0 || secondSP == std::string::npos) {
+		return false;
+	}
+	m_Method = line.substr(0, firstSP);
+	m_Target = line.substr(firstSP + 1, secondSP - firstSP - 1);
+	m_Version = line.substr(secondSP + 1);
+	if (m_Target.empty() || m_Target[0] != '/' || m_Version.compare(0, 5, "HTTP/") != 0) {
+		return false;
+	}
+
+	const std::size_t	queryPos = m_Target.find('?');
+	m_Path = m_Target.substr(0, queryPos);
+	m_Query = (queryPos == std::string::npos) ? "" : m_Target.substr(queryPos + 1);
+	return (!dotSegment(m_Path));
+}
+
+/**
+ *	field-line = field-name ":" OWS field-value OWS
+ */
+bool	HTTP::Request::headerField(const std::string& line) {
+	const std::size_t	colonPos = line.find(':');
+	if (colonPos == 0 || colonPos == std::string::npos) {
+		return false;
+	}
+
+	std::string	name = line.substr(0, colonPos);
+	for (std::size_t i = 0; i < name.size(); i++) {
+		if (std::isspace(static_cast<int>(name[i]))) {
+			return false;
+		}
+		name[i] = std::tolower(name[i]);
+	}
+
+	std::size_t	start = colonPos + 1;
+	std::size_t	end = line.size();
+	while (start < end && (line[start] == ' ' || line[start] == '\t')) {
+		start++;
+	}
+	while (end > start && (line[end - 1] == ' ' || line[end - 1] == '\t')) {
+		end--;
+	}
+	std::string&	value = m_Headers[name];
+	value += (value.empty() ? "" : ", ") + line.substr(start, end - start);
+	return true;
+}
+
+unsigned char	HTTP::Request::parse(const std::string& buffer) {
+	const std::size_t	headerEnd = buffer.find("\r\n\r\n");
+
+	if (headerEnd == std::string::npos) {
+		return (buffer.size() > E_REQUEST::MAX_HEADER_SIZE ? E_REQUEST::ERROR : E_REQUEST::INCOMPLETE);
+	}
+	clear();
+
+	std::size_t	pos = 0;
+	std::size_t	lineEnd = buffer.find("\r\n");
+	if (!requestLine(buffer.substr(0, lineEnd))) {
+		return (E_REQUEST::ERROR);
+	}
+	while (lineEnd < headerEnd) {
+		pos = lineEnd + 2;
+		lineEnd = buffer.find("\r\n", pos);
+		if (!headerField(buffer.substr(pos, lineEnd - pos))) {
+			return (E_REQUEST::ERROR);
+		}
+	}
+	m_HeaderSize = headerEnd + 4;
+
+	const headerMap::const_iterator	it = m_Headers.find("content-length");
+	const headerMap::const_iterator	coding = m_Headers.find("transfer-encoding");
+	if (coding != m_Headers.end()) {
+		std::string	value = coding->second;
+		for (std::size_t i = 0; i < value.size(); i++) {
+			value[i] = std::tolower(value[i]);
+		}
+		// 다른 coding 은 풀 수 없고, Content-Length 와 같이 오면 어느 쪽이 맞는지 알 수 없다. (request smuggling)
+		if (value != "chunked" || it != m_Headers.end()) {
+			return (E_REQUEST::ERROR);
+		}
+		m_Chunked = true;
+	}
+	if (it != m_Headers.end() && !parseLength(it->second, m_ContentLength)) {
+		return (E_REQUEST::ERROR);
+	}
+	return (E_REQUEST::DONE);
+}
+
+const std::string&	HTTP::Request::getMethod() const {
+	return (this->m_Method);
+}
+
+const std::string&	HTTP::Request::getTarget() const {
+	return (this->m_Target);
+}
+
+const std::string&	HTTP::Request::getPath() const {
+	return (this->m_Path);
+}
+
+const std::string&	HTTP::Request::getQuery() const {
+	return (this->m_Query);
+}
+
+const std::string&	HTTP::Request::getVersion() const {
+	return (this->m_Version);
+}
+
+const std::string	HTTP::Request::getHeader(const std::string& name) const {
+	const headerMap::const_iterator	it = this->m_Headers.find(name);
+	return (it != this->m_Headers.end() ? it->second : "");
+}
+
+const HTTP::Request::headerMap&	HTTP::Request::getHeaders() const {
+	return (this->m_Headers);
+}
+
+const std::size_t&	HTTP::Request::getContentLength() const {
+	return (this->m_ContentLength);
+}
+
+const bool&	HTTP::Request::isChunked() const {
+	return (this->m_Chunked);
+}
+
+const std::size_t&	HTTP::Request::getHeaderSize() const {
+	return (this->m_HeaderSize);
+}
+
+/**
+ *	Connection = #connection-option (RFC 9110 7.6.1.)
+ *	쉼표로 나눈 option 중에 option (소문자) 이 있는지. 대소문자는 가리지 않는다.
+ */
+bool	HTTP::Request::hasConnectionOption(const std::string& option) const {
+	const std::string	connection = getHeader("connection");
+	std::size_t			start = 0;
+
+	while (start <= connection.size()) {
+		std::size_t	end = connection.find(',', start);
+		if (end == std::string::npos) {
+			end = connection.size();
+		}
+		std::size_t	first = start;
+		std::size_t	last = end;
+		while (first < last && (connection[first] == ' ' || connection[first] == '\t')) {
+			first++;
+		}
+		while (last > first && (connection[last - 1] == ' ' || connection[last - 1] == '\t')) {
+			last--;
+		}
+		if (last - first == option.size()) {
+			std::size_t	i = 0;
+			while (i < option.size() && std::tolower(connection[first + i]) == option[i]) {
+				i++;
+			}
+			if (i == option.size()) {
+				return true;
+			}
+		}
+		start = end + 1;
+	}
+	return false;
+}
+
+/**
+ * @brief	HTTP/1.1 은 "close" 가 없으면, HTTP/1.0 은 "keep-alive" 가 있으면 연결을 다시 쓴다.
+ */
+bool	HTTP::Request::isKeepAlive() const {
+	if (hasConnectionOption("close")) {
+		return false;
+	}
+	if (m_Version == "HTTP/1.0") {
+		return (hasConnectionOption("keep-alive"));
+	}
+	return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace E_REQUEST {
+	enum E_REQUEST {
+		INCOMPLETE = 0,
+		DONE,
+		ERROR
+	};
+
+	const std::size_t	MAX_HEADER_SIZE = 8192;
+	const std::size_t	MAX_CONTENT_LENGTH = 0xffffffffffUL;
+}
+
+namespace HTTP {
+	/**
+	 * @brief	request line + header fields
+	 * @details	header name 은 소문자로 저장한다. body 는 Client 가 직접 흘려보낸다.
+	 *			path 에는 ".." segment 가 없다. (있으면 ERROR)
+	 *			Transfer-Encoding 은 "chunked" 하나만 받는다. (Content-Length 와 같이 오면 ERROR)
+	 *			Content-Length 는 숫자만, MAX_CONTENT_LENGTH 까지 받는다. (여러 번 오면 ERROR)
+	 */
+	class Request {
+	public:
+		typedef std::map<std::string, std::string>	headerMap;
+
+	private:
+		std::string		m_Method;
+		std::string		m_Target;
+		std::string		m_Path;
+		std::string		m_Query;
+		std::string		m_Version;
+		headerMap		m_Headers;
+		std::size_t		m_ContentLength;
+		bool			m_Chunked;
+		std::size_t		m_HeaderSize;
+
+		bool			requestLine(const std::string& line);
+		bool			headerField(const std::string& line);
+
+		bool			hasConnectionOption(const std::string& option) const;
+
+		static bool		dotSegment(const std::string& path);
+		static bool		parseLength(const std::string& value, std::size_t& length);
+
+	public:
+		Request();
+		Request(const Request& other);
+		Request& operator=(const Request& other);
+		~Request();
+
+		unsigned char		parse(const std::string& buffer);
+		void				clear();
+
+		const std::string&	getMethod() const;
+		const std::string&	getTarget() const;
+		const std::string&	getPath() const;
+		const std::string&	getQuery() const;
+		const std::string&	getVersion() const;
+		const std::string	getHeader(const std::string& name) const;
+		const headerMap&	getHeaders() const;
+		const std::size_t&	getContentLength() const;
+		const bool&			isChunked() const;
+		const std::size_t&	getHeaderSize() const;
+		bool				isKeepAlive() const;
+	};
+}
@@ -0,0 +1,98 @@
+#include "AccessLog.hpp"
+#include "BinaryLog.hpp"
+
+#include "../Server/Client/Client.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+
+#include <stdexcept>
+#include <unistd.h>
+
+AccessLog::formatVec	AccessLog::m_Formats;
+unsigned long			AccessLog::m_Random = 0;
+
+/**
+ * @brief	error (400 이상) 와 느린 요청은 언제나, 나머지는 sample 에 따라 남긴다.
+ */
+bool	AccessLog::wanted(const CONF::accessLogData& data, const Client& client) {
+	if (data.m_Sample == 1 || client.getStatus() >= 400) {
+		return true;
+	}
+	if (data.m_SlowerThan != 0 && client.getRequestStart() != 0
+			&& EventLoop::now() >= client.getRequestStart() + data.m_SlowerThan) {
+		return true;
+	}
+	if (data.m_Sample == 0) {
+		return false;
+	}
+	if (m_Random == 0) {
+		m_Random = static_cast<unsigned long>(getpid()) * 2654435761UL | 1;
+	}
+	m_Random ^= m_Random << 13;
+	m_Random ^= m_Random >> 7;
+	m_Random ^= m_Random << 17;
+	return (m_Random % data.m_Sample == 0);
+}
+
+/**
+ * @brief	data 의 log 에 data 의 log_format 으로 한 줄을 남긴다. (access_log off 면 아무것도 하지 않는다)
+ * @details	format 이 binary 면 BinaryLog 가 record 를 만든다.
+ */
+void	AccessLog::write(const CONF::accessLogData& data, const Client& client) {
+	LogFile* const	log = LogFile::at(data.m_File);
+
+	if (log == NULL || !wanted(data, client)) {
+		return ;
+	}
+	if (data.m_Binary) {
+		BinaryLog::write(data, client);
+		return ;
+	}
+	std::string&	line = log->begin();
+
+	m_Formats[data.m_FormatIndex]->evaluate(line, client);
+	line += '\n';
+	log->end();
+}
+
+/**
+ *			setup (master, fork 전. LogFile::prepare 뒤에)
+ */
+
+/**
+ * @throw	std::runtime_error	log_format 에 없는 format 이름
+ */
+void	AccessLog::prepareLog(const CONF::accessLogData& data) {
+	LogFile* const	log = LogFile::at(data.m_File);
+
+	if (log == NULL) {
+		return ;
+	}
+	if (!data.m_Binary && m_Formats[data.m_FormatIndex] == NULL) {
+		throw std::runtime_error("access_log: unknown log_format " + data.m_Format);
+	}
+	log->configure(data.m_Buffer, data.m_Flush);
+}
+
+void	AccessLog::prepareServer(const CONF::ServerBlock& server, void*) {
+	prepareLog(server.getAccess_log());
+}
+
+void	AccessLog::prepareLocation(const CONF::ServerBlock&, const CONF::LocationBlock& location, const std::string&, void*) {
+	prepareLog(location.getAccess_log());
+}
+
+/**
+ * @brief	log_format 이름 표를 채우고, 모든 블록의 access_log 로 파일마다 buffer / flush 를 정한다.
+ */
+void	AccessLog::prepare(const CONF::MainBlock& mainBlock) {
+	const CONF::HTTPBlock&					http = mainBlock.getHTTPBlock();
+	const CONF::HTTPBlock::logFormatMap&	formats = http.getLog_format();
+	const std::vector<std::string>&			names = CONF::AConfParser::getLogFormats();
+
+	for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it) {
+		const CONF::HTTPBlock::logFormatMap::const_iterator	format = formats.find(*it);
+		m_Formats.push_back(format != formats.end() ? &format->second : NULL);
+	}
+	prepareLog(http.getAccess_log());
+	http.visitLocations(prepareServer, prepareLocation, NULL);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "LogFile.hpp"
+#include "LogFormat.hpp"
+#include "../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include <vector>
+
+/**
+ * @brief	access_log 한 줄을 log_format 으로 만들어 LogFile 에 넘긴다.
+ * @details	블록의 accessLogData 는 읽을 때 정한 번호 (m_File / m_FormatIndex) 만 가지므로 요청마다 문자열로 찾지 않는다.
+ *			log_format 이름 표는 fork 전에 HTTP 블록의 log_format 으로 채운다.
+ *			sample= / if_slower_than= 으로 거를 요청은 줄을 만들기 전에 버린다. (표본은 worker 마다 xorshift 로 고른다)
+ */
+class AccessLog {
+private:
+	typedef std::vector<const LogFormat*>	formatVec;
+
+	static formatVec		m_Formats;
+	static unsigned long	m_Random;
+
+	AccessLog();
+	AccessLog(const AccessLog& other);
+	AccessLog& operator=(const AccessLog& other);
+	~AccessLog();
+
+	static bool	wanted(const CONF::accessLogData& data, const Client& client);
+	static void	prepareLog(const CONF::accessLogData& data);
+	static void	prepareServer(const CONF::ServerBlock& server, void* context);
+	static void	prepareLocation(const CONF::ServerBlock& server, const CONF::LocationBlock& location, const std::string& name, void* context);
+
+public:
+	static void	write(const CONF::accessLogData& data, const Client& client);
+
+	static void	prepare(const CONF::MainBlock& mainBlock);
+};
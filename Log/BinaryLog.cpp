@@ -0,0 +1,85 @@
+#include "BinaryLog.hpp"
+#include "LogFile.hpp"
+#include "../Server/Client/Client.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <unistd.h>
+
+std::vector<BinaryLog::Table>	BinaryLog::m_Tables;
+unsigned long					BinaryLog::m_Pid = 0;
+
+/**
+ * @brief	처음 보는 value 면 id 를 주고 'S' record 를 out 에 붙인다. (요청 record 보다 앞에 와야 한다)
+ * @return	value 의 id. 표가 가득 찼으면 INLINE
+ */
+unsigned long	BinaryLog::define(std::string& out, Table& table, const std::string& value, std::vector<idMap::iterator>& added) {
+	const idMap::const_iterator	it = table.m_Ids.find(value);
+
+	if (it != table.m_Ids.end()) {
+		return (it->second);
+	}
+	if (table.m_Ids.size() >= E_BINARY_LOG::MAX_STRINGS) {
+		return (E_BINARY_LOG::INLINE);
+	}
+	const unsigned long	id = table.m_Ids.size() + 1;
+
+	added.push_back(table.m_Ids.insert(std::make_pair(value, id)).first);
+	BinaryLogCodec::appendString(out, m_Pid, id, value);
+	return (id);
+}
+
+/**
+ * @brief	data 의 log 에 client 의 요청 하나를 binary record 로 남긴다.
+ */
+void	BinaryLog::write(const CONF::accessLogData& data, const Client& client) {
+	LogFile* const	log = LogFile::at(data.m_File);
+
+	if (log == NULL) {
+		return ;
+	}
+	if (m_Pid == 0) {
+		m_Pid = getpid();
+	}
+	if (m_Tables.size() <= data.m_File) {
+		m_Tables.resize(data.m_File + 1);
+	}
+	Table&	table = m_Tables[data.m_File];
+	if (table.m_Generation != log->getGeneration()) {
+		table.m_Ids.clear();
+		table.m_Generation = log->getGeneration();
+	}
+
+	const HTTP::Request&			request = client.getRequest();
+	const unsigned long&			now = EventLoop::now();
+	std::vector<idMap::iterator>	added;
+	std::string&					out = log->begin();
+	BinaryLogRecord					record;
+	struct in_addr					addr;
+
+	record.m_HostInline = request.getHeader("host");
+	record.m_LocationInline = request.getPath().substr(0, client.getLocationMatch());
+	record.m_Host = define(out, table, record.m_HostInline, added);
+	record.m_Location = define(out, table, record.m_LocationInline, added);
+	if (inet_pton(AF_INET, client.getRemoteAddr().c_str(), &addr) != 1) {
+		addr.s_addr = 0;
+	}
+	std::memcpy(record.m_Addr, &addr.s_addr, 4);
+	record.m_Method = BinaryLogCodec::methodCode(request.getMethod());
+	record.m_Status = client.getStatus();
+	record.m_Time = now / 1000;
+	record.m_Msec = now % 1000;
+	record.m_Pid = m_Pid;
+	record.m_RequestTime = (client.getRequestStart() != 0 && now > client.getRequestStart()) ? now - client.getRequestStart() : 0;
+	record.m_BytesSent = client.getBytesSent();
+	record.m_BodyBytesSent = client.getBodyBytesSent();
+	record.m_Uri = request.getTarget();
+	BinaryLogCodec::appendRequest(out, record);
+	if (!log->end()) {
+		// 정의한 'S' record 도 같이 버려졌다.
+		for (std::vector<idMap::iterator>::iterator it = added.begin(); it != added.end(); ++it) {
+			table.m_Ids.erase(*it);
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "BinaryLogCodec.hpp"
+#include "../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+class Client;
+
+/**
+ * @brief	access_log path binary; 의 record 를 만든다. (BinaryLogCodec 의 형식)
+ * @details	text log_format 대신 고정 폭 head 와 varint 를 그대로 붙이므로 숫자 / 시각을 문자열로 만들지 않는다.
+ *			host 와 location 은 파일마다 처음 나올 때 'S' record 로 한 번만 쓰고 뒤로는 id 만 쓴다.
+ *			- id 표는 worker 마다, 파일마다 따로 둔다. 파일을 다시 열면 (LogFile 의 generation) 표를 비운다.
+ *			- 표가 MAX_STRINGS 만큼 차면 (Host header 가 제각각일 때) 그 뒤의 새 문자열은 record 안에 바로 쓴다.
+ *			- 밀려서 record 를 버리면 그 record 가 정의한 id 도 표에서 뺀다.
+ *			- 읽기는 별도 target (make decoder → logdecode) 이 text / CSV 로 바꾼다.
+ */
+class BinaryLog {
+private:
+	typedef std::map<std::string, unsigned long>	idMap;
+
+	struct Table {
+		unsigned long	m_Generation;
+		idMap			m_Ids;
+
+		Table() : m_Generation(0) {}
+	};
+
+	static std::vector<Table>	m_Tables;
+	static unsigned long		m_Pid;
+
+	BinaryLog();
+	BinaryLog(const BinaryLog& other);
+	BinaryLog& operator=(const BinaryLog& other);
+	~BinaryLog();
+
+	static unsigned long	define(std::string& out, Table& table, const std::string& value, std::vector<idMap::iterator>& added);
+
+public:
+	static void	write(const CONF::accessLogData& data, const Client& client);
+};
@@ -0,0 +1,175 @@
+#include "BinaryLogCodec.hpp"
+
+/**
+ *			encode
+ */
+
+void	BinaryLogCodec::appendVarint(std::string& out, unsigned long value) {
+	while (value >= 0x80) {
+		out += static_cast<char>((value & 0x7f) | 0x80);
+		value >>= 7;
+	}
+	out += static_cast<char>(value);
+}
+
+void	BinaryLogCodec::appendFixed(std::string& out, unsigned long value, const std::size_t& bytes) {
+	for (std::size_t i = 0; i < bytes; i++) {
+		out += static_cast<char>(value & 0xff);
+		value >>= 8;
+	}
+}
+
+void	BinaryLogCodec::appendBytes(std::string& out, const std::string& value) {
+	appendVarint(out, value.size());
+	out += value;
+}
+
+void	BinaryLogCodec::appendString(std::string& out, const unsigned long& pid, const unsigned long& id, const std::string& value) {
+	out += E_BINARY_LOG::TAG_STRING;
+	appendVarint(out, pid);
+	appendVarint(out, id);
+	appendBytes(out, value);
+}
+
+/**
+ * @brief	ref 의 id 가 INLINE 이면 value 를 바로 뒤에 쓴다.
+ */
+void	BinaryLogCodec::appendRef(std::string& out, const unsigned long& id, const std::string& value) {
+	appendVarint(out, id);
+	if (id == E_BINARY_LOG::INLINE) {
+		appendBytes(out, value);
+	}
+}
+
+/**
+ * @brief	'R' record 하나 (tag 포함). readRequest 의 반대
+ */
+void	BinaryLogCodec::appendRequest(std::string& out, const BinaryLogRecord& record) {
+	out += E_BINARY_LOG::TAG_REQUEST;
+	out += static_cast<char>(record.m_Method);
+	appendFixed(out, record.m_Status, 2);
+	appendFixed(out, record.m_Time, 4);
+	appendFixed(out, record.m_Msec, 2);
+	out.append(reinterpret_cast<const char*>(record.m_Addr), 4);
+	appendVarint(out, record.m_Pid);
+	appendVarint(out, record.m_RequestTime);
+	appendVarint(out, record.m_BytesSent);
+	appendVarint(out, record.m_BodyBytesSent);
+	appendRef(out, record.m_Host, record.m_HostInline);
+	appendRef(out, record.m_Location, record.m_LocationInline);
+	appendBytes(out, record.m_Uri);
+}
+
+/**
+ *			decode (false 면 end 까지 record 가 다 오지 않았다. pos 는 그대로 둔다)
+ */
+
+bool	BinaryLogCodec::readVarint(const char*& pos, const char* end, unsigned long& value) {
+	const char*	cursor = pos;
+	unsigned int	shift = 0;
+
+	value = 0;
+	while (cursor < end && shift < E_BINARY_LOG::MAX_VARINT * 7) {
+		const unsigned char	byte = static_cast<unsigned char>(*cursor++);
+		value |= static_cast<unsigned long>(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0) {
+			pos = cursor;
+			return true;
+		}
+		shift += 7;
+	}
+	return false;
+}
+
+bool	BinaryLogCodec::readFixed(const char*& pos, const char* end, const std::size_t& bytes, unsigned long& value) {
+	if (static_cast<std::size_t>(end - pos) < bytes) {
+		return false;
+	}
+	value = 0;
+	for (std::size_t i = 0; i < bytes; i++) {
+		value |= static_cast<unsigned long>(static_cast<unsigned char>(pos[i])) << (i * 8);
+	}
+	pos += bytes;
+	return true;
+}
+
+bool	BinaryLogCodec::readBytes(const char*& pos, const char* end, std::string& value) {
+	const char*		cursor = pos;
+	unsigned long	size;
+
+	if (!readVarint(cursor, end, size) || static_cast<unsigned long>(end - cursor) < size) {
+		return false;
+	}
+	value.assign(cursor, size);
+	pos = cursor + size;
+	return true;
+}
+
+bool	BinaryLogCodec::readRef(const char*& pos, const char* end, unsigned long& id, std::string& value) {
+	const char*	cursor = pos;
+
+	if (!readVarint(cursor, end, id)) {
+		return false;
+	}
+	value.clear();
+	if (id == E_BINARY_LOG::INLINE && !readBytes(cursor, end, value)) {
+		return false;
+	}
+	pos = cursor;
+	return true;
+}
+
+/**
+ * @brief	tag 다음부터 'R' record 하나를 읽는다.
+ */
+bool	BinaryLogCodec::readRequest(const char*& pos, const char* end, BinaryLogRecord& record) {
+	const char*		cursor = pos;
+	unsigned long	value;
+
+	if (!readFixed(cursor, end, 1, value)) {
+		return false;
+	}
+	record.m_Method = value;
+	if (!readFixed(cursor, end, 2, value)) {
+		return false;
+	}
+	record.m_Status = value;
+	if (!readFixed(cursor, end, 4, record.m_Time) || !readFixed(cursor, end, 2, value)) {
+		return false;
+	}
+	record.m_Msec = value;
+	for (std::size_t i = 0; i < 4; i++) {
+		if (!readFixed(cursor, end, 1, value)) {
+			return false;
+		}
+		record.m_Addr[i] = value;
+	}
+	if (!readVarint(cursor, end, record.m_Pid)
+			|| !readVarint(cursor, end, record.m_RequestTime)
+			|| !readVarint(cursor, end, record.m_BytesSent)
+			|| !readVarint(cursor, end, record.m_BodyBytesSent)
+			|| !readRef(cursor, end, record.m_Host, record.m_HostInline)
+			|| !readRef(cursor, end, record.m_Location, record.m_LocationInline)
+			|| !readBytes(cursor, end, record.m_Uri)) {
+		return false;
+	}
+	pos = cursor;
+	return true;
+}
+
+/**
+ *			method
+ */
+
+unsigned char	BinaryLogCodec::methodCode(const std::string& method) {
+	for (std::size_t code = 1; code < E_BINARY_LOG::METHOD_COUNT; code++) {
+		if (method == E_BINARY_LOG::METHOD_NAMES[code]) {
+			return (code);
+		}
+	}
+	return (E_BINARY_LOG::OTHER);
+}
+
+const char*	BinaryLogCodec::methodName(const unsigned char& code) {
+	return (code < E_BINARY_LOG::METHOD_COUNT ? E_BINARY_LOG::METHOD_NAMES[code] : E_BINARY_LOG::METHOD_NAMES[E_BINARY_LOG::OTHER]);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace E_BINARY_LOG {
+	const char			TAG_STRING = 'S';
+	const char			TAG_REQUEST = 'R';
+	const unsigned int	INLINE = 0;
+	const std::size_t	MAX_STRINGS = 4096;
+	const std::size_t	MAX_VARINT = 10;
+
+	enum E_METHOD {
+		OTHER = 0,
+		GET,
+		HEAD,
+		POST,
+		PUT,
+		DELETE,
+		OPTIONS,
+		PATCH,
+		CONNECT,
+		TRACE
+	};
+
+	// E_METHOD 순서 그대로
+	const char* const	METHOD_NAMES[] = { "-", "GET", "HEAD", "POST", "PUT", "DELETE", "OPTIONS", "PATCH", "CONNECT", "TRACE" };
+	const std::size_t	METHOD_COUNT = sizeof(METHOD_NAMES) / sizeof(METHOD_NAMES[0]);
+}
+
+/**
+ * @brief	binary access_log 의 record 하나 (BinaryLogCodec::readRequest 가 채운다)
+ */
+struct BinaryLogRecord {
+	unsigned char	m_Method;
+	unsigned short	m_Status;
+	unsigned long	m_Time;
+	unsigned int	m_Msec;
+	unsigned char	m_Addr[4];
+	unsigned long	m_Pid;
+	unsigned long	m_RequestTime;
+	unsigned long	m_BytesSent;
+	unsigned long	m_BodyBytesSent;
+	unsigned long	m_Host;
+	unsigned long	m_Location;
+	std::string		m_HostInline;
+	std::string		m_LocationInline;
+	std::string		m_Uri;
+};
+
+/**
+ * @brief	binary access_log 의 encode / decode (server 와 logdecode 가 같이 쓴다)
+ * @details	파일은 record 를 이어 붙인 것이다. 정수는 little endian, varint 는 7 bit 씩 (LEB128).
+ *			- 'S' 문자열 정의:	[tag][varint pid][varint id][varint 길이][bytes]
+ *			- 'R' 요청:			[tag][method 1][status 2][time 4][msec 2][IPv4 4]  (고정 14 byte)
+ *								[varint pid][varint request_time ms][varint bytes_sent][varint body_bytes_sent]
+ *								[host ref][location ref][varint 길이][uri]
+ *			- ref 는 같은 pid 가 앞에서 정의한 문자열 id 이고, INLINE (0) 이면 뒤에 [varint 길이][bytes] 가 바로 온다.
+ *			worker 끼리 한 파일에 O_APPEND 로 쓰므로 문자열 id 는 pid 마다 따로 센다.
+ *			같은 pid 가 id 를 다시 정의하면 (다시 열기 / 재시작) 뒤의 정의가 이긴다.
+ */
+class BinaryLogCodec {
+private:
+	BinaryLogCodec();
+	BinaryLogCodec(const BinaryLogCodec& other);
+	BinaryLogCodec& operator=(const BinaryLogCodec& other);
+	~BinaryLogCodec();
+
+public:
+	static void				appendVarint(std::string& out, unsigned long value);
+	static void				appendFixed(std::string& out, unsigned long value, const std::size_t& bytes);
+	static void				appendBytes(std::string& out, const std::string& value);
+	static void				appendString(std::string& out, const unsigned long& pid, const unsigned long& id, const std::string& value);
+	static void				appendRef(std::string& out, const unsigned long& id, const std::string& value);
+	static void				appendRequest(std::string& out, const BinaryLogRecord& record);
+
+	static bool				readVarint(const char*& pos, const char* end, unsigned long& value);
+	static bool				readFixed(const char*& pos, const char* end, const std::size_t& bytes, unsigned long& value);
+	static bool				readBytes(const char*& pos, const char* end, std::string& value);
+	static bool				readRef(const char*& pos, const char* end, unsigned long& id, std::string& value);
+	static bool				readRequest(const char*& pos, const char* end, BinaryLogRecord& record);
+
+	static unsigned char	methodCode(const std::string& method);
+	static const char*		methodName(const unsigned char& code);
+};
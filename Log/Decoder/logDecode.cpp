@@ -0,0 +1,177 @@
+#include "../BinaryLogCodec.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unistd.h>
+
+/**
+ * @brief	binary access_log 을 text (combined 비슷한 한 줄) 나 CSV 로 바꾼다.
+ * @details	usage: logdecode [-csv] [file ...]	(file 이 없으면 stdin)
+ *			파일을 READ_SIZE 씩 읽으며 record 를 푼다. 끝에 잘린 record 가 남으면 stderr 에 알린다.
+ */
+
+namespace E_LOG_DECODE {
+	const std::size_t	READ_SIZE = 1 << 20;
+}
+
+typedef std::map<std::pair<unsigned long, unsigned long>, std::string>	stringMap;
+
+static std::string	resolve(const stringMap& strings, const unsigned long& pid, const unsigned long& id, const std::string& inlineValue) {
+	if (id == E_BINARY_LOG::INLINE) {
+		return (inlineValue);
+	}
+	const stringMap::const_iterator	it = strings.find(std::make_pair(pid, id));
+	return (it != strings.end() ? it->second : "?");
+}
+
+static std::string	csvField(const std::string& value) {
+	std::string	out = "\"";
+
+	for (std::string::const_iterator it = value.begin(); it != value.end(); ++it) {
+		if (*it == '"') {
+			out += '"';
+		}
+		out += *it;
+	}
+	return (out + "\"");
+}
+
+/**
+ * @brief	text 줄에서는 server 의 log_format 처럼 '"' '\' 와 제어 문자를 \xHH 로 쓴다.
+ */
+static std::string	textField(const std::string& value) {
+	static const char	hex[] = "0123456789ABCDEF";
+	std::string			out;
+
+	for (std::string::const_iterator it = value.begin(); it != value.end(); ++it) {
+		const unsigned char	c = static_cast<unsigned char>(*it);
+		if (c == '"' || c == '\\' || c < 0x20 || c >= 0x7f) {
+			out += "\\x";
+			out += hex[c >> 4];
+			out += hex[c & 0x0f];
+		} else {
+			out += static_cast<char>(c);
+		}
+	}
+	return (out);
+}
+
+static void	printRecord(const BinaryLogRecord& record, const stringMap& strings, const bool& csv) {
+	const time_t		seconds = static_cast<time_t>(record.m_Time);
+	const std::string	host = resolve(strings, record.m_Pid, record.m_Host, record.m_HostInline);
+	const std::string	location = resolve(strings, record.m_Pid, record.m_Location, record.m_LocationInline);
+	char			addr[INET_ADDRSTRLEN];
+	char			time[40];
+	struct in_addr	raw;
+
+	std::memcpy(&raw.s_addr, record.m_Addr, sizeof(record.m_Addr));
+	inet_ntop(AF_INET, &raw, addr, sizeof(addr));
+	if (csv) {
+		std::strftime(time, sizeof(time), "%Y-%m-%dT%H:%M:%S", std::gmtime(&seconds));
+		std::printf("%s.%03uZ,%s,%s,%s,%s,%s,%u,%lu,%lu,%lu\n", time, record.m_Msec, addr,
+			BinaryLogCodec::methodName(record.m_Method), csvField(host).c_str(), csvField(location).c_str(),
+			csvField(record.m_Uri).c_str(), record.m_Status, record.m_BytesSent, record.m_BodyBytesSent, record.m_RequestTime);
+		return ;
+	}
+	std::strftime(time, sizeof(time), "%d/%b/%Y:%H:%M:%S %z", std::localtime(&seconds));
+	std::printf("%s - - [%s] \"%s %s\" %u %lu \"%s\" \"%s\" %lu.%03lu\n", addr, time,
+		BinaryLogCodec::methodName(record.m_Method), textField(record.m_Uri).c_str(), record.m_Status, record.m_BodyBytesSent,
+		textField(host).c_str(), textField(location).c_str(), record.m_RequestTime / 1000, record.m_RequestTime % 1000);
+}
+
+/**
+ * @brief	buffer 앞쪽의 완전한 record 들을 풀고, 쓴 만큼을 돌려준다.
+ * @return	모르는 tag 를 만나면 -1
+ */
+static long	decode(const std::string& buffer, stringMap& strings, const bool& csv) {
+	const char*		pos = buffer.data();
+	const char* const	end = pos + buffer.size();
+
+	while (pos < end) {
+		const char*	cursor = pos + 1;
+
+		if (*pos == E_BINARY_LOG::TAG_STRING) {
+			unsigned long	pid;
+			unsigned long	id;
+			std::string		value;
+			if (!BinaryLogCodec::readVarint(cursor, end, pid) || !BinaryLogCodec::readVarint(cursor, end, id)
+					|| !BinaryLogCodec::readBytes(cursor, end, value)) {
+				break;
+			}
+			strings[std::make_pair(pid, id)] = value;
+		} else if (*pos == E_BINARY_LOG::TAG_REQUEST) {
+			BinaryLogRecord	record;
+			if (!BinaryLogCodec::readRequest(cursor, end, record)) {
+				break;
+			}
+			printRecord(record, strings, csv);
+		} else {
+			return (-1);
+		}
+		pos = cursor;
+	}
+	return (pos - buffer.data());
+}
+
+static bool	decodeFile(const int& fd, const char* name, const bool& csv) {
+	stringMap	strings;
+	std::string	buffer;
+	char*		chunk = new char[E_LOG_DECODE::READ_SIZE];
+	ssize_t		readSize;
+	bool		valid = true;
+
+	while ((readSize = ::read(fd, chunk, E_LOG_DECODE::READ_SIZE)) > 0) {
+		buffer.append(chunk, readSize);
+		const long	used = decode(buffer, strings, csv);
+		if (used < 0) {
+			std::cerr << "logdecode: " << name << ": not a binary access_log (unknown record tag)" << std::endl;
+			valid = false;
+			break;
+		}
+		buffer.erase(0, used);
+	}
+	delete[] chunk;
+	if (readSize < 0) {
+		std::cerr << "logdecode: " << name << ": " << std::strerror(errno) << std::endl;
+		return false;
+	}
+	if (valid && !buffer.empty()) {
+		std::cerr << "logdecode: " << name << ": truncated record at end (" << buffer.size() << " bytes)" << std::endl;
+	}
+	return (valid);
+}
+
+int	main(int argc, char** argv) {
+	bool	csv = false;
+	int		first = 1;
+	bool	ok = true;
+
+	if (argc > 1 && std::strcmp(argv[1], "-csv") == 0) {
+		csv = true;
+		first = 2;
+	}
+	if (csv) {
+		std::printf("time,remote_addr,method,host,location,uri,status,bytes_sent,body_bytes_sent,request_time_ms\n");
+	}
+	if (first == argc) {
+		return (decodeFile(STDIN_FILENO, "stdin", csv) ? 0 : 1);
+	}
+	for (int i = first; i < argc; i++) {
+		const int	fd = ::open(argv[i], O_RDONLY);
+		if (fd < 0) {
+			std::cerr << "logdecode: " << argv[i] << ": " << std::strerror(errno) << std::endl;
+			ok = false;
+			continue;
+		}
+		ok = decodeFile(fd, argv[i], csv) && ok;
+		::close(fd);
+	}
+	return (ok ? 0 : 1);
+}
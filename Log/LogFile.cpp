@@ -0,0 +1,353 @@
+#include "LogFile.hpp"
+#include "LogFormat.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+LogFile::fileVec	LogFile::m_Files;
+unsigned int		LogFile::m_ErrorLog = E_ACCESS_LOG_DATA::NONE;
+LogReopen			LogFile::m_Reopen;
+
+void	LogReopen::handleEvent(const struct kevent& event) {
+	static_cast<void>(event);
+	LogFile::reopenAll();
+}
+
+LogFile::LogFile(const std::string& path, const int& fd)
+  : m_Path(path),
+	m_Fd(fd),
+	m_Capacity(0),
+	m_Flush(0),
+	m_Written(0),
+	m_InFlight(false),
+	m_LineStart(0),
+	m_Dropped(0),
+	m_Generation(0)
+{
+	std::memset(&m_Request, 0, sizeof(m_Request));
+}
+
+LogFile::~LogFile() {
+	drain();
+	::close(m_Fd);
+}
+
+/**
+ *			aio
+ */
+
+/**
+ * @brief	앞의 aio_write 가 끝났는지 본다. 덜 썼으면 나머지를 다시 보낸다.
+ * @return	내보내는 중인 것이 없으면 true
+ */
+bool	LogFile::complete() {
+	if (!m_InFlight) {
+		return true;
+	}
+	if (aio_error(&m_Request) == EINPROGRESS) {
+		return false;
+	}
+	const ssize_t	result = aio_return(&m_Request);
+
+	m_InFlight = false;
+	if (result > 0 && m_Written + result < m_Writing.size()) {
+		m_Written += result;
+		submit();
+		return (!m_InFlight);
+	}
+	// 다 썼거나 쓰지 못했다. (disk full 등, 버리고 다음 줄로 넘어간다)
+	m_Writing.clear();
+	m_Written = 0;
+	return true;
+}
+
+/**
+ * @brief	m_Writing 의 남은 부분을 aio_write 로 넘긴다. aio 를 받지 않으면 (EAGAIN 등) 그냥 write 한다.
+ */
+void	LogFile::submit() {
+	m_Request.aio_fildes = m_Fd;
+	m_Request.aio_buf = &m_Writing[m_Written];
+	m_Request.aio_nbytes = m_Writing.size() - m_Written;
+	m_Request.aio_offset = 0;
+	m_Request.aio_sigevent.sigev_notify = SIGEV_NONE;
+	if (aio_write(&m_Request) == 0) {
+		m_InFlight = true;
+		return ;
+	}
+	while (m_Written < m_Writing.size()) {
+		const ssize_t	writeSize = ::write(m_Fd, m_Writing.data() + m_Written, m_Writing.size() - m_Written);
+		if (writeSize <= 0) {
+			break;
+		}
+		m_Written += writeSize;
+	}
+	m_Writing.clear();
+	m_Written = 0;
+}
+
+/**
+ * @brief	내보내는 중인 것을 기다리고 남은 줄을 모두 쓴다. (worker 가 끝날 때와 reopen)
+ */
+void	LogFile::drain() {
+	while (!complete()) {
+		const struct aiocb*	list[1] = { &m_Request };
+		aio_suspend(list, 1, NULL);
+	}
+	if (!m_Buffer.empty()) {
+		m_Writing.swap(m_Buffer);
+		m_Buffer.clear();
+		m_Written = 0;
+		submit();
+		while (!complete()) {
+			const struct aiocb*	list[1] = { &m_Request };
+			aio_suspend(list, 1, NULL);
+		}
+	}
+}
+
+/**
+ * @brief	쌓인 줄을 옛 파일로 넘기고 같은 path 를 새로 연다.
+ * @details	내보내는 중인 aio 를 기다리고 m_Buffer 까지 옛 fd 에 다 쓴 뒤에 fd 를 바꾼다.
+ *			그래서 signal 전에 만든 줄은 모두 옛 파일에, 뒤의 줄은 모두 새 파일에 들어간다.
+ *			(binary log 의 string table 처럼 앞의 줄에 기대는 형식이 파일 사이에서 갈라지지 않는다)
+ *			새로 열지 못하면 (권한 / directory 가 없음 등) 옛 파일에 계속 쓴다.
+ *			header 가 있으면 header 까지 쓴 파일이 path 에 나타나므로 (createWithHeader) 다른 worker 의 줄이 앞에 끼지 않는다.
+ */
+void	LogFile::reopen() {
+	drain();
+
+	int	fd = m_Header.empty() ? -1 : createWithHeader();
+
+	if (fd < 0) {
+		fd = openPath(m_Path, O_CREAT);
+	}
+	if (fd < 0) {
+		std::cerr << "log: cannot reopen " << m_Path << ": " << std::strerror(errno) << std::endl;
+		return ;
+	}
+	::close(m_Fd);
+	m_Fd = fd;
+	m_Generation++;
+}
+
+/**
+ * @brief	header 를 쓴 임시 파일 (path.pid) 을 link 로 path 에 건다.
+ * @details	link 는 path 가 이미 있으면 실패하므로 (EEXIST) 여러 worker 중 하나만 건다.
+ * @return	건 파일의 fd. 다른 worker 가 먼저 만들었거나 실패하면 -1
+ */
+int	LogFile::createWithHeader() const {
+	std::string	temp = m_Path + ".";
+
+	LogFormat::appendNumber(temp, getpid());
+
+	const int	fd = openPath(temp, O_CREAT | O_TRUNC);
+
+	if (fd < 0) {
+		return (-1);
+	}
+	const bool	written = (::write(fd, m_Header.data(), m_Header.size()) == static_cast<ssize_t>(m_Header.size()));
+	const bool	linked = written && ::link(temp.c_str(), m_Path.c_str()) == 0;
+
+	::unlink(temp.c_str());
+	if (!linked) {
+		::close(fd);
+		return (-1);
+	}
+	return (fd);
+}
+
+int	LogFile::openPath(const std::string& path, const int& flags) {
+	const int	fd = ::open(path.c_str(), O_WRONLY | O_APPEND | flags, 0644);
+
+	if (fd >= 0) {
+		fcntl(fd, F_SETFD, FD_CLOEXEC);
+	}
+	return (fd);
+}
+
+/**
+ *			worker
+ */
+
+/**
+ * @brief	flush= timer
+ */
+void	LogFile::handleEvent(const struct kevent& event) {
+	static_cast<void>(event);
+	flush();
+}
+
+/**
+ * @brief	줄 하나를 시작한다. 돌려준 buffer 뒤에 줄 ('\n' 까지) 을 붙이고 end() 를 부를 것.
+ */
+std::string&	LogFile::begin() {
+	m_LineStart = m_Buffer.size();
+	return (m_Buffer);
+}
+
+/**
+ * @return	false 면 밀려서 줄을 버렸다.
+ */
+bool	LogFile::end() {
+	const std::size_t	limit = m_Capacity ? m_Capacity * E_LOG_FILE::PENDING_LIMIT : E_LOG_FILE::UNBUFFERED_LIMIT;
+	const bool			kept = (m_Buffer.size() <= limit);
+
+	if (!kept) {
+		m_Buffer.resize(m_LineStart);
+		m_Dropped++;
+	}
+	if (m_Buffer.size() >= m_Capacity) {
+		flush();
+	}
+	return (kept);
+}
+
+/**
+ * @brief	앞의 write 가 끝났으면 쌓인 줄을 통째로 넘긴다. 아직이면 다음 기회 (다음 줄 / timer) 에 넘긴다.
+ * @details	그 사이 버린 줄이 있으면 그 수를 error_log 에 남긴다.
+ */
+void	LogFile::flush() {
+	if (!complete() || m_Buffer.empty()) {
+		return ;
+	}
+	m_Writing.swap(m_Buffer);
+	m_Buffer.clear();
+	m_Buffer.reserve(m_Capacity);
+	m_Written = 0;
+	submit();
+	if (m_Dropped > 0) {
+		std::string	message = "log: ";
+
+		LogFormat::appendNumber(message, m_Dropped);
+		message += " lines dropped while writing " + m_Path + " was behind";
+		// error_log 가 이 파일이어도 다시 들어오지 않게 먼저 비운다.
+		m_Dropped = 0;
+		error(message);
+	}
+}
+
+/**
+ * @brief	같은 파일을 여러 블록이 쓰면 buffer 는 큰 쪽, flush 는 짧은 쪽을 따른다.
+ */
+void	LogFile::configure(const std::size_t& buffer, const unsigned int& flush) {
+	if (buffer > m_Capacity) {
+		m_Capacity = buffer;
+		m_Buffer.reserve(m_Capacity);
+	}
+	if (flush != 0 && (m_Flush == 0 || flush < m_Flush)) {
+		m_Flush = flush;
+	}
+}
+
+/**
+ * @brief	빈 파일의 맨 앞에 쓸 내용. 지금 파일이 비어 있으면 바로 쓴다. (master, fork 전)
+ */
+void	LogFile::setHeader(const std::string& header) {
+	struct stat	status;
+
+	m_Header = header;
+	if (fstat(m_Fd, &status) == 0 && status.st_size == 0) {
+		static_cast<void>(::write(m_Fd, m_Header.data(), m_Header.size()));
+	}
+}
+
+/**
+ * @brief	다시 열 때마다 하나씩 는다. (새 파일에 앞의 내용을 기대하는 쪽이 알아챌 수 있게)
+ */
+const unsigned long&	LogFile::getGeneration() const {
+	return (m_Generation);
+}
+
+/**
+ * @return	log path 표의 index 번째 파일. 없으면 (off / 설정 없음) NULL
+ */
+LogFile*	LogFile::at(const unsigned int& index) {
+	return (index < m_Files.size() ? m_Files[index] : NULL);
+}
+
+/**
+ * @brief	error_log 에 "YYYY/MM/DD HH:MM:SS [error] pid: message" 한 줄을 남긴다. error_log 가 없으면 stderr 로.
+ */
+void	LogFile::error(const std::string& message) {
+	LogFile* const	log = at(m_ErrorLog);
+
+	if (log == NULL) {
+		std::cerr << message << std::endl;
+		return ;
+	}
+	const time_t	now = std::time(NULL);
+	char			time[32];
+	std::string&	line = log->begin();
+
+	std::strftime(time, sizeof(time), "%Y/%m/%d %H:%M:%S", std::localtime(&now));
+	line += time;
+	line += " [error] ";
+	LogFormat::appendNumber(line, getpid());
+	line += ": ";
+	line += message;
+	line += '\n';
+	log->end();
+}
+
+/**
+ *			setup (master, fork 전)
+ */
+
+/**
+ * @brief	log path 표의 파일을 모두 연다. (fork 전에 한 번. worker 는 fd 를 물려받고 buffer 는 각자 가진다)
+ * @throw	std::runtime_error	열 수 없는 path
+ */
+void	LogFile::prepare(const CONF::MainBlock& mainBlock) {
+	const std::vector<std::string>&	paths = CONF::AConfParser::getLogPaths();
+
+	for (std::vector<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it) {
+		const int	fd = openPath(*it, O_CREAT);
+		if (fd < 0) {
+			throw std::runtime_error("log: cannot open " + *it + ": " + std::strerror(errno));
+		}
+		m_Files.push_back(new LogFile(*it, fd));
+	}
+	m_ErrorLog = mainBlock.getErrorLogFile();
+}
+
+/**
+ * @brief	flush= 가 있는 파일마다 timer 를 걸고, REOPEN_SIGNAL 을 event loop 로 받는다.
+ */
+void	LogFile::start(EventLoop& loop) {
+	for (fileVec::iterator it = m_Files.begin(); it != m_Files.end(); ++it) {
+		if ((*it)->m_Flush != 0) {
+			loop.addTimer(reinterpret_cast<uintptr_t>(*it), (*it)->m_Flush, *it);
+		}
+	}
+	// master 에게서 물려받은 handler 대신 kqueue 로만 받는다.
+	signal(E_LOG_FILE::REOPEN_SIGNAL, SIG_IGN);
+	loop.addSignal(E_LOG_FILE::REOPEN_SIGNAL, &m_Reopen);
+}
+
+void	LogFile::reopenAll() {
+	for (fileVec::iterator it = m_Files.begin(); it != m_Files.end(); ++it) {
+		(*it)->reopen();
+	}
+}
+
+/**
+ * @brief	master 가 fork 전에 남긴 줄 (prepare 의 error 등) 을 다 쓴다. worker 가 같은 줄을 물려받지 않게.
+ */
+void	LogFile::drainAll() {
+	for (fileVec::iterator it = m_Files.begin(); it != m_Files.end(); ++it) {
+		(*it)->drain();
+	}
+}
+
+void	LogFile::finish() {
+	for (fileVec::iterator it = m_Files.begin(); it != m_Files.end(); ++it) {
+		delete *it;
+	}
+	m_Files.clear();
+}
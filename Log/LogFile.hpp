@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+#include <aio.h>
+#include <csignal>
+#include <string>
+#include <vector>
+
+namespace E_LOG_FILE {
+	const std::size_t	PENDING_LIMIT = 8;
+	const std::size_t	UNBUFFERED_LIMIT = 262144;
+	const int			REOPEN_SIGNAL = SIGUSR1;
+}
+
+/**
+ * @brief	REOPEN_SIGNAL 이 오면 모든 log 파일을 다시 연다. (worker 의 event loop 에서)
+ */
+class LogReopen : public AEventHandler {
+public:
+	void	handleEvent(const struct kevent& event);
+};
+
+/**
+ * @brief	log 파일 하나 (worker 마다)
+ * @details	access_log / error_log 의 path 는 설정을 읽을 때 한 표 (AConfParser::getLogPaths) 에 모이고, 블록은 그 번호만 가진다.
+ *			fork 전에 표의 path 를 하나씩 열어 두므로 vhost 가 수천 개여도 fd 는 서로 다른 path 개수만큼이다.
+ *			- 줄은 m_Buffer 에 바로 만들어 붙이고, buffer= 만큼 차거나 flush= 가 지나면 aio_write 한 번으로 내보낸다.
+ *			- 내보내는 동안에는 m_Writing 을 kernel 이 읽으므로 새 줄은 m_Buffer 에 계속 쌓는다. (double buffer)
+ *			  느린 disk 때문에 write 를 기다리는 일은 없다. 끝났는지는 다음 flush 때 aio_error 로 본다.
+ *			- 앞의 write 가 끝나지 않은 채 m_Buffer 가 buffer 의 PENDING_LIMIT 배를 넘으면 새 줄은 버리고 센다.
+ *			  버린 줄 수는 다음 flush 때 error_log 에 한 줄로 남긴다.
+ *			- 파일은 O_APPEND 로 열고 한 번에 완성된 줄만 내보내므로 worker 끼리 줄이 섞이지 않는다.
+ *			- REOPEN_SIGNAL (master 가 worker 로 넘겨준다) 이 오면 쌓인 줄을 옛 파일에 다 쓰고 같은 path 를 새로 연다. (log rotation)
+ *			  내보내는 중인 aio 도 기다리므로 signal 전의 줄이 새 파일로 넘어가는 일은 없다. (이때만 event loop 가 기다린다)
+ *			- header 가 있으면 (request_trace 의 '[') 빈 파일의 맨 앞에 한 번 쓴다. 다시 열 때는 header 를 쓴 임시 파일을 link 로 path 에 건다.
+ *			  link 에 성공한 worker 만 만들고, 다른 worker 는 header 가 이미 있는 파일을 연다.
+ *			- worker 가 끝날 때 (finish) 남은 줄은 기다려서라도 마저 쓴다.
+ */
+class LogFile : public AEventHandler {
+private:
+	typedef std::vector<LogFile*>	fileVec;
+
+	std::string		m_Path;
+	int				m_Fd;
+	std::size_t		m_Capacity;
+	unsigned int	m_Flush;
+	std::string		m_Buffer;
+	std::string		m_Writing;
+	std::size_t		m_Written;
+	struct aiocb	m_Request;
+	bool			m_InFlight;
+	std::size_t		m_LineStart;
+	unsigned long	m_Dropped;
+	unsigned long	m_Generation;
+	std::string		m_Header;
+
+	static fileVec		m_Files;
+	static unsigned int	m_ErrorLog;
+	static LogReopen	m_Reopen;
+
+	LogFile(const std::string& path, const int& fd);
+	LogFile(const LogFile& other);
+	LogFile& operator=(const LogFile& other);
+
+	bool	complete();
+	void	submit();
+	void	drain();
+	void	reopen();
+	int		createWithHeader() const;
+
+	static int	openPath(const std::string& path, const int& flags);
+
+public:
+	virtual ~LogFile();
+
+	void			handleEvent(const struct kevent& event);
+
+	std::string&	begin();
+	bool			end();
+	void			flush();
+	void			configure(const std::size_t& buffer, const unsigned int& flush);
+	void			setHeader(const std::string& header);
+
+	const unsigned long&	getGeneration() const;
+
+	static LogFile*		at(const unsigned int& index);
+	static void			error(const std::string& message);
+
+	static void			prepare(const CONF::MainBlock& mainBlock);
+	static void			start(EventLoop& loop);
+	static void			reopenAll();
+	static void			drainAll();
+	static void			finish();
+};
@@ -0,0 +1,263 @@
+#include "LogFormat.hpp"
+#include "../Server/Client/Client.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+
+#include <cctype>
+#include <stdexcept>
+
+time_t		LogFormat::m_TimeSecond = 0;
+std::string	LogFormat::m_TimeLocal;
+std::string	LogFormat::m_TimeISO8601;
+
+LogFormat::LogFormat() {}
+
+LogFormat::LogFormat(const std::string& pattern) {
+	compile(pattern);
+}
+
+LogFormat::LogFormat(const LogFormat& other)
+  : m_Ops(other.m_Ops),
+	m_Pool(other.m_Pool),
+	m_Headers(other.m_Headers)
+{}
+
+LogFormat&	LogFormat::operator=(const LogFormat& other) {
+	if (this != &other) {
+		m_Ops = other.m_Ops;
+		m_Pool = other.m_Pool;
+		m_Headers = other.m_Headers;
+	}
+	return (*this);
+}
+
+LogFormat::~LogFormat() {}
+
+void	LogFormat::push(const unsigned char& type, const std::string& value) {
+	// 이어지는 literal 은 하나로 합친다. (pool 에서도 바로 뒤에 붙어 있다)
+	if (type == E_LOG_FORMAT::LITERAL && !m_Ops.empty() && m_Ops.back().m_Type == E_LOG_FORMAT::LITERAL
+			&& m_Ops.back().m_Offset + m_Ops.back().m_Length == m_Pool.size()) {
+		m_Ops.back().m_Length += value.size();
+		m_Pool += value;
+		return ;
+	}
+	Op	op;
+	op.m_Type = type;
+	op.m_Offset = m_Pool.size();
+	op.m_Length = value.size();
+	m_Pool += value;
+	m_Ops.push_back(op);
+}
+
+/**
+ * @throw	std::runtime_error	모르는 변수 이름 / 닫히지 않은 ${
+ */
+void	LogFormat::compile(const std::string& pattern) {
+	std::size_t	pos = 0;
+
+	m_Ops.clear();
+	m_Pool.clear();
+	m_Headers.clear();
+	while (pos < pattern.size()) {
+		const std::size_t	dollarPos = pattern.find('$', pos);
+		if (dollarPos != pos) {
+			push(E_LOG_FORMAT::LITERAL, pattern.substr(pos, dollarPos - pos));
+			if (dollarPos == std::string::npos) {
+				break;
+			}
+		}
+
+		std::size_t	nameStart = dollarPos + 1;
+		std::size_t	nameEnd;
+		const bool	braced = (nameStart < pattern.size() && pattern[nameStart] == '{');
+		if (braced) {
+			nameStart++;
+			nameEnd = pattern.find('}', nameStart);
+			if (nameEnd == std::string::npos) {
+				throw std::runtime_error("unterminated variable: " + pattern);
+			}
+		} else {
+			nameEnd = nameStart;
+			while (nameEnd < pattern.size() && (std::isalnum(static_cast<int>(pattern[nameEnd])) || pattern[nameEnd] == '_')) {
+				nameEnd++;
+			}
+		}
+
+		std::string	name = pattern.substr(nameStart, nameEnd - nameStart);
+		for (std::size_t i = 0; i < name.size(); i++) {
+			name[i] = std::tolower(name[i]);
+		}
+		std::size_t	variable = 1;
+		while (variable < E_LOG_FORMAT::VARIABLE_COUNT && name != E_LOG_FORMAT::VARIABLE_NAMES[variable]) {
+			variable++;
+		}
+		if (variable < E_LOG_FORMAT::VARIABLE_COUNT) {
+			push(variable, "");
+		} else if (name.compare(0, 5, "http_") == 0 && name.size() > 5) {
+			// $http_user_agent -> "user-agent" (Request 는 header 이름을 소문자로 저장한다)
+			std::string	header = name.substr(5);
+			for (std::size_t i = 0; i < header.size(); i++) {
+				header[i] = (header[i] == '_') ? '-' : header[i];
+			}
+			push(E_LOG_FORMAT::HTTP_HEADER, "");
+			m_Ops.back().m_Offset = m_Headers.size();
+			m_Headers.push_back(header);
+		} else {
+			throw std::runtime_error("unknown log variable: $" + name);
+		}
+		pos = braced ? nameEnd + 1 : nameEnd;
+	}
+}
+
+/**
+ * @brief	compile 한 것을 다시 format 문자열로 만든다. 변수는 모두 ${name} 꼴이다. (설정 확인 / test 용)
+ */
+std::string	LogFormat::pattern() const {
+	std::string	result;
+
+	for (std::vector<Op>::const_iterator it = m_Ops.begin(); it != m_Ops.end(); ++it) {
+		if (it->m_Type == E_LOG_FORMAT::LITERAL) {
+			result.append(m_Pool, it->m_Offset, it->m_Length);
+		} else if (it->m_Type == E_LOG_FORMAT::HTTP_HEADER) {
+			std::string	header = m_Headers[it->m_Offset];
+			for (std::size_t i = 0; i < header.size(); i++) {
+				header[i] = (header[i] == '-') ? '_' : header[i];
+			}
+			result += "${http_" + header + "}";
+		} else {
+			result += std::string("${") + E_LOG_FORMAT::VARIABLE_NAMES[it->m_Type] + "}";
+		}
+	}
+	return (result);
+}
+
+/**
+ * @brief	client 의 지금 request / 응답으로 한 줄 ('\n' 은 붙이지 않는다) 을 out 뒤에 만든다.
+ */
+void	LogFormat::evaluate(std::string& out, const Client& client) const {
+	const HTTP::Request&	request = client.getRequest();
+	const unsigned long&	now = EventLoop::now();
+
+	for (std::vector<Op>::const_iterator it = m_Ops.begin(); it != m_Ops.end(); ++it) {
+		switch (it->m_Type) {
+			case E_LOG_FORMAT::LITERAL:
+				out.append(m_Pool, it->m_Offset, it->m_Length);
+				break;
+			case E_LOG_FORMAT::REMOTE_ADDR:
+				out += client.getRemoteAddr();
+				break;
+			case E_LOG_FORMAT::REMOTE_USER:
+				out += '-';
+				break;
+			case E_LOG_FORMAT::TIME_LOCAL:
+				updateTime();
+				out += m_TimeLocal;
+				break;
+			case E_LOG_FORMAT::TIME_ISO8601:
+				updateTime();
+				out += m_TimeISO8601;
+				break;
+			case E_LOG_FORMAT::MSEC:
+				appendNumber(out, now / 1000);
+				out += '.';
+				out += static_cast<char>('0' + now % 1000 / 100);
+				out += static_cast<char>('0' + now % 100 / 10);
+				out += static_cast<char>('0' + now % 10);
+				break;
+			case E_LOG_FORMAT::REQUEST:
+				appendEscaped(out, request.getMethod());
+				out += ' ';
+				appendEscaped(out, request.getTarget());
+				out += ' ';
+				appendEscaped(out, request.getVersion());
+				break;
+			case E_LOG_FORMAT::REQUEST_METHOD:
+				appendEscaped(out, request.getMethod());
+				break;
+			case E_LOG_FORMAT::REQUEST_URI:
+				appendEscaped(out, request.getTarget());
+				break;
+			case E_LOG_FORMAT::URI:
+				appendEscaped(out, request.getPath());
+				break;
+			case E_LOG_FORMAT::ARGS:
+				appendEscaped(out, request.getQuery());
+				break;
+			case E_LOG_FORMAT::SERVER_PROTOCOL:
+				appendEscaped(out, request.getVersion());
+				break;
+			case E_LOG_FORMAT::HOST:
+				appendEscaped(out, request.getHeader("host"));
+				break;
+			case E_LOG_FORMAT::STATUS:
+				appendNumber(out, client.getStatus());
+				break;
+			case E_LOG_FORMAT::BYTES_SENT:
+				appendNumber(out, client.getBytesSent());
+				break;
+			case E_LOG_FORMAT::BODY_BYTES_SENT:
+				appendNumber(out, client.getBodyBytesSent());
+				break;
+			case E_LOG_FORMAT::REQUEST_TIME: {
+				const unsigned long	elapsed = (client.getRequestStart() != 0 && now > client.getRequestStart()) ? now - client.getRequestStart() : 0;
+				appendNumber(out, elapsed / 1000);
+				out += '.';
+				out += static_cast<char>('0' + elapsed % 1000 / 100);
+				out += static_cast<char>('0' + elapsed % 100 / 10);
+				out += static_cast<char>('0' + elapsed % 10);
+				break;
+			}
+			case E_LOG_FORMAT::HTTP_HEADER: {
+				const std::string	value = request.getHeader(m_Headers[it->m_Offset]);
+				value.empty() ? static_cast<void>(out += '-') : appendEscaped(out, value);
+				break;
+			}
+		}
+	}
+}
+
+void	LogFormat::appendNumber(std::string& out, unsigned long number) {
+	char		buf[24];
+	std::size_t	pos = sizeof(buf);
+
+	do {
+		buf[--pos] = '0' + number % 10;
+		number /= 10;
+	} while (number != 0);
+	out.append(buf + pos, sizeof(buf) - pos);
+}
+
+void	LogFormat::appendEscaped(std::string& out, const std::string& value) {
+	static const char	hex[] = "0123456789ABCDEF";
+
+	for (std::string::const_iterator it = value.begin(); it != value.end(); ++it) {
+		const unsigned char	c = static_cast<unsigned char>(*it);
+		if (c == '"' || c == '\\' || c < 0x20 || c >= 0x7f) {
+			out += "\\x";
+			out += hex[c >> 4];
+			out += hex[c & 0x0f];
+		} else {
+			out += static_cast<char>(c);
+		}
+	}
+}
+
+/**
+ * @brief	$time_local (10/Oct/2000:13:55:36 -0700) / $time_iso8601 (2000-10-10T13:55:36-07:00) 을 초마다 다시 만든다.
+ */
+void	LogFormat::updateTime() {
+	const time_t	now = static_cast<time_t>(EventLoop::now() / 1000);
+
+	if (now == m_TimeSecond && !m_TimeLocal.empty()) {
+		return ;
+	}
+	char			buf[40];
+	struct tm*		local = std::localtime(&now);
+
+	std::strftime(buf, sizeof(buf), "%d/%b/%Y:%H:%M:%S %z", local);
+	m_TimeLocal = buf;
+	std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S%z", local);
+	m_TimeISO8601 = buf;
+	// %z 는 +0900 이므로 ISO 8601 의 +09:00 으로 바꾼다.
+	m_TimeISO8601.insert(m_TimeISO8601.size() - 2, ":");
+	m_TimeSecond = now;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+class Client;
+
+namespace E_LOG_FORMAT {
+	enum E_OP {
+		LITERAL = 0,
+		REMOTE_ADDR,
+		REMOTE_USER,
+		TIME_LOCAL,
+		TIME_ISO8601,
+		MSEC,
+		REQUEST,
+		REQUEST_METHOD,
+		REQUEST_URI,
+		URI,
+		ARGS,
+		SERVER_PROTOCOL,
+		HOST,
+		STATUS,
+		BYTES_SENT,
+		BODY_BYTES_SENT,
+		REQUEST_TIME,
+		HTTP_HEADER
+	};
+
+	// E_OP 순서 그대로 (LITERAL 과 HTTP_HEADER 는 이름으로 찾지 않는다)
+	const char* const	VARIABLE_NAMES[] = { "", "remote_addr", "remote_user", "time_local", "time_iso8601", "msec", "request",
+											 "request_method", "request_uri", "uri", "args", "server_protocol", "host", "status",
+											 "bytes_sent", "body_bytes_sent", "request_time" };
+	const std::size_t	VARIABLE_COUNT = sizeof(VARIABLE_NAMES) / sizeof(VARIABLE_NAMES[0]);
+
+	const char* const	COMBINED = "$remote_addr - $remote_user [$time_local] \"$request\" $status $body_bytes_sent \"$http_referer\" \"$http_user_agent\"";
+}
+
+/**
+ * @brief	log_format 하나를 컴파일한 것
+ * @details	설정을 읽을 때 format 문자열을 op 배열 (literal 조각 / 변수 id) 로 한 번만 나눠 둔다.
+ *			literal 은 m_Pool 하나에 이어 두고 op 는 (offset, length) 만 가진다. ($http_<name> 은 m_Headers 의 index)
+ *			한 줄을 만들 때는 op 를 순서대로 돌며 out 뒤에 바로 붙인다. (문자열 파싱 / stream 없음)
+ *			- 변수: $remote_addr $remote_user $time_local $time_iso8601 $msec $request $request_method $request_uri
+ *			  $uri $args $server_protocol $host $status $bytes_sent $body_bytes_sent $request_time $http_<name>
+ *			- request 에서 온 값은 '"' '\' 와 제어 문자를 \xHH 로 바꿔 쓴다. (줄 / field 를 깨지 않게)
+ *			- 시각 문자열은 초가 바뀔 때만 다시 만든다.
+ */
+class LogFormat {
+private:
+	struct Op {
+		unsigned char	m_Type;
+		unsigned int	m_Offset;
+		unsigned int	m_Length;
+	};
+
+	std::vector<Op>		m_Ops;
+	std::string			m_Pool;
+	std::vector<std::string>	m_Headers;
+
+	static time_t		m_TimeSecond;
+	static std::string	m_TimeLocal;
+	static std::string	m_TimeISO8601;
+
+	void	push(const unsigned char& type, const std::string& value);
+
+	static void	updateTime();
+
+public:
+	LogFormat();
+	LogFormat(const std::string& pattern);
+	LogFormat(const LogFormat& other);
+	LogFormat& operator=(const LogFormat& other);
+	~LogFormat();
+
+	void	compile(const std::string& pattern);
+	void	evaluate(std::string& out, const Client& client) const;
+	std::string	pattern() const;
+
+	static void	appendNumber(std::string& out, unsigned long number);
+	static void	appendEscaped(std::string& out, const std::string& value);
+};
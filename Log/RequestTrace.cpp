@@ -0,0 +1,117 @@
+#include "RequestTrace.hpp"
+#include "LogFormat.hpp"
+#include "../Server/Client/Client.hpp"
+
+#include <unistd.h>
+
+unsigned int	RequestTrace::m_File = E_ACCESS_LOG_DATA::NONE;
+unsigned int	RequestTrace::m_Sample = E_REQUEST_TRACE_DATA::DEFAULT_SAMPLE;
+unsigned long	RequestTrace::m_Seen = 0;
+
+/**
+ * @brief	JSON 문자열. '"' '\' 와 제어 문자를 escape 한다.
+ */
+void	RequestTrace::appendString(std::string& out, const std::string& value) {
+	static const char	hex[] = "0123456789abcdef";
+
+	out += '"';
+	for (std::string::const_iterator it = value.begin(); it != value.end(); ++it) {
+		const unsigned char	c = static_cast<unsigned char>(*it);
+		if (c == '"' || c == '\\') {
+			out += '\\';
+			out += static_cast<char>(c);
+		} else if (c < 0x20 || c >= 0x7f) {
+			out += "\\u00";
+			out += hex[c >> 4];
+			out += hex[c & 0x0f];
+		} else {
+			out += static_cast<char>(c);
+		}
+	}
+	out += '"';
+}
+
+/**
+ * @brief	event 의 앞부분. 부른 쪽이 phase 에 맞는 field 를 붙이고 "},\n" 으로 닫는다.
+ */
+void	RequestTrace::appendEvent(std::string& out, const char* name, const char& phase, const unsigned long& ts, const unsigned long& pid, const int& tid) {
+	out += "{\"name\":\"";
+	out += name;
+	out += "\",\"cat\":\"http\",\"ph\":\"";
+	out += phase;
+	out += "\",\"ts\":";
+	LogFormat::appendNumber(out, ts);
+	out += ",\"pid\":";
+	LogFormat::appendNumber(out, pid);
+	out += ",\"tid\":";
+	LogFormat::appendNumber(out, tid);
+}
+
+/**
+ * @brief	from 부터 to 까지 한 칸. 둘 중 하나라도 지나지 않았으면 쓰지 않는다.
+ */
+void	RequestTrace::appendSpan(std::string& out, const char* name, const RequestTiming& timing, const E_TIMING::E_MARK& from, const E_TIMING::E_MARK& to, const unsigned long& pid, const int& tid) {
+	if (timing.m_At[from] == 0 || timing.m_At[to] < timing.m_At[from]) {
+		return ;
+	}
+	appendEvent(out, name, 'X', timing.m_At[from], pid, tid);
+	out += ",\"dur\":";
+	LogFormat::appendNumber(out, timing.m_At[to] - timing.m_At[from]);
+	out += "},\n";
+}
+
+/**
+ * @brief	응답이 끝난 request 하나. 표본이면 event 들을 한 번에 (한 줄 묶음으로) 넘긴다.
+ */
+void	RequestTrace::write(const Client& client, const RequestTiming& timing) {
+	LogFile* const	log = LogFile::at(m_File);
+
+	if (log == NULL || timing.m_At[E_TIMING::START] == 0 || timing.m_At[E_TIMING::DONE] == 0 || ++m_Seen % m_Sample != 0) {
+		return ;
+	}
+	const HTTP::Request&	request = client.getRequest();
+	const unsigned long		pid = getpid();
+	const int				tid = client.getFd();
+	std::string&			out = log->begin();
+
+	appendEvent(out, "request", 'X', timing.m_At[E_TIMING::START], pid, tid);
+	out += ",\"dur\":";
+	LogFormat::appendNumber(out, timing.m_At[E_TIMING::DONE] - timing.m_At[E_TIMING::START]);
+	out += ",\"args\":{\"method\":";
+	appendString(out, request.getMethod());
+	out += ",\"uri\":";
+	appendString(out, request.getTarget());
+	out += ",\"status\":";
+	LogFormat::appendNumber(out, client.getStatus());
+	out += ",\"bytes\":";
+	LogFormat::appendNumber(out, client.getBytesSent());
+	out += "}},\n";
+	appendSpan(out, "read header", timing, E_TIMING::START, E_TIMING::HEADER_PARSED, pid, tid);
+	appendSpan(out, "route", timing, E_TIMING::HEADER_PARSED, E_TIMING::LOCATION_MATCHED, pid, tid);
+	appendSpan(out, "open file", timing, E_TIMING::LOCATION_MATCHED, E_TIMING::FILE_OPENED, pid, tid);
+	appendSpan(out, "upstream", timing, E_TIMING::UPSTREAM_START, E_TIMING::DONE, pid, tid);
+	appendSpan(out, "send", timing, E_TIMING::FIRST_SENT, E_TIMING::DONE, pid, tid);
+	for (unsigned int mark = 0; mark < E_TIMING::MARK_COUNT; mark++) {
+		if (timing.m_At[mark] != 0) {
+			appendEvent(out, E_REQUEST_TRACE::MARK_NAMES[mark], 'i', timing.m_At[mark], pid, tid);
+			out += ",\"s\":\"t\"},\n";
+		}
+	}
+	log->end();
+}
+
+/**
+ * @brief	request_trace 의 파일에 buffer / flush 를 정하고, 비어 있으면 '[' 를 쓴다. (master, fork 전. LogFile::prepare 뒤에)
+ */
+void	RequestTrace::prepare(const CONF::MainBlock& mainBlock) {
+	const CONF::requestTraceData&	data = mainBlock.getHTTPBlock().getRequest_trace();
+	LogFile* const					log = LogFile::at(data.m_File);
+
+	if (log == NULL) {
+		return ;
+	}
+	m_File = data.m_File;
+	m_Sample = data.m_Sample;
+	log->configure(data.m_Buffer, data.m_Flush);
+	log->setHeader("[\n");
+}
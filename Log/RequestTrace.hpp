@@ -0,0 +1,45 @@
+#pragma once
+
+#include "LogFile.hpp"
+#include "../Metrics/Metrics.hpp"
+#include "../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include <string>
+
+class Client;
+
+namespace E_REQUEST_TRACE {
+	// E_TIMING::E_MARK 순서 그대로
+	const char* const	MARK_NAMES[] = { "accept", "first byte read", "header parsed", "location matched",
+		"file opened", "upstream start", "first byte sent", "done" };
+}
+
+/**
+ * @brief	request_trace: 표본 request 의 단계별 시각을 Chrome trace-event JSON 으로 남긴다. (Perfetto / chrome://tracing 으로 연다)
+ * @details	파일은 JSON array format 이다. 비어 있으면 fork 전에 '[' 를 쓰고, worker 는 event 마다 "{...},\n" 을 이어 붙인다.
+ *			닫는 ']' 는 쓰지 않는다. (trace-event format 은 끝이 열린 array 를 받는다. 여러 worker 가 O_APPEND 로 같이 쓰므로)
+ *			- ts / dur 은 EventLoop::monotonic (µs) 이라 worker 끼리 같은 시간 축에 놓인다.
+ *			- pid 는 worker pid, tid 는 connection 의 fd 이다. (동시에 처리하는 request 가 서로 다른 줄로 보인다)
+ *			- request 전체 한 칸 ("request", args 에 method / uri / status / bytes) 과 그 안의 단계 칸
+ *			  (read header, route, open file, upstream, send), 그리고 지난 mark 마다 instant event 하나씩을 쓴다.
+ *			표본은 worker 마다 m_Sample 개 중 하나다. 시각은 모든 request 가 재므로 (Metrics) 고르는 데만 비용이 든다.
+ */
+class RequestTrace {
+private:
+	static unsigned int		m_File;
+	static unsigned int		m_Sample;
+	static unsigned long	m_Seen;
+
+	RequestTrace();
+	RequestTrace(const RequestTrace& other);
+	RequestTrace& operator=(const RequestTrace& other);
+	~RequestTrace();
+
+	static void	appendString(std::string& out, const std::string& value);
+	static void	appendEvent(std::string& out, const char* name, const char& phase, const unsigned long& ts, const unsigned long& pid, const int& tid);
+	static void	appendSpan(std::string& out, const char* name, const RequestTiming& timing, const E_TIMING::E_MARK& from, const E_TIMING::E_MARK& to, const unsigned long& pid, const int& tid);
+
+public:
+	static void	write(const Client& client, const RequestTiming& timing);
+
+	static void	prepare(const CONF::MainBlock& mainBlock);
+};
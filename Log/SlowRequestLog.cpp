@@ -0,0 +1,73 @@
+#include "SlowRequestLog.hpp"
+#include "LogFormat.hpp"
+#include "../Server/Client/Client.hpp"
+
+#include <ctime>
+#include <unistd.h>
+
+/**
+ * @brief	µs 를 ms 로 (소수점 아래 3 자리)
+ */
+void	SlowRequestLog::appendMillis(std::string& out, const unsigned long& micro) {
+	LogFormat::appendNumber(out, micro / 1000);
+	out += '.';
+	out += static_cast<char>('0' + micro % 1000 / 100);
+	out += static_cast<char>('0' + micro % 100 / 10);
+	out += static_cast<char>('0' + micro % 10);
+}
+
+void	SlowRequestLog::appendPhase(std::string& out, const char* name, const RequestTiming& timing, const E_TIMING::E_MARK& from, const E_TIMING::E_MARK& to) {
+	out += ' ';
+	out += name;
+	out += '=';
+	if (timing.m_At[from] == 0 || timing.m_At[to] == 0 || timing.m_At[to] < timing.m_At[from]) {
+		out += '-';
+		return ;
+	}
+	appendMillis(out, timing.m_At[to] - timing.m_At[from]);
+}
+
+/**
+ * @brief	data 의 threshold 를 넘은 request 면 한 줄을 남긴다. (응답이 끝난 뒤, DONE 을 mark 한 다음)
+ */
+void	SlowRequestLog::write(const CONF::slowRequestLogData& data, const Client& client, const RequestTiming& timing) {
+	LogFile* const		log = LogFile::at(data.m_File);
+	const unsigned long	start = timing.m_At[E_TIMING::START];
+	const unsigned long	done = timing.m_At[E_TIMING::DONE];
+
+	if (log == NULL || start == 0 || done < start || done - start < static_cast<unsigned long>(data.m_Threshold) * 1000) {
+		return ;
+	}
+	const HTTP::Request&	request = client.getRequest();
+	const time_t			now = static_cast<time_t>(EventLoop::now() / 1000);
+	char					time[40];
+	std::string&			line = log->begin();
+
+	std::strftime(time, sizeof(time), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+	line += time;
+	line += " pid=";
+	LogFormat::appendNumber(line, getpid());
+	line += " client=";
+	line += client.getRemoteAddr();
+	line += " host=\"";
+	LogFormat::appendEscaped(line, request.getHeader("host"));
+	line += "\" method=";
+	LogFormat::appendEscaped(line, request.getMethod());
+	line += " uri=\"";
+	LogFormat::appendEscaped(line, request.getTarget());
+	line += "\" status=";
+	LogFormat::appendNumber(line, client.getStatus());
+	line += " total_ms=";
+	appendMillis(line, done - start);
+	appendPhase(line, "parse_ms", timing, E_TIMING::START, E_TIMING::HEADER_PARSED);
+	appendPhase(line, "routing_ms", timing, E_TIMING::HEADER_PARSED, E_TIMING::LOCATION_MATCHED);
+	appendPhase(line, "disk_ms", timing, E_TIMING::LOCATION_MATCHED, E_TIMING::FILE_OPENED);
+	appendPhase(line, "upstream_ms", timing, E_TIMING::UPSTREAM_START, E_TIMING::FIRST_SENT);
+	appendPhase(line, "send_ms", timing, E_TIMING::FIRST_SENT, E_TIMING::DONE);
+	line += " bytes=";
+	LogFormat::appendNumber(line, client.getBytesSent());
+	line += " loop_lag_ms=";
+	appendMillis(line, EventLoop::lag());
+	line += '\n';
+	log->end();
+}
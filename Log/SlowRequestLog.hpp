@@ -0,0 +1,34 @@
+#pragma once
+
+#include "LogFile.hpp"
+#include "../Metrics/Metrics.hpp"
+#include "../Parser/ConfParser/ConfData/ConfServerBlock.hpp"
+#include <string>
+
+class Client;
+
+/**
+ * @brief	slow_request_log: threshold 보다 오래 걸린 request 하나를 key=value 한 줄로 남긴다.
+ * @details	"time pid= client= host= method= uri= status= total_ms= parse_ms= routing_ms= disk_ms= upstream_ms= send_ms= bytes= loop_lag_ms="
+ *			단계 시간은 RequestTiming 의 mark 사이 (µs 까지, ms 로 쓴다) 이고, 지나지 않은 단계는 '-' 이다.
+ *			- parse:	첫 byte ~ header 끝		- routing:	header 끝 ~ location 결정
+ *			- disk:		location 결정 ~ 파일 열기 (file_cache hit 포함)
+ *			- upstream:	upstream 시작 ~ 응답 첫 byte (proxy / CGI / FastCGI 가 답하기까지)
+ *			- send:		응답 첫 byte ~ 끝
+ *			loop_lag 는 줄을 쓰는 순간 그 worker 의 event loop 가 이번 batch 에 쓴 시간이다. (EventLoop::lag)
+ *			크면 request 자체보다 같은 worker 의 다른 일이 늦춘 것이다.
+ *			요청마다 하는 일은 뺄셈과 비교 하나이므로 켜 둔 채로 운영해도 된다.
+ */
+class SlowRequestLog {
+private:
+	SlowRequestLog();
+	SlowRequestLog(const SlowRequestLog& other);
+	SlowRequestLog& operator=(const SlowRequestLog& other);
+	~SlowRequestLog();
+
+	static void	appendMillis(std::string& out, const unsigned long& micro);
+	static void	appendPhase(std::string& out, const char* name, const RequestTiming& timing, const E_TIMING::E_MARK& from, const E_TIMING::E_MARK& to);
+
+public:
+	static void	write(const CONF::slowRequestLogData& data, const Client& client, const RequestTiming& timing);
+};
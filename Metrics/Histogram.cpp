@@ -0,0 +1,71 @@
+#include "Histogram.hpp"
+
+/**
+ * @brief	value 가 들어갈 bucket 번호
+ */
+unsigned int	Histogram::index(const unsigned long& value) {
+	if (value < E_HISTOGRAM::SUB_COUNT) {
+		return (value);
+	}
+	const unsigned int	magnitude = sizeof(unsigned long) * 8 - 1 - __builtin_clzl(value);
+
+	if (magnitude >= E_HISTOGRAM::MAX_BITS) {
+		return (E_HISTOGRAM::BUCKETS - 1);
+	}
+	return ((magnitude - E_HISTOGRAM::SUB_BITS + 1) * E_HISTOGRAM::SUB_COUNT
+		+ ((value >> (magnitude - E_HISTOGRAM::SUB_BITS)) & (E_HISTOGRAM::SUB_COUNT - 1)));
+}
+
+/**
+ * @brief	bucket 에 들어가는 가장 큰 값 (quantile 은 이 값으로 답한다. 꼬리를 작게 보지 않게)
+ */
+unsigned long	Histogram::highest(const unsigned int& index) {
+	if (index < E_HISTOGRAM::SUB_COUNT) {
+		return (index);
+	}
+	const unsigned int	shift = index / E_HISTOGRAM::SUB_COUNT - 1;
+	const unsigned long	lowest = static_cast<unsigned long>(E_HISTOGRAM::SUB_COUNT + index % E_HISTOGRAM::SUB_COUNT) << shift;
+
+	return (lowest + (1UL << shift) - 1);
+}
+
+void	Histogram::record(const unsigned long& value) {
+	m_Buckets[index(value)]++;
+	m_Count++;
+	m_Sum += value;
+}
+
+void	Histogram::merge(const Histogram& other) {
+	for (unsigned int i = 0; i < E_HISTOGRAM::BUCKETS; i++) {
+		m_Buckets[i] += other.m_Buckets[i];
+	}
+	m_Count += other.m_Count;
+	m_Sum += other.m_Sum;
+}
+
+/**
+ * @brief	q (0 ~ 1) quantile. 비어 있으면 0
+ */
+unsigned long	Histogram::quantile(const double& q) const {
+	unsigned long	total = 0;
+
+	for (unsigned int i = 0; i < E_HISTOGRAM::BUCKETS; i++) {
+		total += m_Buckets[i];
+	}
+	if (total == 0) {
+		return (0);
+	}
+	unsigned long	rank = static_cast<unsigned long>(q * total);
+	unsigned long	seen = 0;
+
+	if (rank < q * total || rank == 0) {
+		rank++;
+	}
+	for (unsigned int i = 0; i < E_HISTOGRAM::BUCKETS; i++) {
+		seen += m_Buckets[i];
+		if (seen >= rank) {
+			return (highest(i));
+		}
+	}
+	return (highest(E_HISTOGRAM::BUCKETS - 1));
+}
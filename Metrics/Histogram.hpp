@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+namespace E_HISTOGRAM {
+	const unsigned int	SUB_BITS = 4;
+	const unsigned int	SUB_COUNT = 1 << SUB_BITS;
+	const unsigned int	MAX_BITS = 32;
+	const unsigned int	BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+}
+
+/**
+ * @brief	log-linear (HDR 과 같은 모양) histogram. 값은 µs 같은 0 이상의 정수.
+ * @details	2 의 거듭제곱 구간 [2^m, 2^(m+1)) 마다 SUB_COUNT 개로 똑같이 나눈다.
+ *			SUB_COUNT 보다 작은 값은 값 그대로 한 칸씩이고, 그 위로는 bucket 폭이 값의 1/SUB_COUNT 이하이므로
+ *			어느 값이든 오차가 6.25% 를 넘지 않는다. 2^MAX_BITS (µs 면 약 71분) 이상은 마지막 칸에 모은다.
+ *			공유 메모리에 그대로 두는 POD 이다. 쓰는 쪽은 하나 (worker) 이고 읽는 쪽은 merge 로 더해서 본다.
+ *			읽는 동안 쓰고 있으면 m_Count / m_Sum 과 bucket 이 한두 개 어긋날 수 있으므로 quantile 은 bucket 만으로 센다.
+ */
+struct Histogram {
+	volatile unsigned long	m_Count;
+	volatile unsigned long	m_Sum;
+	volatile unsigned int	m_Buckets[E_HISTOGRAM::BUCKETS];
+
+	void					record(const unsigned long& value);
+	void					merge(const Histogram& other);
+	unsigned long			quantile(const double& q) const;
+
+	static unsigned int		index(const unsigned long& value);
+	static unsigned long	highest(const unsigned int& index);
+};
@@ -0,0 +1,372 @@
+#include "Metrics.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <set>
+#include <sstream>
+
+ShmZone*		Metrics::m_Zone = NULL;
+WorkerSlot*		Metrics::m_Slots = NULL;
+unsigned int	Metrics::m_Workers = 0;
+WorkerCounters	Metrics::m_Local;
+WorkerCounters*	Metrics::m_Mine = &Metrics::m_Local;
+
+Metrics::routeMap			Metrics::m_Routes;
+std::vector<std::string>	Metrics::m_RouteLabels;
+std::size_t					Metrics::m_WorkerStride = 0;
+char*						Metrics::m_WorkerAreas = NULL;
+LoopStats*					Metrics::m_MyLoop = NULL;
+Histogram*					Metrics::m_MyHistograms = NULL;
+
+RequestTiming::RequestTiming() {
+	clear();
+}
+
+void	RequestTiming::mark(const E_TIMING::E_MARK& which) {
+	if (m_At[which] == 0) {
+		m_At[which] = EventLoop::monotonic();
+	}
+}
+
+void	RequestTiming::clear() {
+	std::memset(m_At, 0, sizeof(m_At));
+}
+
+/**
+ *			worker (hot path)
+ */
+
+volatile unsigned long*	Metrics::gauge(const unsigned char& phase) {
+	switch (phase) {
+		case E_METRICS::WAITING:
+			return (&m_Mine->m_Waiting);
+		case E_METRICS::READING:
+			return (&m_Mine->m_Reading);
+		case E_METRICS::WRITING:
+			return (&m_Mine->m_Writing);
+	}
+	return (NULL);
+}
+
+/**
+ * @brief	새 connection. phase 는 Client 의 상태 자리 (WAITING 이 된다)
+ */
+void	Metrics::accept(unsigned char& phase) {
+	m_Mine->m_Accepted++;
+	m_Mine->m_Handled++;
+	phase = E_METRICS::CLOSED;
+	move(phase, E_METRICS::WAITING);
+}
+
+/**
+ * @brief	connection 상태를 바꾼다. (CLOSED 로 바꾸면 active 에서 빠진다)
+ */
+void	Metrics::move(unsigned char& phase, const unsigned char& next) {
+	volatile unsigned long*	from = gauge(phase);
+	volatile unsigned long*	to = gauge(next);
+
+	if (from == to) {
+		return ;
+	}
+	if (from != NULL) {
+		(*from)--;
+	}
+	if (to != NULL) {
+		(*to)++;
+	}
+	phase = next;
+}
+
+/**
+ * @brief	request 하나 (header 를 다 읽었거나 잘못된 request)
+ */
+void	Metrics::request() {
+	const unsigned long	second = EventLoop::now() / 1000;
+
+	if (m_Mine->m_Second != second) {
+		m_Mine->m_LastSecondRequests = (m_Mine->m_Second + 1 == second) ? m_Mine->m_SecondRequests : 0;
+		m_Mine->m_SecondRequests = 0;
+		m_Mine->m_Second = second;
+	}
+	m_Mine->m_SecondRequests++;
+	m_Mine->m_Requests++;
+}
+
+/**
+ * @brief	끝난 request 하나의 시간을 location 과 server 의 histogram 에 넣는다. (DONE 을 mark 한 뒤에)
+ */
+void	Metrics::observe(const CONF::ServerBlock* server, const CONF::LocationBlock* location, const RequestTiming& timing) {
+	if (m_MyHistograms == NULL || timing.m_At[E_TIMING::START] == 0 || timing.m_At[E_TIMING::DONE] == 0) {
+		return ;
+	}
+	if (location != NULL) {
+		record(location, timing);
+	}
+	if (server != NULL) {
+		record(server, timing);
+	}
+}
+
+void	Metrics::record(const void* block, const RequestTiming& timing) {
+	const routeMap::const_iterator	route = m_Routes.find(block);
+
+	if (route == m_Routes.end()) {
+		return ;
+	}
+	Histogram* const	histograms = m_MyHistograms + route->second * E_METRICS::LATENCY_COUNT;
+	const unsigned long	done = timing.m_At[E_TIMING::DONE];
+
+	histograms[E_METRICS::TOTAL].record(done - timing.m_At[E_TIMING::START]);
+	if (timing.m_At[E_TIMING::FIRST_SENT] != 0) {
+		histograms[E_METRICS::FIRST_BYTE].record(timing.m_At[E_TIMING::FIRST_SENT] - timing.m_At[E_TIMING::START]);
+	}
+	if (timing.m_At[E_TIMING::UPSTREAM_START] != 0) {
+		histograms[E_METRICS::UPSTREAM].record(done - timing.m_At[E_TIMING::UPSTREAM_START]);
+	}
+}
+
+/**
+ * @brief	event loop 한 바퀴. busy 는 handler 를 돌린 시간, idle 은 그 앞에 kevent() 에서 기다린 시간 (µs)
+ */
+void	Metrics::loop(const unsigned long& busy, const unsigned long& idle, const unsigned int& events) {
+	if (m_MyLoop == NULL) {
+		return ;
+	}
+	const unsigned long	second = EventLoop::now() / 1000;
+
+	m_MyLoop->m_Histograms[E_METRICS::ITERATION].record(busy);
+	m_MyLoop->m_Histograms[E_METRICS::EVENTS].record(events);
+	m_MyLoop->m_Busy += busy;
+	m_MyLoop->m_Idle += idle;
+	if (m_MyLoop->m_Second != second) {
+		const bool	previous = (m_MyLoop->m_Second + 1 == second);
+		m_MyLoop->m_LastSecondBusy = previous ? m_MyLoop->m_SecondBusy : 0;
+		m_MyLoop->m_LastSecondIdle = previous ? m_MyLoop->m_SecondIdle : 0;
+		m_MyLoop->m_SecondBusy = 0;
+		m_MyLoop->m_SecondIdle = 0;
+		m_MyLoop->m_Second = second;
+	}
+	m_MyLoop->m_SecondBusy += busy;
+	m_MyLoop->m_SecondIdle += idle;
+}
+
+/**
+ * @brief	timer 가 deadline 보다 lateness (µs) 만큼 늦게 불렸다. (LoopProbe)
+ */
+void	Metrics::timer(const unsigned long& lateness) {
+	if (m_MyLoop != NULL) {
+		m_MyLoop->m_Histograms[E_METRICS::TIMER_LATENESS].record(lateness);
+	}
+}
+
+/**
+ *			read
+ */
+
+/**
+ * @brief	모든 worker 의 자리를 더해서 nginx stub_status 와 같은 모양으로 만든다. (+ 바로 앞 1초의 요청 수)
+ */
+std::string	Metrics::stubStatus() {
+	const unsigned long	second = EventLoop::now() / 1000;
+	WorkerCounters		total = WorkerCounters();
+	std::stringstream	body;
+
+	for (unsigned int id = 0; id < m_Workers; id++) {
+		const WorkerCounters&	worker = m_Slots[id].m_Counters;
+		const unsigned long		workerSecond = worker.m_Second;
+
+		total.m_Accepted += worker.m_Accepted;
+		total.m_Handled += worker.m_Handled;
+		total.m_Requests += worker.m_Requests;
+		total.m_Reading += worker.m_Reading;
+		total.m_Writing += worker.m_Writing;
+		total.m_Waiting += worker.m_Waiting;
+		// 그 worker 가 이번 초에 request 를 받았으면 앞 초 값이, 앞 초가 마지막이면 그 초의 값이 바로 앞 1초다.
+		if (workerSecond == second) {
+			total.m_LastSecondRequests += worker.m_LastSecondRequests;
+		} else if (workerSecond + 1 == second) {
+			total.m_LastSecondRequests += worker.m_SecondRequests;
+		}
+	}
+	body << "Active connections: " << total.m_Reading + total.m_Writing + total.m_Waiting << " \n"
+		 << "server accepts handled requests\n"
+		 << " " << total.m_Accepted << " " << total.m_Handled << " " << total.m_Requests << " \n"
+		 << "Reading: " << total.m_Reading << " Writing: " << total.m_Writing << " Waiting: " << total.m_Waiting << " \n"
+		 << "Requests per second: " << total.m_LastSecondRequests << "\n";
+	return (body.str());
+}
+
+static void	appendSeconds(std::stringstream& out, const unsigned long micro) {
+	out << micro / 1000000 << '.' << std::setw(6) << std::setfill('0') << micro % 1000000 << std::setfill(' ');
+}
+
+/**
+ * @brief	histogram 하나를 Prometheus summary (quantile, _sum, _count) 로 쓴다. seconds 면 µs 를 초로 바꾼다.
+ */
+static void	appendSummary(std::stringstream& out, const char* name, const std::string& labels, const Histogram& histogram, const bool& seconds) {
+	for (std::size_t i = 0; i < E_METRICS::QUANTILE_COUNT; i++) {
+		const unsigned long	value = histogram.quantile(E_METRICS::QUANTILES[i]);
+
+		out << name << "{" << labels << (labels.empty() ? "" : ",") << "quantile=\"" << E_METRICS::QUANTILES[i] << "\"} ";
+		seconds ? appendSeconds(out, value) : static_cast<void>(out << value);
+		out << "\n";
+	}
+	out << name << "_sum{" << labels << "} ";
+	seconds ? appendSeconds(out, histogram.m_Sum) : static_cast<void>(out << histogram.m_Sum);
+	out << "\n" << name << "_count{" << labels << "} " << histogram.m_Count << "\n";
+}
+
+static void	appendHeader(std::stringstream& out, const char* name, const char* help, const char* type) {
+	out << "# HELP " << name << " " << help << "\n"
+		<< "# TYPE " << name << " " << type << "\n";
+}
+
+/**
+ * @brief	route 마다 worker 의 histogram 을 더한 latency summary 와, worker 마다의 event loop 통계를 Prometheus text 로 쓴다.
+ * @details	server 전체는 location="" 이다. 한 번도 요청이 없던 route 는 빼고 쓴다.
+ *			busy ratio 는 stub_status 의 초당 요청 수처럼, 그 worker 가 이번 초에 돌았으면 앞 초 값을, 앞 초가 마지막이면 그 초의 값을 쓴다.
+ *			(그보다 오래 kevent() 에서 기다리기만 했으면 0)
+ */
+std::string	Metrics::scrape() {
+	const unsigned long	second = EventLoop::now() / 1000;
+	std::stringstream	body;
+
+	for (unsigned int latency = 0; latency < E_METRICS::LATENCY_COUNT; latency++) {
+		appendHeader(body, E_METRICS::LATENCY_NAMES[latency], E_METRICS::LATENCY_HELP[latency], "summary");
+		for (unsigned int route = 0; route < m_RouteLabels.size(); route++) {
+			Histogram	merged;
+
+			std::memset(&merged, 0, sizeof(merged));
+			for (unsigned int id = 0; id < m_Workers; id++) {
+				merged.merge(routeHistograms(id)[route * E_METRICS::LATENCY_COUNT + latency]);
+			}
+			if (merged.m_Count != 0) {
+				appendSummary(body, E_METRICS::LATENCY_NAMES[latency], m_RouteLabels[route], merged, true);
+			}
+		}
+	}
+	for (unsigned int kind = 0; kind < E_METRICS::LOOP_COUNT; kind++) {
+		appendHeader(body, E_METRICS::LOOP_NAMES[kind], E_METRICS::LOOP_HELP[kind], "summary");
+		for (unsigned int id = 0; id < m_Workers; id++) {
+			std::stringstream	labels;
+
+			labels << "worker=\"" << id << "\"";
+			appendSummary(body, E_METRICS::LOOP_NAMES[kind], labels.str(), loopStats(id).m_Histograms[kind], kind != E_METRICS::EVENTS);
+		}
+	}
+	appendHeader(body, "webserv_loop_busy_ratio", "Share of the previous second the event loop spent running handlers.", "gauge");
+	for (unsigned int id = 0; id < m_Workers; id++) {
+		const LoopStats&	stats = loopStats(id);
+		const unsigned long	workerSecond = stats.m_Second;
+		unsigned long		busy = 0;
+		unsigned long		idle = 0;
+
+		if (workerSecond == second) {
+			busy = stats.m_LastSecondBusy;
+			idle = stats.m_LastSecondIdle;
+		} else if (workerSecond + 1 == second) {
+			busy = stats.m_SecondBusy;
+			idle = stats.m_SecondIdle;
+		}
+		body << "webserv_loop_busy_ratio{worker=\"" << id << "\"} " << std::fixed << std::setprecision(3)
+			 << (busy + idle != 0 ? static_cast<double>(busy) / (busy + idle) : 0.0) << "\n";
+		body.unsetf(std::ios::floatfield);
+	}
+	appendHeader(body, "webserv_loop_busy_seconds_total", "Time the event loop spent running handlers.", "counter");
+	for (unsigned int id = 0; id < m_Workers; id++) {
+		body << "webserv_loop_busy_seconds_total{worker=\"" << id << "\"} ";
+		appendSeconds(body, loopStats(id).m_Busy);
+		body << "\n";
+	}
+	appendHeader(body, "webserv_loop_idle_seconds_total", "Time the event loop spent waiting in kevent().", "counter");
+	for (unsigned int id = 0; id < m_Workers; id++) {
+		body << "webserv_loop_idle_seconds_total{worker=\"" << id << "\"} ";
+		appendSeconds(body, loopStats(id).m_Idle);
+		body << "\n";
+	}
+	return (body.str());
+}
+
+LoopStats&	Metrics::loopStats(const unsigned int& id) {
+	return (*reinterpret_cast<LoopStats*>(m_WorkerAreas + id * m_WorkerStride));
+}
+
+Histogram*	Metrics::routeHistograms(const unsigned int& id) {
+	return (reinterpret_cast<Histogram*>(m_WorkerAreas + id * m_WorkerStride + sizeof(LoopStats)));
+}
+
+/**
+ *			setup
+ */
+
+static std::string	labelValue(const std::string& value) {
+	std::string	out;
+
+	for (std::string::const_iterator it = value.begin(); it != value.end(); ++it) {
+		if (*it == '"' || *it == '\\') {
+			out += '\\';
+		}
+		out += *it;
+	}
+	return (out);
+}
+
+void	Metrics::addRoute(const void* block, const std::string& server, const std::string& location) {
+	if (m_Routes.insert(std::make_pair(block, m_RouteLabels.size())).second) {
+		m_RouteLabels.push_back("server=\"" + labelValue(server) + "\",location=\"" + labelValue(location) + "\"");
+	}
+}
+
+/**
+ * @brief	첫 server_name (없으면 listen IP) 과 port
+ */
+const std::string	Metrics::serverLabel(const CONF::ServerBlock& server) {
+	const std::set<std::string>&	names = server.getServerNames();
+	std::stringstream				label;
+
+	label << (names.empty() ? server.getIP() : *names.begin()) << ":" << server.getPort();
+	return (label.str());
+}
+
+void	Metrics::prepareServer(const CONF::ServerBlock& server, void*) {
+	addRoute(&server, serverLabel(server), "");
+}
+
+void	Metrics::prepareLocation(const CONF::ServerBlock& server, const CONF::LocationBlock& location, const std::string& name, void*) {
+	addRoute(&location, serverLabel(server), name);
+}
+
+void	Metrics::findMetrics(const CONF::ServerBlock&, const CONF::LocationBlock& location, const std::string&, void* context) {
+	*static_cast<bool*>(context) |= location.getMetrics();
+}
+
+/**
+ * @brief	server / location 블록마다 route 번호를 매기고, worker 수만큼 자리를 만든다. (master, fork 전. ShmZone::prepare 뒤에)
+ * @details	metrics location 이 하나도 없으면 읽을 곳이 없으므로 route histogram 은 만들지도 세지도 않는다.
+ */
+void	Metrics::prepare(const CONF::MainBlock& mainBlock) {
+	bool	enabled = false;
+
+	mainBlock.getHTTPBlock().visitLocations(NULL, findMetrics, &enabled);
+	if (enabled) {
+		mainBlock.getHTTPBlock().visitLocations(prepareServer, prepareLocation, NULL);
+	}
+	m_Workers = mainBlock.getWorkerProcess();
+	m_WorkerStride = (sizeof(LoopStats) + m_RouteLabels.size() * E_METRICS::LATENCY_COUNT * sizeof(Histogram) + E_SHM_ZONE::CACHE_LINE - 1)
+		/ E_SHM_ZONE::CACHE_LINE * E_SHM_ZONE::CACHE_LINE;
+	m_Zone = &ShmZone::create("metrics", ShmZone::maxSize(), m_Workers * (sizeof(WorkerSlot) + m_WorkerStride));
+	m_Slots = static_cast<WorkerSlot*>(m_Zone->data());
+	m_WorkerAreas = reinterpret_cast<char*>(m_Slots + m_Workers);
+}
+
+/**
+ * @brief	worker id 의 자리에 세기 시작한다. (worker, fork 뒤)
+ */
+void	Metrics::attach(const unsigned int& id) {
+	if (id < m_Workers) {
+		m_Mine = &m_Slots[id].m_Counters;
+		m_MyLoop = &loopStats(id);
+		m_MyHistograms = m_RouteLabels.empty() ? NULL : routeHistograms(id);
+	}
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include "../Shm/ShmZone.hpp"
+#include "Histogram.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace E_METRICS {
+	enum E_PHASE {
+		CLOSED = 0,
+		WAITING,
+		READING,
+		WRITING
+	};
+
+	enum E_LATENCY {
+		TOTAL = 0,
+		FIRST_BYTE,
+		UPSTREAM,
+		LATENCY_COUNT
+	};
+
+	// E_LATENCY 순서 그대로
+	const char* const	LATENCY_NAMES[] = { "webserv_request_seconds", "webserv_first_byte_seconds", "webserv_upstream_seconds" };
+	const char* const	LATENCY_HELP[] = {
+		"Time from the first request byte to the end of the response.",
+		"Time from the first request byte to the first response byte.",
+		"Time from starting the upstream (proxy / CGI / FastCGI) to the end of the response."
+	};
+	enum E_LOOP {
+		ITERATION = 0,
+		EVENTS,
+		TIMER_LATENESS,
+		LOOP_COUNT
+	};
+
+	// E_LOOP 순서 그대로
+	const char* const	LOOP_NAMES[] = { "webserv_loop_iteration_seconds", "webserv_loop_events", "webserv_loop_timer_lateness_seconds" };
+	const char* const	LOOP_HELP[] = {
+		"Time one event loop iteration spent running handlers (not waiting in kevent).",
+		"Number of events handled by one event loop iteration.",
+		"Delay between a timer deadline and the moment its handler ran."
+	};
+	const double		QUANTILES[] = { 0.5, 0.9, 0.99, 0.999 };
+	const std::size_t	QUANTILE_COUNT = sizeof(QUANTILES) / sizeof(QUANTILES[0]);
+}
+
+namespace E_TIMING {
+	enum E_MARK {
+		ACCEPT = 0,
+		START,
+		HEADER_PARSED,
+		LOCATION_MATCHED,
+		FILE_OPENED,
+		UPSTREAM_START,
+		FIRST_SENT,
+		DONE,
+		MARK_COUNT
+	};
+}
+
+/**
+ * @brief	request 하나의 단계별 시각 (EventLoop::monotonic, µs). 0 이면 그 단계를 지나지 않았다.
+ * @details	mark 는 처음 한 번만 남는다. (proxy 를 다시 시도해도 UPSTREAM_START 는 첫 시도)
+ *			ACCEPT 는 connection 의 첫 request 에만 있다. (keep-alive 의 다음 request 는 START 부터)
+ */
+struct RequestTiming {
+	unsigned long	m_At[E_TIMING::MARK_COUNT];
+
+	RequestTiming();
+
+	void	mark(const E_TIMING::E_MARK& which);
+	void	clear();
+};
+
+/**
+ * @brief	worker 하나의 counter. 그 worker 만 쓴다.
+ * @details	m_Reading / m_Writing / m_Waiting 은 지금 그 상태인 connection 수 (gauge) 이다.
+ *			m_Second 초 동안의 요청 수가 m_SecondRequests, 바로 앞 초가 m_LastSecondRequests 이다.
+ */
+struct WorkerCounters {
+	volatile unsigned long	m_Accepted;
+	volatile unsigned long	m_Handled;
+	volatile unsigned long	m_Requests;
+	volatile unsigned long	m_Reading;
+	volatile unsigned long	m_Writing;
+	volatile unsigned long	m_Waiting;
+	volatile unsigned long	m_Second;
+	volatile unsigned long	m_SecondRequests;
+	volatile unsigned long	m_LastSecondRequests;
+};
+
+/**
+ * @brief	worker 하나의 event loop 통계. 그 worker 만 쓴다.
+ * @details	m_Busy / m_Idle 은 handler 를 돌린 시간과 kevent() 에서 기다린 시간의 합 (µs) 이다.
+ *			m_Second 초 동안의 값이 m_SecondBusy / m_SecondIdle, 바로 앞 초가 m_LastSecondBusy / m_LastSecondIdle 이다. (busy ratio)
+ */
+struct LoopStats {
+	Histogram				m_Histograms[E_METRICS::LOOP_COUNT];
+	volatile unsigned long	m_Busy;
+	volatile unsigned long	m_Idle;
+	volatile unsigned long	m_Second;
+	volatile unsigned long	m_SecondBusy;
+	volatile unsigned long	m_SecondIdle;
+	volatile unsigned long	m_LastSecondBusy;
+	volatile unsigned long	m_LastSecondIdle;
+};
+
+/**
+ * @brief	worker 마다 cache line 단위로 떨어진 자리. (다른 worker 의 counter 와 같은 line 을 쓰지 않는다)
+ */
+union WorkerSlot {
+	WorkerCounters	m_Counters;
+	char			m_Pad[(sizeof(WorkerCounters) + E_SHM_ZONE::CACHE_LINE - 1) / E_SHM_ZONE::CACHE_LINE * E_SHM_ZONE::CACHE_LINE];
+};
+
+/**
+ * @brief	connection / request counter (stub_status) 와 route 별 latency histogram, event loop 통계 (metrics)
+ * @details	fork 전에 ShmZone "metrics" 의 reserve 영역에 worker 수만큼 WorkerSlot 을 두고,
+ *			그 뒤에 worker 마다 [LoopStats][route histogram ...] 자리 (m_WorkerStride byte) 를 둔다.
+ *			worker 는 자기 자리 (attach) 만 lock / atomic 없이 더하고, 읽는 쪽 (stub_status) 이 모든 자리를 더한다.
+ *			읽는 동안 다른 worker 가 바꾸고 있어도 한두 개 어긋날 뿐 틀린 값이 쌓이지는 않는다.
+ *			- connection 상태: accept 하면 WAITING, request 의 첫 byte 부터 header 끝까지 READING,
+ *			  응답이 끝날 때까지 WRITING, keep-alive 로 다음 request 를 기다리면 다시 WAITING.
+ *			- route 는 server 블록과 location 블록 하나하나이다. (prepare 에서 번호를 매긴다. metrics location 이 없으면 route 도 없다)
+ *			  응답이 끝나면 location 과 server 두 route 에 E_LATENCY 별로 하나씩 넣는다. 평균 대신 p99 / p999 를 보기 위해서다.
+ *			  worker 의 histogram 자리는 cache line 단위로 떨어져 있고, metrics 가 읽을 때 worker 들을 더한다.
+ *			- event loop 통계는 worker 마다 따로 보인다. (한 worker 만 CPU 에 묶이거나 막혀도 알 수 있게)
+ *			  busy ratio 는 바로 앞 1초 동안 handler 를 돌린 시간의 비율이다. 1 에 가까우면 그 worker 는 포화 상태다.
+ *			- attach 전 (master) 에는 m_Local 에 센다. (hot path 에 NULL 검사를 두지 않는다)
+ */
+class Metrics {
+private:
+	static ShmZone*			m_Zone;
+	static WorkerSlot*		m_Slots;
+	static unsigned int		m_Workers;
+	static WorkerCounters	m_Local;
+	static WorkerCounters*	m_Mine;
+
+	typedef std::map<const void*, unsigned int>	routeMap;
+
+	static routeMap					m_Routes;
+	static std::vector<std::string>	m_RouteLabels;
+	static std::size_t				m_WorkerStride;
+	static char*					m_WorkerAreas;
+	static LoopStats*				m_MyLoop;
+	static Histogram*				m_MyHistograms;
+
+	Metrics();
+	Metrics(const Metrics& other);
+	Metrics& operator=(const Metrics& other);
+	~Metrics();
+
+	static volatile unsigned long*	gauge(const unsigned char& phase);
+	static LoopStats&				loopStats(const unsigned int& id);
+	static Histogram*				routeHistograms(const unsigned int& id);
+	static void						record(const void* block, const RequestTiming& timing);
+	static void						addRoute(const void* block, const std::string& server, const std::string& location);
+	static const std::string		serverLabel(const CONF::ServerBlock& server);
+	static void						prepareServer(const CONF::ServerBlock& server, void* context);
+	static void						prepareLocation(const CONF::ServerBlock& server, const CONF::LocationBlock& location, const std::string& name, void* context);
+	static void						findMetrics(const CONF::ServerBlock& server, const CONF::LocationBlock& location, const std::string& name, void* context);
+
+public:
+	static void			prepare(const CONF::MainBlock& mainBlock);
+	static void			attach(const unsigned int& id);
+
+	static void			accept(unsigned char& phase);
+	static void			move(unsigned char& phase, const unsigned char& next);
+	static void			request();
+	static void			observe(const CONF::ServerBlock* server, const CONF::LocationBlock* location, const RequestTiming& timing);
+	static void			loop(const unsigned long& busy, const unsigned long& idle, const unsigned int& events);
+	static void			timer(const unsigned long& lateness);
+
+	static std::string	stubStatus();
+	static std::string	scrape();
+};
@@ -1,13 +1,17 @@
 #include "AConfParser.hpp"
 #include "ConfParserUtils.hpp"
 #include "Exception/ConfParserException.hpp"
+#include <cctype>
 #include <cstddef>
+#include <cstdlib>
 #include <string>
 
 // TODO: delete
 #include <iostream>
 
 std::stack<unsigned char> CONF::AConfParser::m_BlockStack;
+std::vector<std::string> CONF::AConfParser::m_LogPaths;
+std::vector<std::string> CONF::AConfParser::m_LogFormats;
 
 CONF::AConfParser::AConfParser() {}
 
@@ -16,13 +20,13 @@ CONF::AConfParser::~AConfParser() {}
 /**
  *		Common Util Parser
 */
-bool	CONF::AConfParser::isMultipleDirective(const unsigned char& block_status, const unsigned short& directive_status) {
+bool	CONF::AConfParser::isMultipleDirective(const unsigned char& block_status, const unsigned int& directive_status) {
 	switch (block_status) {
 		case CONF::E_BLOCK_STATUS::MAIN: {
 			return (directive_status & CONF::E_MAIN_BLOCK_STATUS::ENV) ? true : false;
 		}
 		case CONF::E_BLOCK_STATUS::HTTP: {
-			return ((directive_status & E_HTTP_BLOCK_STATUS::SERVER || directive_status & E_HTTP_BLOCK_STATUS::INCLUDE) ? true : false);
+			return ((directive_status & E_HTTP_BLOCK_STATUS::SERVER || directive_status & E_HTTP_BLOCK_STATUS::INCLUDE || directive_status & E_HTTP_BLOCK_STATUS::UPSTREAM || directive_status & E_HTTP_BLOCK_STATUS::PROXY_CACHE_PATH || directive_status & E_HTTP_BLOCK_STATUS::MICROCACHE_ZONE || directive_status & E_HTTP_BLOCK_STATUS::SHM_ZONE || directive_status & E_HTTP_BLOCK_STATUS::LOG_FORMAT) ? true : false);
 		}
 		case CONF::E_BLOCK_STATUS::SERVER: {
 			return (directive_status & CONF::E_SERVER_BLOCK_STATUS::LOCATION) ? true : false;
@@ -30,6 +34,9 @@ bool	CONF::AConfParser::isMultipleDirective(const unsigned char& block_status, c
 		case CONF::E_BLOCK_STATUS::LOCATION: {
 			return (directive_status & CONF::E_LOCATION_BLOCK_STATUS::LOCATION) ? true : false;
 		}
+		case CONF::E_BLOCK_STATUS::UPSTREAM: {
+			return (directive_status & CONF::E_UPSTREAM_BLOCK_STATUS::SERVER) ? true : false;
+		}
 		default:
 			return false;
 	}
@@ -108,6 +115,61 @@ void	CONF::AConfParser::errorPageArgumentParser(std::string& argument) {
 }
 
 
+void	CONF::AConfParser::urlArgumentParser(std::string& argument) {
+	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
+	std::size_t*				Pos = CONF::ConfFile::getInstance()->Pos();
+
+	const std::size_t		startFilePos = Pos[E_INDEX::FILE];
+
+	argument.clear();
+	URIParser::errorPageParser<ConfParserException>(fileContent, Pos[E_INDEX::FILE], argument) ?
+	Pos[E_INDEX::COLUMN] += ((Pos[E_INDEX::FILE]) - startFilePos) : throw ConfParserException("", "not URL");
+}
+
+/**
+ * @brief	시간 인자를 millisecond 로 바꾼다. 단위가 없으면 초. (e.g. 500ms, 60s, 60, 2m)
+ */
+unsigned int	CONF::AConfParser::timeArgumentChecker(const std::string& argument) {
+	char*		endptr;
+	const long	number = std::strtol(argument.c_str(), &endptr, 10);
+	const std::string	unit(endptr);
+
+	if (argument.empty() || !std::isdigit(static_cast<int>(argument[0])) || number < 0 || argument.size() > 9) {
+		throw ConfParserException(argument, "is invalid time argument!");
+	}
+	if (unit == "ms") {
+		return (static_cast<unsigned int>(number));
+	} else if (unit.empty() || unit == "s") {
+		return (static_cast<unsigned int>(number * 1000));
+	} else if (unit == "m") {
+		return (static_cast<unsigned int>(number * 60 * 1000));
+	}
+	throw ConfParserException(argument, "is invalid time unit!");
+}
+
+/**
+ * @brief	크기 인자를 byte 로 바꾼다. 단위가 없으면 byte. (e.g. 512k, 10m, 1g)
+ */
+std::size_t	CONF::AConfParser::sizeArgumentChecker(const std::string& argument) {
+	char*		endptr;
+	const long	number = std::strtol(argument.c_str(), &endptr, 10);
+	const std::string	unit(endptr);
+
+	if (argument.empty() || !std::isdigit(static_cast<int>(argument[0])) || number < 0 || argument.size() > 9) {
+		throw ConfParserException(argument, "is invalid size argument!");
+	}
+	if (unit.empty()) {
+		return (static_cast<std::size_t>(number));
+	} else if (unit == "k" || unit == "K") {
+		return (static_cast<std::size_t>(number) << 10);
+	} else if (unit == "m" || unit == "M") {
+		return (static_cast<std::size_t>(number) << 20);
+	} else if (unit == "g" || unit == "G") {
+		return (static_cast<std::size_t>(number) << 30);
+	}
+	throw ConfParserException(argument, "is invalid size unit!");
+}
+
 void	CONF::AConfParser::errorPageChecker(const std::vector<std::string>& args, errorPageMap& errorMap) {
 	const std::size_t	argumentSize = args.size();
 
@@ -118,20 +180,18 @@ void	CONF::AConfParser::errorPageChecker(const std::vector<std::string>& args, e
 
 	(args[argumentSize - 2].empty()) ? throw ConfParserException("", "invalid error page arguments!") : 0;
 	const char&			startSymbol = args[argumentSize - 2][0];
+	// named location 이 없으므로 "@name" 으로 internal redirect 할 곳이 없다.
+	(path[0] == '@') ? throw ConfParserException(path, "is not supported error page (named location)!") : 0;
 	CONF::errorPageData	data;
-	if (path[0] == '@') {
+	if (std::isdigit(static_cast<int>(startSymbol))) {
+		data.m_Type = E_ERRORPAGE::DEFAULT;
+	} else if (startSymbol == BNF::E_RESERVED::EQUALS) {
 		data.m_Type = E_ERRORPAGE::REPLACE;
+		char*	ptr;
+		const short replaceCode = strtol(args[argumentSize - 2].c_str() + 1, &ptr, 10);
+		(*ptr != '\0' || replaceCode < 0 || replaceCode > 599) ? throw ConfParserException(args[argumentSize - 2], "is invalid error page replace arguments!") : data.m_Replace = replaceCode;
 	} else {
-		if (std::isdigit(static_cast<int>(startSymbol))) {
-			data.m_Type = E_ERRORPAGE::DEFAULT;
-		} else if (startSymbol == BNF::E_RESERVED::EQUALS) {
-			data.m_Type = E_ERRORPAGE::REPLACE;
-			char*	ptr;
-			const short replaceCode = strtol(args[argumentSize - 2].c_str() + 1, &ptr, 10);
-			(*ptr != '\0' || replaceCode < 0 || replaceCode > 599) ? throw ConfParserException(args[argumentSize - 2], "is invalid error page replace arguments!") : data.m_Replace = replaceCode;
-		} else {
-			throw ConfParserException(args[argumentSize - 2], "is invalid error page arguments!");
-		}
+		throw ConfParserException(args[argumentSize - 2], "is invalid error page arguments!");
 	}
 	data.m_Path = path;
 	const std::size_t	lastArgument = (data.m_Type > 1) ? 2 : 1;
@@ -144,6 +204,101 @@ void	CONF::AConfParser::errorPageChecker(const std::vector<std::string>& args, e
 	}
 }
 
+/**
+ * @brief	access_log path [format] [buffer=size] [flush=time]; / access_log off;
+ * @details	상위 블록에서 물려받은 값을 통째로 바꾼다.
+ */
+void	CONF::AConfParser::accessLogChecker(const std::vector<std::string>& args, accessLogData& accessLog) {
+	accessLogData	data;
+	bool			sampled = false;
+
+	if (args.empty() || args[0].empty()) {
+		throw ConfParserException("", "invalid number of Access Log arguments!");
+	}
+	if (args[0] == "off") {
+		(args.size() != 1) ? throw ConfParserException(args[1], "access_log off takes no parameter!") : 0;
+		accessLog = data;
+		return ;
+	}
+	data.m_Path = args[0];
+	for (std::size_t i = 1; i < args.size(); i++) {
+		if (args[i].compare(0, 7, "buffer=") == 0) {
+			data.m_Buffer = sizeArgumentChecker(args[i].substr(7));
+		} else if (args[i].compare(0, 6, "flush=") == 0) {
+			data.m_Flush = timeArgumentChecker(args[i].substr(6));
+		} else if (args[i].compare(0, 9, "sample=1/") == 0) {
+			const std::string	rate = args[i].substr(9);
+			if (rate.empty() || rate.size() > 9 || rate.find_first_not_of("0123456789") != std::string::npos || std::atoi(rate.c_str()) < 1) {
+				throw ConfParserException(args[i], "is invalid Access Log sample rate!");
+			}
+			data.m_Sample = std::atoi(rate.c_str());
+			sampled = true;
+		} else if (args[i].compare(0, 15, "if_slower_than=") == 0) {
+			const std::string	threshold = args[i].substr(15);
+			// 단위가 없으면 ms (timeArgumentChecker 는 초로 읽는다)
+			data.m_SlowerThan = (!threshold.empty() && threshold.find_first_not_of("0123456789") == std::string::npos)
+				? timeArgumentChecker(threshold + "ms") : timeArgumentChecker(threshold);
+		} else if (i == 1 && args[i].find('=') == std::string::npos) {
+			data.m_Format = args[i];
+		} else {
+			throw ConfParserException(args[i], "is invalid Access Log parameter!");
+		}
+	}
+	if (data.m_Flush != 0 && data.m_Buffer == 0) {
+		data.m_Buffer = E_ACCESS_LOG_DATA::DEFAULT_BUFFER;
+	}
+	if (data.m_Buffer != 0 && data.m_Flush == 0) {
+		data.m_Flush = E_ACCESS_LOG_DATA::DEFAULT_FLUSH;
+	}
+	if (data.m_SlowerThan != 0 && !sampled) {
+		data.m_Sample = 0;
+	}
+	data.m_File = intern(m_LogPaths, data.m_Path);
+	data.m_Binary = (data.m_Format == E_ACCESS_LOG_DATA::BINARY);
+	if (!data.m_Binary) {
+		data.m_FormatIndex = intern(m_LogFormats, data.m_Format);
+	}
+	accessLog = data;
+}
+
+/**
+ * @brief	slow_request_log path threshold; (threshold 는 단위가 없으면 ms)
+ * @details	http 에 두면 server 가 물려받고, server 에 두면 그 server 만 바꾼다.
+ */
+void	CONF::AConfParser::slowRequestLogChecker(const std::vector<std::string>& args, slowRequestLogData& slowRequestLog) {
+	if (args.size() != 2 || args[0].empty() || args[1].empty()) {
+		throw ConfParserException(args.empty() ? "" : args[0], "invalid number of Slow Request Log arguments!");
+	}
+	slowRequestLog.m_Path = args[0];
+	slowRequestLog.m_Threshold = (args[1].find_first_not_of("0123456789") == std::string::npos)
+		? timeArgumentChecker(args[1] + "ms") : timeArgumentChecker(args[1]);
+	slowRequestLog.m_File = intern(m_LogPaths, slowRequestLog.m_Path);
+}
+
+/**
+ * @brief	table 에 value 가 없으면 뒤에 넣는다.
+ * @details	log path 와 log_format 이름은 읽을 때 번호로 바꿔 둔다. vhost 가 수천 개여도 같은 path 는 번호 하나 (worker 마다 fd 하나) 다.
+ *			log_format 은 access_log 보다 뒤에 정의되어도 되므로, 이름이 실제로 있는지는 fork 전에 (AccessLog::prepare) 본다.
+ * @return	value 의 번호
+ */
+unsigned int	CONF::AConfParser::intern(std::vector<std::string>& table, const std::string& value) {
+	for (std::size_t i = 0; i < table.size(); i++) {
+		if (table[i] == value) {
+			return (i);
+		}
+	}
+	table.push_back(value);
+	return (table.size() - 1);
+}
+
+const std::vector<std::string>&	CONF::AConfParser::getLogPaths() {
+	return (m_LogPaths);
+}
+
+const std::vector<std::string>&	CONF::AConfParser::getLogFormats() {
+	return (m_LogFormats);
+}
+
 void	CONF::AConfParser::argumentParser(std::string& argument) {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
 	const std::size_t&	fileSize = CONF::ConfFile::getInstance()->getFileSize();
@@ -161,12 +316,64 @@ void	CONF::AConfParser::argumentParser(std::string& argument) {
 	}
 }
 
+/**
+ * @brief	'...' 또는 "..." 이면 따옴표 안을 그대로 (공백 포함) 읽고, 아니면 rawArgumentParser 와 같다.
+ * @details	따옴표가 같은 줄에서 닫히지 않으면 잘못된 설정이다.
+ */
+void	CONF::AConfParser::quotedArgumentParser(std::string& argument) {
+	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
+	const std::size_t&	fileSize = CONF::ConfFile::getInstance()->getFileSize();
+	std::size_t*		Pos = CONF::ConfFile::getInstance()->Pos();
+
+	if (Pos[E_INDEX::FILE] >= fileSize || (fileContent[Pos[E_INDEX::FILE]] != '\'' && fileContent[Pos[E_INDEX::FILE]] != '"')) {
+		rawArgumentParser(argument);
+		return ;
+	}
+	const char	quote = fileContent[Pos[E_INDEX::FILE]];
+
+	Pos[E_INDEX::FILE]++;
+	Pos[E_INDEX::COLUMN]++;
+	while (Pos[E_INDEX::FILE] < fileSize && fileContent[Pos[E_INDEX::FILE]] != quote) {
+		if (ABNF::isLF(fileContent, Pos[E_INDEX::FILE])) {
+			throw ConfParserException(argument, "unterminated quoted argument!");
+		}
+		argument += fileContent[Pos[E_INDEX::FILE]];
+		Pos[E_INDEX::FILE]++;
+		Pos[E_INDEX::COLUMN]++;
+	}
+	if (Pos[E_INDEX::FILE] >= fileSize) {
+		throw ConfParserException(argument, "unterminated quoted argument!");
+	}
+	Pos[E_INDEX::FILE]++;
+	Pos[E_INDEX::COLUMN]++;
+}
+
+/**
+ * @brief	argumentParser 와 같지만 대소문자를 그대로 둔다. (upstream 주소, unix socket 경로)
+ */
+void	CONF::AConfParser::rawArgumentParser(std::string& argument) {
+	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
+	const std::size_t&	fileSize = CONF::ConfFile::getInstance()->getFileSize();
+	std::size_t*		Pos = CONF::ConfFile::getInstance()->Pos();
+
+	while (Pos[E_INDEX::FILE] < fileSize
+			&& !ABNF::isWSP(fileContent, Pos[E_INDEX::FILE])
+			&& !ABNF::isLF(fileContent, Pos[E_INDEX::FILE])
+			&& fileContent[Pos[E_INDEX::FILE]] != E_ABNF::SEMICOLON
+			&& fileContent[Pos[E_INDEX::FILE]] != E_CONF::LBRACE
+			&& fileContent[Pos[E_INDEX::FILE]] != E_CONF::RBRACE) {
+		argument += fileContent[Pos[E_INDEX::FILE]];
+		Pos[E_INDEX::FILE]++;
+		Pos[E_INDEX::COLUMN]++;
+	}
+}
+
 
 
 /**
  *			Common Config Parsing functions
 */
-unsigned short	CONF::AConfParser::directiveName() {
+unsigned int	CONF::AConfParser::directiveName() {
 	std::string	name;
 
 	argumentParser(name);
@@ -181,7 +388,7 @@ bool	CONF::AConfParser::directives() {
 	if (fileContent[Pos[E_INDEX::FILE]] == E_CONF::RBRACE) {
 		return (false);
 	}
-	const unsigned short&		status = directiveName();
+	const unsigned int&			status = directiveName();
 
 	std::vector<std::string>	args;
 	while (Pos[E_INDEX::FILE] < fileSize
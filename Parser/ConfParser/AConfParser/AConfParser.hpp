@@ -3,13 +3,16 @@
 #include "../../ABNF_utils/ABNFFunctions.hpp"
 #include "../../PathParser/PathParser.hpp"
 #include "../../URIParser/URIParser.hpp"
+#include "../ConfData/accessLogData/accessLogData.hpp"
 #include "../ConfData/errorPageData/errorPageData.hpp"
+#include "../ConfData/slowRequestLogData/slowRequestLogData.hpp"
 
 #include "../ConfFile/ConfFile.hpp"
 #include "Exception/ConfParserException.hpp"
 #include "ConfParserUtils.hpp"
 #include <stack>
 #include <string>
+#include <vector>
 
 namespace	E_CONF {
 	enum E_CONF {
@@ -26,9 +29,13 @@ namespace CONF {
 		typedef std::map<unsigned short, errorPageData>	errorPageMap;
 
 		static std::stack<unsigned char>	m_BlockStack;
+		static std::vector<std::string>		m_LogPaths;
+		static std::vector<std::string>		m_LogFormats;
+
+		static unsigned int	intern(std::vector<std::string>& table, const std::string& value);
 
 		// common util functions
-		bool		isMultipleDirective(const unsigned char& block_status, const unsigned short& directive_status);
+		bool		isMultipleDirective(const unsigned char& block_status, const unsigned int& directive_status);
 		bool		stringPathArgumentParser(std::string& argument);
 		bool		absPathArgumentParser(std::string& argument);
 		bool		digitArgumentParser(std::string& argument);
@@ -36,7 +43,14 @@ namespace CONF {
 		void		fileName(std::string& argument);
 		void		errorPageArgumentParser(std::string& argument);
 		void		errorPageChecker(const std::vector<std::string>& args, errorPageMap& errorMap);
+		void		accessLogChecker(const std::vector<std::string>& args, accessLogData& accessLog);
+		void		slowRequestLogChecker(const std::vector<std::string>& args, slowRequestLogData& slowRequestLog);
 		void		argumentParser(std::string& argument);
+		void		rawArgumentParser(std::string& argument);
+		void		quotedArgumentParser(std::string& argument);
+		void		urlArgumentParser(std::string& argument);
+		unsigned int	timeArgumentChecker(const std::string& argument);
+		std::size_t		sizeArgumentChecker(const std::string& argument);
 
 		void		handleHtabSpace(const char& c);
 
@@ -44,14 +58,14 @@ namespace CONF {
 		// common parsing functions
 		bool						contextLines();
 		bool						directives();
-		virtual unsigned short		directiveName();
+		virtual unsigned int		directiveName();
 
 		// virtual functions
 		virtual bool				context() = 0;
-		virtual unsigned short		directiveNameChecker(const std::string& name) = 0;
+		virtual unsigned int		directiveNameChecker(const std::string& name) = 0;
 
-		virtual const std::string	argument(const unsigned short& status) = 0;
-		virtual bool				argumentChecker(const std::vector<std::string>& args, const unsigned short& status) = 0;
+		virtual const std::string	argument(const unsigned int& status) = 0;
+		virtual bool				argumentChecker(const std::vector<std::string>& args, const unsigned int& status) = 0;
 
 
 	private:
@@ -63,5 +77,8 @@ namespace CONF {
 		virtual ~AConfParser();
 
 		virtual void					initialize() = 0;
+
+		static const std::vector<std::string>&	getLogPaths();
+		static const std::vector<std::string>&	getLogFormats();
 	};
 }
\ No newline at end of file
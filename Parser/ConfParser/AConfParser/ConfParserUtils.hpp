@@ -10,6 +10,7 @@ namespace   CONF {
 	 *  0b				  100 = http
 	 *  0b				 1000 = server
 	 *  0b			   1 0000 = location
+	 *  0b			  10 0000 = upstream
 	*/
 	namespace   E_BLOCK_STATUS {
 		enum E_BLOCK_STATUS {
@@ -18,6 +19,7 @@ namespace   CONF {
 			HTTP			= 0b00000100,
 			SERVER			= 0b00001000,
 			LOCATION		= 0b00010000,
+			UPSTREAM		= 0b00100000,
 		};
 	}
 
@@ -55,7 +57,7 @@ namespace   CONF {
 
 	/**
 	* @brief	HTTP Block Status
-	* @details unsigned short : 2 byte
+	* @details unsigned int : 4 byte
 	*  
 	*	0b		  	 		 1 = root
 	*	0b		     		10 = index
@@ -65,7 +67,15 @@ namespace   CONF {
 	*	0b			   10 0000 = keepalive_timeout
 	*	0b	  		  100 0000 = include
 	*	0b	 		 1000 0000 = default_type
+	*	0b	 	   1 0000 0000 = upstream
+	*	0b	 	  10 0000 0000 = proxy_cache_path
+	*	0b		 100 0000 0000 = microcache_zone
+	*	0b		1000 0000 0000 = file_cache
+	*	0b	  1 0000 0000 0000 = shm_zone
+	*	0b	 10 0000 0000 0000 = log_format
+	*	0b	100 0000 0000 0000 = request_trace
 	* 	0b 1000 0000 0000 0000 = server
+	* 	0b 1 0000 0000 0000 0000 = slow_request_log
 	*/
 	namespace   E_HTTP_BLOCK_STATUS {
 		enum E_HTTP_BLOCK_STATUS {
@@ -77,13 +87,21 @@ namespace   CONF {
             KEEPALIVE_TIMEOUT		= 0b00100000,
 			INCLUDE					= 0b01000000,
 			DEFAULT_TYPE			= 0b10000000,
-			SERVER					= 0b1000000000000000
+			UPSTREAM				= 0b100000000,
+			PROXY_CACHE_PATH		= 0b1000000000,
+			MICROCACHE_ZONE			= 0b10000000000,
+			FILE_CACHE				= 0b100000000000,
+			SHM_ZONE				= 0b1000000000000,
+			LOG_FORMAT				= 0b10000000000000,
+			REQUEST_TRACE			= 0b100000000000000,
+			SERVER					= 0b1000000000000000,
+			SLOW_REQUEST_LOG		= 0b10000000000000000
 		};
 	}
 
 	/**
 	* @brief	Server Block Status
-	* @details unsigned short : 2 byte
+	* @details unsigned int : 4 byte
 	*  
 	*	0b			 		 1 = root
 	*	0b  		 		10 = index
@@ -93,6 +111,7 @@ namespace   CONF {
 	*	0b     		   10 0000 = keepalive_timeout
 	*	0b     		  100 0000 = listen
 	*	0b  	     1000 0000 = server_name
+	*	0b  	   1 0000 0000 = slow_request_log
 	*	0b 1000 0000 0000 0000 = location
 	*/
 
@@ -106,21 +125,36 @@ namespace   CONF {
             KEEPALIVE_TIMEOUT		= 0b00100000,
 			LISTEN					= 0b01000000,
 			SERVER_NAME				= 0b10000000,
+			SLOW_REQUEST_LOG		= 0b100000000,
 			LOCATION				= 0b1000000000000000
 		};
 	}
 
 	/**
 	 * @brief	Location Block Status
-	 * @details unsigned char : 1 byte
+	 * @details unsigned int : 4 byte
 	 *
 	 *  0b					 1 = root
 	 *  0b				    10 = index
 	 *  0b				   100 = autoindex
 	 *  0b				  1000 = error_page
 	 *  0b			    1 0000 = access_log
-	 *  0b            100 0000 = cgi
+	 *  0b             10 0000 = cgi
+	 *  0b            100 0000 = cgi_pool
+	 *  0b           1000 0000 = fastcgi_pass
+	 *  0b         1 0000 0000 = proxy_pass
+	 *  0b        10 0000 0000 = proxy_connect_timeout
+	 *  0b       100 0000 0000 = proxy_read_timeout
+	 *  0b      1000 0000 0000 = proxy_cache
+	 *  0b    1 0000 0000 0000 = microcache
+	 *  0b   10 0000 0000 0000 = stub_status
+	 *  0b  100 0000 0000 0000 = metrics
 	 *	0b 1000 0000 0000 0000 = location
+	 *	0b 1 0000 0000 0000 0000 = cgi_read_timeout
+	 *	0b 10 0000 0000 0000 0000 = fastcgi_read_timeout
+	 *	0b 100 0000 0000 0000 0000 = proxy_cache_valid
+	 *	0b 1000 0000 0000 0000 0000 = proxy_cache_lock
+	 *	0b 1 0000 0000 0000 0000 0000 = proxy_cache_lock_timeout
 	*/
 	namespace	E_LOCATION_BLOCK_STATUS {
 		enum E_LOCATION_BLOCK_STATUS {
@@ -130,8 +164,40 @@ namespace   CONF {
 			ERROR_PAGE				= 0b00001000,
 			ACCESS_LOG				= 0b00010000,
 			CGI						= 0b00100000,
-			LOCATION				= 0b1000000000000000
+			CGI_POOL				= 0b01000000,
+			FASTCGI_PASS			= 0b10000000,
+			PROXY_PASS				= 0b100000000,
+			PROXY_CONNECT_TIMEOUT	= 0b1000000000,
+			PROXY_READ_TIMEOUT		= 0b10000000000,
+			PROXY_CACHE				= 0b100000000000,
+			MICROCACHE				= 0b1000000000000,
+			STUB_STATUS				= 0b10000000000000,
+			METRICS					= 0b100000000000000,
+			LOCATION				= 0b1000000000000000,
+			CGI_READ_TIMEOUT		= 0b10000000000000000,
+			FASTCGI_READ_TIMEOUT	= 0b100000000000000000,
+			PROXY_CACHE_VALID		= 0b1000000000000000000,
+			PROXY_CACHE_LOCK		= 0b10000000000000000000,
+			PROXY_CACHE_LOCK_TIMEOUT	= 0b100000000000000000000
 		};
 	
 	}
+
+	/**
+	 * @brief	Upstream Block Status
+	 * @details unsigned int : 4 byte
+	 *
+	 *	0b		 1 = server
+	 *	0b		10 = least_conn
+	 *	0b	   100 = hash
+	 *	0b	  1000 = health_check
+	*/
+	namespace	E_UPSTREAM_BLOCK_STATUS {
+		enum E_UPSTREAM_BLOCK_STATUS {
+			SERVER					= 0b00000001,
+			LEAST_CONN				= 0b00000010,
+			HASH					= 0b00000100,
+			HEALTH_CHECK			= 0b00001000
+		};
+	}
 }
\ No newline at end of file
@@ -67,7 +67,7 @@ void	CONF::ConfBlock::print() {
 	}
 	std::cout << "\t========" << std::endl;
 	std::cout << "\tDefault_type: " << this->m_MainBlock.getHTTPBlock().getDefault_type() << std::endl;
-	std::cout << "\tAccess log: " << this->m_MainBlock.getHTTPBlock().getAccess_log() << std::endl;
+	std::cout << "\tAccess log: " << this->m_MainBlock.getHTTPBlock().getAccess_log().m_Path << std::endl;
 	std::cout << "\tRoot: " << this->m_MainBlock.getHTTPBlock().getRoot() << std::endl;
 	std::cout << "\tAutoindex: " << (this->m_MainBlock.getHTTPBlock().getAutoindex()? "on" : "off") << std::endl;
 	std::cout << "\tIndex: " << this->m_MainBlock.getHTTPBlock().getIndex("index.htmllll") << std::endl;
@@ -84,7 +84,7 @@ void	CONF::ConfBlock::print() {
 	std::cout << tmpServerMap.size() << std::endl;
 	for (auto it = tmpServerMap.begin(); it != tmpServerMap.end(); ++it) {
 		// if (it->second) {
-			std::cout << "\t\tAccess log: " << it->second->getAccess_log() << std::endl;
+			std::cout << "\t\tAccess log: " << it->second->getAccess_log().m_Path << std::endl;
 			std::cout << "\t\tRoot: " << it->second->getRoot() << std::endl;
 			std::cout << "\t\tAutoindex: " << (it->second->getAutoindex() ? "on" : "off") << std::endl;
 			std::cout << "\t\tIndex: " << it->second->getIndex("domain1.com") << std::endl;
@@ -106,7 +106,7 @@ void	CONF::ConfBlock::print() {
 		const std::map<std::string, LocationBlock>& tmpLocationMap = it->second->getLocationMap();
 		for (auto it = tmpLocationMap.begin(); it != tmpLocationMap.end(); ++it) {
 			std::cout << "\t\t\tLocation Name: " << it->first << std::endl;
-			std::cout << "\t\t\t\tAccess log: " << it->second.getAccess_log() << std::endl;
+			std::cout << "\t\t\t\tAccess log: " << it->second.getAccess_log().m_Path << std::endl;
 			std::cout << "\t\t\t\tRoot: " << it->second.getRoot() << std::endl;
 			std::cout << "\t\t\t\tAutoindex: " << (it->second.getAutoindex() ? "on" : "off") << std::endl;
 			std::cout << "\t\t\t\tIndex: " << it->second.getIndex("domain1.com") << std::endl;
@@ -118,7 +118,7 @@ void	CONF::ConfBlock::print() {
 
 			for (auto loc_it = it->second.getLocationBlock().begin(); loc_it != it->second.getLocationBlock().end(); ++loc_it) {
 				std::cout << "\t\t\t\t\tLocation Name: " << loc_it->first << std::endl;
-				std::cout << "\t\t\t\t\t\tAccess log: " << loc_it->second.getAccess_log() << std::endl;
+				std::cout << "\t\t\t\t\t\tAccess log: " << loc_it->second.getAccess_log().m_Path << std::endl;
 				std::cout << "\t\t\t\t\t\tRoot: " << loc_it->second.getRoot() << std::endl;
 				std::cout << "\t\t\t\t\t\tAutoindex: " << (loc_it->second.getAutoindex() ? "on" : "off") << std::endl;
 				std::cout << "\t\t\t\t\t\tIndex: " << loc_it->second.getIndex("domain1.com") << std::endl;
@@ -9,7 +9,7 @@ CONF::EventsBlock::EventsBlock(): m_Status(false), m_Worker_connections(1024) {}
 CONF::EventsBlock::~EventsBlock() {}
 
 
-bool	CONF::EventsBlock::argumentChecker(const std::vector<std::string>& args, const unsigned short& status) {
+bool	CONF::EventsBlock::argumentChecker(const std::vector<std::string>& args, const unsigned int& status) {
 	static_cast<void>(status);
 
 	if (args.size() != 1) {
@@ -28,7 +28,7 @@ bool	CONF::EventsBlock::argumentChecker(const std::vector<std::string>& args, co
 	return (false);
 }
 
-const std::string	CONF::EventsBlock::argument(const unsigned short& status) {
+const std::string	CONF::EventsBlock::argument(const unsigned int& status) {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
 	const std::size_t&		fileSize = CONF::ConfFile::getInstance()->getFileSize();
 	std::size_t*				Pos = CONF::ConfFile::getInstance()->Pos();
@@ -47,7 +47,7 @@ const std::string	CONF::EventsBlock::argument(const unsigned short& status) {
 	return (argument);
 }
 
-unsigned short	CONF::EventsBlock::directiveNameChecker(const std::string& name) {
+unsigned int	CONF::EventsBlock::directiveNameChecker(const std::string& name) {
 	if (name == "worker_connections") {
 		(m_Status & E_EVENTS_BLOCK_STATUS::WORKER_CONNECTIONS) ? throw ConfParserException(name, "events directive is duplicated!") : m_Status |= E_EVENTS_BLOCK_STATUS::WORKER_CONNECTIONS;
 		return (E_EVENTS_BLOCK_STATUS::WORKER_CONNECTIONS);
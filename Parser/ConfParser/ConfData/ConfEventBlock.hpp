@@ -9,10 +9,10 @@ namespace   CONF {
 		EventsBlock& operator=(const EventsBlock& other);
 
 		bool				context();
-		unsigned short	directiveNameChecker(const std::string& name);
+		unsigned int	directiveNameChecker(const std::string& name);
 
-		const std::string		argument(const unsigned short& status);
-		bool					argumentChecker(const std::vector<std::string>& args, const unsigned short& status);
+		const std::string		argument(const unsigned int& status);
+		bool					argumentChecker(const std::vector<std::string>& args, const unsigned int& status);
 
 	public:
 		bool			m_Status;
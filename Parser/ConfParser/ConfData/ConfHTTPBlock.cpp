@@ -1,4 +1,8 @@
 #include "ConfHTTPBlock.hpp"
+#include <cctype>
+#include <cstdlib>
+#include <set>
+#include <stdexcept>
 #include <string>
 #include "../../MIMEParser/MIMEParser.hpp"
 #include "ConfServerBlock.hpp"
@@ -9,7 +13,7 @@
 #include <sys/_types/_size_t.h>
 #include <utility>
 
-std::map<std::string, unsigned short>	CONF::HTTPBlock::m_HTTPStatusMap;
+std::map<std::string, unsigned int>	CONF::HTTPBlock::m_HTTPStatusMap;
 
 CONF::HTTPBlock::HTTPBlock()
 : AConfParser(),
@@ -17,7 +21,12 @@ CONF::HTTPBlock::HTTPBlock()
   m_Status(0),
   m_KeepAliveTime(75),
   m_Default_type("text/plain")
-{}
+{
+	m_File_cache.m_Size = 0;
+	m_File_cache.m_MaxFile = E_FILE_CACHE_DATA::DEFAULT_MAX_FILE;
+	m_File_cache.m_Valid = E_FILE_CACHE_DATA::DEFAULT_VALID;
+	m_Log_format["combined"] = LogFormat(E_LOG_FORMAT::COMBINED);
+}
 
 CONF::HTTPBlock::~HTTPBlock() {
 }
@@ -31,11 +40,19 @@ void	CONF::HTTPBlock::initHTTPStatusMap() {
 	m_HTTPStatusMap["keepalive_timeout"] = E_HTTP_BLOCK_STATUS::KEEPALIVE_TIMEOUT;
 	m_HTTPStatusMap["include"] = E_HTTP_BLOCK_STATUS::INCLUDE;
 	m_HTTPStatusMap["default_type"] = E_HTTP_BLOCK_STATUS::DEFAULT_TYPE;
+	m_HTTPStatusMap["upstream"] = E_HTTP_BLOCK_STATUS::UPSTREAM;
+	m_HTTPStatusMap["proxy_cache_path"] = E_HTTP_BLOCK_STATUS::PROXY_CACHE_PATH;
+	m_HTTPStatusMap["microcache_zone"] = E_HTTP_BLOCK_STATUS::MICROCACHE_ZONE;
+	m_HTTPStatusMap["file_cache"] = E_HTTP_BLOCK_STATUS::FILE_CACHE;
+	m_HTTPStatusMap["shm_zone"] = E_HTTP_BLOCK_STATUS::SHM_ZONE;
+	m_HTTPStatusMap["log_format"] = E_HTTP_BLOCK_STATUS::LOG_FORMAT;
+	m_HTTPStatusMap["request_trace"] = E_HTTP_BLOCK_STATUS::REQUEST_TRACE;
+	m_HTTPStatusMap["slow_request_log"] = E_HTTP_BLOCK_STATUS::SLOW_REQUEST_LOG;
 	m_HTTPStatusMap["server"] = E_HTTP_BLOCK_STATUS::SERVER;
 }
 
 
-bool	CONF::HTTPBlock::argumentChecker(const std::vector<std::string>& args, const unsigned short& status) {
+bool	CONF::HTTPBlock::argumentChecker(const std::vector<std::string>& args, const unsigned int& status) {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
 	const std::size_t&		fileSize = CONF::ConfFile::getInstance()->getFileSize();
 	std::size_t*				Pos = CONF::ConfFile::getInstance()->Pos();
@@ -78,11 +95,7 @@ bool	CONF::HTTPBlock::argumentChecker(const std::vector<std::string>& args, cons
 			return false;
 		}
 		case CONF::E_HTTP_BLOCK_STATUS::ACCESS_LOG: {
-			if (args.size() != 1) {
-				throw ConfParserException(args.at(0), "invalid number of Access Log arguments!");
-			} else {
-				(args[0].empty()) ? throw ConfParserException(args[0], "invalid number of Access Log arguments!") : this->m_Access_log = args[0];
-			}
+			accessLogChecker(args, this->m_Access_log);
 			return false;
 		}
 		case CONF::E_HTTP_BLOCK_STATUS::KEEPALIVE_TIMEOUT: {
@@ -115,17 +128,165 @@ bool	CONF::HTTPBlock::argumentChecker(const std::vector<std::string>& args, cons
 			}
 			return false;
 		}
+		case CONF::E_HTTP_BLOCK_STATUS::UPSTREAM: {
+			if (args.size() != 1 || args[0].empty()) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of Upstream arguments!");
+			}
+			(this->m_Upstream_block.find(args[0]) != this->m_Upstream_block.end()) ? throw ConfParserException(args[0], "upstream is duplicated!") : this->m_UpstreamName = args[0];
+			return true;
+		}
+		case CONF::E_HTTP_BLOCK_STATUS::PROXY_CACHE_PATH: {
+			// proxy_cache_path path [levels=1:2] keys_zone=name:size [max_size=size] [inactive=time];
+			if (args.size() < 2 || args[0].empty()) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of Proxy Cache Path arguments!");
+			}
+			CONF::cachePathData	cachePath;
+			std::string			zone;
+			cachePath.m_Path = args[0];
+			cachePath.m_ZoneSize = 0;
+			cachePath.m_MaxSize = 0;
+			cachePath.m_Inactive = E_CACHE_PATH::DEFAULT_INACTIVE;
+			while (cachePath.m_Path.size() > 1 && cachePath.m_Path[cachePath.m_Path.size() - 1] == '/') {
+				cachePath.m_Path.erase(cachePath.m_Path.size() - 1);
+			}
+			for (std::size_t i = 1; i < args.size(); i++) {
+				if (args[i].compare(0, 7, "levels=") == 0) {
+					std::string	levels = args[i].substr(7);
+					std::size_t	colonPos;
+					do {
+						colonPos = levels.find(':');
+						const std::string	level = levels.substr(0, colonPos);
+						if (level.size() != 1 || level[0] < '1' || level[0] > '2') {
+							throw ConfParserException(args[i], "is invalid Proxy Cache Path levels!");
+						}
+						cachePath.m_Levels.push_back(level[0] - '0');
+						levels.erase(0, (colonPos == std::string::npos) ? colonPos : colonPos + 1);
+					} while (colonPos != std::string::npos);
+					(cachePath.m_Levels.size() > E_CACHE_PATH::MAX_LEVELS) ? throw ConfParserException(args[i], "is invalid Proxy Cache Path levels!") : 0;
+				} else if (args[i].compare(0, 10, "keys_zone=") == 0) {
+					const std::size_t	colonPos = args[i].find(':', 10);
+					if (colonPos == std::string::npos || colonPos == 10) {
+						throw ConfParserException(args[i], "is invalid Proxy Cache Path keys_zone!");
+					}
+					zone = args[i].substr(10, colonPos - 10);
+					for (std::size_t j = 0; j < zone.size(); j++) {
+						zone[j] = std::tolower(zone[j]);
+					}
+					cachePath.m_ZoneSize = sizeArgumentChecker(args[i].substr(colonPos + 1));
+				} else if (args[i].compare(0, 9, "max_size=") == 0) {
+					cachePath.m_MaxSize = sizeArgumentChecker(args[i].substr(9));
+				} else if (args[i].compare(0, 9, "inactive=") == 0) {
+					cachePath.m_Inactive = timeArgumentChecker(args[i].substr(9));
+				} else {
+					throw ConfParserException(args[i], "is invalid Proxy Cache Path parameter!");
+				}
+			}
+			if (zone.empty() || cachePath.m_ZoneSize == 0) {
+				throw ConfParserException(args[0], "proxy_cache_path needs keys_zone=name:size!");
+			}
+			(this->m_Proxy_cache_path.find(zone) != this->m_Proxy_cache_path.end()) ? throw ConfParserException(zone, "cache zone is duplicated!") : 0;
+			this->m_Proxy_cache_path.insert(std::make_pair(zone, cachePath));
+			return false;
+		}
+		case CONF::E_HTTP_BLOCK_STATUS::MICROCACHE_ZONE: {
+			// microcache_zone name:size;
+			const std::size_t	colonPos = (args.size() == 1) ? args[0].find(':') : std::string::npos;
+			if (colonPos == std::string::npos || colonPos == 0) {
+				throw ConfParserException(args.empty() ? "" : args[0], "microcache_zone needs name:size!");
+			}
+			const std::string	zone = args[0].substr(0, colonPos);
+			const std::size_t	size = sizeArgumentChecker(args[0].substr(colonPos + 1));
+			(size == 0) ? throw ConfParserException(args[0], "microcache_zone size must be positive!") : 0;
+			(this->m_Microcache_zone.find(zone) != this->m_Microcache_zone.end()) ? throw ConfParserException(zone, "microcache zone is duplicated!") : 0;
+			this->m_Microcache_zone.insert(std::make_pair(zone, size));
+			return false;
+		}
+		case CONF::E_HTTP_BLOCK_STATUS::FILE_CACHE: {
+			// file_cache size [max_file=size] [valid=time];
+			if (args.empty() || args.size() > 3 || args[0].empty()) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of File Cache arguments!");
+			}
+			this->m_File_cache.m_Size = sizeArgumentChecker(args[0]);
+			for (std::size_t i = 1; i < args.size(); i++) {
+				if (args[i].compare(0, 9, "max_file=") == 0) {
+					this->m_File_cache.m_MaxFile = sizeArgumentChecker(args[i].substr(9));
+				} else if (args[i].compare(0, 6, "valid=") == 0) {
+					this->m_File_cache.m_Valid = timeArgumentChecker(args[i].substr(6));
+				} else {
+					throw ConfParserException(args[i], "is invalid File Cache parameter!");
+				}
+			}
+			return false;
+		}
+		case CONF::E_HTTP_BLOCK_STATUS::SHM_ZONE: {
+			// shm_zone name size;
+			if (args.size() != 2 || args[0].empty()) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of Shm Zone arguments!");
+			}
+			const std::size_t	size = sizeArgumentChecker(args[1]);
+			(size == 0) ? throw ConfParserException(args[1], "shm_zone size must be positive!") : 0;
+			(this->m_Shm_zone.find(args[0]) != this->m_Shm_zone.end()) ? throw ConfParserException(args[0], "shm zone is duplicated!") : 0;
+			this->m_Shm_zone.insert(std::make_pair(args[0], size));
+			return false;
+		}
+		case CONF::E_HTTP_BLOCK_STATUS::LOG_FORMAT: {
+			// log_format name 'string' ...; (따옴표 안의 문자열들을 이어 붙인다)
+			if (args.size() < 2 || args[0].empty()) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of Log Format arguments!");
+			}
+			(this->m_Log_format.find(args[0]) != this->m_Log_format.end()) ? throw ConfParserException(args[0], "log_format is duplicated!") : 0;
+			(args[0] == E_ACCESS_LOG_DATA::BINARY) ? throw ConfParserException(args[0], "log_format name is reserved!") : 0;
+			std::string	pattern;
+			for (std::size_t i = 1; i < args.size(); i++) {
+				pattern += args[i];
+			}
+			try {
+				this->m_Log_format.insert(std::make_pair(args[0], LogFormat(pattern)));
+			} catch (const std::runtime_error& e) {
+				throw ConfParserException(args[0], e.what());
+			}
+			return false;
+		}
+		case CONF::E_HTTP_BLOCK_STATUS::SLOW_REQUEST_LOG: {
+			slowRequestLogChecker(args, this->m_Slow_request_log);
+			return false;
+		}
+		case CONF::E_HTTP_BLOCK_STATUS::REQUEST_TRACE: {
+			// request_trace path [sample=1/N] [buffer=size] [flush=time];
+			if (args.empty() || args[0].empty()) {
+				throw ConfParserException("", "invalid number of Request Trace arguments!");
+			}
+			this->m_Request_trace.m_Path = args[0];
+			for (std::size_t i = 1; i < args.size(); i++) {
+				if (args[i].compare(0, 9, "sample=1/") == 0) {
+					const std::string	rate = args[i].substr(9);
+					if (rate.empty() || rate.size() > 9 || rate.find_first_not_of("0123456789") != std::string::npos || std::atoi(rate.c_str()) < 1) {
+						throw ConfParserException(args[i], "is invalid Request Trace sample rate!");
+					}
+					this->m_Request_trace.m_Sample = std::atoi(rate.c_str());
+				} else if (args[i].compare(0, 7, "buffer=") == 0) {
+					this->m_Request_trace.m_Buffer = sizeArgumentChecker(args[i].substr(7));
+				} else if (args[i].compare(0, 6, "flush=") == 0) {
+					this->m_Request_trace.m_Flush = timeArgumentChecker(args[i].substr(6));
+				} else {
+					throw ConfParserException(args[i], "is invalid Request Trace parameter!");
+				}
+			}
+			this->m_Request_trace.m_File = intern(m_LogPaths, this->m_Request_trace.m_Path);
+			return false;
+		}
 		case CONF::E_HTTP_BLOCK_STATUS::SERVER: {
 			if (args.size() > 1 || (args.size() == 1 && !args[0].empty())) {
 				throw ConfParserException(args.at(0), "invalid number of Server arguments!");
 			}
+			this->m_UpstreamName.clear();
 			return true;
 		}
 	}
 	throw ConfParserException("", "Invalid configure file!");
 }
 
-const std::string	CONF::HTTPBlock::argument(const unsigned short& status) {
+const std::string	CONF::HTTPBlock::argument(const unsigned int& status) {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
 	const std::size_t&		fileSize = CONF::ConfFile::getInstance()->getFileSize();
 	std::size_t*				Pos = CONF::ConfFile::getInstance()->Pos();
@@ -138,7 +299,6 @@ const std::string	CONF::HTTPBlock::argument(const unsigned short& status) {
 
 	switch (status) {
 		case CONF::E_HTTP_BLOCK_STATUS::ROOT:
-		case CONF::E_HTTP_BLOCK_STATUS::ACCESS_LOG:
 		case CONF::E_HTTP_BLOCK_STATUS::INDEX:
 		case CONF::E_HTTP_BLOCK_STATUS::INCLUDE:
 			return (stringPathArgumentParser(argument) ? argument : throw ConfParserException(argument, "invalid root argument format!"));
@@ -158,13 +318,23 @@ const std::string	CONF::HTTPBlock::argument(const unsigned short& status) {
 			}
 			return (argument);
 		}
+		case CONF::E_HTTP_BLOCK_STATUS::LOG_FORMAT:
+			quotedArgumentParser(argument);
+			return (argument);
+		case CONF::E_HTTP_BLOCK_STATUS::PROXY_CACHE_PATH:
+		case CONF::E_HTTP_BLOCK_STATUS::ACCESS_LOG:
+		case CONF::E_HTTP_BLOCK_STATUS::REQUEST_TRACE:
+		case CONF::E_HTTP_BLOCK_STATUS::SLOW_REQUEST_LOG:
+			// cache directory / log 경로는 대소문자를 그대로 둔다.
+			rawArgumentParser(argument);
+			return (argument);
 	}
 	argumentParser(argument);
 	return (argument);
 }
 
 
-unsigned short	CONF::HTTPBlock::directiveNameChecker(const std::string& name) {
+unsigned int	CONF::HTTPBlock::directiveNameChecker(const std::string& name) {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
 	std::size_t*				Pos = CONF::ConfFile::getInstance()->Pos();
 
@@ -189,10 +359,16 @@ bool	CONF::HTTPBlock::blockContent() {
 	Pos[E_INDEX::FILE]++;
 	Pos[E_INDEX::COLUMN]++;
 
+	if (!this->m_UpstreamName.empty()) {
+		upstreamBlockContent();
+		return true;
+	}
+
 	ft::shared_ptr<CONF::ServerBlock>	server(new ServerBlock(this->m_Autoindex,
 												this->m_KeepAliveTime,
 												this->m_Root,
 												this->m_Access_log,
+												this->m_Slow_request_log,
 												this->m_Error_page,
 												this->m_Index));
 
@@ -219,6 +395,25 @@ bool	CONF::HTTPBlock::blockContent() {
 	return true;
 }
 
+/**
+ * @brief	upstream name { ... } 의 '{' 다음부터 '}' 까지
+ */
+void	CONF::HTTPBlock::upstreamBlockContent() {
+	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
+	std::size_t*				Pos = CONF::ConfFile::getInstance()->Pos();
+
+	CONF::UpstreamBlock	upstream;
+	upstream.initialize();
+	this->m_Upstream_block.insert(std::make_pair(this->m_UpstreamName, upstream));
+	this->m_UpstreamName.clear();
+
+	if (fileContent[Pos[E_INDEX::FILE]] != E_CONF::RBRACE) {
+		throw ConfParserException("}", "Direct block has no brace!");
+	}
+	Pos[E_INDEX::FILE]++;
+	Pos[E_INDEX::COLUMN]++;
+	m_BlockStack.pop();
+}
 
 bool	CONF::HTTPBlock::context() {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
@@ -260,7 +455,7 @@ const std::string	CONF::HTTPBlock::getIndex(const std::string& uri) const {
 	return (this->m_Index.find(uri));
 }
 
-const std::string&	CONF::HTTPBlock::getAccess_log() const {
+const CONF::accessLogData&	CONF::HTTPBlock::getAccess_log() const {
 	return (this->m_Access_log);
 }
 
@@ -283,3 +478,70 @@ const CONF::HTTPBlock::TypeMap&	CONF::HTTPBlock::getMime_types() const {
 const std::map<std::pair<std::string, unsigned short>, ft::shared_ptr<CONF::ServerBlock> >	CONF::HTTPBlock::getServerMap() const {
 	return (this->m_Server_block);
 }
+
+const CONF::HTTPBlock::upstreamMap&	CONF::HTTPBlock::getUpstreamMap() const {
+	return (this->m_Upstream_block);
+}
+
+const CONF::HTTPBlock::cachePathMap&	CONF::HTTPBlock::getProxy_cache_path() const {
+	return (this->m_Proxy_cache_path);
+}
+
+const CONF::HTTPBlock::microcacheZoneMap&	CONF::HTTPBlock::getMicrocache_zone() const {
+	return (this->m_Microcache_zone);
+}
+
+const CONF::fileCacheData&	CONF::HTTPBlock::getFile_cache() const {
+	return (this->m_File_cache);
+}
+
+const CONF::HTTPBlock::shmZoneMap&	CONF::HTTPBlock::getShm_zone() const {
+	return (this->m_Shm_zone);
+}
+
+const CONF::HTTPBlock::logFormatMap&	CONF::HTTPBlock::getLog_format() const {
+	return (this->m_Log_format);
+}
+
+const CONF::slowRequestLogData&	CONF::HTTPBlock::getSlow_request_log() const {
+	return (this->m_Slow_request_log);
+}
+
+const CONF::requestTraceData&	CONF::HTTPBlock::getRequest_trace() const {
+	return (this->m_Request_trace);
+}
+
+/**
+ * @brief	server 블록마다 (여러 listen 이 같은 블록을 가리켜도 한 번) onServer 를, 그 안의 location 마다
+ *			(nested 까지, 바깥 location 먼저) onLocation 을 부른다. fork 전에 location 별 표를 만드는 prepare 들이 쓴다.
+ * @param	onServer	NULL 이면 부르지 않는다.
+ * @param	context		그대로 넘긴다.
+ */
+void	CONF::HTTPBlock::visitLocations(serverVisitor onServer, locationVisitor onLocation, void* context) const {
+	std::set<const ServerBlock*>	visited;
+
+	for (serverMap::const_iterator it = m_Server_block.begin(); it != m_Server_block.end(); ++it) {
+		if (!visited.insert(it->second.get()).second) {
+			continue;
+		}
+		const ServerBlock&							server = *it->second.get();
+		const std::map<std::string, LocationBlock>&	locations = server.getLocationMap();
+
+		if (onServer != NULL) {
+			onServer(server, context);
+		}
+		for (std::map<std::string, LocationBlock>::const_iterator loc = locations.begin(); loc != locations.end(); ++loc) {
+			visitLocation(server, loc->second, loc->first, onLocation, context);
+		}
+	}
+}
+
+void	CONF::HTTPBlock::visitLocation(const ServerBlock& server, const LocationBlock& location, const std::string& name,
+	locationVisitor onLocation, void* context) {
+	const std::map<std::string, LocationBlock>&	nested = location.getLocationBlock();
+
+	onLocation(server, location, name, context);
+	for (std::map<std::string, LocationBlock>::const_iterator it = nested.begin(); it != nested.end(); ++it) {
+		visitLocation(server, it->second, it->first, onLocation, context);
+	}
+}
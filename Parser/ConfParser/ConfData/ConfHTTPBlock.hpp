@@ -4,13 +4,18 @@
 #include "../../../Trie/Trie.hpp"
 #include "../../MIMEParser/Exception/MIMEParserException.hpp"
 #include "ConfServerBlock.hpp"
+#include "ConfUpstreamBlock.hpp"
+#include "cachePathData/cachePathData.hpp"
+#include "fileCacheData/fileCacheData.hpp"
+#include "requestTraceData/requestTraceData.hpp"
 #include "../../../Utils/SmartPointer.hpp"
+#include "../../../Log/LogFormat.hpp"
 
 #include <vector>
 
 /**
  * @brief	HTTP Block Status
- * @details unsigned short : 2 byte
+ * @details unsigned int : 4 byte
  *  
  *	0b		  	 		 1 = root
  *	0b		     		10 = index
@@ -20,7 +25,15 @@
  *	0b			   10 0000 = keepalive_timeout
  *	0b	  		  100 0000 = include
  *	0b	 		 1000 0000 = default_type
+ *	0b	 	   1 0000 0000 = upstream
+ *	0b	 	  10 0000 0000 = proxy_cache_path
+ *	0b		 100 0000 0000 = microcache_zone
+ *	0b		1000 0000 0000 = file_cache
+ *	0b	  1 0000 0000 0000 = shm_zone
+ *	0b	 10 0000 0000 0000 = log_format
+ *	0b	100 0000 0000 0000 = request_trace
  * 	0b 1000 0000 0000 0000 = server
+ * 	0b 1 0000 0000 0000 0000 = slow_request_log
  */
 
 // TODO: root, access_log, index, include 각각이 abs/rel 둘 중 어떤 것이 되는지 알아볼 것
@@ -30,23 +43,39 @@ namespace   CONF {
 	public:
 		typedef std::pair<std::string, unsigned short>					serverKey;
 		typedef std::map<serverKey, ft::shared_ptr<CONF::ServerBlock> >	serverMap;
+		typedef std::map<std::string, CONF::UpstreamBlock>				upstreamMap;
+		typedef std::map<std::string, CONF::cachePathData>				cachePathMap;
+		typedef std::map<std::string, std::size_t>						microcacheZoneMap;
+		typedef std::map<std::string, std::size_t>						shmZoneMap;
+		typedef std::map<std::string, LogFormat>						logFormatMap;
+		typedef void	(*serverVisitor)(const ServerBlock& server, void* context);
+		typedef void	(*locationVisitor)(const ServerBlock& server, const LocationBlock& location, const std::string& name, void* context);
 
 	private:
-		typedef std::map<std::string, unsigned short>				statusMap;
+		typedef std::map<std::string, unsigned int>				statusMap;
 		typedef std::map<std::string, std::vector<std::string> >	TypeMap ;
 		typedef std::map<unsigned short, errorPageData>				errorPageMap;
 
 		bool									m_Autoindex;
-		unsigned short							m_Status;
+		unsigned int							m_Status;
 		unsigned int							m_KeepAliveTime;
 		std::string								m_Default_type;
 		std::string								m_Root;
-		std::string								m_Access_log;
+		accessLogData							m_Access_log;
+		slowRequestLogData						m_Slow_request_log;
 		std::string								m_Include;
 		Trie									m_Index;
 		errorPageMap							m_Error_page;
 		TypeMap									m_Mime_types;
 		serverMap								m_Server_block;
+		std::string								m_UpstreamName;
+		upstreamMap								m_Upstream_block;
+		cachePathMap							m_Proxy_cache_path;
+		microcacheZoneMap						m_Microcache_zone;
+		fileCacheData							m_File_cache;
+		shmZoneMap								m_Shm_zone;
+		logFormatMap							m_Log_format;
+		requestTraceData						m_Request_trace;
 		static statusMap						m_HTTPStatusMap;
 
 	private:
@@ -54,13 +83,16 @@ namespace   CONF {
 		HTTPBlock& operator=(const HTTPBlock& other);
 
 		static void			initHTTPStatusMap();
+		static void			visitLocation(const ServerBlock& server, const LocationBlock& location, const std::string& name,
+								locationVisitor onLocation, void* context);
 
 		bool				context();
 		bool				blockContent();
-		unsigned short		directiveNameChecker(const std::string& name);
+		void				upstreamBlockContent();
+		unsigned int		directiveNameChecker(const std::string& name);
 
-		const std::string	argument(const unsigned short& status);
-		bool				argumentChecker(const std::vector<std::string>& args, const unsigned short& status);
+		const std::string	argument(const unsigned int& status);
+		bool				argumentChecker(const std::vector<std::string>& args, const unsigned int& status);
 	
 	public:
 		HTTPBlock();
@@ -73,11 +105,21 @@ namespace   CONF {
 		const unsigned int&		getKeepAliveTime() const;
 		const std::string&		getDefault_type() const;
 		const std::string&		getRoot() const;
-		const std::string&		getAccess_log() const;
+		const accessLogData&	getAccess_log() const;
+		const slowRequestLogData&	getSlow_request_log() const;
 		const std::string&		getInclude() const;
 		const std::string		getIndex(const std::string& uri) const;
 		const errorPageMap&		getError_page() const;
 		const TypeMap&			getMime_types() const;
 		const std::map<std::pair<std::string, unsigned short>, ft::shared_ptr<CONF::ServerBlock> >	getServerMap() const;
+		const upstreamMap&		getUpstreamMap() const;
+		const cachePathMap&		getProxy_cache_path() const;
+		const microcacheZoneMap&	getMicrocache_zone() const;
+		const fileCacheData&	getFile_cache() const;
+		const shmZoneMap&		getShm_zone() const;
+		const logFormatMap&		getLog_format() const;
+		const requestTraceData&	getRequest_trace() const;
+
+		void					visitLocations(serverVisitor onServer, locationVisitor onLocation, void* context) const;
 	};
 }
@@ -1,15 +1,16 @@
 #include "ConfLocationBlock.hpp"
+#include <cstdlib>
 
 // TODO: delete
 #include <iostream>
 #include <sys/_types/_size_t.h>
 
-std::map<std::string, unsigned short>	CONF::LocationBlock::m_LocationStatusMap;
+std::map<std::string, unsigned int>	CONF::LocationBlock::m_LocationStatusMap;
 
 CONF::LocationBlock::LocationBlock(
 	const bool&			autoIndex,
 	const std::string&	root,
-	const std::string&	accessLog,
+	const accessLogData&	accessLog,
 	const errorPageMap&	errorPage,
 	const Trie&			index
 )
@@ -19,8 +20,25 @@ CONF::LocationBlock::LocationBlock(
   m_Root(root),
   m_Error_page(errorPage),
   m_Access_log(accessLog),
-  m_Index(index)
-{}
+  m_Index(index),
+  m_CgiPool(),
+  m_Proxy_pass(),
+  m_Proxy_connect_timeout(E_LOCATION::DEFAULT_PROXY_TIMEOUT),
+  m_Proxy_read_timeout(E_LOCATION::DEFAULT_PROXY_TIMEOUT),
+  m_Cgi_read_timeout(E_LOCATION::DEFAULT_PROXY_TIMEOUT),
+  m_Fastcgi_read_timeout(E_LOCATION::DEFAULT_PROXY_TIMEOUT),
+  m_Proxy_cache(),
+  m_Microcache(),
+  m_Stub_status(false),
+  m_Metrics(false)
+{
+	m_Proxy_cache.m_Valid = 0;
+	m_Proxy_cache.m_Lock = false;
+	m_Proxy_cache.m_LockTimeout = E_PROXY_CACHE::DEFAULT_LOCK_TIMEOUT;
+	m_Proxy_cache.m_StaleUpdate = 0;
+	m_Proxy_cache.m_StaleError = 0;
+	m_Microcache.m_Valid = E_MICROCACHE_DATA::DEFAULT_VALID;
+}
 
 CONF::LocationBlock::LocationBlock(const LocationBlock& other)
 : AConfParser(),
@@ -32,6 +50,17 @@ CONF::LocationBlock::LocationBlock(const LocationBlock& other)
   m_Index(other.m_Index),
   m_LocationName(other.m_LocationName),
   m_Cgi(other.m_Cgi),
+  m_CgiPool(other.m_CgiPool),
+  m_Fastcgi_pass(other.m_Fastcgi_pass),
+  m_Proxy_pass(other.m_Proxy_pass),
+  m_Proxy_connect_timeout(other.m_Proxy_connect_timeout),
+  m_Proxy_read_timeout(other.m_Proxy_read_timeout),
+  m_Cgi_read_timeout(other.m_Cgi_read_timeout),
+  m_Fastcgi_read_timeout(other.m_Fastcgi_read_timeout),
+  m_Proxy_cache(other.m_Proxy_cache),
+  m_Microcache(other.m_Microcache),
+  m_Stub_status(other.m_Stub_status),
+  m_Metrics(other.m_Metrics),
   m_LocationBlock(other.m_LocationBlock)
 {}
 
@@ -44,11 +73,25 @@ void	CONF::LocationBlock::initLocationStatusMap() {
 	m_LocationStatusMap["error_page"] = E_LOCATION_BLOCK_STATUS::ERROR_PAGE;
 	m_LocationStatusMap["access_log"] = E_LOCATION_BLOCK_STATUS::ACCESS_LOG;
 	m_LocationStatusMap["cgi"] = E_LOCATION_BLOCK_STATUS::CGI;
+	m_LocationStatusMap["cgi_pool"] = E_LOCATION_BLOCK_STATUS::CGI_POOL;
+	m_LocationStatusMap["fastcgi_pass"] = E_LOCATION_BLOCK_STATUS::FASTCGI_PASS;
+	m_LocationStatusMap["proxy_pass"] = E_LOCATION_BLOCK_STATUS::PROXY_PASS;
+	m_LocationStatusMap["proxy_connect_timeout"] = E_LOCATION_BLOCK_STATUS::PROXY_CONNECT_TIMEOUT;
+	m_LocationStatusMap["proxy_read_timeout"] = E_LOCATION_BLOCK_STATUS::PROXY_READ_TIMEOUT;
+	m_LocationStatusMap["cgi_read_timeout"] = E_LOCATION_BLOCK_STATUS::CGI_READ_TIMEOUT;
+	m_LocationStatusMap["fastcgi_read_timeout"] = E_LOCATION_BLOCK_STATUS::FASTCGI_READ_TIMEOUT;
+	m_LocationStatusMap["proxy_cache"] = E_LOCATION_BLOCK_STATUS::PROXY_CACHE;
+	m_LocationStatusMap["proxy_cache_valid"] = E_LOCATION_BLOCK_STATUS::PROXY_CACHE_VALID;
+	m_LocationStatusMap["proxy_cache_lock"] = E_LOCATION_BLOCK_STATUS::PROXY_CACHE_LOCK;
+	m_LocationStatusMap["proxy_cache_lock_timeout"] = E_LOCATION_BLOCK_STATUS::PROXY_CACHE_LOCK_TIMEOUT;
+	m_LocationStatusMap["microcache"] = E_LOCATION_BLOCK_STATUS::MICROCACHE;
+	m_LocationStatusMap["stub_status"] = E_LOCATION_BLOCK_STATUS::STUB_STATUS;
+	m_LocationStatusMap["metrics"] = E_LOCATION_BLOCK_STATUS::METRICS;
 	m_LocationStatusMap["location"] = E_LOCATION_BLOCK_STATUS::LOCATION;
 }
 
 
-bool	CONF::LocationBlock::argumentChecker(const std::vector<std::string>& args, const unsigned short& status) {
+bool	CONF::LocationBlock::argumentChecker(const std::vector<std::string>& args, const unsigned int& status) {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
 	const std::size_t&	fileSize = CONF::ConfFile::getInstance()->getFileSize();
 	std::size_t*		Pos = CONF::ConfFile::getInstance()->Pos();
@@ -64,6 +107,8 @@ bool	CONF::LocationBlock::argumentChecker(const std::vector<std::string>& args,
 		}
 		case CONF::E_LOCATION_BLOCK_STATUS::INDEX: {
 			args.empty() ? throw ConfParserException("", "index argument is empty!") : 0;
+			// 상위 블록에서 물려받은 index 는 이 블록의 index 로 바뀐다.
+			this->m_Index = Trie();
 			for (std::size_t i = 0; i < args.size(); i++) {
 				(args[i].empty()) ? throw ConfParserException(args.at(0), "invalid number of Index arguments!") : this->m_Index.insert(args[i]);
 			}
@@ -91,16 +136,175 @@ bool	CONF::LocationBlock::argumentChecker(const std::vector<std::string>& args,
 			return false;
 		}
 		case CONF::E_HTTP_BLOCK_STATUS::ACCESS_LOG: {
+			accessLogChecker(args, this->m_Access_log);
+			return false;
+		}
+		case CONF::E_LOCATION_BLOCK_STATUS::CGI: {
 			if (args.size() != 1) {
-				throw ConfParserException(args.at(0), "invalid number of Access Log arguments!");
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of CGI arguments!");
 			} else {
-				(args[0].empty()) ? throw ConfParserException(args[0], "invalid number of Access Log arguments!") : this->m_Access_log = args[0];
+				(args[0].empty()) ? throw ConfParserException(args[0], "invalid number of CGI arguments!") : this->m_Cgi = args[0];
 			}
 			return false;
 		}
-		case CONF::E_LOCATION_BLOCK_STATUS::CGI: {
-			args.empty() ? throw ConfParserException("", "server_name argument is empty!") : 0;
-			// TODO: implement
+		case CONF::E_LOCATION_BLOCK_STATUS::CGI_POOL: {
+			// cgi_pool min max [queue];
+			if (args.size() != 2 && args.size() != 3) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of CGI Pool arguments!");
+			}
+			unsigned int	values[3] = { 0, 0, 0 };
+			for (std::size_t i = 0; i < args.size(); i++) {
+				char*		endptr;
+				const long	number = std::strtol(args[i].c_str(), &endptr, 10);
+				if (args[i].empty() || *endptr != '\0' || number < 0 || args[i].size() > 9) {
+					throw ConfParserException(args[i], "is invalid CGI Pool argument!");
+				}
+				values[i] = static_cast<unsigned int>(number);
+			}
+			if (values[1] == 0 || values[0] > values[1]) {
+				throw ConfParserException(args[1], "cgi_pool max must be positive and not less than min!");
+			}
+			this->m_CgiPool.m_Min = values[0];
+			this->m_CgiPool.m_Max = values[1];
+			this->m_CgiPool.m_Queue = (args.size() == 3) ? values[2] : values[1] * 4;
+			return false;
+		}
+		case CONF::E_LOCATION_BLOCK_STATUS::FASTCGI_PASS: {
+			// fastcgi_pass host:port; | fastcgi_pass unix:/path/to/socket;
+			if (args.size() != 1) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of FastCGI Pass arguments!");
+			}
+			const std::size_t	colonPos = args[0].rfind(':');
+			if (colonPos == std::string::npos || colonPos == 0 || colonPos + 1 == args[0].size()) {
+				throw ConfParserException(args[0], "is invalid FastCGI Pass address!");
+			}
+			this->m_Fastcgi_pass = args[0];
+			return false;
+		}
+		case CONF::E_LOCATION_BLOCK_STATUS::PROXY_PASS: {
+			// proxy_pass http://host[:port][/uri];
+			if (args.size() != 1) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of Proxy Pass arguments!");
+			}
+			if (args[0].compare(0, 7, "http://") != 0) {
+				throw ConfParserException(args[0], "proxy_pass supports only http:// URL!");
+			}
+			const std::size_t	slashPos = args[0].find('/', 7);
+			const std::string	authority = args[0].substr(7, slashPos - 7);
+			const std::size_t	colonPos = authority.rfind(':');
+
+			this->m_Proxy_pass.m_Host = authority.substr(0, colonPos);
+			this->m_Proxy_pass.m_Port = 80;
+			this->m_Proxy_pass.m_Uri = (slashPos != std::string::npos) ? args[0].substr(slashPos) : "";
+			if (colonPos != std::string::npos) {
+				char*		endptr;
+				const long	port = std::strtol(authority.c_str() + colonPos + 1, &endptr, 10);
+				if (*endptr != '\0' || port <= 0 || port > 65535) {
+					throw ConfParserException(args[0], "is invalid Proxy Pass port!");
+				}
+				this->m_Proxy_pass.m_Port = static_cast<unsigned short>(port);
+			}
+			if (this->m_Proxy_pass.m_Host.empty()) {
+				throw ConfParserException(args[0], "is invalid Proxy Pass host!");
+			}
+			return false;
+		}
+		case CONF::E_LOCATION_BLOCK_STATUS::PROXY_CONNECT_TIMEOUT:
+		case CONF::E_LOCATION_BLOCK_STATUS::PROXY_READ_TIMEOUT:
+		case CONF::E_LOCATION_BLOCK_STATUS::CGI_READ_TIMEOUT:
+		case CONF::E_LOCATION_BLOCK_STATUS::FASTCGI_READ_TIMEOUT: {
+			if (args.size() != 1) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of Timeout arguments!");
+			}
+			const unsigned int	timeout = timeArgumentChecker(args[0]);
+			(timeout == 0) ? throw ConfParserException(args[0], "timeout must be positive!") : 0;
+			if (status == CONF::E_LOCATION_BLOCK_STATUS::PROXY_CONNECT_TIMEOUT) {
+				this->m_Proxy_connect_timeout = timeout;
+			} else if (status == CONF::E_LOCATION_BLOCK_STATUS::PROXY_READ_TIMEOUT) {
+				this->m_Proxy_read_timeout = timeout;
+			} else if (status == CONF::E_LOCATION_BLOCK_STATUS::CGI_READ_TIMEOUT) {
+				this->m_Cgi_read_timeout = timeout;
+			} else {
+				this->m_Fastcgi_read_timeout = timeout;
+			}
+			return false;
+		}
+		case CONF::E_LOCATION_BLOCK_STATUS::PROXY_CACHE: {
+			// proxy_cache zone [stale_while_revalidate=time] [stale_if_error=time];
+			// (zone 은 http 블록의 proxy_cache_path keys_zone 이름)
+			if (args.empty() || args.size() > 3 || args[0].empty()) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of Proxy Cache arguments!");
+			}
+			this->m_Proxy_cache.m_Zone = args[0];
+			for (std::size_t i = 1; i < args.size(); i++) {
+				if (args[i].compare(0, 23, "stale_while_revalidate=") == 0) {
+					this->m_Proxy_cache.m_StaleUpdate = timeArgumentChecker(args[i].substr(23));
+				} else if (args[i].compare(0, 15, "stale_if_error=") == 0) {
+					this->m_Proxy_cache.m_StaleError = timeArgumentChecker(args[i].substr(15));
+				} else {
+					throw ConfParserException(args[i], "is invalid Proxy Cache parameter!");
+				}
+			}
+			return false;
+		}
+		case CONF::E_LOCATION_BLOCK_STATUS::PROXY_CACHE_VALID: {
+			// proxy_cache_valid time; (Cache-Control max-age 가 없는 응답을 얼마나 쓸지. 0 이면 저장하지 않는다)
+			if (args.size() != 1 || args[0].empty()) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of Proxy Cache Valid arguments!");
+			}
+			this->m_Proxy_cache.m_Valid = timeArgumentChecker(args[0]);
+			return false;
+		}
+		case CONF::E_LOCATION_BLOCK_STATUS::PROXY_CACHE_LOCK: {
+			// proxy_cache_lock on | off;
+			if (args.size() != 1 || (args[0] != "on" && args[0] != "off")) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid Proxy Cache Lock arguments!");
+			}
+			this->m_Proxy_cache.m_Lock = (args[0] == "on");
+			return false;
+		}
+		case CONF::E_LOCATION_BLOCK_STATUS::PROXY_CACHE_LOCK_TIMEOUT: {
+			// proxy_cache_lock_timeout time; (lock 을 기다리는 최대 시간)
+			if (args.size() != 1 || args[0].empty()) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of Proxy Cache Lock Timeout arguments!");
+			}
+			this->m_Proxy_cache.m_LockTimeout = timeArgumentChecker(args[0]);
+			(this->m_Proxy_cache.m_LockTimeout == 0) ? throw ConfParserException(args[0], "proxy_cache_lock_timeout must be positive!") : 0;
+			return false;
+		}
+		case CONF::E_LOCATION_BLOCK_STATUS::MICROCACHE: {
+			// microcache zone [valid=time] [key=header,...]; (zone 은 http 블록의 microcache_zone 이름)
+			if (args.empty() || args.size() > 3 || args[0].empty()) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of Microcache arguments!");
+			}
+			this->m_Microcache.m_Zone = args[0];
+			for (std::size_t i = 1; i < args.size(); i++) {
+				if (args[i].compare(0, 6, "valid=") == 0) {
+					this->m_Microcache.m_Valid = timeArgumentChecker(args[i].substr(6));
+					(this->m_Microcache.m_Valid == 0) ? throw ConfParserException(args[i], "microcache valid must be positive!") : 0;
+				} else if (args[i].compare(0, 4, "key=") == 0) {
+					std::string	headers = args[i].substr(4);
+					std::size_t	commaPos;
+					do {
+						commaPos = headers.find(',');
+						const std::string	header = headers.substr(0, commaPos);
+						header.empty() ? throw ConfParserException(args[i], "is invalid Microcache key!") : this->m_Microcache.m_Headers.push_back(header);
+						headers.erase(0, (commaPos == std::string::npos) ? commaPos : commaPos + 1);
+					} while (commaPos != std::string::npos);
+				} else {
+					throw ConfParserException(args[i], "is invalid Microcache parameter!");
+				}
+			}
+			return false;
+		}
+		case CONF::E_LOCATION_BLOCK_STATUS::STUB_STATUS: {
+			// stub_status; (connection / request counter 를 text 로 응답한다)
+			(!args.empty()) ? throw ConfParserException(args[0], "stub_status takes no parameter!") : this->m_Stub_status = true;
+			return false;
+		}
+		case CONF::E_LOCATION_BLOCK_STATUS::METRICS: {
+			// metrics; (server / location 별 latency histogram 을 Prometheus text 로 응답한다)
+			(!args.empty()) ? throw ConfParserException(args[0], "metrics takes no parameter!") : this->m_Metrics = true;
 			return false;
 		}
 		case CONF::E_LOCATION_BLOCK_STATUS::LOCATION: {
@@ -115,7 +319,7 @@ bool	CONF::LocationBlock::argumentChecker(const std::vector<std::string>& args,
 	throw ConfParserException("", "Invalid configure file!");
 }
 
-const std::string	CONF::LocationBlock::argument(const unsigned short& status) {
+const std::string	CONF::LocationBlock::argument(const unsigned int& status) {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
 	const std::size_t&		fileSize = CONF::ConfFile::getInstance()->getFileSize();
 	std::size_t*				Pos = CONF::ConfFile::getInstance()->Pos();
@@ -129,7 +333,6 @@ const std::string	CONF::LocationBlock::argument(const unsigned short& status) {
 	switch (status) {
 		case CONF::E_LOCATION_BLOCK_STATUS::ROOT:
 		case CONF::E_LOCATION_BLOCK_STATUS::INDEX:
-		case CONF::E_LOCATION_BLOCK_STATUS::ACCESS_LOG:
 			return (stringPathArgumentParser(argument) ? argument : throw ConfParserException(argument, "invalid root argument format!"));
 		case CONF::E_LOCATION_BLOCK_STATUS::ERROR_PAGE: {
 			errorPageArgumentParser(argument);
@@ -141,17 +344,27 @@ const std::string	CONF::LocationBlock::argument(const unsigned short& status) {
 					|| PathParser::File_RelativePath<ConfParserException>(fileContent, Pos[E_INDEX::FILE], argument))
 				? 0 : throw ConfParserException(argument, "is invalid location directive argument");
 			Pos[E_INDEX::COLUMN] += (Pos[E_INDEX::FILE] - startPos);
+			break;
 		}
-		case CONF::E_LOCATION_BLOCK_STATUS::CGI: {
-			// TODO: cgi는 실행파일의 경로인가?
-		}
+		case CONF::E_LOCATION_BLOCK_STATUS::CGI:
+			// cgi: interpreter (실행파일) 경로. e.g. cgi /usr/bin/python3;
+			return (stringPathArgumentParser(argument) ? argument : throw ConfParserException(argument, "invalid cgi argument format!"));
+		case CONF::E_LOCATION_BLOCK_STATUS::CGI_POOL:
+			return (digitArgumentParser(argument) ? argument : throw ConfParserException(argument, "invalid cgi_pool argument format!"));
+		case CONF::E_LOCATION_BLOCK_STATUS::FASTCGI_PASS:
+		case CONF::E_LOCATION_BLOCK_STATUS::ACCESS_LOG:
+			rawArgumentParser(argument);
+			return (argument);
+		case CONF::E_LOCATION_BLOCK_STATUS::PROXY_PASS:
+			urlArgumentParser(argument);
+			return (argument);
 	}
 	argumentParser(argument);
 	return (argument);
 }
 
 
-unsigned short	CONF::LocationBlock::directiveNameChecker(const std::string& name) {
+unsigned int	CONF::LocationBlock::directiveNameChecker(const std::string& name) {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
 	std::size_t*				Pos = CONF::ConfFile::getInstance()->Pos();
 
@@ -241,7 +454,11 @@ const std::string	CONF::LocationBlock::getIndex(const std::string& uri) const {
 	return (this->m_Index.find(uri));
 }
 
-const std::string&	CONF::LocationBlock::getAccess_log() const {
+const std::vector<std::string>&	CONF::LocationBlock::getIndexList() const {
+	return (this->m_Index.getWords());
+}
+
+const CONF::accessLogData&	CONF::LocationBlock::getAccess_log() const {
 	return (this->m_Access_log);
 }
 
@@ -249,6 +466,50 @@ const std::string&	CONF::LocationBlock::getCgi() const {
 	return (this->m_Cgi);
 }
 
+const CONF::cgiPoolData&	CONF::LocationBlock::getCgiPool() const {
+	return (this->m_CgiPool);
+}
+
+const std::string&	CONF::LocationBlock::getFastcgi_pass() const {
+	return (this->m_Fastcgi_pass);
+}
+
+const CONF::proxyPassData&	CONF::LocationBlock::getProxy_pass() const {
+	return (this->m_Proxy_pass);
+}
+
+const unsigned int&	CONF::LocationBlock::getProxy_connect_timeout() const {
+	return (this->m_Proxy_connect_timeout);
+}
+
+const unsigned int&	CONF::LocationBlock::getProxy_read_timeout() const {
+	return (this->m_Proxy_read_timeout);
+}
+
+const unsigned int&	CONF::LocationBlock::getCgi_read_timeout() const {
+	return (this->m_Cgi_read_timeout);
+}
+
+const unsigned int&	CONF::LocationBlock::getFastcgi_read_timeout() const {
+	return (this->m_Fastcgi_read_timeout);
+}
+
+const CONF::proxyCacheData&	CONF::LocationBlock::getProxy_cache() const {
+	return (this->m_Proxy_cache);
+}
+
+const CONF::microcacheData&	CONF::LocationBlock::getMicrocache() const {
+	return (this->m_Microcache);
+}
+
+const bool&	CONF::LocationBlock::getStub_status() const {
+	return (this->m_Stub_status);
+}
+
+const bool&	CONF::LocationBlock::getMetrics() const {
+	return (this->m_Metrics);
+}
+
 const std::map<unsigned short, CONF::errorPageData>&	CONF::LocationBlock::getError_page() const {
 	return (this->m_Error_page);
 }
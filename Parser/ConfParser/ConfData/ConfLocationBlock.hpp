@@ -2,11 +2,15 @@
 
 #include "../../../Trie/Trie.hpp"
 #include "../AConfParser/AConfParser.hpp"
+#include "cgiPoolData/cgiPoolData.hpp"
+#include "microcacheData/microcacheData.hpp"
+#include "proxyCacheData/proxyCacheData.hpp"
+#include "proxyPassData/proxyPassData.hpp"
 #include <string>
 
 	/**
 	 * @brief	Location Block Status
-	 * @details unsigned char : 1 byte
+	 * @details unsigned int : 4 byte
 	 *
 	 *  0b					 1 = root
 	 *  0b				    10 = index
@@ -14,26 +18,55 @@
 	 *  0b				  1000 = error_page
 	 *  0b			    1 0000 = access_log
 	 *  0b             10 0000 = cgi
+	 *  0b            100 0000 = cgi_pool
+	 *  0b           1000 0000 = fastcgi_pass
+	 *  0b         1 0000 0000 = proxy_pass
+	 *  0b        10 0000 0000 = proxy_connect_timeout
+	 *  0b       100 0000 0000 = proxy_read_timeout
+	 *  0b      1000 0000 0000 = proxy_cache
+	 *  0b    1 0000 0000 0000 = microcache
+	 *  0b   10 0000 0000 0000 = stub_status
+	 *  0b  100 0000 0000 0000 = metrics
 	 *	0b 1000 0000 0000 0000 = location
+	 *	0b 1 0000 0000 0000 0000 = cgi_read_timeout
+	 *	0b 10 0000 0000 0000 0000 = fastcgi_read_timeout
+	 *	0b 100 0000 0000 0000 0000 = proxy_cache_valid
+	 *	0b 1000 0000 0000 0000 0000 = proxy_cache_lock
+	 *	0b 1 0000 0000 0000 0000 0000 = proxy_cache_lock_timeout
 	*/
 
+namespace	E_LOCATION {
+	const unsigned int	DEFAULT_PROXY_TIMEOUT = 60000;
+}
+
 namespace   CONF {
 
 	class LocationBlock : public AConfParser {
 	private:
 		typedef	std::vector<std::string>				strVec;
 		typedef std::map<std::string, LocationBlock>	locationMap;
-		typedef std::map<std::string, unsigned short> 	statusMap;
+		typedef std::map<std::string, unsigned int> 	statusMap;
 		typedef std::map<unsigned short, errorPageData> errorPageMap;
 
 		bool							m_Autoindex;
-		unsigned short					m_Status;
+		unsigned int					m_Status;
 		std::string						m_Root;
 		errorPageMap					m_Error_page;
-		std::string						m_Access_log;
+		accessLogData					m_Access_log;
 		Trie							m_Index;
 		std::string						m_LocationName;
 		std::string						m_Cgi;
+		cgiPoolData						m_CgiPool;
+		std::string						m_Fastcgi_pass;
+		proxyPassData					m_Proxy_pass;
+		unsigned int					m_Proxy_connect_timeout;
+		unsigned int					m_Proxy_read_timeout;
+		unsigned int					m_Cgi_read_timeout;
+		unsigned int					m_Fastcgi_read_timeout;
+		proxyCacheData					m_Proxy_cache;
+		microcacheData					m_Microcache;
+		bool							m_Stub_status;
+		bool							m_Metrics;
 		locationMap						m_LocationBlock;
 		static statusMap				m_LocationStatusMap;
 	
@@ -44,15 +77,15 @@ namespace   CONF {
 
 		bool				context();
 		bool				blockContent();
-		unsigned short		directiveNameChecker(const std::string& name);
+		unsigned int		directiveNameChecker(const std::string& name);
 
-		const std::string	argument(const unsigned short& status);
-		bool				argumentChecker(const std::vector<std::string>& args, const unsigned short& status);
+		const std::string	argument(const unsigned int& status);
+		bool				argumentChecker(const std::vector<std::string>& args, const unsigned int& status);
 	
 	public:
 		LocationBlock();
 		LocationBlock(const LocationBlock& other);
-		LocationBlock(const bool& autoIndex, const std::string& root, const std::string& accessLog, const errorPageMap& errorPage, const Trie& index);
+		LocationBlock(const bool& autoIndex, const std::string& root, const accessLogData& accessLog, const errorPageMap& errorPage, const Trie& index);
 		virtual ~LocationBlock();
 
 		void	initialize();
@@ -61,10 +94,22 @@ namespace   CONF {
 
 		const std::string&				getRoot() const;
 		const std::string&				getCgi() const;
+		const cgiPoolData&				getCgiPool() const;
+		const std::string&				getFastcgi_pass() const;
+		const proxyPassData&			getProxy_pass() const;
+		const unsigned int&				getProxy_connect_timeout() const;
+		const unsigned int&				getProxy_read_timeout() const;
+		const unsigned int&				getCgi_read_timeout() const;
+		const unsigned int&				getFastcgi_read_timeout() const;
+		const proxyCacheData&			getProxy_cache() const;
+		const microcacheData&			getMicrocache() const;
+		const bool&						getStub_status() const;
+		const bool&						getMetrics() const;
 		const std::string				getIndex(const std::string& uri) const;
+		const std::vector<std::string>&	getIndexList() const;
 		const bool&						getAutoindex() const;
 		const errorPageMap&				getError_page() const;
-		const std::string&				getAccess_log() const;
+		const accessLogData&			getAccess_log() const;
 		const locationMap&				getLocationBlock() const;
 
 	};
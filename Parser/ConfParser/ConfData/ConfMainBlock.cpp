@@ -16,7 +16,8 @@ CONF::MainBlock::MainBlock()
   m_Daemon(false),
   m_Status(0),
   m_Worker_process(4),
-  m_Timer_resolution(0)
+  m_Timer_resolution(0),
+  m_Error_log_file(E_ACCESS_LOG_DATA::NONE)
 {}
 
 CONF::MainBlock::~MainBlock() {}
@@ -32,7 +33,7 @@ void	CONF::MainBlock::initMainStatusMap() {
 	m_MainStatusMap["events"] = E_MAIN_BLOCK_STATUS::EVENT_BLOCK;
 }
 
-bool	CONF::MainBlock::argumentChecker(const std::vector<std::string>& args, const unsigned short& status) {
+bool	CONF::MainBlock::argumentChecker(const std::vector<std::string>& args, const unsigned int& status) {
 
 	switch (status) {
 		case CONF::E_MAIN_BLOCK_STATUS::ENV: {
@@ -93,6 +94,7 @@ bool	CONF::MainBlock::argumentChecker(const std::vector<std::string>& args, cons
 		case CONF::E_MAIN_BLOCK_STATUS::ERROR_LOG: {
 			if (args.size() == 1) {
 				args[0].empty() ? throw ConfParserException(args.at(0), "invalid number of Error Log arguments!") : this->m_Error_log = args.at(0);
+				this->m_Error_log_file = intern(m_LogPaths, this->m_Error_log);
 				return false;
 			}
 			throw ConfParserException(args.at(0), "invalid number of Error Log arguments!");
@@ -116,7 +118,7 @@ bool	CONF::MainBlock::argumentChecker(const std::vector<std::string>& args, cons
 	}
 }
 
-const std::string	CONF::MainBlock::argument(const unsigned short& status) {
+const std::string	CONF::MainBlock::argument(const unsigned int& status) {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
 	const std::size_t&		fileSize = CONF::ConfFile::getInstance()->getFileSize();
 	std::size_t*				Pos = CONF::ConfFile::getInstance()->Pos();
@@ -147,7 +149,7 @@ const std::string	CONF::MainBlock::argument(const unsigned short& status) {
 	return (argument);
 }
 
-unsigned short	CONF::MainBlock::directiveNameChecker(const std::string& name) {
+unsigned int	CONF::MainBlock::directiveNameChecker(const std::string& name) {
 	const statusMap::iterator	it = m_MainStatusMap.find(name);
 
 	if (it == m_MainStatusMap.end()) {
@@ -224,6 +226,10 @@ const std::string&	CONF::MainBlock::getErrorLog() const {
 	return this->m_Error_log;
 }
 
+const unsigned int&	CONF::MainBlock::getErrorLogFile() const {
+	return this->m_Error_log_file;
+}
+
 const CONF::MainBlock::envMap&	CONF::MainBlock::getEnvMap() const {
 	return this->m_Env;
 }
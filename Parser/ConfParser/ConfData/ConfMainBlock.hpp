@@ -34,6 +34,7 @@ namespace   CONF {
 		unsigned int			m_Worker_process;
 		unsigned long			m_Timer_resolution;
 		std::string				m_Error_log;
+		unsigned int			m_Error_log_file;
 		envMap					m_Env;
 		EventsBlock				m_Event_block;
 		static HTTPBlock		m_HTTP_block;
@@ -48,10 +49,10 @@ namespace   CONF {
 
 		bool					context();
 		bool					blockContent();
-		unsigned short			directiveNameChecker(const std::string& name);
+		unsigned int			directiveNameChecker(const std::string& name);
 
-		const std::string		argument(const unsigned short& status);
-		bool					argumentChecker(const std::vector<std::string>& args, const unsigned short& status);
+		const std::string		argument(const unsigned int& status);
+		bool					argumentChecker(const std::vector<std::string>& args, const unsigned int& status);
 
 	public:
 		MainBlock();
@@ -63,6 +64,7 @@ namespace   CONF {
 		const unsigned int&		getWorkerProcess() const;
 		const unsigned long& 	getTimeResolution() const;
 		const std::string&		getErrorLog() const;
+		const unsigned int&		getErrorLogFile() const;
 		const std::string&		getEnv(const std::string& key) const;
 		const envMap&			getEnvMap() const;
 		const unsigned int&		getWorkerConnections() const;
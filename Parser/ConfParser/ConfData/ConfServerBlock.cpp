@@ -4,13 +4,14 @@
 #include <iostream>
 #include <sys/_types/_size_t.h>
 
-std::map<std::string, unsigned short>	CONF::ServerBlock::m_ServerStatusMap;
+std::map<std::string, unsigned int>	CONF::ServerBlock::m_ServerStatusMap;
 
 CONF::ServerBlock::ServerBlock(
 	const bool&			autoIndex,
 	const unsigned int&	keepAliveTime,
 	const std::string&	root,
-	const std::string&	accessLog,
+	const accessLogData&	accessLog,
+	const slowRequestLogData&	slowRequestLog,
 	const errorPageMap&	errorPage,
 	const Trie&			index
 )
@@ -22,6 +23,7 @@ CONF::ServerBlock::ServerBlock(
   m_Root(root),
   m_Error_page(errorPage),
   m_Access_log(accessLog),
+  m_Slow_request_log(slowRequestLog),
   m_IP(""),
   m_Index(index)
 {}
@@ -37,11 +39,12 @@ void	CONF::ServerBlock::initServerStatusMap() {
 	m_ServerStatusMap["keepalive_timeout"] = E_SERVER_BLOCK_STATUS::KEEPALIVE_TIMEOUT;
 	m_ServerStatusMap["listen"] = E_SERVER_BLOCK_STATUS::LISTEN;
 	m_ServerStatusMap["server_name"] = E_SERVER_BLOCK_STATUS::SERVER_NAME;
+	m_ServerStatusMap["slow_request_log"] = E_SERVER_BLOCK_STATUS::SLOW_REQUEST_LOG;
 	m_ServerStatusMap["location"] = E_SERVER_BLOCK_STATUS::LOCATION;
 }
 
 
-bool	CONF::ServerBlock::argumentChecker(const std::vector<std::string>& args, const unsigned short& status) {
+bool	CONF::ServerBlock::argumentChecker(const std::vector<std::string>& args, const unsigned int& status) {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
 	const std::size_t&		fileSize = CONF::ConfFile::getInstance()->getFileSize();
 	std::size_t*				Pos = CONF::ConfFile::getInstance()->Pos();
@@ -57,6 +60,8 @@ bool	CONF::ServerBlock::argumentChecker(const std::vector<std::string>& args, co
 		}
 		case CONF::E_SERVER_BLOCK_STATUS::INDEX: {
 			args.empty() ? throw ConfParserException("", "index argument is empty!") : 0;
+			// 상위 블록에서 물려받은 index 는 이 블록의 index 로 바뀐다.
+			this->m_Index = Trie();
 			for (std::size_t i = 0; i < args.size(); i++) {
 				(args[i].empty()) ? throw ConfParserException(args.at(0), "invalid number of Index arguments!") : this->m_Index.insert(args[i]);
 			}
@@ -84,11 +89,7 @@ bool	CONF::ServerBlock::argumentChecker(const std::vector<std::string>& args, co
 			return false;
 		}
 		case CONF::E_HTTP_BLOCK_STATUS::ACCESS_LOG: {
-			if (args.size() != 1) {
-				throw ConfParserException(args.at(0), "invalid number of Access Log arguments!");
-			} else {
-				(args[0].empty()) ? throw ConfParserException(args[0], "invalid number of Access Log arguments!") : this->m_Access_log = args[0];
-			}
+			accessLogChecker(args, this->m_Access_log);
 			return false;
 		}
 		case CONF::E_HTTP_BLOCK_STATUS::KEEPALIVE_TIMEOUT: {
@@ -116,6 +117,10 @@ bool	CONF::ServerBlock::argumentChecker(const std::vector<std::string>& args, co
 			}
 			return false;
 		}
+		case CONF::E_SERVER_BLOCK_STATUS::SLOW_REQUEST_LOG: {
+			slowRequestLogChecker(args, this->m_Slow_request_log);
+			return false;
+		}
 		case CONF::E_SERVER_BLOCK_STATUS::LOCATION: {
 			if (args.size() != 1) {
 				throw ConfParserException(args.at(0), "invalid number of Location arguments!");
@@ -128,7 +133,7 @@ bool	CONF::ServerBlock::argumentChecker(const std::vector<std::string>& args, co
 	throw ConfParserException("", "Invalid configure file!");
 }
 
-const std::string	CONF::ServerBlock::argument(const unsigned short& status) {
+const std::string	CONF::ServerBlock::argument(const unsigned int& status) {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
 	const std::size_t&		fileSize = CONF::ConfFile::getInstance()->getFileSize();
 	std::size_t*				Pos = CONF::ConfFile::getInstance()->Pos();
@@ -142,7 +147,6 @@ const std::string	CONF::ServerBlock::argument(const unsigned short& status) {
 	switch (status) {
 		case CONF::E_SERVER_BLOCK_STATUS::ROOT:
 		case CONF::E_SERVER_BLOCK_STATUS::INDEX:
-		case CONF::E_SERVER_BLOCK_STATUS::ACCESS_LOG:
 			return (stringPathArgumentParser(argument) ? argument : throw ConfParserException(argument, "invalid root argument format!"));
 		case CONF::E_SERVER_BLOCK_STATUS::LOCATION: {
 			if (fileContent[Pos[E_INDEX::FILE]] == E_CONF::LBRACE) {
@@ -154,6 +158,11 @@ const std::string	CONF::ServerBlock::argument(const unsigned short& status) {
 			errorPageArgumentParser(argument);
 			return (argument);
 		}
+		case CONF::E_SERVER_BLOCK_STATUS::ACCESS_LOG:
+		case CONF::E_SERVER_BLOCK_STATUS::SLOW_REQUEST_LOG:
+			// log 경로 / format 이름은 대소문자를 그대로 둔다.
+			rawArgumentParser(argument);
+			return (argument);
 		case CONF::E_SERVER_BLOCK_STATUS::KEEPALIVE_TIMEOUT: {
 			if (!digitArgumentParser(argument)) {
 				throw ConfParserException(argument, "invalid number of Keepalive Timeout arguments!");
@@ -179,7 +188,7 @@ const std::string	CONF::ServerBlock::argument(const unsigned short& status) {
 }
 
 
-unsigned short	CONF::ServerBlock::directiveNameChecker(const std::string& name) {
+unsigned int	CONF::ServerBlock::directiveNameChecker(const std::string& name) {
 	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
 	std::size_t*				Pos = CONF::ConfFile::getInstance()->Pos();
 
@@ -267,10 +276,18 @@ const std::string	CONF::ServerBlock::getIndex(const std::string& uri) const {
 	return (this->m_Index.find(uri));
 }
 
-const std::string&	CONF::ServerBlock::getAccess_log() const {
+const std::vector<std::string>&	CONF::ServerBlock::getIndexList() const {
+	return (this->m_Index.getWords());
+}
+
+const CONF::accessLogData&	CONF::ServerBlock::getAccess_log() const {
 	return (this->m_Access_log);
 }
 
+const CONF::slowRequestLogData&	CONF::ServerBlock::getSlow_request_log() const {
+	return (this->m_Slow_request_log);
+}
+
 const unsigned int&	CONF::ServerBlock::getKeepAliveTime() const {
 	return (this->m_KeepAliveTime);
 }
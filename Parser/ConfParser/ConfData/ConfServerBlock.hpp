@@ -1,12 +1,13 @@
 #pragma once
 
 #include "ConfLocationBlock.hpp"
+#include "slowRequestLogData/slowRequestLogData.hpp"
 #include <set>
 #include <string>
 
 /**
  * @brief	Server Block Status
- * @details unsigned short : 2 byte
+ * @details unsigned int : 4 byte
  *  
  *	0b			 		 1 = root
  *	0b  		 		10 = index
@@ -16,6 +17,7 @@
  *	0b     		   10 0000 = keepalive_timeout
  *	0b     		  100 0000 = listen
  *	0b  	     1000 0000 = server_name
+ *	0b  	   1 0000 0000 = slow_request_log
  *	0b 1000 0000 0000 0000 = location
  */
 
@@ -23,16 +25,17 @@ namespace   CONF {
 	class ServerBlock : public AConfParser {
 	private: 
 		typedef std::map<unsigned short, errorPageData> errorPageMap;
-		typedef std::map<std::string, unsigned short> 	statusMap;
+		typedef std::map<std::string, unsigned int> 	statusMap;
 		typedef std::map<std::string, LocationBlock> 	locationBlockMap;
 
 		bool						m_Autoindex;
 		unsigned short				m_Port;
-		unsigned short				m_Status;
+		unsigned int				m_Status;
 		unsigned int				m_KeepAliveTime;
 		std::string					m_Root;
 		errorPageMap				m_Error_page;
-		std::string					m_Access_log;
+		accessLogData				m_Access_log;
+		slowRequestLogData			m_Slow_request_log;
 		std::string					m_IP;
 		Trie						m_Index;
 		std::string					m_LocationName;
@@ -48,14 +51,14 @@ namespace   CONF {
 
 		bool				context();
 		bool				blockContent();
-		unsigned short		directiveNameChecker(const std::string& name);
+		unsigned int		directiveNameChecker(const std::string& name);
 
-		const std::string	argument(const unsigned short& status);
-		bool				argumentChecker(const std::vector<std::string>& args, const unsigned short& status);
+		const std::string	argument(const unsigned int& status);
+		bool				argumentChecker(const std::vector<std::string>& args, const unsigned int& status);
 	
 	public:
 		ServerBlock();
-		ServerBlock(const bool& autoIndex, const unsigned int& keepAliveTime, const std::string& root, const std::string& accessLog, const errorPageMap& errorPage, const Trie& index);
+		ServerBlock(const bool& autoIndex, const unsigned int& keepAliveTime, const std::string& root, const accessLogData& accessLog, const slowRequestLogData& slowRequestLog, const errorPageMap& errorPage, const Trie& index);
 		virtual ~ServerBlock();
 
 		void	initialize();
@@ -66,9 +69,11 @@ namespace   CONF {
 		const std::string&				getDefault_type() const;
 		const std::string&				getRoot() const;
 		const std::string&				getIP() const;
-		const std::string&				getAccess_log() const;
+		const accessLogData&			getAccess_log() const;
+		const slowRequestLogData&		getSlow_request_log() const;
 		const std::string&				getInclude() const;
 		const std::string				getIndex(const std::string& uri) const;
+		const std::vector<std::string>&	getIndexList() const;
 		const errorPageMap&				getError_page() const;
 		const std::set<std::string>&	getServerNames() const;
 		const locationBlockMap&			getLocationMap() const;
@@ -0,0 +1,211 @@
+#include "ConfUpstreamBlock.hpp"
+#include "../../../HTTP/ComplexValue.hpp"
+#include <cstdlib>
+#include <stdexcept>
+
+std::map<std::string, unsigned int>	CONF::UpstreamBlock::m_UpstreamStatusMap;
+
+CONF::UpstreamBlock::UpstreamBlock()
+: AConfParser(),
+  m_Status(0),
+  m_Balance(E_UPSTREAM::ROUND_ROBIN),
+  m_Consistent(false)
+{
+	m_Health_check.m_Interval = 0;
+	m_Health_check.m_Timeout = E_HEALTH_CHECK::DEFAULT_TIMEOUT;
+	m_Health_check.m_Uri = "/";
+	m_Health_check.m_Fails = 1;
+	m_Health_check.m_Passes = 1;
+}
+
+CONF::UpstreamBlock::UpstreamBlock(const UpstreamBlock& other)
+: AConfParser(),
+  m_Status(other.m_Status),
+  m_Server(other.m_Server),
+  m_Balance(other.m_Balance),
+  m_Hash_key(other.m_Hash_key),
+  m_Consistent(other.m_Consistent),
+  m_Health_check(other.m_Health_check)
+{}
+
+CONF::UpstreamBlock::~UpstreamBlock() {}
+
+void	CONF::UpstreamBlock::initUpstreamStatusMap() {
+	m_UpstreamStatusMap["server"] = E_UPSTREAM_BLOCK_STATUS::SERVER;
+	m_UpstreamStatusMap["least_conn"] = E_UPSTREAM_BLOCK_STATUS::LEAST_CONN;
+	m_UpstreamStatusMap["hash"] = E_UPSTREAM_BLOCK_STATUS::HASH;
+	m_UpstreamStatusMap["health_check"] = E_UPSTREAM_BLOCK_STATUS::HEALTH_CHECK;
+}
+
+/**
+ * @brief	"name=N" 의 N (prefixSize 는 "name=" 의 길이)
+ */
+unsigned int	CONF::UpstreamBlock::countArgumentChecker(const std::string& argument, const std::size_t& prefixSize) {
+	char*		endptr;
+	const long	number = std::strtol(argument.c_str() + prefixSize, &endptr, 10);
+
+	if (argument.size() == prefixSize || *endptr != '\0' || number < 0 || argument.size() - prefixSize > 9) {
+		throw ConfParserException(argument, "is invalid number argument!");
+	}
+	return (static_cast<unsigned int>(number));
+}
+
+bool	CONF::UpstreamBlock::argumentChecker(const std::vector<std::string>& args, const unsigned int& status) {
+	switch (status) {
+		case CONF::E_UPSTREAM_BLOCK_STATUS::SERVER: {
+			// server host[:port] [weight=N] [max_fails=N] [fail_timeout=time] [slow_start=time];
+			if (args.empty() || args[0].empty()) {
+				throw ConfParserException("", "invalid number of Upstream Server arguments!");
+			}
+			upstreamServerData	server;
+			server.m_Address = args[0];
+			server.m_Weight = 1;
+			server.m_MaxFails = E_UPSTREAM_SERVER::DEFAULT_MAX_FAILS;
+			server.m_FailTimeout = E_UPSTREAM_SERVER::DEFAULT_FAIL_TIMEOUT;
+			server.m_SlowStart = 0;
+			if (server.m_Address.compare(0, 5, "unix:") != 0 && server.m_Address.find(':') == std::string::npos) {
+				server.m_Address += ":80";
+			}
+			for (std::size_t i = 1; i < args.size(); i++) {
+				if (args[i].compare(0, 7, "weight=") == 0) {
+					server.m_Weight = countArgumentChecker(args[i], 7);
+					(server.m_Weight == 0 || server.m_Weight > E_UPSTREAM::MAX_WEIGHT) ? throw ConfParserException(args[i], "is invalid Upstream Server weight!") : 0;
+				} else if (args[i].compare(0, 10, "max_fails=") == 0) {
+					server.m_MaxFails = countArgumentChecker(args[i], 10);
+				} else if (args[i].compare(0, 13, "fail_timeout=") == 0) {
+					server.m_FailTimeout = timeArgumentChecker(args[i].substr(13));
+				} else if (args[i].compare(0, 11, "slow_start=") == 0) {
+					server.m_SlowStart = timeArgumentChecker(args[i].substr(11));
+				} else {
+					throw ConfParserException(args[i], "is invalid Upstream Server parameter!");
+				}
+			}
+			this->m_Server.push_back(server);
+			return false;
+		}
+		case CONF::E_UPSTREAM_BLOCK_STATUS::LEAST_CONN: {
+			if (!args.empty()) {
+				throw ConfParserException(args[0], "least_conn takes no argument!");
+			}
+			(this->m_Balance != E_UPSTREAM::ROUND_ROBIN) ? throw ConfParserException("least_conn", "balancing method is duplicated!") : this->m_Balance = E_UPSTREAM::LEAST_CONN;
+			return false;
+		}
+		case CONF::E_UPSTREAM_BLOCK_STATUS::HASH: {
+			// hash key [consistent];
+			if (args.empty() || args.size() > 2 || (args.size() == 2 && args[1] != "consistent")) {
+				throw ConfParserException(args.empty() ? "" : args[0], "invalid number of Hash arguments!");
+			}
+			(this->m_Balance != E_UPSTREAM::ROUND_ROBIN) ? throw ConfParserException("hash", "balancing method is duplicated!") : this->m_Balance = E_UPSTREAM::HASH;
+			try {
+				HTTP::ComplexValue	key(args[0]);
+			} catch (const std::runtime_error& e) {
+				throw ConfParserException(args[0], e.what());
+			}
+			this->m_Hash_key = args[0];
+			this->m_Consistent = (args.size() == 2);
+			return false;
+		}
+		case CONF::E_UPSTREAM_BLOCK_STATUS::HEALTH_CHECK: {
+			// health_check [interval=time] [timeout=time] [uri=/path] [fails=N] [passes=N];
+			this->m_Health_check.m_Interval = E_HEALTH_CHECK::DEFAULT_INTERVAL;
+			for (std::size_t i = 0; i < args.size(); i++) {
+				if (args[i].compare(0, 9, "interval=") == 0) {
+					this->m_Health_check.m_Interval = timeArgumentChecker(args[i].substr(9));
+				} else if (args[i].compare(0, 8, "timeout=") == 0) {
+					this->m_Health_check.m_Timeout = timeArgumentChecker(args[i].substr(8));
+				} else if (args[i].compare(0, 4, "uri=") == 0) {
+					this->m_Health_check.m_Uri = args[i].substr(4);
+				} else if (args[i].compare(0, 6, "fails=") == 0) {
+					this->m_Health_check.m_Fails = countArgumentChecker(args[i], 6);
+				} else if (args[i].compare(0, 7, "passes=") == 0) {
+					this->m_Health_check.m_Passes = countArgumentChecker(args[i], 7);
+				} else {
+					throw ConfParserException(args[i], "is invalid Health Check parameter!");
+				}
+			}
+			if (this->m_Health_check.m_Interval == 0 || this->m_Health_check.m_Timeout == 0
+					|| this->m_Health_check.m_Fails == 0 || this->m_Health_check.m_Passes == 0
+					|| this->m_Health_check.m_Uri.empty() || this->m_Health_check.m_Uri[0] != '/') {
+				throw ConfParserException("health_check", "invalid Health Check arguments!");
+			}
+			return false;
+		}
+	}
+	throw ConfParserException("", "Invalid configure file!");
+}
+
+const std::string	CONF::UpstreamBlock::argument(const unsigned int& status) {
+	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
+	const std::size_t&	fileSize = CONF::ConfFile::getInstance()->getFileSize();
+	std::size_t*		Pos = CONF::ConfFile::getInstance()->Pos();
+
+	std::string	argument;
+	while (Pos[E_INDEX::FILE] < fileSize && ABNF::isWSP(fileContent, Pos[E_INDEX::FILE])) {
+		handleHtabSpace(fileContent.at(Pos[E_INDEX::FILE]));
+		Pos[E_INDEX::FILE]++;
+	}
+
+	switch (status) {
+		case CONF::E_UPSTREAM_BLOCK_STATUS::SERVER:
+		case CONF::E_UPSTREAM_BLOCK_STATUS::HASH:
+		case CONF::E_UPSTREAM_BLOCK_STATUS::HEALTH_CHECK:
+			// unix socket 경로, hash key 의 literal, health check uri 는 대소문자를 그대로 둔다.
+			rawArgumentParser(argument);
+			return (argument);
+	}
+	argumentParser(argument);
+	return (argument);
+}
+
+unsigned int	CONF::UpstreamBlock::directiveNameChecker(const std::string& name) {
+	const statusMap::iterator	it = m_UpstreamStatusMap.find(name);
+
+	if (it == m_UpstreamStatusMap.end()) {
+		throw ConfParserException(name, "Upstream directive name is invalid!");
+	} else {
+		((m_Status & it->second) && !isMultipleDirective(m_BlockStack.top(), it->second)) ? throw ConfParserException(name, "Upstream directive is duplicated!") : m_Status |= it->second;
+		return it->second;
+	}
+}
+
+bool	CONF::UpstreamBlock::context() {
+	const std::string&	fileContent = CONF::ConfFile::getInstance()->getFileContent();
+	std::size_t*		Pos = CONF::ConfFile::getInstance()->Pos();
+
+	if (fileContent[Pos[E_INDEX::FILE]] == E_ABNF::SEMICOLON
+			|| ABNF::isLF(fileContent, Pos[E_INDEX::FILE])) {
+		return (false);
+	}
+	if (directives()) {
+		throw ConfParserException("{", "upstream block cannot have a nested block!");
+	}
+	return (ABNF::isC_nl(fileContent, Pos[E_INDEX::FILE]) ? true : false);
+}
+
+void	CONF::UpstreamBlock::initialize() {
+	this->m_UpstreamStatusMap.empty() ? initUpstreamStatusMap() : static_cast<void>(0);
+	CONF::AConfParser::m_BlockStack.push(CONF::E_BLOCK_STATUS::UPSTREAM);
+
+	contextLines();
+	this->m_Server.empty() ? throw ConfParserException("upstream", "upstream block has no server!") : 0;
+}
+
+const std::vector<CONF::upstreamServerData>&	CONF::UpstreamBlock::getServer() const {
+	return (this->m_Server);
+}
+
+const unsigned char&	CONF::UpstreamBlock::getBalance() const {
+	return (this->m_Balance);
+}
+
+const std::string&	CONF::UpstreamBlock::getHash_key() const {
+	return (this->m_Hash_key);
+}
+
+const bool&	CONF::UpstreamBlock::getConsistent() const {
+	return (this->m_Consistent);
+}
+
+const CONF::healthCheckData&	CONF::UpstreamBlock::getHealth_check() const {
+	return (this->m_Health_check);
+}
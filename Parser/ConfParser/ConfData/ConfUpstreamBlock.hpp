@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../AConfParser/AConfParser.hpp"
+#include "healthCheckData/healthCheckData.hpp"
+#include "upstreamServerData/upstreamServerData.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * @brief	Upstream Block Status
+ * @details unsigned int : 4 byte
+ *
+ *	0b		 1 = server
+ *	0b		10 = least_conn
+ *	0b	   100 = hash
+ *	0b	  1000 = health_check
+ */
+
+namespace	E_UPSTREAM {
+	enum E_BALANCE {
+		ROUND_ROBIN = 0,
+		LEAST_CONN,
+		HASH
+	};
+	const unsigned int	MAX_WEIGHT = 1000;
+}
+
+namespace   CONF {
+	class UpstreamBlock : public AConfParser {
+	private:
+		typedef std::map<std::string, unsigned int>	statusMap;
+		typedef std::vector<upstreamServerData>			serverVec;
+
+		unsigned int					m_Status;
+		serverVec						m_Server;
+		unsigned char					m_Balance;
+		std::string						m_Hash_key;
+		bool							m_Consistent;
+		healthCheckData					m_Health_check;
+		static statusMap				m_UpstreamStatusMap;
+
+	private:
+		UpstreamBlock& operator=(const UpstreamBlock& other);
+
+		static void			initUpstreamStatusMap();
+
+		bool				context();
+		unsigned int		directiveNameChecker(const std::string& name);
+		unsigned int		countArgumentChecker(const std::string& argument, const std::size_t& prefixSize);
+
+		const std::string	argument(const unsigned int& status);
+		bool				argumentChecker(const std::vector<std::string>& args, const unsigned int& status);
+
+	public:
+		UpstreamBlock();
+		UpstreamBlock(const UpstreamBlock& other);
+		virtual ~UpstreamBlock();
+
+		void	initialize();
+
+		const serverVec&				getServer() const;
+		const unsigned char&			getBalance() const;
+		const std::string&				getHash_key() const;
+		const bool&						getConsistent() const;
+		const healthCheckData&			getHealth_check() const;
+	};
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace E_ACCESS_LOG_DATA {
+	const std::size_t	DEFAULT_BUFFER = 65536;
+	const unsigned int	DEFAULT_FLUSH = 1000;
+	const unsigned int	NONE = static_cast<unsigned int>(-1);
+	const char* const	BINARY = "binary";
+}
+
+namespace CONF {
+	/**
+	 * @brief	access_log path [format] [buffer=size] [flush=time] [sample=1/N] [if_slower_than=time]; / access_log off;
+	 * @details	m_Path 가 비어 있으면 (off 또는 설정 없음) 기록하지 않는다.
+	 *			m_Buffer 가 0 이면 한 줄마다 내보낸다.
+	 *			buffer 나 flush 하나만 주면 나머지는 DEFAULT_BUFFER / DEFAULT_FLUSH 로 채운다.
+	 *			status 400 이상 (error) 과 if_slower_than 보다 오래 걸린 요청은 언제나 남긴다. 나머지 (빠른 요청) 는
+	 *			- sample=1/N 이 있으면 N 개 중 하나 꼴로 남긴다.
+	 *			- sample 없이 if_slower_than 만 있으면 남기지 않는다. (느린 요청만, m_Sample 0)
+	 *			- 둘 다 없으면 모두 남긴다. (m_Sample 1, m_SlowerThan 0)
+	 *			if_slower_than 은 단위가 없으면 ms 다.
+	 *			format 이 binary 면 log_format 대신 BinaryLog 의 binary record 로 쓴다. (m_FormatIndex 는 NONE)
+	 *			m_File / m_FormatIndex 는 읽을 때 정한 log path 표 / log_format 이름 표의 번호다. (요청마다 문자열로 찾지 않는다)
+	 */
+	struct accessLogData {
+		std::string		m_Path;
+		std::string		m_Format;
+		std::size_t		m_Buffer;
+		unsigned int	m_Flush;
+		unsigned int	m_File;
+		unsigned int	m_FormatIndex;
+		bool			m_Binary;
+		unsigned int	m_Sample;
+		unsigned int	m_SlowerThan;
+
+		accessLogData() : m_Format("combined"), m_Buffer(0), m_Flush(0), m_File(E_ACCESS_LOG_DATA::NONE), m_FormatIndex(E_ACCESS_LOG_DATA::NONE), m_Binary(false), m_Sample(1), m_SlowerThan(0) {}
+	};
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace E_CACHE_PATH {
+	const unsigned int	MAX_LEVELS = 3;
+	const unsigned int	DEFAULT_INACTIVE = 600000;
+}
+
+namespace CONF {
+	/**
+	 * @brief	proxy_cache_path path [levels=1:2] keys_zone=name:size [max_size=size] [inactive=time];
+	 * @details	응답은 path 아래에 key hash 로 만든 파일로 저장된다.
+	 *			levels 는 hash 의 끝에서부터 자른 directory 이름의 길이. (e.g. 1:2 -> path/c/29/...)
+	 *			keys_zone 크기만큼의 공유 메모리에 key 목록을 둔다.
+	 *			m_MaxSize 가 0 이면 디스크 크기 제한이 없다.
+	 */
+	struct cachePathData {
+		std::string					m_Path;
+		std::vector<unsigned int>	m_Levels;
+		std::size_t					m_ZoneSize;
+		std::size_t					m_MaxSize;
+		unsigned int				m_Inactive;
+	};
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace CONF {
+	/**
+	 * @brief	cgi_pool min max [queue];
+	 * @details	m_Max 가 0 이면 pool 을 쓰지 않는다. (request 마다 CGI 를 새로 띄운다)
+	 */
+	struct cgiPoolData {
+		unsigned int	m_Min;
+		unsigned int	m_Max;
+		unsigned int	m_Queue;
+	};
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+namespace E_FILE_CACHE_DATA {
+	const std::size_t	DEFAULT_MAX_FILE = 65536;
+	const unsigned int	DEFAULT_VALID = 1000;
+}
+
+namespace CONF {
+	/**
+	 * @brief	file_cache size [max_file=size] [valid=time];
+	 * @details	m_MaxFile 이하의 정적 파일을 응답 header 와 함께 메모리에 둔다. (전체 m_Size byte 까지)
+	 *			m_Valid 마다 한 번 stat 해서 mtime 이 바뀌었으면 다시 읽는다.
+	 *			m_Size 가 0 이면 cache 하지 않는다.
+	 */
+	struct fileCacheData {
+		std::size_t		m_Size;
+		std::size_t		m_MaxFile;
+		unsigned int	m_Valid;
+	};
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+namespace E_HEALTH_CHECK {
+	const unsigned int	DEFAULT_INTERVAL = 5000;
+	const unsigned int	DEFAULT_TIMEOUT = 1000;
+}
+
+namespace CONF {
+	/**
+	 * @brief	upstream 블록의 health_check [interval=time] [timeout=time] [uri=/path] [fails=N] [passes=N];
+	 * @details	m_Interval 이 0 이면 active health check 를 하지 않는다.
+	 *			interval 마다 서버별로 "GET uri" 를 보내서 2xx / 3xx 면 통과.
+	 *			연속 fails 번 실패하면 down, 연속 passes 번 통과하면 다시 up.
+	 */
+	struct healthCheckData {
+		unsigned int	m_Interval;
+		unsigned int	m_Timeout;
+		std::string		m_Uri;
+		unsigned int	m_Fails;
+		unsigned int	m_Passes;
+	};
+}
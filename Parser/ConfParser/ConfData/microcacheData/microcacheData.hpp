@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace E_MICROCACHE_DATA {
+	const unsigned int	DEFAULT_VALID = 1000;
+}
+
+namespace CONF {
+	/**
+	 * @brief	microcache zone [valid=time] [key=header,...];
+	 * @details	CGI / FastCGI location 의 응답을 m_Valid (기본 1초) 동안 공유 메모리에 둔다.
+	 *			key 는 method + host + URI 에 m_Headers 의 값을 붙인 것이다. (e.g. key=accept-encoding,cookie)
+	 *			m_Zone 이 비어 있으면 cache 하지 않는다.
+	 */
+	struct microcacheData {
+		std::string					m_Zone;
+		unsigned int				m_Valid;
+		std::vector<std::string>	m_Headers;
+	};
+}
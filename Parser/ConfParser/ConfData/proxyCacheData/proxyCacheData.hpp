@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+namespace E_PROXY_CACHE {
+	const unsigned int	DEFAULT_LOCK_TIMEOUT = 5000;
+}
+
+namespace CONF {
+	/**
+	 * @brief	proxy_cache zone [stale_while_revalidate=time] [stale_if_error=time]; / proxy_cache_valid time;
+	 *			proxy_cache_lock on | off; / proxy_cache_lock_timeout time;
+	 * @details	m_Zone 이 비어 있으면 cache 하지 않는다.
+	 *			upstream 응답에 Cache-Control max-age 가 없으면 m_Valid (proxy_cache_valid) 동안 쓴다. (0 이면 저장하지 않는다)
+	 *			m_Lock 이 켜져 있으면 같은 key 의 miss 는 하나만 upstream 으로 가고,
+	 *			나머지는 최대 m_LockTimeout (기본 5s) 동안 그 응답이 cache 에 들어오기를 기다린다.
+	 *			m_StaleUpdate / m_StaleError 는 응답의 Cache-Control 에 같은 이름의 값 (RFC 5861) 이 없을 때 쓴다.
+	 *			- stale_while_revalidate: 만료 후 이 시간 동안은 옛 응답을 바로 보내고 뒤에서 한 번만 새로 가져온다.
+	 *			- stale_if_error: 만료 후 이 시간 동안은 upstream 이 실패하면 (연결 실패, timeout, 5xx) 옛 응답을 보낸다.
+	 */
+	struct proxyCacheData {
+		std::string		m_Zone;
+		unsigned int	m_Valid;
+		bool			m_Lock;
+		unsigned int	m_LockTimeout;
+		unsigned int	m_StaleUpdate;
+		unsigned int	m_StaleError;
+	};
+}
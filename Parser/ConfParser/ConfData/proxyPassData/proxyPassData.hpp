@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+namespace CONF {
+	/**
+	 * @brief	proxy_pass http://host[:port][/uri];
+	 * @details	m_Host 가 비어 있으면 proxy 가 아니다.
+	 *			m_Uri 가 있으면 request URI 중 location 과 맞은 부분을 m_Uri 로 바꿔서 보낸다.
+	 */
+	struct proxyPassData {
+		std::string		m_Host;
+		unsigned short	m_Port;
+		std::string		m_Uri;
+	};
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../accessLogData/accessLogData.hpp"
+#include <cstddef>
+#include <string>
+
+namespace E_REQUEST_TRACE_DATA {
+	const unsigned int	DEFAULT_SAMPLE = 100;
+}
+
+namespace CONF {
+	/**
+	 * @brief	request_trace path [sample=1/N] [buffer=size] [flush=time];
+	 * @details	N 개 요청 중 하나 꼴로 단계별 시각을 Chrome trace-event JSON 으로 path 에 남긴다. (sample 이 없으면 1/DEFAULT_SAMPLE)
+	 *			path 는 access_log 와 같은 log path 표에 넣으므로 buffer / flush / 다시 열기 (SIGUSR1) 도 같다.
+	 *			설정이 없으면 m_File 이 NONE 이고 기록하지 않는다.
+	 */
+	struct requestTraceData {
+		std::string		m_Path;
+		unsigned int	m_File;
+		unsigned int	m_Sample;
+		std::size_t		m_Buffer;
+		unsigned int	m_Flush;
+
+		requestTraceData() : m_File(E_ACCESS_LOG_DATA::NONE), m_Sample(E_REQUEST_TRACE_DATA::DEFAULT_SAMPLE), m_Buffer(E_ACCESS_LOG_DATA::DEFAULT_BUFFER), m_Flush(E_ACCESS_LOG_DATA::DEFAULT_FLUSH) {}
+	};
+}
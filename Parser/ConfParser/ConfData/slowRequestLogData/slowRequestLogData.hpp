@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../accessLogData/accessLogData.hpp"
+#include <string>
+
+namespace CONF {
+	/**
+	 * @brief	slow_request_log path threshold;
+	 * @details	threshold (단위가 없으면 ms) 보다 오래 걸린 request 마다 단계별 시간을 한 줄로 path 에 남긴다.
+	 *			path 는 access_log 와 같은 log path 표에 넣는다. 설정이 없으면 m_File 이 NONE 이고 기록하지 않는다.
+	 */
+	struct slowRequestLogData {
+		std::string		m_Path;
+		unsigned int	m_File;
+		unsigned int	m_Threshold;
+
+		slowRequestLogData() : m_File(E_ACCESS_LOG_DATA::NONE), m_Threshold(0) {}
+	};
+}
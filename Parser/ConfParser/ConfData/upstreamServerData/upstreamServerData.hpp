@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+namespace E_UPSTREAM_SERVER {
+	const unsigned int	DEFAULT_MAX_FAILS = 1;
+	const unsigned int	DEFAULT_FAIL_TIMEOUT = 10000;
+}
+
+namespace CONF {
+	/**
+	 * @brief	upstream 블록의 server address [weight=N] [max_fails=N] [fail_timeout=time] [slow_start=time];
+	 * @details	m_Address 는 "host:port" (port 가 없으면 80) 또는 "unix:/path".
+	 *			fail_timeout 안에 max_fails 번 실패하면 fail_timeout 동안 보내지 않는다. (max_fails=0 이면 세지 않는다)
+	 *			다시 살아난 서버는 slow_start 동안 weight 를 0 에서부터 천천히 올린다.
+	 *			시간은 millisecond.
+	 */
+	struct upstreamServerData {
+		std::string		m_Address;
+		unsigned int	m_Weight;
+		unsigned int	m_MaxFails;
+		unsigned int	m_FailTimeout;
+		unsigned int	m_SlowStart;
+	};
+}
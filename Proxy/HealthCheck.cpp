@@ -0,0 +1,135 @@
+#include "HealthCheck.hpp"
+#include "ProxyUpstream.hpp"
+
+#include <cstdlib>
+#include <sys/socket.h>
+#include <unistd.h>
+
+HealthCheck::HealthCheck(EventLoop& loop, UpstreamGroup::Peer& peer, const CONF::healthCheckData& config, const std::string& host)
+  : m_Loop(loop),
+	m_Peer(peer),
+	m_Config(config),
+	m_Request("GET " + config.m_Uri + " HTTP/1.0\r\nHost: " + host + "\r\nConnection: close\r\nUser-Agent: webserv-health-check\r\n\r\n"),
+	m_Socket(-1),
+	m_Connecting(false),
+	m_Fails(0),
+	m_Passes(0)
+{}
+
+HealthCheck::~HealthCheck() {
+	closeSocket();
+}
+
+/**
+ * @brief	시작하자마자 한 번 검사한다.
+ */
+void	HealthCheck::start() {
+	probe();
+}
+
+void	HealthCheck::handleEvent(const struct kevent& event) {
+	if (event.filter == EVFILT_TIMER) {
+		// 대기 중이면 다음 검사, 검사 중이면 timeout
+		(m_Socket < 0) ? probe() : finish(false);
+		return ;
+	}
+	if (m_Socket < 0) {
+		return ;
+	}
+	if (event.filter == EVFILT_WRITE) {
+		onWrite();
+	} else if (event.filter == EVFILT_READ) {
+		onRead();
+	}
+}
+
+void	HealthCheck::probe() {
+	m_Response.clear();
+	m_Socket = m_Peer.m_Upstream->connect(m_Connecting);
+	if (m_Socket < 0) {
+		finish(false);
+		return ;
+	}
+	m_Loop.addRead(m_Socket, this);
+	m_Loop.addWrite(m_Socket, this);
+	m_Loop.enableWrite(m_Socket, this);
+	m_Loop.addTimeout(reinterpret_cast<uintptr_t>(this), m_Config.m_Timeout, this);
+}
+
+/**
+ * @brief	연결되면 request 를 한 번에 보낸다. (socket buffer 보다 훨씬 작다)
+ */
+void	HealthCheck::onWrite() {
+	int			error = 0;
+	socklen_t	length = sizeof(error);
+
+	m_Loop.disableWrite(m_Socket, this);
+	if (m_Connecting && (getsockopt(m_Socket, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0)) {
+		finish(false);
+		return ;
+	}
+	m_Connecting = false;
+	if (::send(m_Socket, m_Request.data(), m_Request.size(), 0) != static_cast<ssize_t>(m_Request.size())) {
+		finish(false);
+	}
+}
+
+/**
+ * @brief	"HTTP/1.x 200 ..." 까지만 읽고 2xx / 3xx 면 통과
+ */
+void	HealthCheck::onRead() {
+	char			buf[E_HEALTH_CHECK::READ_SIZE];
+	const ssize_t	readSize = recv(m_Socket, buf, sizeof(buf), 0);
+
+	if (readSize < 0) {
+		return ;
+	}
+	if (readSize == 0) {
+		finish(false);
+		return ;
+	}
+	m_Response.append(buf, readSize);
+
+	const std::size_t	lineEnd = m_Response.find("\r\n");
+	if (lineEnd == std::string::npos) {
+		if (m_Response.size() > E_HEALTH_CHECK::READ_SIZE) {
+			finish(false);
+		}
+		return ;
+	}
+	const int	status = (lineEnd >= 12 && m_Response.compare(0, 7, "HTTP/1.") == 0) ? std::atoi(m_Response.c_str() + 9) : 0;
+	finish(status >= 200 && status < 400);
+}
+
+/**
+ * @brief	결과를 공유 상태에 반영하고 다음 검사를 기다린다.
+ */
+void	HealthCheck::finish(const bool& passed) {
+	UpstreamPeerState&	state = *m_Peer.m_State;
+
+	closeSocket();
+	if (passed) {
+		m_Fails = 0;
+		m_Passes++;
+		if (state.m_Down && m_Passes >= m_Config.m_Passes) {
+			state.m_Fails = 0;
+			state.m_RecoveredAt = EventLoop::now();
+			state.m_Down = 0;
+		}
+	} else {
+		m_Passes = 0;
+		m_Fails++;
+		if (!state.m_Down && m_Fails >= m_Config.m_Fails) {
+			state.m_Down = 1;
+		}
+	}
+	m_Loop.addTimeout(reinterpret_cast<uintptr_t>(this), m_Config.m_Interval, this);
+}
+
+void	HealthCheck::closeSocket() {
+	if (m_Socket >= 0) {
+		m_Loop.forget(m_Socket);
+		close(m_Socket);
+		m_Socket = -1;
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "../Server/EventLoop/EventLoop.hpp"
+#include "UpstreamGroup.hpp"
+#include <string>
+
+namespace E_HEALTH_CHECK {
+	const std::size_t	READ_SIZE = 1024;
+}
+
+/**
+ * @brief	upstream 서버 하나의 active health check
+ * @details	worker 하나 (id 0) 에서만 돈다. interval 마다 새로 연결해서 "GET uri" 를 보내고,
+ *			status line 만 보고 끊는다. 결과는 공유 메모리의 UpstreamPeerState::m_Down 에 쓰므로
+ *			다른 worker 는 request 를 보낼 때 flag 하나만 보면 된다.
+ *			timer 하나를 대기 (interval) 와 검사 timeout 에 번갈아 쓴다.
+ */
+class HealthCheck : public AEventHandler {
+private:
+	EventLoop&						m_Loop;
+	UpstreamGroup::Peer&			m_Peer;
+	const CONF::healthCheckData&	m_Config;
+	std::string						m_Request;
+	int								m_Socket;
+	bool							m_Connecting;
+	std::string						m_Response;
+	unsigned int					m_Fails;
+	unsigned int					m_Passes;
+
+	HealthCheck(const HealthCheck& other);
+	HealthCheck& operator=(const HealthCheck& other);
+
+	void	probe();
+	void	onWrite();
+	void	onRead();
+	void	finish(const bool& passed);
+	void	closeSocket();
+
+public:
+	HealthCheck(EventLoop& loop, UpstreamGroup::Peer& peer, const CONF::healthCheckData& config, const std::string& host);
+	virtual ~HealthCheck();
+
+	void	start();
+	void	handleEvent(const struct kevent& event);
+};
@@ -0,0 +1,649 @@
+#include "ProxyConnection.hpp"
+#include "ProxyUpstream.hpp"
+#include "../Cache/CacheWriter.hpp"
+#include "../Server/Client/Client.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <sys/socket.h>
+#include <unistd.h>
+
+ProxyConnection::ProxyConnection(EventLoop& loop, ProxyUpstream& upstream)
+  : m_Loop(loop),
+	m_Upstream(upstream),
+	m_Socket(-1),
+	m_Connecting(false),
+	m_SendOffset(0),
+	m_WriteEnabled(false),
+	m_OutputPaused(false),
+	m_Client(NULL),
+	m_Location(NULL),
+	m_Peer(NULL),
+	m_Requests(0),
+	m_Busy(false),
+	m_ReadTimeout(0),
+	m_TimerArmed(false),
+	m_HeadRequest(false),
+	m_InputDone(false),
+	m_ChunkedInput(false),
+	m_Http10(false),
+	m_CloseDelimited(false),
+	m_HeaderDone(false),
+	m_BodyType(E_PROXY::NONE),
+	m_BodyLeft(0),
+	m_KeepAlive(false),
+	m_Cache(NULL),
+	m_Refresh(NULL),
+	m_RefreshKey(0)
+{}
+
+ProxyConnection::~ProxyConnection() {
+	endCache(false);
+	if (m_Socket >= 0) {
+		m_Loop.forget(m_Socket);
+		::close(m_Socket);
+	}
+}
+
+bool	ProxyConnection::open() {
+	m_Socket = m_Upstream.connect(m_Connecting);
+	if (m_Socket < 0) {
+		return false;
+	}
+	m_Loop.addRead(m_Socket, this);
+	m_Loop.addWrite(m_Socket, this);
+	if (m_Connecting) {
+		m_Loop.enableWrite(m_Socket, this);
+		m_WriteEnabled = true;
+	}
+	return true;
+}
+
+/**
+ * @brief	request line + header 를 만들어서 보낸다. body 는 writeBody() 로 그대로 따라간다.
+ */
+void	ProxyConnection::begin(Client& client, UpstreamGroup::Peer& peer) {
+	request(client, peer, false);
+}
+
+/**
+ * @brief	stale_while_revalidate: client 의 request 로 GET 을 만들어 보내고, 응답은 cache 에만 쓴다.
+ * @details	client 는 옛 응답을 받고 먼저 끝날 수 있으므로 여기서부터는 client 를 보지 않는다.
+ *			zone 의 lock 은 이 연결이 넘겨받아서 응답이 끝나거나 실패하면 놓는다.
+ */
+void	ProxyConnection::refresh(Client& client, UpstreamGroup::Peer& peer, CacheZone& zone, const unsigned long& key) {
+	request(client, peer, true);
+	m_Client = NULL;
+	m_InputDone = true;
+	m_Refresh = &zone;
+	m_RefreshKey = key;
+}
+
+/**
+ * @details	hop-by-hop header 는 빼고, Host 는 upstream 주소로 바꾸고,
+ *			X-Forwarded-For / X-Real-IP 에 client 주소를 붙인다.
+ *			refresh 면 method 는 GET 이고, 조건부 / 범위 header 와 body 는 보내지 않는다. (전체 응답을 받아야 한다)
+ */
+void	ProxyConnection::request(Client& client, UpstreamGroup::Peer& peer, const bool& refresh) {
+	const CONF::LocationBlock&	location = *client.getLocation();
+	const CONF::proxyPassData&	pass = location.getProxy_pass();
+	const HTTP::Request&		request = client.getRequest();
+	const std::string			method = refresh ? "GET" : request.getMethod();
+	std::stringstream			host;
+	std::string					head;
+
+	m_Client = &client;
+	m_Location = &location;
+	m_Peer = &peer;
+	m_Requests++;
+	m_Busy = true;
+	m_ReadTimeout = location.getProxy_read_timeout();
+	m_HeadRequest = (method == "HEAD");
+	m_CacheKey = (method == "GET" && CacheZone::find(&location) != NULL) ? CacheZone::key(client) : "";
+	m_InputDone = false;
+	m_ChunkedInput = (!refresh && request.isChunked());
+	m_Http10 = (!refresh && request.getVersion() == "HTTP/1.0");
+	m_CloseDelimited = false;
+	m_Header.clear();
+	m_HeaderDone = false;
+	m_BodyType = E_PROXY::NONE;
+	m_BodyLeft = 0;
+	m_Chunked.clear();
+	m_KeepAlive = true;
+
+	head.reserve(request.getHeaderSize() + 128);
+	head += method + " ";
+	if (pass.m_Uri.empty()) {
+		head += request.getTarget();
+	} else {
+		const std::string&	path = request.getPath();
+		head += pass.m_Uri + path.substr(std::min(client.getLocationMatch(), path.size()));
+		if (!request.getQuery().empty()) {
+			head += "?" + request.getQuery();
+		}
+	}
+	// upstream 블록이면 블록 이름이 Host 가 된다. (nginx 의 $proxy_host)
+	host << pass.m_Host;
+	if (pass.m_Port != 80) {
+		host << ":" << pass.m_Port;
+	}
+	head += " HTTP/1.1\r\nHost: " + host.str() + "\r\n";
+
+	const HTTP::Request::headerMap&	headers = request.getHeaders();
+	std::string						forwarded = client.getRemoteAddr();
+	for (HTTP::Request::headerMap::const_iterator it = headers.begin(); it != headers.end(); ++it) {
+		const std::string&	name = it->first;
+		if (name == "x-forwarded-for") {
+			forwarded = it->second + ", " + forwarded;
+			continue;
+		}
+		if (name == "host" || name == "connection" || name == "keep-alive" || name == "proxy-connection"
+			|| name == "te" || name == "upgrade" || name == "trailer" || name == "transfer-encoding"
+			|| name == "x-real-ip") {
+			continue;
+		}
+		if (refresh && (name == "if-modified-since" || name == "if-none-match" || name == "if-range"
+			|| name == "range" || name == "content-length" || name == "expect")) {
+			continue;
+		}
+		head += name + ": " + it->second + "\r\n";
+	}
+	if (m_ChunkedInput) {
+		head += "Transfer-Encoding: chunked\r\n";
+	}
+	head += "X-Forwarded-For: " + forwarded + "\r\nX-Real-IP: " + client.getRemoteAddr() + "\r\n\r\n";
+
+	send(head);
+	armTimer(m_Connecting ? location.getProxy_connect_timeout() : m_ReadTimeout);
+}
+
+/**
+ * @brief	버퍼가 비어 있으면 바로 보내 보고, 남은 것만 쌓는다.
+ */
+void	ProxyConnection::send(const std::string& data) {
+	std::size_t	sent = 0;
+
+	if (m_Socket < 0) {
+		return ;
+	}
+	if (!m_Connecting && m_SendOffset == m_SendBuffer.size()) {
+		m_SendBuffer.clear();
+		m_SendOffset = 0;
+
+		const ssize_t	writeSize = ::send(m_Socket, data.data(), data.size(), 0);
+		sent = (writeSize > 0) ? static_cast<std::size_t>(writeSize) : 0;
+	}
+	if (sent < data.size()) {
+		m_SendBuffer.append(data, sent, std::string::npos);
+		if (!m_WriteEnabled) {
+			m_Loop.enableWrite(m_Socket, this);
+			m_WriteEnabled = true;
+		}
+	}
+}
+
+void	ProxyConnection::writeBody(const char* data, const std::size_t& size) {
+	if (size > 0 && m_ChunkedInput) {
+		std::string	chunk;
+		HTTP::appendChunk(chunk, data, size);
+		send(chunk);
+	} else if (size > 0) {
+		send(std::string(data, size));
+	}
+}
+
+void	ProxyConnection::endBody() {
+	if (m_ChunkedInput && !m_InputDone) {
+		send("0\r\n\r\n");
+	}
+	m_InputDone = true;
+}
+
+/**
+ * @brief	connect / read timeout. 다시 걸면 이전 것은 없어진다. (EV_ONESHOT)
+ */
+void	ProxyConnection::armTimer(const unsigned int& milliseconds) {
+	m_Loop.addTimeout(reinterpret_cast<uintptr_t>(this), milliseconds, this);
+	m_TimerArmed = true;
+}
+
+void	ProxyConnection::disarmTimer() {
+	if (m_TimerArmed) {
+		m_Loop.removeTimer(reinterpret_cast<uintptr_t>(this));
+		m_TimerArmed = false;
+	}
+}
+
+void	ProxyConnection::handleEvent(const struct kevent& event) {
+	if (event.filter == EVFILT_TIMER) {
+		m_TimerArmed = false;
+		if (m_Busy) {
+			fail(504, E_UPSTREAM_GROUP::FAILED);
+		}
+		return ;
+	}
+	if (m_Socket < 0) {
+		return ;
+	}
+	if (event.filter == EVFILT_WRITE) {
+		m_Connecting ? onConnect() : onWrite();
+	} else if (event.filter == EVFILT_READ) {
+		onRead();
+	}
+}
+
+void	ProxyConnection::onConnect() {
+	int			error = 0;
+	socklen_t	length = sizeof(error);
+
+	if (getsockopt(m_Socket, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0) {
+		fail(502, E_UPSTREAM_GROUP::FAILED);
+		return ;
+	}
+	m_Connecting = false;
+	armTimer(m_ReadTimeout);
+	onWrite();
+}
+
+void	ProxyConnection::onWrite() {
+	if (m_SendOffset < m_SendBuffer.size()) {
+		const ssize_t	writeSize = ::send(m_Socket, m_SendBuffer.data() + m_SendOffset, m_SendBuffer.size() - m_SendOffset, 0);
+		if (writeSize < 0) {
+			return ;
+		}
+		m_SendOffset += writeSize;
+	}
+	if (m_SendOffset == m_SendBuffer.size()) {
+		m_SendBuffer.clear();
+		m_SendOffset = 0;
+		m_Loop.disableWrite(m_Socket, this);
+		m_WriteEnabled = false;
+	}
+	if (m_Client != NULL && getPendingInput() < E_CLIENT::LOW_WATERMARK) {
+		m_Client->resumeRead();
+	}
+}
+
+void	ProxyConnection::onRead() {
+	char			buf[E_PROXY::READ_SIZE];
+	const ssize_t	readSize = recv(m_Socket, buf, sizeof(buf), 0);
+
+	if (readSize < 0) {
+		return ;
+	}
+	if (!m_Busy) {
+		// idle 연결을 upstream 이 닫았다.
+		close();
+		return ;
+	}
+	if (readSize == 0) {
+		onEof();
+		return ;
+	}
+	armTimer(m_ReadTimeout);
+
+	if (m_HeaderDone) {
+		responseBody(buf, readSize);
+	} else {
+		std::size_t	headerEnd;
+
+		m_Header.append(buf, readSize);
+		while (!m_HeaderDone && (headerEnd = m_Header.find("\r\n\r\n")) != std::string::npos) {
+			if (!responseHeader(headerEnd)) {
+				fail(502, E_UPSTREAM_GROUP::FAILED);
+				return ;
+			}
+		}
+		if (!m_HeaderDone) {
+			if (m_Header.size() > E_PROXY::MAX_HEADER_SIZE) {
+				fail(502, E_UPSTREAM_GROUP::FAILED);
+			}
+			return ;
+		}
+		std::string	body;
+		body.swap(m_Header);
+		responseBody(body.data(), body.size());
+	}
+
+	if (m_Busy && m_Client != NULL && m_Client->getPendingOutput() > E_CLIENT::HIGH_WATERMARK && !m_OutputPaused) {
+		m_Loop.disableRead(m_Socket, this);
+		m_OutputPaused = true;
+	}
+}
+
+/**
+ * @brief	upstream status line + header -> client 응답 header
+ * @details	header 부분은 m_Header 에서 지운다. 1xx (101 제외) 는 버리고 다음 header 를 기다린다.
+ * @return	false 면 잘못된 응답 (502)
+ */
+bool	ProxyConnection::responseHeader(const std::size_t& headerEnd) {
+	std::size_t	lineEnd = m_Header.find("\r\n");
+	const std::string	statusLine = m_Header.substr(0, lineEnd);
+
+	if (statusLine.size() < 12 || statusLine.compare(0, 7, "HTTP/1.") != 0 || statusLine[8] != ' ') {
+		return false;
+	}
+	const int	status = std::atoi(statusLine.c_str() + 9);
+	if (status < 100 || status > 599 || status == 101) {
+		return false;
+	}
+	if (status < 200) {
+		m_Header.erase(0, headerEnd + 4);
+		return true;
+	}
+
+	std::string	fields;
+	std::string	plainFields;
+	std::string	cacheControl;
+	bool		storable = true;
+	bool		hasLength = false;
+	bool		chunked = false;
+	bool		keepAlive = (statusLine[7] != '0');
+	std::size_t	pos = lineEnd + 2;
+
+	while (pos < headerEnd) {
+		lineEnd = m_Header.find("\r\n", pos);
+		const std::string	line = m_Header.substr(pos, lineEnd - pos);
+		pos = lineEnd + 2;
+
+		const std::size_t	colonPos = line.find(':');
+		if (colonPos == std::string::npos || colonPos == 0) {
+			return false;
+		}
+		std::string	name = line.substr(0, colonPos);
+		for (std::size_t i = 0; i < name.size(); i++) {
+			name[i] = std::tolower(name[i]);
+		}
+		std::size_t	valueStart = colonPos + 1;
+		while (valueStart < line.size() && (line[valueStart] == ' ' || line[valueStart] == '\t')) {
+			valueStart++;
+		}
+		std::string	value = line.substr(valueStart);
+		for (std::size_t i = 0; i < value.size(); i++) {
+			value[i] = std::tolower(value[i]);
+		}
+
+		if (name == "connection") {
+			keepAlive = (value.find("close") == std::string::npos) && (keepAlive || value.find("keep-alive") != std::string::npos);
+			continue;
+		}
+		if (name == "keep-alive" || name == "proxy-connection") {
+			continue;
+		}
+		if (name == "transfer-encoding") {
+			chunked |= (value.find("chunked") != std::string::npos);
+		} else if (name == "content-length") {
+			// 숫자가 아니거나 두 번 오면 body 끝을 믿을 수 없다. (RFC 9112 6.3)
+			if (hasLength || value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+				return false;
+			}
+			hasLength = true;
+			m_BodyLeft = std::strtoul(value.c_str(), NULL, 10);
+		} else if (name == "cache-control") {
+			cacheControl += value + ",";
+		} else if (name == "set-cookie" || name == "vary") {
+			// cache key 에 request header 를 넣지 않으므로 header 마다 다른 응답은 저장하지 않는다.
+			storable = false;
+		}
+		fields += line + "\r\n";
+		if (name != "transfer-encoding") {
+			plainFields += line + "\r\n";
+		}
+	}
+	if (chunked && hasLength) {
+		return false;
+	}
+
+	m_KeepAlive = keepAlive;
+	if (m_HeadRequest || status == 204 || status == 304) {
+		m_BodyType = E_PROXY::NONE;
+	} else if (chunked) {
+		m_BodyType = E_PROXY::CHUNKED;
+	} else if (hasLength) {
+		m_BodyType = E_PROXY::LENGTH;
+	} else {
+		// 연결 종료로 끝나는 body. client 쪽은 chunked 로 감싼다.
+		m_BodyType = E_PROXY::CLOSE;
+		m_KeepAlive = false;
+	}
+
+	// cache 와 HTTP/1.1 client 는 길이 모르는 body 를 chunked 로 받는다.
+	// HTTP/1.0 client 는 chunked 를 모르므로 풀어서 보내고 연결 종료로 끝을 알린다.
+	const std::string	head = "HTTP/1.1" + statusLine.substr(8) + "\r\n" + fields
+							+ (m_BodyType == E_PROXY::CLOSE ? "Transfer-Encoding: chunked\r\n" : "") + "\r\n";
+	m_CloseDelimited = (m_Http10 && (m_BodyType == E_PROXY::CHUNKED || m_BodyType == E_PROXY::CLOSE));
+	m_Header.erase(0, headerEnd + 4);
+	m_HeaderDone = true;
+	if (status >= 500 && m_Client != NULL && m_Client->serveStale()) {
+		// stale_if_error: client 는 옛 응답을 받았다. 이 응답은 끝까지 읽어서 버리고 연결만 재사용한다.
+		m_Client = NULL;
+		return true;
+	}
+	if (m_Client != NULL && m_CloseDelimited) {
+		const std::string	plainHead = "HTTP/1.1" + statusLine.substr(8) + "\r\n" + plainFields + "\r\n";
+		m_Client->closeAfterResponse();
+		m_Client->send(plainHead.data(), plainHead.size());
+	} else if (m_Client != NULL) {
+		m_Client->send(head.data(), head.size());
+	}
+	if (storable) {
+		startCache(status, cacheControl, head);
+	}
+	return true;
+}
+
+/**
+ * @brief	body 를 client 에게 넘기면서 응답의 끝을 찾는다.
+ * @details	응답 뒤에 남는 byte 가 있으면 upstream 을 믿을 수 없으므로 연결을 재사용하지 않는다.
+ */
+void	ProxyConnection::responseBody(const char* data, const std::size_t& size) {
+	std::size_t	used;
+	std::string	decoded;
+
+	switch (m_BodyType) {
+		case E_PROXY::NONE:
+			m_KeepAlive &= (size == 0);
+			complete(m_KeepAlive);
+			return ;
+		case E_PROXY::LENGTH:
+			used = std::min(size, m_BodyLeft);
+			if (used > 0) {
+				output(data, used);
+			}
+			m_BodyLeft -= used;
+			if (m_BodyLeft == 0) {
+				m_KeepAlive &= (used == size);
+				complete(m_KeepAlive);
+			}
+			return ;
+		case E_PROXY::CHUNKED:
+			used = m_CloseDelimited ? m_Chunked.decode(data, size, decoded) : m_Chunked.scan(data, size);
+			if (m_Chunked.isError()) {
+				fail(502, E_UPSTREAM_GROUP::FAILED);
+				return ;
+			}
+			if (used > 0) {
+				m_CloseDelimited ? output(decoded.data(), decoded.size(), data, used) : output(data, used);
+			}
+			if (m_Chunked.isDone()) {
+				m_KeepAlive &= (used == size);
+				complete(m_KeepAlive);
+			}
+			return ;
+		case E_PROXY::CLOSE:
+			if (size > 0) {
+				std::string	chunk;
+				HTTP::appendChunk(chunk, data, size);
+				m_CloseDelimited ? output(data, size, chunk.data(), chunk.size()) : output(chunk.data(), chunk.size());
+			}
+			return ;
+	}
+}
+
+void	ProxyConnection::output(const char* data, const std::size_t& size) {
+	output(data, size, data, size);
+}
+
+/**
+ * @brief	client 와 cache 에 다른 모양을 쓸 때. (HTTP/1.0 client 는 chunk 를 푼 body 를 받는다)
+ */
+void	ProxyConnection::output(const char* data, const std::size_t& size, const char* cacheData, const std::size_t& cacheSize) {
+	if (m_Client != NULL && size > 0) {
+		m_Client->send(data, size);
+	}
+	if (m_Cache != NULL) {
+		m_Cache->write(cacheData, cacheSize);
+	}
+}
+
+/**
+ * @brief	proxy_cache location 의 GET 응답 (200 / 301 / 302) 이면 cache 파일에 쓰기 시작한다.
+ * @details	Cache-Control 의 no-store / no-cache / private, Set-Cookie, Vary 가 있는 응답은 저장하지 않는다.
+ *			stale-while-revalidate / stale-if-error 가 응답에 있으면 location 설정보다 먼저 쓴다.
+ */
+void	ProxyConnection::startCache(const int& status, const std::string& cacheControl, const std::string& head) {
+	CacheZone*	zone = CacheZone::find(m_Location);
+
+	if (zone == NULL || m_CacheKey.empty() || (status != 200 && status != 301 && status != 302)) {
+		return ;
+	}
+	const CONF::proxyCacheData&	cache = m_Location->getProxy_cache();
+	const unsigned int			maxAge = CacheZone::maxAge(cacheControl, cache.m_Valid);
+	if (maxAge == 0) {
+		return ;
+	}
+	CacheEntry	lifetime;
+	lifetime.m_Expire = EventLoop::now() + maxAge;
+	lifetime.m_StaleUpdate = lifetime.m_Expire + CacheZone::seconds(cacheControl, "stale-while-revalidate", cache.m_StaleUpdate);
+	lifetime.m_StaleError = lifetime.m_Expire + CacheZone::seconds(cacheControl, "stale-if-error", cache.m_StaleError);
+	lifetime.m_Chunked = (m_BodyType == E_PROXY::CHUNKED || m_BodyType == E_PROXY::CLOSE);
+	m_Cache = new CacheWriter(*zone, m_CacheKey, lifetime);
+	if (!m_Cache->open(head)) {
+		endCache(false);
+	}
+}
+
+/**
+ * @brief	응답이 끝까지 왔으면 cache 에 넣고, 아니면 쓰던 파일을 버린다.
+ * @details	refresh 면 lock 도 놓는다. (실패했으면 다음 request 가 다시 갱신한다)
+ */
+void	ProxyConnection::endCache(const bool& commit) {
+	if (m_Cache != NULL) {
+		commit ? m_Cache->commit() : m_Cache->abort();
+		delete m_Cache;
+		m_Cache = NULL;
+	}
+	if (m_Refresh != NULL) {
+		m_Refresh->unlock(m_RefreshKey);
+		m_Refresh = NULL;
+	}
+}
+
+void	ProxyConnection::onEof() {
+	if (m_HeaderDone && m_BodyType == E_PROXY::CLOSE) {
+		m_CloseDelimited ? output(NULL, 0, "0\r\n\r\n", 5) : output("0\r\n\r\n", 5);
+		complete(false);
+		return ;
+	}
+	// idle 로 있던 연결을 upstream 이 막 닫았으면 서버 탓이 아니다. (다른 연결로 다시 보낸다)
+	const bool	stale = (m_Requests > 1 && !m_HeaderDone && m_Header.empty());
+	fail(502, stale ? E_UPSTREAM_GROUP::ABORTED : E_UPSTREAM_GROUP::FAILED);
+}
+
+void	ProxyConnection::releasePeer(const unsigned char& result) {
+	UpstreamGroup::release(m_Peer, result);
+	m_Peer = NULL;
+}
+
+/**
+ * @brief	응답이 끝났을 때. request body 까지 다 보냈으면 client 에게 알리기 전에 idle 로 돌려서
+ *			같은 client 의 다음 request 가 바로 이 연결을 쓸 수 있게 한다.
+ */
+void	ProxyConnection::complete(const bool& keep) {
+	Client*	client = m_Client;
+
+	disarmTimer();
+	endCache(true);
+	releasePeer(E_UPSTREAM_GROUP::DONE);
+	m_Client = NULL;
+	m_Busy = false;
+	m_Header.clear();
+	resumeOutput();
+	if (!(keep && m_InputDone && m_SendOffset == m_SendBuffer.size() && m_Upstream.keep(this))) {
+		close();
+	}
+	if (client != NULL) {
+		client->responseDone();
+	}
+}
+
+/**
+ * @brief	header 를 보내기 전이면 error 응답을, 보낸 뒤면 client 연결을 끊는다.
+ * @details	응답을 한 byte 도 받지 못했고 다시 보내도 되는 request (body 없음, POST / PATCH 아님) 면
+ *			같은 묶음의 다른 서버로 다시 보낸다. idle 연결이 끊긴 것 (ABORTED) 이면 같은 서버도 새 연결로 한 번 더 고른다.
+ */
+void	ProxyConnection::fail(const unsigned short& statusCode, const unsigned char& result) {
+	Client*						client = m_Client;
+	const UpstreamGroup::Peer*	peer = m_Peer;
+	const bool					headerSent = m_HeaderDone;
+	bool						retry = false;
+
+	if (client != NULL && !headerSent && m_Header.empty()) {
+		const HTTP::Request&	request = client->getRequest();
+		retry = (request.getContentLength() == 0 && !request.isChunked() && request.getMethod() != "POST" && request.getMethod() != "PATCH");
+	}
+	endCache(false);
+	releasePeer(result);
+	m_Client = NULL;
+	m_Busy = false;
+	close();
+	if (client == NULL) {
+		return ;
+	}
+	if (headerSent) {
+		client->abort();
+	} else if (retry) {
+		client->retryProxy(statusCode, (result == E_UPSTREAM_GROUP::ABORTED) ? peer : NULL);
+	} else if (!client->serveStale()) {
+		client->sendError(statusCode);
+	}
+}
+
+void	ProxyConnection::resumeOutput() {
+	if (m_OutputPaused && m_Socket >= 0) {
+		m_Loop.enableRead(m_Socket, this);
+		m_OutputPaused = false;
+	}
+}
+
+/**
+ * @brief	client 가 먼저 끊겼을 때 Client 에서 호출한다.
+ */
+void	ProxyConnection::detach() {
+	endCache(false);
+	releasePeer(E_UPSTREAM_GROUP::ABORTED);
+	m_Client = NULL;
+	m_Busy = false;
+	close();
+}
+
+void	ProxyConnection::close() {
+	disarmTimer();
+	endCache(false);
+	if (m_Socket >= 0) {
+		m_Loop.forget(m_Socket);
+		::close(m_Socket);
+		m_Socket = -1;
+	}
+	m_SendBuffer.clear();
+	m_SendOffset = 0;
+	m_Header.clear();
+	m_Upstream.forget(this);
+	m_Loop.release(this);
+}
+
+std::size_t	ProxyConnection::getPendingInput() const {
+	return (m_SendBuffer.size() - m_SendOffset);
+}
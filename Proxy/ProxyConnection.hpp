@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../HTTP/Chunked.hpp"
+#include "../Server/Client/AResponder.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+#include "UpstreamGroup.hpp"
+#include <string>
+
+class CacheWriter;
+class CacheZone;
+class Client;
+class ProxyUpstream;
+
+namespace E_PROXY {
+	enum E_BODY {
+		NONE = 0,
+		LENGTH,
+		CHUNKED,
+		CLOSE
+	};
+	const std::size_t	READ_SIZE = 65536;
+	const std::size_t	MAX_HEADER_SIZE = 8192;
+}
+
+/**
+ * @brief	proxy_pass 의 HTTP/1.1 upstream 연결 하나
+ * @details	request 하나를 보내고 응답 끝 (Content-Length / chunked) 을 찾으면
+ *			ProxyUpstream 의 idle 목록으로 돌아가 다음 request 에 다시 쓰인다.
+ *			- body 는 고치지 않고 그대로 흘려보낸다. (chunked 는 끝만 찾는다)
+ *			- chunked request body 는 Client 가 풀어서 넘기므로 upstream 에는 다시 chunk 로 감싸서 보낸다.
+ *			- 연결 종료로 끝나는 응답은 client 쪽에서 chunked 로 감싸고, 연결은 재사용하지 않는다.
+ *			- HTTP/1.0 client 에게는 길이 모르는 body (chunked / 연결 종료) 를 풀어서 보내고 client 연결을 닫아 끝을 알린다.
+ *			  (cache 에는 HTTP/1.1 client 에게 보내는 모양 그대로 쓴다)
+ *			- proxy_connect_timeout / proxy_read_timeout 은 EventLoop timer 로 잰다. (504)
+ *			- 응답 header 를 보낸 뒤에 upstream 이 끊기면 client 연결도 끊는다.
+ *			- 끝날 때 결과 (성공 / 실패 / 중단) 를 UpstreamGroup 에 알려서 passive health check 에 쓴다.
+ *			- proxy_cache location 이면 client 에게 보내는 byte 를 CacheWriter 에도 쓴다.
+ *			- stale_while_revalidate 의 갱신은 client 없이 (m_Client == NULL) 응답을 cache 에만 쓴다.
+ *			- 5xx 응답이 오면 stale_if_error 안의 옛 응답이 있는지 client 에게 먼저 물어본다.
+ */
+class ProxyConnection : public AEventHandler, public AResponder {
+private:
+	EventLoop&				m_Loop;
+	ProxyUpstream&			m_Upstream;
+	int						m_Socket;
+	bool					m_Connecting;
+
+	std::string				m_SendBuffer;
+	std::size_t				m_SendOffset;
+	bool					m_WriteEnabled;
+	bool					m_OutputPaused;
+
+	Client*					m_Client;
+	const CONF::LocationBlock*	m_Location;
+	UpstreamGroup::Peer*	m_Peer;
+	unsigned int			m_Requests;
+	bool					m_Busy;
+	unsigned int			m_ReadTimeout;
+	bool					m_TimerArmed;
+	bool					m_HeadRequest;
+	bool					m_InputDone;
+	bool					m_ChunkedInput;
+	bool					m_Http10;
+	bool					m_CloseDelimited;
+
+	std::string				m_Header;
+	bool					m_HeaderDone;
+	unsigned char			m_BodyType;
+	std::size_t				m_BodyLeft;
+	HTTP::ChunkedScanner	m_Chunked;
+	bool					m_KeepAlive;
+	CacheWriter*			m_Cache;
+	std::string				m_CacheKey;
+	CacheZone*				m_Refresh;
+	unsigned long			m_RefreshKey;
+
+	ProxyConnection(const ProxyConnection& other);
+	ProxyConnection& operator=(const ProxyConnection& other);
+
+	void	request(Client& client, UpstreamGroup::Peer& peer, const bool& refresh);
+	void	send(const std::string& data);
+	void	armTimer(const unsigned int& milliseconds);
+	void	disarmTimer();
+	void	onConnect();
+	void	onWrite();
+	void	onRead();
+	bool	responseHeader(const std::size_t& headerEnd);
+	void	responseBody(const char* data, const std::size_t& size);
+	void	output(const char* data, const std::size_t& size);
+	void	output(const char* data, const std::size_t& size, const char* cacheData, const std::size_t& cacheSize);
+	void	startCache(const int& status, const std::string& cacheControl, const std::string& head);
+	void	endCache(const bool& commit);
+	void	onEof();
+	void	releasePeer(const unsigned char& result);
+	void	complete(const bool& keep);
+	void	fail(const unsigned short& statusCode, const unsigned char& result);
+	void	close();
+
+public:
+	ProxyConnection(EventLoop& loop, ProxyUpstream& upstream);
+	virtual ~ProxyConnection();
+
+	bool		open();
+	void		begin(Client& client, UpstreamGroup::Peer& peer);
+	void		refresh(Client& client, UpstreamGroup::Peer& peer, CacheZone& zone, const unsigned long& key);
+
+	void		writeBody(const char* data, const std::size_t& size);
+	void		endBody();
+	void		resumeOutput();
+	void		detach();
+
+	std::size_t	getPendingInput() const;
+
+	void		handleEvent(const struct kevent& event);
+};
@@ -0,0 +1,81 @@
+#include "ProxyUpstream.hpp"
+#include "ProxyConnection.hpp"
+
+#include <algorithm>
+
+ProxyUpstream::upstreamMap	ProxyUpstream::m_Upstreams;
+
+ProxyUpstream::ProxyUpstream() {}
+
+ProxyUpstream::ProxyUpstream(const std::string& address) : m_Address(address) {}
+
+ProxyUpstream::ProxyUpstream(const ProxyUpstream& other) {
+	*this = other;
+}
+
+ProxyUpstream&	ProxyUpstream::operator=(const ProxyUpstream& other) {
+	if (this != &other) {
+		m_Address = other.m_Address;
+		m_Idle = other.m_Idle;
+	}
+	return (*this);
+}
+
+ProxyUpstream::~ProxyUpstream() {}
+
+/**
+ * @brief	주소에 해당하는 upstream 을 찾거나 만든다. (fork 전에 UpstreamGroup::prepare 에서)
+ */
+ProxyUpstream*	ProxyUpstream::get(const std::string& address) {
+	upstreamMap::iterator	it = m_Upstreams.find(address);
+
+	if (it == m_Upstreams.end()) {
+		it = m_Upstreams.insert(std::make_pair(address, ProxyUpstream(address))).first;
+	}
+	return (&it->second);
+}
+
+int	ProxyUpstream::connect(bool& inProgress) const {
+	return (m_Address.connect(inProgress));
+}
+
+/**
+ * @brief	가장 최근에 돌려받은 idle 연결부터 쓴다. 없거나 fresh 면 새로 연결한다.
+ * @details	fresh 는 idle 연결이 끊겨서 다시 보낼 때 쓴다. (남은 idle 연결도 이미 닫혔을 수 있다)
+ */
+ProxyConnection*	ProxyUpstream::acquire(EventLoop& loop, const bool& fresh) {
+	if (!fresh && !m_Idle.empty()) {
+		ProxyConnection*	connection = m_Idle.back();
+		m_Idle.pop_back();
+		return (connection);
+	}
+
+	ProxyConnection*	connection = new ProxyConnection(loop, *this);
+	if (!connection->open()) {
+		delete connection;
+		return (NULL);
+	}
+	return (connection);
+}
+
+/**
+ * @return	false 면 idle 이 이미 가득 찼다. (연결을 닫는다)
+ */
+bool	ProxyUpstream::keep(ProxyConnection* connection) {
+	if (m_Idle.size() >= E_PROXY_UPSTREAM::KEEPALIVE) {
+		return false;
+	}
+	m_Idle.push_back(connection);
+	return true;
+}
+
+void	ProxyUpstream::forget(ProxyConnection* connection) {
+	const std::vector<ProxyConnection*>::iterator	it = std::find(m_Idle.begin(), m_Idle.end(), connection);
+	if (it != m_Idle.end()) {
+		m_Idle.erase(it);
+	}
+}
+
+const std::string&	ProxyUpstream::getAddress() const {
+	return (m_Address.getAddress());
+}
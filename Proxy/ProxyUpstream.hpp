@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../FileDescriptor/Socket/SocketAddress.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+class ProxyConnection;
+
+namespace E_PROXY_UPSTREAM {
+	const std::size_t	KEEPALIVE = 16;
+}
+
+/**
+ * @brief	proxy_pass 의 upstream 서버 하나 ("host:port")
+ * @details	FastCGIUpstream 과 같다. 주소는 fork 전에 해석하고,
+ *			worker 마다 응답을 끝낸 HTTP/1.1 연결을 KEEPALIVE 개까지 idle 로 들고 있다.
+ *			같은 주소는 여러 upstream 블록에 있어도 idle 연결을 함께 쓴다.
+ *			어느 서버로 보낼지는 UpstreamGroup 이 고른다.
+ */
+class ProxyUpstream {
+private:
+	typedef std::map<std::string, ProxyUpstream>	upstreamMap;
+
+	SocketAddress					m_Address;
+	std::vector<ProxyConnection*>	m_Idle;
+
+	static upstreamMap				m_Upstreams;
+
+public:
+	ProxyUpstream();
+	ProxyUpstream(const std::string& address);
+	ProxyUpstream(const ProxyUpstream& other);
+	ProxyUpstream& operator=(const ProxyUpstream& other);
+	~ProxyUpstream();
+
+	ProxyConnection*	acquire(EventLoop& loop, const bool& fresh);
+	bool				keep(ProxyConnection* connection);
+	void				forget(ProxyConnection* connection);
+	int					connect(bool& inProgress) const;
+
+	const std::string&	getAddress() const;
+
+	static ProxyUpstream*		get(const std::string& address);
+};
@@ -0,0 +1,367 @@
+#include "UpstreamGroup.hpp"
+#include "HealthCheck.hpp"
+#include "ProxyUpstream.hpp"
+#include "../Server/Client/Client.hpp"
+#include "../utils/SpinLock.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+
+UpstreamGroup::groupMap		UpstreamGroup::m_Groups;
+UpstreamGroup::locationMap	UpstreamGroup::m_Locations;
+
+UpstreamGroup::UpstreamGroup()
+  : m_Balance(E_UPSTREAM::ROUND_ROBIN),
+	m_Consistent(false),
+	m_TotalWeight(0),
+	m_Lock(NULL)
+{
+	m_HealthCheck.m_Interval = 0;
+}
+
+UpstreamGroup::UpstreamGroup(const UpstreamGroup& other) {
+	*this = other;
+}
+
+UpstreamGroup&	UpstreamGroup::operator=(const UpstreamGroup& other) {
+	if (this != &other) {
+		m_Name = other.m_Name;
+		m_Peers = other.m_Peers;
+		m_Balance = other.m_Balance;
+		m_HashKey = other.m_HashKey;
+		m_Consistent = other.m_Consistent;
+		m_Ring = other.m_Ring;
+		m_TotalWeight = other.m_TotalWeight;
+		m_Lock = other.m_Lock;
+		m_HealthCheck = other.m_HealthCheck;
+	}
+	return (*this);
+}
+
+UpstreamGroup::~UpstreamGroup() {}
+
+void	UpstreamGroup::addPeer(const CONF::upstreamServerData& server) {
+	const Peer	peer = { ProxyUpstream::get(server.m_Address), m_Peers.size(), server.m_Weight,
+						 server.m_MaxFails, server.m_FailTimeout, server.m_SlowStart, NULL };
+
+	m_Peers.push_back(peer);
+	m_TotalWeight += server.m_Weight;
+}
+
+/**
+ * @brief	ketama ring. 서버마다 KETAMA_POINTS * weight 개의 점을 주소의 hash 로 흩뿌린다.
+ * @details	점의 위치는 자기 주소로만 정해지므로, 서버 하나가 빠지면 그 서버의 key 만 옮겨 간다.
+ */
+void	UpstreamGroup::buildRing() {
+	m_Ring.clear();
+	for (std::size_t i = 0; i < m_Peers.size(); i++) {
+		const std::string&	address = m_Peers[i].m_Upstream->getAddress();
+		const unsigned int	points = E_UPSTREAM_GROUP::KETAMA_POINTS * m_Peers[i].m_Weight;
+
+		for (unsigned int point = 0; point < points; point++) {
+			std::stringstream	seed;
+			seed << address << "-" << point;
+			m_Ring.push_back(std::make_pair(hash32(seed.str()), i));
+		}
+	}
+	std::sort(m_Ring.begin(), m_Ring.end());
+}
+
+/**
+ * @brief	FNV-1a + murmur3 finalizer. 짧은 key 도 32 bit 전체에 고르게 퍼진다.
+ */
+unsigned int	UpstreamGroup::hash32(const std::string& key) {
+	unsigned int	h = 2166136261u;
+
+	for (std::size_t i = 0; i < key.size(); i++) {
+		h ^= static_cast<unsigned char>(key[i]);
+		h *= 16777619u;
+	}
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return (h);
+}
+
+/**
+ * @brief	지금 보낼 수 있는 서버인지. 공유 상태의 값 몇 개만 본다.
+ */
+bool	UpstreamGroup::usable(const Peer& peer, const unsigned long& tried, const unsigned long& now) {
+	const UpstreamPeerState&	state = *peer.m_State;
+
+	if (peer.m_Index < E_UPSTREAM_GROUP::MAX_TRIED && (tried & (1UL << peer.m_Index))) {
+		return false;
+	}
+	if (state.m_Down) {
+		return false;
+	}
+	return (peer.m_MaxFails == 0 || state.m_Fails < peer.m_MaxFails || now - state.m_FailedAt >= peer.m_FailTimeout);
+}
+
+/**
+ * @brief	slow_start 동안은 살아난 뒤 지난 시간에 비례해서 weight 를 1 부터 올린다.
+ */
+unsigned int	UpstreamGroup::effectiveWeight(const Peer& peer, const unsigned long& now) {
+	const unsigned long	recoveredAt = peer.m_State->m_RecoveredAt;
+
+	if (peer.m_SlowStart == 0 || recoveredAt == 0 || now - recoveredAt >= peer.m_SlowStart) {
+		return (peer.m_Weight);
+	}
+	const unsigned int	weight = static_cast<unsigned int>(peer.m_Weight * (now - recoveredAt) / peer.m_SlowStart);
+	return (weight > 0 ? weight : 1);
+}
+
+/**
+ * @param	tried	이 request 에서 이미 실패한 서버 (bit = Peer::m_Index)
+ * @return	보낼 서버가 없으면 NULL
+ */
+UpstreamGroup::Peer*	UpstreamGroup::select(const Client& client, const unsigned long& tried) {
+	std::string	key;
+
+	if (m_Balance == E_UPSTREAM::HASH && m_Peers.size() > 1) {
+		m_HashKey.evaluate(key, client.getRequest(), client.getRemoteAddr());
+	}
+	return (select(key, tried));
+}
+
+/**
+ * @param	key	hash 면 hash key 를 계산한 값. (다른 balance 에서는 보지 않는다)
+ */
+UpstreamGroup::Peer*	UpstreamGroup::select(const std::string& key, const unsigned long& tried) {
+	const unsigned long&	now = EventLoop::now();
+	Peer*					peer;
+
+	if (m_Peers.size() == 1) {
+		// 하나뿐이면 실패 기록과 상관없이 보낸다. (보낼 곳이 없으므로)
+		peer = (tried & 1UL) ? NULL : &m_Peers[0];
+	} else if (m_Balance == E_UPSTREAM::HASH) {
+		peer = hash(key, tried, now);
+	} else {
+		peer = roundRobin(m_Balance == E_UPSTREAM::LEAST_CONN, tried, now);
+	}
+	if (peer != NULL) {
+		__sync_fetch_and_add(&peer->m_State->m_Conns, 1);
+	}
+	return (peer);
+}
+
+/**
+ * @brief	upstream 연결이 request 하나를 끝냈을 때
+ * @details	- DONE: 실패 횟수를 지운다. 죽었던 서버면 slow start 를 시작한다.
+ *			- FAILED: fail_timeout 안의 실패 횟수를 센다.
+ *			- ABORTED: client 가 먼저 끊겼거나, 서버 탓이 아닌 실패. 연결 수만 줄인다.
+ */
+void	UpstreamGroup::release(Peer* peer, const unsigned char& result) {
+	if (peer == NULL) {
+		return ;
+	}
+	UpstreamPeerState&		state = *peer->m_State;
+	const unsigned long&	now = EventLoop::now();
+
+	__sync_fetch_and_sub(&state.m_Conns, 1);
+	if (result == E_UPSTREAM_GROUP::FAILED && peer->m_MaxFails > 0) {
+		if (now - state.m_FailedAt >= peer->m_FailTimeout) {
+			state.m_Fails = 0;
+		}
+		state.m_FailedAt = now;
+		__sync_fetch_and_add(&state.m_Fails, 1);
+	} else if (result == E_UPSTREAM_GROUP::DONE && state.m_Fails > 0) {
+		if (state.m_Fails >= peer->m_MaxFails) {
+			state.m_RecoveredAt = now;
+		}
+		state.m_Fails = 0;
+	}
+}
+
+/**
+ * @brief	smooth weighted round robin. (weight 5, 1, 1 -> a a b a c a a)
+ * @details	매번 보낼 수 있는 모든 서버의 current 에 weight 를 더하고,
+ *			가장 큰 서버를 고른 뒤 그 서버에서 총합을 뺀다.
+ *			leastConn 이면 연결 수 / weight 가 가장 작은 서버들 사이에서만 고른다.
+ */
+UpstreamGroup::Peer*	UpstreamGroup::roundRobin(const bool& leastConn, const unsigned long& tried, const unsigned long& now) {
+	ft::SpinLock	lock(m_Lock);
+	Peer*			least = NULL;
+	unsigned int	leastWeight = 0;
+	Peer*			best = NULL;
+	int				total = 0;
+
+	if (leastConn) {
+		for (std::vector<Peer>::iterator it = m_Peers.begin(); it != m_Peers.end(); ++it) {
+			if (!usable(*it, tried, now)) {
+				continue;
+			}
+			const unsigned int	weight = effectiveWeight(*it, now);
+			if (least == NULL || static_cast<unsigned long>(it->m_State->m_Conns) * leastWeight
+									< static_cast<unsigned long>(least->m_State->m_Conns) * weight) {
+				least = &*it;
+				leastWeight = weight;
+			}
+		}
+		if (least == NULL) {
+			return (NULL);
+		}
+	}
+	for (std::vector<Peer>::iterator it = m_Peers.begin(); it != m_Peers.end(); ++it) {
+		if (!usable(*it, tried, now)) {
+			continue;
+		}
+		const unsigned int	weight = effectiveWeight(*it, now);
+		if (least != NULL && static_cast<unsigned long>(it->m_State->m_Conns) * leastWeight
+								!= static_cast<unsigned long>(least->m_State->m_Conns) * weight) {
+			continue;
+		}
+		it->m_State->m_CurrentWeight += weight;
+		total += weight;
+		if (best == NULL || it->m_State->m_CurrentWeight > best->m_State->m_CurrentWeight) {
+			best = &*it;
+		}
+	}
+	if (best == NULL) {
+		// 연결 수는 lock 없이 바뀐다. 그 사이에 바뀌었으면 가장 한가한 서버로 보낸다.
+		return (least);
+	}
+	best->m_State->m_CurrentWeight -= total;
+	return (best);
+}
+
+/**
+ * @details	고른 서버를 쓸 수 없으면 consistent 는 ring 의 다음 서버로, 아니면 round robin 으로 넘어간다.
+ */
+UpstreamGroup::Peer*	UpstreamGroup::hash(const std::string& key, const unsigned long& tried, const unsigned long& now) {
+	const unsigned int	h = hash32(key);
+
+	if (m_Consistent) {
+		ringVec::const_iterator	it = std::lower_bound(m_Ring.begin(), m_Ring.end(), std::make_pair(h, static_cast<std::size_t>(0)));
+		for (std::size_t step = 0; step < m_Ring.size(); step++, ++it) {
+			if (it == m_Ring.end()) {
+				it = m_Ring.begin();
+			}
+			if (usable(m_Peers[it->second], tried, now)) {
+				return (&m_Peers[it->second]);
+			}
+		}
+		return (NULL);
+	}
+
+	unsigned int	point = h % m_TotalWeight;
+	for (std::vector<Peer>::iterator it = m_Peers.begin(); it != m_Peers.end(); ++it) {
+		if (point < it->m_Weight) {
+			return (usable(*it, tried, now) ? &*it : roundRobin(false, tried, now));
+		}
+		point -= it->m_Weight;
+	}
+	return (roundRobin(false, tried, now));
+}
+
+/**
+ * @brief	proxy_pass 의 host 가 upstream 블록 이름이면 그 블록을, 아니면 "host:port" 하나짜리 묶음을 쓴다.
+ */
+void	UpstreamGroup::prepareLocation(const CONF::ServerBlock&, const CONF::LocationBlock& location, const std::string&, void* context) {
+	const CONF::HTTPBlock&		http = *static_cast<const CONF::HTTPBlock*>(context);
+	const CONF::proxyPassData&	pass = location.getProxy_pass();
+
+	if (!pass.m_Host.empty()) {
+		std::string	name = pass.m_Host;
+		for (std::size_t i = 0; i < name.size(); i++) {
+			name[i] = std::tolower(name[i]);
+		}
+		const CONF::HTTPBlock::upstreamMap&					upstreams = http.getUpstreamMap();
+		const CONF::HTTPBlock::upstreamMap::const_iterator	upstream = upstreams.find(name);
+		std::stringstream									key;
+
+		(upstream != upstreams.end()) ? key << name : key << pass.m_Host << ":" << pass.m_Port;
+		groupMap::iterator	it = m_Groups.find(key.str());
+		if (it == m_Groups.end()) {
+			UpstreamGroup	group;
+			group.m_Name = pass.m_Host;
+			if (upstream != upstreams.end()) {
+				const std::vector<CONF::upstreamServerData>&	servers = upstream->second.getServer();
+				for (std::vector<CONF::upstreamServerData>::const_iterator server = servers.begin(); server != servers.end(); ++server) {
+					group.addPeer(*server);
+				}
+				group.m_HealthCheck = upstream->second.getHealth_check();
+				group.m_Balance = upstream->second.getBalance();
+				group.m_Consistent = upstream->second.getConsistent();
+				if (group.m_Balance == E_UPSTREAM::HASH) {
+					group.m_HashKey.compile(upstream->second.getHash_key());
+				}
+				if (group.m_Consistent) {
+					group.buildRing();
+				}
+			} else {
+				const CONF::upstreamServerData	server = { key.str(), 1, 0, 0, 0 };
+				group.addPeer(server);
+			}
+			it = m_Groups.insert(std::make_pair(key.str(), group)).first;
+		}
+		m_Locations[&location] = &it->second;
+	}
+}
+
+/**
+ * @brief	묶음마다 lock 하나 + 서버마다 상태 하나를 한 공유 영역에 cache line 단위로 나눠 준다.
+ */
+void	UpstreamGroup::mapState() {
+	const std::size_t	line = E_UPSTREAM_GROUP::CACHE_LINE;
+	std::size_t			size = 0;
+
+	for (groupMap::const_iterator it = m_Groups.begin(); it != m_Groups.end(); ++it) {
+		size += line * (1 + it->second.m_Peers.size());
+	}
+	if (size == 0) {
+		return ;
+	}
+	void*	region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_ANON | MAP_SHARED, -1, 0);
+	if (region == MAP_FAILED) {
+		throw std::runtime_error("UpstreamGroup::prepare(): mmap failed");
+	}
+
+	char*	cursor = static_cast<char*>(region);
+	for (groupMap::iterator it = m_Groups.begin(); it != m_Groups.end(); ++it) {
+		it->second.m_Lock = reinterpret_cast<volatile int*>(cursor);
+		cursor += line;
+		for (std::vector<Peer>::iterator peer = it->second.m_Peers.begin(); peer != it->second.m_Peers.end(); ++peer) {
+			peer->m_State = reinterpret_cast<UpstreamPeerState*>(cursor);
+			cursor += line;
+		}
+	}
+}
+
+/**
+ * @brief	proxy_pass 가 설정된 모든 location 의 묶음과 공유 상태를 만든다. (fork 전에 한 번)
+ */
+void	UpstreamGroup::prepare(const CONF::MainBlock& mainBlock) {
+	const CONF::HTTPBlock&	http = mainBlock.getHTTPBlock();
+
+	http.visitLocations(NULL, prepareLocation, const_cast<CONF::HTTPBlock*>(&http));
+	mapState();
+}
+
+/**
+ * @brief	location 의 proxy_pass 에 해당하는 묶음. (location 주소는 fork 후에도 같다)
+ */
+UpstreamGroup*	UpstreamGroup::find(const CONF::LocationBlock* location) {
+	const locationMap::const_iterator	it = m_Locations.find(location);
+	return (it != m_Locations.end() ? it->second : NULL);
+}
+
+/**
+ * @brief	health_check 가 있는 묶음의 서버마다 검사를 시작한다. (worker 하나에서만)
+ */
+void	UpstreamGroup::startHealthChecks(EventLoop& loop) {
+	for (groupMap::iterator it = m_Groups.begin(); it != m_Groups.end(); ++it) {
+		if (it->second.m_HealthCheck.m_Interval == 0) {
+			continue;
+		}
+		for (std::vector<Peer>::iterator peer = it->second.m_Peers.begin(); peer != it->second.m_Peers.end(); ++peer) {
+			HealthCheck*	check = new HealthCheck(loop, *peer, it->second.m_HealthCheck, it->second.m_Name);
+			check->start();
+		}
+	}
+}
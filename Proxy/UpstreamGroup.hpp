@@ -0,0 +1,105 @@
+#pragma once
+
+#include "../HTTP/ComplexValue.hpp"
+#include "../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include "../Server/EventLoop/EventLoop.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+class Client;
+class ProxyUpstream;
+
+namespace E_UPSTREAM_GROUP {
+	enum E_RESULT {
+		DONE = 0,
+		FAILED,
+		ABORTED
+	};
+	const std::size_t	CACHE_LINE = 64;
+	const unsigned int	KETAMA_POINTS = 160;
+	const std::size_t	MAX_TRIED = sizeof(unsigned long) * 8;
+}
+
+/**
+ * @brief	모든 worker 가 함께 보는 서버별 상태 (공유 메모리)
+ * @details	서로 다른 서버의 상태가 같은 cache line 에 올라가지 않도록 CACHE_LINE 간격으로 둔다.
+ *			- m_Fails / m_FailedAt: passive. proxy 요청이 실패할 때마다 worker 가 센다.
+ *			- m_Down: active. health check 를 하는 worker 하나만 쓴다.
+ *			- m_RecoveredAt: 다시 살아난 시각. slow_start 동안 weight 를 줄인다.
+ */
+struct UpstreamPeerState {
+	volatile int			m_CurrentWeight;
+	volatile unsigned int	m_Conns;
+	volatile unsigned int	m_Fails;
+	volatile unsigned long	m_FailedAt;
+	volatile unsigned long	m_RecoveredAt;
+	volatile unsigned char	m_Down;
+};
+
+/**
+ * @brief	proxy_pass 가 가리키는 서버 묶음 (upstream 블록, 또는 주소 하나짜리 묶음)
+ * @details	- round robin: nginx 의 smooth weighted round robin. weight 비율대로, 고르게 섞어서 보낸다.
+ *			- least_conn: 진행 중인 연결 수 / weight 가 가장 작은 서버. 같으면 round robin.
+ *			- hash key: key 의 hash 를 weight 비율로 나눈다.
+ *			- hash key consistent: ketama ring. 서버가 빠지거나 늘어도 대부분의 key 는 그대로 간다.
+ *			round robin 의 current weight 와 서버별 연결 수는 fork 전에 만든 공유 메모리에 있어서
+ *			worker 가 여러 개여도 하나의 balancer 처럼 동작한다.
+ *			죽은 서버 (max_fails / health check) 는 고를 때 공유 상태의 flag 만 보고 건너뛴다.
+ *			한 request 안에서 이미 실패한 서버는 tried bitmask 로 건너뛴다. (앞 MAX_TRIED 개까지)
+ */
+class UpstreamGroup {
+public:
+	struct Peer {
+		ProxyUpstream*		m_Upstream;
+		std::size_t			m_Index;
+		unsigned int		m_Weight;
+		unsigned int		m_MaxFails;
+		unsigned int		m_FailTimeout;
+		unsigned int		m_SlowStart;
+		UpstreamPeerState*	m_State;
+	};
+
+private:
+	typedef std::map<std::string, UpstreamGroup>					groupMap;
+	typedef std::map<const CONF::LocationBlock*, UpstreamGroup*>	locationMap;
+	typedef std::vector<std::pair<unsigned int, std::size_t> >		ringVec;
+
+	std::string				m_Name;
+	std::vector<Peer>		m_Peers;
+	unsigned char			m_Balance;
+	HTTP::ComplexValue		m_HashKey;
+	bool					m_Consistent;
+	ringVec					m_Ring;
+	unsigned int			m_TotalWeight;
+	volatile int*			m_Lock;
+	CONF::healthCheckData	m_HealthCheck;
+
+	static groupMap			m_Groups;
+	static locationMap		m_Locations;
+
+	void	addPeer(const CONF::upstreamServerData& server);
+	void	buildRing();
+	Peer*	roundRobin(const bool& leastConn, const unsigned long& tried, const unsigned long& now);
+	Peer*	hash(const std::string& key, const unsigned long& tried, const unsigned long& now);
+
+	static bool			usable(const Peer& peer, const unsigned long& tried, const unsigned long& now);
+	static unsigned int	effectiveWeight(const Peer& peer, const unsigned long& now);
+	static unsigned int	hash32(const std::string& key);
+	static void			prepareLocation(const CONF::ServerBlock& server, const CONF::LocationBlock& location, const std::string& name, void* context);
+	static void			mapState();
+
+public:
+	UpstreamGroup();
+	UpstreamGroup(const UpstreamGroup& other);
+	UpstreamGroup& operator=(const UpstreamGroup& other);
+	~UpstreamGroup();
+
+	Peer*	select(const Client& client, const unsigned long& tried);
+	Peer*	select(const std::string& key, const unsigned long& tried);
+
+	static void				release(Peer* peer, const unsigned char& result);
+	static void				startHealthChecks(EventLoop& loop);
+	static void				prepare(const CONF::MainBlock& mainBlock);
+	static UpstreamGroup*	find(const CONF::LocationBlock* location);
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief	Client 대신 응답을 만들어 주는 쪽 (CGI, FastCGI, proxy)
+ * @details	Client 는 받는 대로 request body 를 writeBody() / endBody() 로 넘긴다.
+ *			응답이 끝나면 responder 가 Client::responseDone() 또는 sendError() 를 부르고,
+ *			client 가 먼저 끊기면 Client 가 detach() 를 부른다. (그 뒤로 Client 를 건드리면 안 된다)
+ */
+class AResponder {
+public:
+	virtual ~AResponder() {}
+
+	virtual void		writeBody(const char* data, const std::size_t& size) = 0;
+	virtual void		endBody() = 0;
+	virtual void		resumeOutput() = 0;
+	virtual void		detach() = 0;
+
+	virtual std::size_t	getPendingInput() const = 0;
+};
@@ -0,0 +1,1121 @@
+#include "Client.hpp"
+#include "../../Cache/CacheZone.hpp"
+#include "../../Cache/FileCache.hpp"
+#include "../../Cache/MicroCache.hpp"
+#include "../../CGI/CGIPool.hpp"
+#include "../../CGI/CGIProcess.hpp"
+#include "../../FastCGI/FastCGIConnection.hpp"
+#include "../../FastCGI/FastCGIUpstream.hpp"
+#include "../../Log/AccessLog.hpp"
+#include "../../Log/RequestTrace.hpp"
+#include "../../Log/SlowRequestLog.hpp"
+#include "../../Proxy/ProxyConnection.hpp"
+#include "../../Proxy/ProxyUpstream.hpp"
+#include "../../Proxy/UpstreamGroup.hpp"
+#include "../ErrorPage/ErrorPage.hpp"
+#include "../Server/Server.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+Client::Client(const int& fd, const std::string& remoteAddr, EventLoop& loop, Server& server)
+  : m_Socket(fd),
+	m_RemoteAddr(remoteAddr),
+	m_Loop(loop),
+	m_Server(server),
+	m_SendOffset(0),
+	m_WriteEnabled(false),
+	m_ReadPaused(false),
+	m_File(-1),
+	m_FileOffset(0),
+	m_FileLeft(0),
+	m_HeaderDone(false),
+	m_Responding(false),
+	m_KeepAlive(true),
+	m_Closing(false),
+	m_Draining(false),
+	m_BodyLeft(0),
+	m_ServerBlock(NULL),
+	m_Location(NULL),
+	m_LocationMatch(0),
+	m_Responder(NULL),
+	m_UpstreamTried(0),
+	m_UpstreamFresh(false),
+	m_CacheLock(NULL),
+	m_MicroLock(NULL),
+	m_CacheKey(0),
+	m_CacheWaitStart(0),
+	m_CacheWaiting(false),
+	m_RequestStart(0),
+	m_Status(0),
+	m_BytesSent(0),
+	m_HeaderBytes(0),
+	m_HeaderEnd(0),
+	m_Phase(E_METRICS::CLOSED)
+{
+	Metrics::accept(m_Phase);
+	m_Timing.mark(E_TIMING::ACCEPT);
+}
+
+Client::~Client() {
+	closeFile();
+	Metrics::move(m_Phase, E_METRICS::CLOSED);
+}
+
+void	Client::handleEvent(const struct kevent& event) {
+	if (m_Closing && event.filter == EVFILT_READ) {
+		return ;
+	}
+	switch (event.filter) {
+		case EVFILT_TIMER:
+			if (m_CacheWaiting) {
+				m_CacheWaiting = false;
+				m_Location->getProxy_pass().m_Host.empty() ? cgiRequest() : proxyRequest();
+			}
+			break;
+		case EVFILT_READ:
+			onRead(event);
+			break;
+		case EVFILT_WRITE:
+			(event.flags & EV_EOF) ? close() : onWrite();
+			break;
+	}
+}
+
+void	Client::onRead(const struct kevent& event) {
+	char			buf[E_CLIENT::RECV_SIZE];
+	const ssize_t	readSize = recv(m_Socket.getFd(), buf, sizeof(buf), 0);
+
+	if (readSize <= 0) {
+		if (readSize == 0 || (event.flags & EV_EOF)) {
+			close();
+		}
+		return ;
+	}
+	m_RecvBuffer.append(buf, readSize);
+	onRequestData();
+}
+
+void	Client::onRequestData() {
+	if (!m_HeaderDone) {
+		if (m_Responding || m_Closing) {
+			return ;
+		}
+		if (m_RequestStart == 0) {
+			m_RequestStart = EventLoop::now();
+			m_Timing.mark(E_TIMING::START);
+			Metrics::move(m_Phase, E_METRICS::READING);
+		}
+		switch (m_Request.parse(m_RecvBuffer)) {
+			case E_REQUEST::INCOMPLETE:
+				return ;
+			case E_REQUEST::ERROR:
+				Metrics::request();
+				Metrics::move(m_Phase, E_METRICS::WRITING);
+				m_KeepAlive = false;
+				m_Responding = true;
+				sendError(400);
+				return ;
+			case E_REQUEST::DONE:
+				m_Timing.mark(E_TIMING::HEADER_PARSED);
+				Metrics::request();
+				Metrics::move(m_Phase, E_METRICS::WRITING);
+				m_RecvBuffer.erase(0, m_Request.getHeaderSize());
+				m_HeaderDone = true;
+				m_BodyLeft = m_Request.isChunked() ? E_CLIENT::CHUNKED_BODY : m_Request.getContentLength();
+				m_ChunkedBody.clear();
+				m_KeepAlive = m_Request.isKeepAlive();
+				dispatch();
+				break;
+		}
+	}
+	forwardBody();
+}
+
+void	Client::dispatch() {
+	m_Responding = true;
+	m_ServerBlock = &m_Server.findServerBlock(m_Request.getHeader("host"));
+	m_Location = Server::findLocation(*m_ServerBlock, m_Request.getPath(), m_LocationMatch);
+	m_Timing.mark(E_TIMING::LOCATION_MATCHED);
+
+	if (m_Location != NULL && m_Location->getStub_status()) {
+		serveStatus(&Metrics::stubStatus);
+		return ;
+	}
+	if (m_Location != NULL && m_Location->getMetrics()) {
+		serveStatus(&Metrics::scrape);
+		return ;
+	}
+	if (m_Location != NULL && !m_Location->getProxy_pass().m_Host.empty()) {
+		m_CacheWaitStart = 0;
+		proxyRequest();
+		return ;
+	}
+	if (m_Location != NULL && (!m_Location->getCgi().empty() || !m_Location->getFastcgi_pass().empty())) {
+		m_CacheWaitStart = 0;
+		cgiRequest();
+		return ;
+	}
+	serveStatic();
+}
+
+/**
+ * @brief	root + path 의 정적 파일. file_cache 에 있으면 메모리에서, 없으면 sendfile 로 보낸다.
+ * @details	path 에 ".." segment 가 없는 것은 HTTP::Request 가 보장한다.
+ *			path 가 '/' 로 끝나면 index 파일을 순서대로 찾고, 없으면 autoindex 목록 (또는 403) 을 보낸다.
+ *			'/' 없이 directory 를 가리키면 '/' 를 붙인 곳으로 301 redirect 한다.
+ *			If-Modified-Since 가 Last-Modified 와 같으면 304 를 보낸다.
+ */
+void	Client::serveStatic() {
+	const std::string&		method = m_Request.getMethod();
+	const std::string&		path = m_Request.getPath();
+	const std::string		root = (m_Location != NULL) ? m_Location->getRoot() : m_ServerBlock->getRoot();
+	const bool				head = (method == "HEAD");
+	std::string				cachedHead;
+	std::string				cachedBody;
+	struct stat				status;
+
+	if (method != "GET" && !head) {
+		sendError(405);
+		return ;
+	}
+	std::string	file = root + path;
+	if (!path.empty() && path[path.size() - 1] == '/' && !findIndex(file)) {
+		serveDirectory(file);
+		return ;
+	}
+	if (FileCache::find(file, cachedHead, cachedBody, head)) {
+		m_Timing.mark(E_TIMING::FILE_OPENED);
+		if (notModified(cachedHead)) {
+			return ;
+		}
+		head ? send(cachedHead.data(), cachedHead.size()) : send(cachedHead, cachedBody);
+		responseDone();
+		return ;
+	}
+
+	const int	fd = open(file.c_str(), O_RDONLY);
+	if (fd < 0) {
+		sendError(errno == EACCES ? 403 : 404);
+		return ;
+	}
+	m_Timing.mark(E_TIMING::FILE_OPENED);
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	const bool	statDone = (fstat(fd, &status) == 0);
+	if (!statDone || !S_ISREG(status.st_mode)) {
+		::close(fd);
+		(statDone && S_ISDIR(status.st_mode)) ? redirectDirectory() : sendError(404);
+		return ;
+	}
+	if (FileCache::insert(file, fd, status, cachedHead, cachedBody)) {
+		::close(fd);
+		if (notModified(cachedHead)) {
+			return ;
+		}
+		head ? send(cachedHead.data(), cachedHead.size()) : send(cachedHead, cachedBody);
+		responseDone();
+		return ;
+	}
+	const std::string	response = FileCache::header(file, status);
+	if (notModified(response)) {
+		::close(fd);
+		return ;
+	}
+	send(response.data(), response.size());
+	if (head) {
+		::close(fd);
+		responseDone();
+		return ;
+	}
+	sendFile(fd, 0, status.st_size);
+}
+
+/**
+ * @brief	directory (root + path, '/' 로 끝난다) 안에서 index 파일을 지시어 순서대로 찾는다.
+ * @details	location 에 index 가 없으면 server 의 것, 둘 다 없으면 "index.html" 이다.
+ * @param	file	찾으면 index 파일의 경로로 바뀐다.
+ */
+bool	Client::findIndex(std::string& file) const {
+	const std::vector<std::string>&	index = (m_Location != NULL) ? m_Location->getIndexList() : m_ServerBlock->getIndexList();
+	struct stat						status;
+
+	if (index.empty()) {
+		if (stat((file + "index.html").c_str(), &status) == 0 && S_ISREG(status.st_mode)) {
+			file += "index.html";
+			return true;
+		}
+		return false;
+	}
+	for (std::size_t i = 0; i < index.size(); i++) {
+		if (stat((file + index[i]).c_str(), &status) == 0 && S_ISREG(status.st_mode)) {
+			file += index[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief	index 파일이 없는 directory. autoindex 면 목록을, 아니면 403 (directory 가 없으면 404) 을 보낸다.
+ */
+void	Client::serveDirectory(const std::string& directory) {
+	const bool			autoindex = (m_Location != NULL) ? m_Location->getAutoindex() : m_ServerBlock->getAutoindex();
+	DIR*				dir = autoindex ? opendir(directory.c_str()) : NULL;
+	struct stat			status;
+	std::string			body;
+	std::stringstream	head;
+
+	if (dir == NULL) {
+		if (stat(directory.c_str(), &status) < 0 || !S_ISDIR(status.st_mode)) {
+			sendError(404);
+		} else {
+			sendError(403);
+		}
+		return ;
+	}
+	m_Timing.mark(E_TIMING::FILE_OPENED);
+	const std::string	title = escapeHtml(m_Request.getPath());
+	body = "<html>\r\n<head><title>Index of " + title + "</title></head>\r\n<body>\r\n<h1>Index of " + title + "</h1><hr><pre>\r\n";
+	for (struct dirent* entry = readdir(dir); entry != NULL; entry = readdir(dir)) {
+		const std::string	name = entry->d_name;
+
+		if (name == "." || (name[0] == '.' && name != "..")) {
+			continue;
+		}
+		const std::string	link = escapeHtml(name) + ((entry->d_type == DT_DIR) ? "/" : "");
+		body += "<a href=\"" + link + "\">" + link + "</a>\r\n";
+	}
+	closedir(dir);
+	body += "</pre><hr></body>\r\n</html>\r\n";
+	head << "HTTP/1.1 200 OK\r\nServer: webserv\r\nContent-Type: text/html\r\nContent-Length: " << body.size() << "\r\n\r\n";
+	const std::string	response = head.str();
+	(m_Request.getMethod() == "HEAD") ? send(response.data(), response.size()) : send(response, body);
+	responseDone();
+}
+
+/**
+ * @brief	'/' 없이 directory 를 가리킨 request 를 path + "/" 로 보낸다. (query 는 그대로)
+ */
+void	Client::redirectDirectory() {
+	const std::string&	query = m_Request.getQuery();
+	const std::string	location = m_Request.getPath() + "/" + (query.empty() ? "" : "?" + query);
+	std::stringstream	head;
+
+	head << "HTTP/1.1 301 Moved Permanently\r\nServer: webserv\r\nLocation: " << location << "\r\nContent-Length: 0\r\n\r\n";
+	const std::string	response = head.str();
+	send(response.data(), response.size());
+	responseDone();
+}
+
+/**
+ * @brief	If-Modified-Since 가 응답의 Last-Modified 와 같으면 304 를 보낸다. (nginx 의 if_modified_since exact)
+ * @param	response	FileCache 가 만든 200 응답 header
+ * @return	304 를 보냈는지
+ */
+bool	Client::notModified(const std::string& response) {
+	const std::string	since = m_Request.getHeader("if-modified-since");
+	const std::size_t	datePos = response.find("\r\nLast-Modified: ");
+
+	if (since.empty() || datePos == std::string::npos) {
+		return false;
+	}
+	const std::size_t	dateStart = datePos + 17;
+	if (response.compare(dateStart, response.find("\r\n", dateStart) - dateStart, since) != 0) {
+		return false;
+	}
+	const std::string	head = "HTTP/1.1 304 Not Modified\r\nServer: webserv\r\nLast-Modified: " + since + "\r\n\r\n";
+	send(head.data(), head.size());
+	responseDone();
+	return true;
+}
+
+/**
+ * @brief	autoindex 목록에 넣을 이름 (&, <, >, ")
+ */
+std::string	Client::escapeHtml(const std::string& text) {
+	std::string	result;
+
+	for (std::size_t i = 0; i < text.size(); i++) {
+		switch (text[i]) {
+			case '&': result += "&amp;"; break;
+			case '<': result += "&lt;"; break;
+			case '>': result += "&gt;"; break;
+			case '"': result += "&quot;"; break;
+			default: result += text[i];
+		}
+	}
+	return result;
+}
+
+/**
+ * @brief	stub_status / metrics location: 모든 worker 의 counter 를 더한 text 응답
+ * @param	render	Metrics::stubStatus 또는 Metrics::scrape
+ */
+void	Client::serveStatus(std::string (*render)()) {
+	const std::string&	method = m_Request.getMethod();
+	std::stringstream	stream;
+
+	if (method != "GET" && method != "HEAD") {
+		sendError(405);
+		return ;
+	}
+	const std::string	body = render();
+	stream << "HTTP/1.1 200 OK\r\nServer: webserv\r\nContent-Type: text/plain\r\nContent-Length: " << body.size()
+		   << "\r\nCache-Control: no-cache\r\n\r\n";
+	const std::string	head = stream.str();
+	(method == "HEAD") ? send(head.data(), head.size()) : send(head, body);
+	responseDone();
+}
+
+void	Client::proxyRequest() {
+	if (serveCache()) {
+		return ;
+	}
+	m_UpstreamTried = 0;
+	m_UpstreamFresh = false;
+	startProxy(502);
+}
+
+/**
+ * @brief	proxy_cache 에 아직 만료되지 않은 응답이 있으면 파일을 열어서 그대로 보낸다.
+ * @details	index 와 파일 사이에 cache manager 가 파일을 지웠으면 index 에서도 빼고 upstream 으로 간다.
+ *			만료됐어도 stale_while_revalidate 안이면 옛 응답을 보내고,
+ *			lock 을 잡은 request 하나만 뒤에서 새 응답을 가져온다. (나머지는 갱신을 기다리지 않는다)
+ *			miss 이고 lock 이 켜져 있으면:
+ *			- lock 을 잡으면 이 request 가 upstream 으로 간다. (응답이 끝나면 놓는다)
+ *			- 다른 request 가 잡고 있으면 LOCK_POLL 마다 다시 본다. lock timeout 이 지나면 그냥 upstream 으로 간다.
+ * @return	true 면 응답했거나 기다리는 중
+ */
+bool	Client::serveCache() {
+	CacheZone*			zone = CacheZone::find(m_Location);
+	const std::string&	method = m_Request.getMethod();
+	CacheEntry			entry;
+
+	if (zone == NULL || (method != "GET" && method != "HEAD")) {
+		return false;
+	}
+	const std::string	cacheKey = CacheZone::key(*this);
+	const unsigned long	key = CacheZone::hash64(cacheKey);
+	const bool			found = zone->lookup(key, entry);
+	if (found && entry.m_Chunked && m_Request.getVersion() == "HTTP/1.0") {
+		// chunked 로 저장된 응답은 HTTP/1.0 client 가 읽지 못한다. upstream 에서 받아서 풀어 보낸다.
+		return false;
+	}
+	if (found && entry.m_Expire > EventLoop::now() && sendCached(*zone, cacheKey, entry)) {
+		return true;
+	}
+	if (found && entry.m_Expire <= EventLoop::now() && entry.m_StaleUpdate > EventLoop::now()) {
+		// 파일을 보내다 끝나면 다음 request 로 넘어가므로 갱신을 먼저 시작한다.
+		if (zone->lock(key, m_Location->getProxy_read_timeout())) {
+			refreshCache(*zone, key);
+		}
+		if (sendCached(*zone, cacheKey, entry)) {
+			return true;
+		}
+	}
+
+	const CONF::proxyCacheData&	cache = m_Location->getProxy_cache();
+	const unsigned int			lockTimeout = cache.m_Lock ? cache.m_LockTimeout : 0;
+	if (lockTimeout == 0 || (m_CacheWaitStart != 0 && EventLoop::now() >= m_CacheWaitStart + lockTimeout)) {
+		return false;
+	}
+	if (zone->lock(key, lockTimeout)) {
+		m_CacheLock = zone;
+		m_CacheKey = key;
+		return false;
+	}
+	if (m_CacheWaitStart == 0) {
+		m_CacheWaitStart = EventLoop::now();
+	}
+	m_CacheWaiting = true;
+	m_Loop.addTimeout(reinterpret_cast<uintptr_t>(this), E_CACHE::LOCK_POLL, this);
+	return true;
+}
+
+/**
+ * @brief	cache 파일을 열어서 응답으로 보낸다. 파일이 없어졌으면 index 에서도 뺀다.
+ * @details	파일에 저장된 key 가 다르면 (hash 충돌) 보내지 않는다.
+ *			chunked 로 저장된 응답은 HTTP/1.0 client 에게 보내지 않는다. (upstream 에서 받으면 풀어서 보낸다)
+ */
+bool	Client::sendCached(CacheZone& zone, const std::string& cacheKey, const CacheEntry& entry) {
+	if (entry.m_Chunked && m_Request.getVersion() == "HTTP/1.0") {
+		return false;
+	}
+
+	const unsigned long	key = CacheZone::hash64(cacheKey);
+	const int			fd = open(zone.path(key, entry.m_Version).c_str(), O_RDONLY);
+
+	if (fd < 0) {
+		zone.remove(key, entry.m_Version);
+		return false;
+	}
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	if (!CacheZone::verify(fd, cacheKey, entry)) {
+		::close(fd);
+		return false;
+	}
+	sendFile(fd, entry.m_DataStart, (m_Request.getMethod() == "HEAD") ? entry.m_HeaderSize : entry.m_Size);
+	return true;
+}
+
+/**
+ * @brief	stale_while_revalidate: 이 request 로 upstream 에 GET 을 보내서 cache 만 새로 채운다.
+ * @details	lock 은 ProxyConnection 이 넘겨받는다. 연결을 얻지 못하면 바로 놓는다.
+ *			request body 는 보내지 않으므로 m_Responder 는 비워 둔다. (받는 body 는 버린다)
+ */
+void	Client::refreshCache(CacheZone& zone, const unsigned long& key) {
+	UpstreamGroup*			group = UpstreamGroup::find(m_Location);
+	UpstreamGroup::Peer*	peer = (group != NULL) ? group->select(*this, 0) : NULL;
+	ProxyConnection*		connection = (peer != NULL) ? peer->m_Upstream->acquire(m_Loop, false) : NULL;
+
+	if (connection == NULL) {
+		if (peer != NULL) {
+			UpstreamGroup::release(peer, E_UPSTREAM_GROUP::FAILED);
+		}
+		zone.unlock(key);
+		return ;
+	}
+	connection->refresh(*this, *peer, zone, key);
+}
+
+/**
+ * @brief	stale_if_error: upstream 이 실패했을 때 (연결 실패, timeout, 5xx) 옛 응답이 아직 쓸 만하면 보낸다.
+ * @details	ProxyConnection 에서도 부른다. 보내면 upstream 연결은 이 client 와 끊어진다.
+ * @return	true 면 응답을 보냈다.
+ */
+bool	Client::serveStale() {
+	CacheZone*			zone = CacheZone::find(m_Location);
+	const std::string&	method = m_Request.getMethod();
+	CacheEntry			entry;
+
+	if (zone == NULL || (method != "GET" && method != "HEAD")) {
+		return false;
+	}
+	const std::string	cacheKey = CacheZone::key(*this);
+	if (!zone->lookup(CacheZone::hash64(cacheKey), entry) || entry.m_StaleError <= EventLoop::now()) {
+		return false;
+	}
+	m_Responder = NULL;
+	return (sendCached(*zone, cacheKey, entry));
+}
+
+/**
+ * @brief	upstream 응답이 끝났으면 (cache 에 들어갔든 아니든) 기다리던 request 들이 다시 볼 수 있게 한다.
+ */
+void	Client::releaseCacheLock() {
+	if (m_CacheLock != NULL) {
+		m_CacheLock->unlock(m_CacheKey);
+		m_CacheLock = NULL;
+	}
+	if (m_MicroLock != NULL) {
+		m_MicroLock->unlock(m_CacheKey);
+		m_MicroLock = NULL;
+	}
+}
+
+void	Client::cgiRequest() {
+	if (!serveMicrocache()) {
+		startCgi();
+	}
+}
+
+/**
+ * @brief	microcache 에 아직 valid 안인 응답이 있으면 그대로 보낸다. (HEAD 는 header 만, request body 는 버린다)
+ * @details	없으면 lock 을 잡은 request 하나만 backend 로 가고, 나머지는 valid 동안 그 응답을 기다린다. (serveCache 와 같다)
+ *			lock 은 backend 가 멈춰도 read timeout (cgi_read_timeout / fastcgi_read_timeout) 이 지나면 풀린다.
+ *			HEAD 응답은 저장하지 않으므로 (ACGI::startMicrocache) HEAD miss 는 lock 을 잡지도 기다리지도 않는다.
+ * @return	true 면 응답했거나 기다리는 중이다.
+ */
+bool	Client::serveMicrocache() {
+	MicroCache*			zone = MicroCache::find(m_Location);
+	const std::string&	method = m_Request.getMethod();
+	std::string			response;
+	std::size_t			headerSize = 0;
+
+	if (zone == NULL || (method != "GET" && method != "HEAD")) {
+		return false;
+	}
+	const unsigned long	key = CacheZone::hash64(MicroCache::key(*this));
+	if (zone->lookup(key, response, headerSize)) {
+		send(response.data(), (method == "HEAD") ? headerSize : response.size());
+		responseDone();
+		return true;
+	}
+	if (method == "HEAD") {
+		return false;
+	}
+
+	if (m_CacheWaitStart != 0 && EventLoop::now() >= m_CacheWaitStart + m_Location->getMicrocache().m_Valid) {
+		return false;
+	}
+	const unsigned int	lockTimeout = m_Location->getFastcgi_pass().empty() ? m_Location->getCgi_read_timeout() : m_Location->getFastcgi_read_timeout();
+	if (zone->lock(key, lockTimeout)) {
+		m_MicroLock = zone;
+		m_CacheKey = key;
+		return false;
+	}
+	if (m_CacheWaitStart == 0) {
+		m_CacheWaitStart = EventLoop::now();
+	}
+	m_CacheWaiting = true;
+	m_Loop.addTimeout(reinterpret_cast<uintptr_t>(this), E_CACHE::LOCK_POLL, this);
+	return true;
+}
+
+/**
+ * @brief	cgi / cgi_pool 의 script 파일. path 에서 location 뒤로 segment 를 하나씩 늘려 가며 처음 나오는 정규 파일이다.
+ * @details	그 뒤의 나머지는 PATH_INFO 가 된다. (ACGI::environment)
+ *			fastcgi_pass 는 script 가 다른 host 에 있을 수 있으므로 path 전체를 쓴다.
+ */
+const std::string	Client::scriptFile() const {
+	const std::string&	root = m_Location->getRoot();
+	const std::string&	path = m_Request.getPath();
+	struct stat			status;
+
+	if (!m_Location->getFastcgi_pass().empty()) {
+		return (root + path);
+	}
+	for (std::size_t end = path.find('/', std::max<std::size_t>(m_LocationMatch, 1)); end != std::string::npos; end = path.find('/', end + 1)) {
+		const std::string	file = root + path.substr(0, end);
+
+		if (stat(file.c_str(), &status) == 0 && S_ISREG(status.st_mode)) {
+			return (file);
+		}
+	}
+	return (root + path);
+}
+
+/**
+ * @brief	fastcgi_pass 면 upstream 연결 (keepalive) 에, cgi_pool 이 있으면 pool 에 맡기고,
+ *			둘 다 아니면 request 마다 CGIProcess 를 띄운다.
+ */
+void	Client::startCgi() {
+	const std::string	script = scriptFile();
+
+	m_Timing.mark(E_TIMING::UPSTREAM_START);
+	if (!m_Location->getFastcgi_pass().empty()) {
+		startFastcgi(script, false);
+		return ;
+	}
+	if (m_Location->getCgiPool().m_Max > 0) {
+		CGIPool&	pool = CGIPool::get(m_Loop, *m_Location);
+		if (pool.isFull()) {
+			sendError(503);
+			return ;
+		}
+		m_Responder = pool.submit(*this, script);
+	} else {
+		CGIProcess*	process = new CGIProcess(m_Loop, *this);
+		if (process->start(m_Location->getCgi(), script)) {
+			m_Responder = process;
+		} else {
+			delete process;
+		}
+	}
+	if (m_Responder == NULL) {
+		sendError(502);
+		return ;
+	}
+	if (m_BodyLeft == 0) {
+		m_Responder->endBody();
+	}
+}
+
+/**
+ * @brief	fastcgi_pass upstream 의 연결 (fresh 가 아니면 idle 연결부터) 로 request 를 보낸다.
+ */
+void	Client::startFastcgi(const std::string& script, const bool& fresh) {
+	FastCGIUpstream*	upstream = FastCGIUpstream::find(m_Location->getFastcgi_pass());
+	FastCGIConnection*	connection = (upstream != NULL) ? upstream->acquire(m_Loop, fresh) : NULL;
+
+	if (connection == NULL) {
+		sendError(502);
+		return ;
+	}
+	connection->begin(*this, script);
+	m_Responder = connection;
+	if (m_BodyLeft == 0) {
+		m_Responder->endBody();
+	}
+}
+
+/**
+ * @brief	idle 로 있던 fastcgi 연결이 응답 전에 끊겼을 때 FastCGIConnection 에서 호출한다. 새 연결로 다시 보낸다.
+ */
+void	Client::retryFastcgi() {
+	m_Responder = NULL;
+	startFastcgi(scriptFile(), true);
+}
+
+/**
+ * @brief	upstream 묶음에서 서버를 고르고, 그 서버의 idle 연결을 쓰거나 새로 연결해서 request 를 그대로 넘긴다.
+ * @details	이번 request 에서 이미 실패한 서버는 m_UpstreamTried 에 표시해 두고 다시 고르지 않는다.
+ *			고를 서버가 없으면 마지막 실패 원인 (statusCode) 으로 응답한다.
+ */
+void	Client::startProxy(const unsigned short& statusCode) {
+	UpstreamGroup*			group = UpstreamGroup::find(m_Location);
+	UpstreamGroup::Peer*	peer = NULL;
+	ProxyConnection*		connection = NULL;
+
+	m_Timing.mark(E_TIMING::UPSTREAM_START);
+	while (group != NULL && connection == NULL) {
+		peer = group->select(*this, m_UpstreamTried);
+		if (peer == NULL) {
+			break ;
+		}
+		if (peer->m_Index < E_UPSTREAM_GROUP::MAX_TRIED) {
+			m_UpstreamTried |= (1UL << peer->m_Index);
+		}
+		connection = peer->m_Upstream->acquire(m_Loop, m_UpstreamFresh);
+		if (connection == NULL) {
+			UpstreamGroup::release(peer, E_UPSTREAM_GROUP::FAILED);
+		}
+	}
+	if (connection == NULL) {
+		if (!serveStale()) {
+			sendError(group != NULL ? statusCode : 502);
+		}
+		return ;
+	}
+	connection->begin(*this, *peer);
+	m_Responder = connection;
+	if (m_BodyLeft == 0) {
+		m_Responder->endBody();
+	}
+}
+
+/**
+ * @brief	응답을 받기 전에 upstream 이 실패했을 때 ProxyConnection 에서 호출한다. 다른 서버로 다시 보낸다.
+ * @details	stale 은 idle 로 있던 연결을 upstream 이 먼저 닫은 서버다. 서버 탓이 아니므로
+ *			request 마다 한 번은 그 서버도 다시 고를 수 있게 하고, 이후로는 idle 연결을 쓰지 않는다.
+ *			(서버가 하나뿐인 proxy_pass 도 새 연결로 다시 보낸다)
+ */
+void	Client::retryProxy(const unsigned short& statusCode, const UpstreamGroup::Peer* stale) {
+	m_Responder = NULL;
+	if (stale != NULL && !m_UpstreamFresh) {
+		if (stale->m_Index < E_UPSTREAM_GROUP::MAX_TRIED) {
+			m_UpstreamTried &= ~(1UL << stale->m_Index);
+		}
+		m_UpstreamFresh = true;
+	}
+	startProxy(statusCode);
+}
+
+/**
+ * @brief	받은 body 를 responder (CGI stdin, upstream) 로 흘려보낸다. responder 가 없으면 버린다.
+ * @details	responder 가 늦게 받으면 client 읽기를 멈춘다. (responder 쪽에서 resumeRead 호출)
+ *			chunked 면 chunk-data 만 넘기고, 마지막 chunk (와 trailer) 까지 읽으면 body 가 끝난다.
+ */
+void	Client::forwardBody() {
+	std::size_t	used = std::min(m_RecvBuffer.size(), m_BodyLeft);
+	std::string	decoded;
+	const char*	data = m_RecvBuffer.data();
+	std::size_t	size = used;
+
+	if (m_Request.isChunked() && m_BodyLeft > 0 && !m_RecvBuffer.empty()) {
+		used = m_ChunkedBody.decode(m_RecvBuffer.data(), m_RecvBuffer.size(), decoded);
+		if (m_ChunkedBody.isError()) {
+			chunkedBodyError();
+			return ;
+		}
+		data = decoded.data();
+		size = decoded.size();
+	}
+	if (used > 0) {
+		if (m_Responder != NULL && size > 0) {
+			m_Responder->writeBody(data, size);
+		}
+		m_RecvBuffer.erase(0, used);
+		if (!m_Request.isChunked()) {
+			m_BodyLeft -= used;
+		} else if (m_ChunkedBody.isDone()) {
+			m_BodyLeft = 0;
+		}
+
+		if (m_Responder != NULL && m_BodyLeft == 0) {
+			m_Responder->endBody();
+		}
+		if (m_Responder != NULL && m_Responder->getPendingInput() > E_CLIENT::HIGH_WATERMARK && !m_ReadPaused) {
+			m_Loop.disableRead(m_Socket.getFd(), this);
+			m_ReadPaused = true;
+		}
+	}
+	if (m_HeaderDone && m_BodyLeft == 0 && !m_Responding) {
+		nextRequest();
+	}
+}
+
+/**
+ * @brief	chunked body 가 깨졌다. 다음 request 의 시작을 알 수 없으므로 연결을 끝낸다.
+ * @details	responder 가 아직 응답을 보내지 않았으면 떼어 내고 400 으로 끝내고, 보내는 중이면 끊는다.
+ */
+void	Client::chunkedBodyError() {
+	m_RecvBuffer.clear();
+	m_BodyLeft = 0;
+	m_KeepAlive = false;
+	if (m_Responder != NULL) {
+		m_Responder->detach();
+		m_Responder = NULL;
+	}
+	if (!m_Responding || m_BytesSent > 0) {
+		close();
+		return ;
+	}
+	sendError(400);
+}
+
+void	Client::resumeRead() {
+	if (m_ReadPaused) {
+		m_Loop.enableRead(m_Socket.getFd(), this);
+		m_ReadPaused = false;
+	}
+}
+
+/**
+ * @brief	비어 있으면 바로 보내 보고, 남은 것만 버퍼에 쌓는다.
+ */
+void	Client::send(const char* data, const std::size_t& size) {
+	std::size_t	sent = 0;
+
+	if (m_Closing && !m_Responding) {
+		return ;
+	}
+	countOutput(data, size);
+	if (m_SendOffset == m_SendBuffer.size()) {
+		m_SendBuffer.clear();
+		m_SendOffset = 0;
+
+		const ssize_t	writeSize = ::send(m_Socket.getFd(), data, size, 0);
+		sent = (writeSize > 0) ? static_cast<std::size_t>(writeSize) : 0;
+		if (sent > 0) {
+			m_Timing.mark(E_TIMING::FIRST_SENT);
+		}
+	}
+	if (sent < size) {
+		m_SendBuffer.append(data + sent, size - sent);
+		if (!m_WriteEnabled) {
+			m_Loop.enableWrite(m_Socket.getFd(), this);
+			m_WriteEnabled = true;
+		}
+	}
+}
+
+/**
+ * @brief	header 와 body 를 writev 한 번으로 보내 본다. (body 를 header 뒤에 복사하지 않는다)
+ */
+void	Client::send(const std::string& head, const std::string& body) {
+	if ((m_Closing && !m_Responding) || m_SendOffset != m_SendBuffer.size() || body.empty()) {
+		send(head.data(), head.size());
+		send(body.data(), body.size());
+		return ;
+	}
+	struct iovec	iov[2];
+	countOutput(head.data(), head.size());
+	m_BytesSent += body.size();
+	iov[0].iov_base = const_cast<char*>(head.data());
+	iov[0].iov_len = head.size();
+	iov[1].iov_base = const_cast<char*>(body.data());
+	iov[1].iov_len = body.size();
+
+	const ssize_t		writeSize = writev(m_Socket.getFd(), iov, 2);
+	const std::size_t	sent = (writeSize > 0) ? static_cast<std::size_t>(writeSize) : 0;
+
+	if (sent > 0) {
+		m_Timing.mark(E_TIMING::FIRST_SENT);
+	}
+	m_SendBuffer.clear();
+	m_SendOffset = 0;
+	if (sent < head.size()) {
+		m_SendBuffer.append(head, sent, std::string::npos);
+		m_SendBuffer.append(body);
+	} else if (sent < head.size() + body.size()) {
+		m_SendBuffer.append(body, sent - head.size(), std::string::npos);
+	}
+	if (!m_SendBuffer.empty() && !m_WriteEnabled) {
+		m_Loop.enableWrite(m_Socket.getFd(), this);
+		m_WriteEnabled = true;
+	}
+}
+
+void	Client::onWrite() {
+	if (m_SendOffset < m_SendBuffer.size()) {
+		const ssize_t	writeSize = ::send(m_Socket.getFd(), m_SendBuffer.data() + m_SendOffset, m_SendBuffer.size() - m_SendOffset, 0);
+
+		if (writeSize < 0) {
+			return ;
+		}
+		if (writeSize > 0) {
+			m_Timing.mark(E_TIMING::FIRST_SENT);
+		}
+		m_SendOffset += writeSize;
+	}
+	if (m_SendOffset == m_SendBuffer.size()) {
+		m_SendBuffer.clear();
+		m_SendOffset = 0;
+		if (m_File >= 0) {
+			sendFileBody();
+			return ;
+		}
+		m_Loop.disableWrite(m_Socket.getFd(), this);
+		m_WriteEnabled = false;
+		if (m_Draining) {
+			m_Draining = false;
+			finishResponse();
+			return ;
+		}
+		if (m_Closing && !m_Responding) {
+			close();
+			return ;
+		}
+	}
+	if (m_Responder != NULL && getPendingOutput() < E_CLIENT::LOW_WATERMARK) {
+		m_Responder->resumeOutput();
+	}
+}
+
+/**
+ * @brief	파일 [offset, offset + size) 를 응답으로 보낸다. fd 는 다 보낸 뒤에 닫는다.
+ * @details	다 보낼 때까지 응답이 끝나지 않으므로 (m_Responding) 다음 request 의 응답과 섞이지 않는다.
+ */
+void	Client::sendFile(const int& fd, const off_t& offset, const std::size_t& size) {
+	m_File = fd;
+	m_FileOffset = offset;
+	m_FileLeft = size;
+	m_BytesSent += size;
+	if (m_SendOffset == m_SendBuffer.size()) {
+		sendFileBody();
+	}
+}
+
+/**
+ * @brief	socket buffer 가 받는 만큼 kernel 안에서 바로 보낸다. (macOS sendfile)
+ */
+void	Client::sendFileBody() {
+	off_t		length = m_FileLeft;
+	const int	result = sendfile(m_File, m_Socket.getFd(), m_FileOffset, &length, NULL, 0);
+
+	if (result == 0 && length == 0 && m_FileLeft > 0) {
+		// 파일이 index 보다 짧다. header 는 이미 나갔으므로 끊는다.
+		closeFile();
+		abort();
+		return ;
+	}
+	m_FileOffset += length;
+	m_FileLeft -= length;
+	if (m_FileLeft > 0) {
+		if (!m_WriteEnabled) {
+			m_Loop.enableWrite(m_Socket.getFd(), this);
+			m_WriteEnabled = true;
+		}
+		return ;
+	}
+	closeFile();
+	if (m_WriteEnabled) {
+		m_Loop.disableWrite(m_Socket.getFd(), this);
+		m_WriteEnabled = false;
+	}
+	responseDone();
+}
+
+void	Client::closeFile() {
+	if (m_File >= 0) {
+		::close(m_File);
+		m_File = -1;
+	}
+	m_FileLeft = 0;
+}
+
+void	Client::sendError(const unsigned short& statusCode) {
+	const ErrorPage::Response*	response = NULL;
+
+	if (m_Location != NULL) {
+		response = ErrorPage::get(m_Location->getError_page(), statusCode);
+	} else if (m_ServerBlock != NULL) {
+		response = ErrorPage::get(m_ServerBlock->getError_page(), statusCode);
+	}
+	if (response == NULL) {
+		response = &ErrorPage::getDefault(statusCode);
+	}
+	send(response->m_Data, (m_Request.getMethod() == "HEAD") ? response->m_HeaderSize : response->m_Size);
+	responseDone();
+}
+
+/**
+ * @brief	응답 하나가 끝났을 때 호출된다. (responder 쪽에서도 호출)
+ * @details	m_SendBuffer 가 남았으면 onWrite 가 다 보낸 뒤에 finishResponse 로 마저 끝낸다.
+ *			그동안 request body 는 계속 읽어서 버린다. (client 가 body 를 다 보내야 응답을 읽는 경우)
+ */
+void	Client::responseDone() {
+	releaseCacheLock();
+	m_Responder = NULL;
+	if (m_SendOffset < m_SendBuffer.size()) {
+		m_Draining = true;
+		resumeRead();
+		return ;
+	}
+	finishResponse();
+}
+
+/**
+ * @brief	응답을 socket 에 다 넘겼다. DONE 을 mark 하고 log 를 남긴 뒤 다음 request 로 넘어간다.
+ * @details	body 를 아직 다 받지 못했으면 여기서는 log 만 남기고, 다음 request 는 body 를 다 버린 뒤에 (forwardBody) 본다.
+ */
+void	Client::finishResponse() {
+	m_Timing.mark(E_TIMING::DONE);
+	Metrics::observe(m_ServerBlock, m_Location, m_Timing);
+	RequestTrace::write(*this, m_Timing);
+	writeAccessLog();
+	Metrics::move(m_Phase, E_METRICS::WAITING);
+	m_Responding = false;
+	resumeRead();
+	if (m_BodyLeft > 0) {
+		return ;
+	}
+	nextRequest();
+}
+
+/**
+ * @brief	응답도 log 도 끝났고 request body 도 다 받았다. request 별 상태를 지우고 다음 request 를 본다.
+ * @details	응답이 body 보다 먼저 끝났으면 forwardBody 가 body 를 다 버린 뒤에 부른다.
+ */
+void	Client::nextRequest() {
+	m_HeaderDone = false;
+	m_ServerBlock = NULL;
+	m_Location = NULL;
+	m_Request.clear();
+	if (!m_KeepAlive) {
+		m_Closing = true;
+		if (m_SendBuffer.empty()) {
+			close();
+		}
+		return ;
+	}
+	if (!m_RecvBuffer.empty()) {
+		onRequestData();
+	}
+}
+
+/**
+ * @brief	응답의 첫 byte 면 status line 에서 status code 를 읽어 두고, 보낸 byte 수를 센다.
+ * @details	header 끝 (CRLF CRLF) 을 찾을 때까지만 byte 를 훑는다. ($body_bytes_sent)
+ */
+void	Client::countOutput(const char* data, const std::size_t& size) {
+	static const char	headerEnd[] = "\r\n\r\n";
+
+	if (m_BytesSent == 0 && size >= 12 && std::memcmp(data, "HTTP/", 5) == 0) {
+		m_Status = (data[9] - '0') * 100 + (data[10] - '0') * 10 + (data[11] - '0');
+	}
+	for (std::size_t i = 0; m_HeaderEnd < 4 && i < size; i++) {
+		m_HeaderEnd = (data[i] == headerEnd[m_HeaderEnd]) ? m_HeaderEnd + 1 : (data[i] == '\r');
+		if (m_HeaderEnd == 4) {
+			m_HeaderBytes = m_BytesSent + i + 1;
+		}
+	}
+	m_BytesSent += size;
+}
+
+/**
+ * @brief	location (없으면 server) 의 access_log 에 한 줄을 남기고 응답별 값을 지운다.
+ * @details	server (없으면 http 에서 물려받은) 의 slow_request_log 보다 오래 걸렸으면 그쪽에도 한 줄을 남긴다.
+ */
+void	Client::writeAccessLog() {
+	const CONF::ServerBlock*	server = (m_ServerBlock != NULL) ? m_ServerBlock : &m_Server.findServerBlock(m_Request.getHeader("host"));
+
+	AccessLog::write(m_Location != NULL ? m_Location->getAccess_log() : server->getAccess_log(), *this);
+	SlowRequestLog::write(server->getSlow_request_log(), *this, m_Timing);
+	m_RequestStart = 0;
+	m_Status = 0;
+	m_BytesSent = 0;
+	m_HeaderBytes = 0;
+	m_HeaderEnd = 0;
+	m_Timing.clear();
+}
+
+/**
+ * @brief	응답 끝을 연결 종료로 알리는 responder (HTTP/1.0 client 의 길이 모르는 body) 가 부른다.
+ */
+void	Client::closeAfterResponse() {
+	m_KeepAlive = false;
+}
+
+/**
+ * @brief	응답 header 를 보낸 뒤에 responder 가 실패했을 때. 응답을 끝낼 방법이 없으므로 연결을 끊는다.
+ */
+void	Client::abort() {
+	m_Responder = NULL;
+	m_KeepAlive = false;
+	close();
+}
+
+void	Client::close() {
+	if (m_Draining) {
+		// 응답을 다 보내기 전에 끊겼다. DONE 없이 access_log 만 남긴다.
+		m_Draining = false;
+		writeAccessLog();
+	}
+	if (m_Responder != NULL) {
+		m_Responder->detach();
+		m_Responder = NULL;
+	}
+	closeFile();
+	releaseCacheLock();
+	if (m_CacheWaiting) {
+		m_Loop.removeTimer(reinterpret_cast<uintptr_t>(this));
+		m_CacheWaiting = false;
+	}
+	m_Closing = true;
+	m_Responding = false;
+	m_Loop.forget(m_Socket.getFd());
+	m_Loop.release(this);
+}
+
+const int&	Client::getFd() const {
+	return (this->m_Socket.getFd());
+}
+
+const std::string&	Client::getRemoteAddr() const {
+	return (this->m_RemoteAddr);
+}
+
+const HTTP::Request&	Client::getRequest() const {
+	return (this->m_Request);
+}
+
+const CONF::ServerBlock*	Client::getServerBlock() const {
+	return (this->m_ServerBlock);
+}
+
+const CONF::LocationBlock*	Client::getLocation() const {
+	return (this->m_Location);
+}
+
+const std::size_t&	Client::getLocationMatch() const {
+	return (this->m_LocationMatch);
+}
+
+std::size_t	Client::getPendingOutput() const {
+	return (this->m_SendBuffer.size() - this->m_SendOffset);
+}
+
+const unsigned short&	Client::getStatus() const {
+	return (this->m_Status);
+}
+
+const std::size_t&	Client::getBytesSent() const {
+	return (this->m_BytesSent);
+}
+
+std::size_t	Client::getBodyBytesSent() const {
+	return (this->m_BytesSent - this->m_HeaderBytes);
+}
+
+const unsigned long&	Client::getRequestStart() const {
+	return (this->m_RequestStart);
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "../../FileDescriptor/Socket/ClientSocket.hpp"
+#include "../../HTTP/Chunked.hpp"
+#include "../../HTTP/Request.hpp"
+#include "../../Metrics/Metrics.hpp"
+#include "../../Parser/ConfParser/ConfData/ConfServerBlock.hpp"
+#include "../../Proxy/UpstreamGroup.hpp"
+#include "../EventLoop/EventLoop.hpp"
+#include "AResponder.hpp"
+#include <string>
+
+class CacheZone;
+class MicroCache;
+class Server;
+struct CacheEntry;
+
+namespace E_CLIENT {
+	const std::size_t	RECV_SIZE = 65536;
+	const std::size_t	HIGH_WATERMARK = 262144;
+	const std::size_t	LOW_WATERMARK = 65536;
+	// chunked request body 는 길이를 모르므로 마지막 chunk 까지 m_BodyLeft 를 이 값으로 둔다.
+	const std::size_t	CHUNKED_BODY = static_cast<std::size_t>(-1);
+}
+
+/**
+ * @brief	accept 된 connection 하나
+ * @details	request header 를 파싱해서 location 을 고르고,
+ *			CGI / proxy_pass location 이면 body 를 받는 대로 responder (CGI, cgi_pool, upstream 연결) 에 흘려보낸다.
+ *			chunked request body 는 chunk-data 만 풀어서 넘긴다. (proxy_pass 는 upstream 에 다시 chunked 로 보낸다)
+ *			응답은 m_SendBuffer 에 쌓였다가 write filter 가 켜지면 나간다.
+ *			파일 응답 (정적 파일, proxy_cache hit) 은 m_SendBuffer 를 다 보낸 뒤에 sendfile 로 보낸다.
+ *			file_cache 에 있는 작은 정적 파일은 header 와 body 를 writev 한 번으로 보낸다.
+ *			다른 request 가 같은 key 를 upstream 에서 가져오는 중이면 (cache lock) timer 로 다시 보면서 기다린다.
+ *			만료된 응답도 stale_while_revalidate / stale_if_error 안이면 보낸다.
+ *			microcache location 이면 CGI 를 띄우기 전에 공유 메모리의 응답부터 본다.
+ *			응답이 끝나면 (responseDone) 보낸 status / byte 수로 access_log 에 log_format 한 줄을 남긴다. (느렸으면 slow_request_log 에도)
+ *			connection 상태 (waiting / reading / writing) 는 바뀔 때마다 Metrics 의 worker counter 에 옮겨 센다. (stub_status)
+ *			request 의 단계별 시각 (m_Timing) 은 응답이 끝날 때 Metrics 의 route histogram 에 넣는다. (metrics)
+ *			FIRST_SENT 는 socket 에 처음 넘긴 때, DONE 은 m_SendBuffer 까지 다 넘긴 때다. (m_Draining 동안 다음 request 는 기다린다)
+ */
+class Client : public AEventHandler {
+private:
+	ClientSocket				m_Socket;
+	std::string					m_RemoteAddr;
+	EventLoop&					m_Loop;
+	Server&						m_Server;
+
+	std::string					m_RecvBuffer;
+	std::string					m_SendBuffer;
+	std::size_t					m_SendOffset;
+	bool						m_WriteEnabled;
+	bool						m_ReadPaused;
+	int							m_File;
+	off_t						m_FileOffset;
+	std::size_t					m_FileLeft;
+
+	HTTP::Request				m_Request;
+	bool						m_HeaderDone;
+	bool						m_Responding;
+	bool						m_KeepAlive;
+	bool						m_Closing;
+	bool						m_Draining;
+	std::size_t					m_BodyLeft;
+	HTTP::ChunkedScanner		m_ChunkedBody;
+
+	const CONF::ServerBlock*	m_ServerBlock;
+	const CONF::LocationBlock*	m_Location;
+	std::size_t					m_LocationMatch;
+	AResponder*					m_Responder;
+	unsigned long				m_UpstreamTried;
+	bool						m_UpstreamFresh;
+	CacheZone*					m_CacheLock;
+	MicroCache*					m_MicroLock;
+	unsigned long				m_CacheKey;
+	unsigned long				m_CacheWaitStart;
+	bool						m_CacheWaiting;
+	unsigned long				m_RequestStart;
+	unsigned short				m_Status;
+	std::size_t					m_BytesSent;
+	std::size_t					m_HeaderBytes;
+	unsigned char				m_HeaderEnd;
+	unsigned char				m_Phase;
+	RequestTiming				m_Timing;
+
+	Client(const Client& other);
+	Client& operator=(const Client& other);
+
+	void	onRead(const struct kevent& event);
+	void	onWrite();
+	void	sendFileBody();
+	void	closeFile();
+	void	onRequestData();
+	void	dispatch();
+	void	proxyRequest();
+	bool	serveCache();
+	bool	sendCached(CacheZone& zone, const std::string& cacheKey, const CacheEntry& entry);
+	void	refreshCache(CacheZone& zone, const unsigned long& key);
+	void	releaseCacheLock();
+	void	cgiRequest();
+	bool	serveMicrocache();
+	void	serveStatic();
+	bool	findIndex(std::string& file) const;
+	void	serveDirectory(const std::string& directory);
+	void	redirectDirectory();
+	bool	notModified(const std::string& response);
+	void	serveStatus(std::string (*render)());
+	const std::string	scriptFile() const;
+	void	startCgi();
+	void	startFastcgi(const std::string& script, const bool& fresh);
+	void	startProxy(const unsigned short& statusCode);
+	void	forwardBody();
+	void	chunkedBodyError();
+	void	countOutput(const char* data, const std::size_t& size);
+	void	writeAccessLog();
+	void	finishResponse();
+	void	nextRequest();
+	void	close();
+
+	static std::string	escapeHtml(const std::string& text);
+
+public:
+	Client(const int& fd, const std::string& remoteAddr, EventLoop& loop, Server& server);
+	virtual ~Client();
+
+	void	handleEvent(const struct kevent& event);
+
+	void	send(const char* data, const std::size_t& size);
+	void	send(const std::string& head, const std::string& body);
+	void	sendFile(const int& fd, const off_t& offset, const std::size_t& size);
+	void	sendError(const unsigned short& statusCode);
+	void	responseDone();
+	void	abort();
+	void	closeAfterResponse();
+	void	retryProxy(const unsigned short& statusCode, const UpstreamGroup::Peer* stale);
+	void	retryFastcgi();
+	bool	serveStale();
+	void	resumeRead();
+
+	const int&					getFd() const;
+	const std::string&			getRemoteAddr() const;
+	const HTTP::Request&		getRequest() const;
+	const CONF::ServerBlock*	getServerBlock() const;
+	const CONF::LocationBlock*	getLocation() const;
+	const std::size_t&			getLocationMatch() const;
+	std::size_t					getPendingOutput() const;
+	const unsigned short&		getStatus() const;
+	const std::size_t&			getBytesSent() const;
+	std::size_t					getBodyBytesSent() const;
+	const unsigned long&		getRequestStart() const;
+};
@@ -0,0 +1,229 @@
+#include "ErrorPage.hpp"
+#include "../../HTTP/HTTPStatus.hpp"
+#include "../../Log/LogFile.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+char*					ErrorPage::m_Region = NULL;
+std::size_t				ErrorPage::m_RegionSize = 0;
+ErrorPage::responseMap	ErrorPage::m_Responses;
+ErrorPage::defaultMap	ErrorPage::m_Defaults;
+
+const std::string	ErrorPage::resolvePath(const std::string& root, const std::string& path) {
+	if (root.empty()) {
+		return (path);
+	}
+	if (path[0] == '/' || root[root.size() - 1] == '/') {
+		return (root + path);
+	}
+	return (root + "/" + path);
+}
+
+bool	ErrorPage::readBody(const std::string& path, std::string& body) {
+	const int	fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat	buf;
+	if (fstat(fd, &buf) < 0 || !S_ISREG(buf.st_mode)) {
+		close(fd);
+		return false;
+	}
+	body.resize(buf.st_size);
+
+	std::size_t	total = 0;
+	while (total < body.size()) {
+		const ssize_t	readSize = read(fd, &body[total], body.size() - total);
+		if (readSize <= 0) {
+			break;
+		}
+		total += readSize;
+	}
+	close(fd);
+	body.resize(total);
+	return (total == static_cast<std::size_t>(buf.st_size));
+}
+
+const std::string	ErrorPage::contentType(const std::string& path, const extensionMap& extensions, const std::string& defaultType) {
+	const std::size_t	dotPos = path.rfind('.');
+	if (dotPos == std::string::npos || path.find('/', dotPos) != std::string::npos) {
+		return (defaultType);
+	}
+	const extensionMap::const_iterator	it = extensions.find(path.substr(dotPos + 1));
+	return (it != extensions.end() ? it->second : defaultType);
+}
+
+const std::string	ErrorPage::defaultBody(const unsigned short& statusCode) {
+	std::stringstream	body;
+	const char*			reason = HTTP::reasonPhrase(statusCode);
+
+	body << "<html>\r\n<head><title>" << statusCode << " " << (reason ? reason : "") << "</title></head>\r\n"
+		 << "<body>\r\n<center><h1>" << statusCode << " " << (reason ? reason : "") << "</h1></center>\r\n"
+		 << "<hr><center>webserv</center>\r\n</body>\r\n</html>\r\n";
+	return (body.str());
+}
+
+const std::string	ErrorPage::buildResponse(const unsigned short& statusCode, const std::string& type, const std::string& body, const std::string& location) {
+	std::stringstream	res;
+	const char*			reason = HTTP::reasonPhrase(statusCode);
+
+	res << "HTTP/1.1 " << statusCode << " " << (reason ? reason : "") << "\r\n"
+		<< "Server: webserv\r\n"
+		<< "Content-Type: " << type << "\r\n"
+		<< "Content-Length: " << body.size() << "\r\n";
+	if (!location.empty()) {
+		res << "Location: " << location << "\r\n";
+	}
+	res << "\r\n" << body;
+	return (res.str());
+}
+
+/**
+ * @brief	한 블록의 error_page 를 완성된 응답으로 만들어 blob 에 붙인다.
+ * @details	URL 이면 302 (또는 =3xx) redirect, 로컬 파일이면 root 기준으로 읽는다.
+ *			같은 파일은 한 번만 읽는다.
+ */
+void	ErrorPage::collect(const std::string& root, const errorPageMap& pages, preloadContext& ctx) {
+	for (errorPageMap::const_iterator it = pages.begin(); it != pages.end(); ++it) {
+		const CONF::errorPageData&	data = it->second;
+
+		if (data.m_Path.empty() || ctx.m_Pending.count(&data)) {
+			continue;
+		}
+		unsigned short	statusCode = it->first;
+		if (data.m_Type == E_ERRORPAGE::REPLACE && data.m_Replace != 0) {
+			statusCode = data.m_Replace;
+		}
+
+		std::string	response;
+		std::size_t	bodySize = 0;
+		if (data.m_Path.find("://") != std::string::npos) {
+			const unsigned short	redirectCode = (statusCode >= 301 && statusCode <= 308) ? statusCode : 302;
+			const std::string		body = defaultBody(redirectCode);
+			response = buildResponse(redirectCode, "text/html", body, data.m_Path);
+			bodySize = body.size();
+		} else {
+			const std::string					path = resolvePath(root, data.m_Path);
+			std::map<std::string, std::string>::iterator	bodyIt = ctx.m_Bodies.find(path);
+
+			if (bodyIt == ctx.m_Bodies.end()) {
+				std::string	body;
+				if (!readBody(path, body)) {
+					LogFile::error("error_page: cannot read \"" + path + "\", default page is used");
+					continue;
+				}
+				bodyIt = ctx.m_Bodies.insert(std::make_pair(path, body)).first;
+			}
+			response = buildResponse(statusCode, contentType(path, ctx.m_Extensions, ctx.m_DefaultType), bodyIt->second, "");
+			bodySize = bodyIt->second.size();
+		}
+
+		const pending	entry = { ctx.m_Blob.size(), response.size(), response.size() - bodySize };
+		ctx.m_Blob += response;
+		ctx.m_Pending.insert(std::make_pair(&data, entry));
+	}
+}
+
+void	ErrorPage::collectServer(const CONF::ServerBlock& server, void* context) {
+	collect(server.getRoot(), server.getError_page(), *static_cast<preloadContext*>(context));
+}
+
+void	ErrorPage::collectLocation(const CONF::ServerBlock&, const CONF::LocationBlock& location, const std::string&, void* context) {
+	collect(location.getRoot(), location.getError_page(), *static_cast<preloadContext*>(context));
+}
+
+void	ErrorPage::preload(const CONF::MainBlock& mainBlock) {
+	const CONF::HTTPBlock&	http = mainBlock.getHTTPBlock();
+	preloadContext			ctx;
+
+	ctx.m_DefaultType = "text/html";
+	const std::map<std::string, std::vector<std::string> >&	types = http.getMime_types();
+	for (std::map<std::string, std::vector<std::string> >::const_iterator it = types.begin(); it != types.end(); ++it) {
+		for (std::vector<std::string>::const_iterator ext = it->second.begin(); ext != it->second.end(); ++ext) {
+			ctx.m_Extensions[*ext] = it->first;
+		}
+	}
+
+	// default pages: every registered 3xx redirect / 4xx / 5xx status code
+	for (unsigned short code = 300; code < 600; code++) {
+		if (HTTP::reasonPhrase(code) == NULL) {
+			continue;
+		}
+		const std::string	body = defaultBody(code);
+		const std::string	response = buildResponse(code, "text/html", body, "");
+		const pending		entry = { ctx.m_Blob.size(), response.size(), response.size() - body.size() };
+		ctx.m_Blob += response;
+		ctx.m_PendingDefaults.insert(std::make_pair(code, entry));
+	}
+
+	collect(http.getRoot(), http.getError_page(), ctx);
+
+	http.visitLocations(collectServer, collectLocation, &ctx);
+
+	// 하나의 공유 영역에 복사한 뒤 읽기 전용으로 잠근다. fork 후에도 같은 물리 페이지를 본다.
+	m_RegionSize = ctx.m_Blob.size();
+	void*	region = mmap(NULL, m_RegionSize, PROT_READ | PROT_WRITE, MAP_ANON | MAP_SHARED, -1, 0);
+	if (region == MAP_FAILED) {
+		throw std::runtime_error("ErrorPage::preload(): mmap failed");
+	}
+	std::memcpy(region, ctx.m_Blob.data(), m_RegionSize);
+	if (mprotect(region, m_RegionSize, PROT_READ) < 0) {
+		munmap(region, m_RegionSize);
+		m_RegionSize = 0;
+		throw std::runtime_error("ErrorPage::preload(): mprotect failed");
+	}
+	m_Region = static_cast<char*>(region);
+
+	for (std::map<const CONF::errorPageData*, pending>::const_iterator it = ctx.m_Pending.begin(); it != ctx.m_Pending.end(); ++it) {
+		const Response	response = { m_Region + it->second.m_Offset, it->second.m_Size, it->second.m_HeaderSize };
+		m_Responses.insert(std::make_pair(it->first, response));
+	}
+	for (std::map<unsigned short, pending>::const_iterator it = ctx.m_PendingDefaults.begin(); it != ctx.m_PendingDefaults.end(); ++it) {
+		const Response	response = { m_Region + it->second.m_Offset, it->second.m_Size, it->second.m_HeaderSize };
+		m_Defaults.insert(std::make_pair(it->first, response));
+	}
+}
+
+void	ErrorPage::destroy() {
+	if (m_Region != NULL) {
+		munmap(m_Region, m_RegionSize);
+	}
+	m_Region = NULL;
+	m_RegionSize = 0;
+	m_Responses.clear();
+	m_Defaults.clear();
+}
+
+/**
+ * @brief	block 의 error_page 설정에 맞는 응답을 돌려준다.
+ * @return	"@name" 설정이면 NULL (internal redirect 는 호출한 쪽에서 처리)
+ */
+const ErrorPage::Response*	ErrorPage::get(const errorPageMap& pages, const unsigned short& statusCode) {
+	const errorPageMap::const_iterator	it = pages.find(statusCode);
+	if (it == pages.end()) {
+		return (&getDefault(statusCode));
+	}
+	if (it->second.m_Path.empty() || it->second.m_Path[0] == '@') {
+		return (NULL);
+	}
+	const responseMap::const_iterator	res = m_Responses.find(&it->second);
+	return (res != m_Responses.end() ? &res->second : &getDefault(statusCode));
+}
+
+const ErrorPage::Response&	ErrorPage::getDefault(const unsigned short& statusCode) {
+	defaultMap::const_iterator	it = m_Defaults.find(statusCode);
+	if (it == m_Defaults.end()) {
+		it = m_Defaults.find(500);
+	}
+	if (it == m_Defaults.end()) {
+		throw std::runtime_error("ErrorPage::getDefault(): error pages are not preloaded");
+	}
+	return (it->second);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include <cstddef>
+#include <map>
+#include <string>
+
+/**
+ * @brief	Preloaded error page responses
+ * @details	MasterProcess::start()에서 fork 전에 한 번 호출한다.
+ *			http / server / location 블록의 error_page 를 모두 읽어서
+ *			"status line + header + body" 형태의 완성된 응답으로 만들어 두고,
+ *			하나의 mmap 영역에 복사한 뒤 PROT_READ 로 잠근다.
+ *			worker 는 fork 로 같은 페이지를 공유하므로 에러 응답을 보낼 때
+ *			디스크 접근도, 문자열 포맷팅도 하지 않는다.
+ *			HEAD 에는 앞의 m_HeaderSize byte (status line + header) 만 보낸다.
+ *			읽지 못한 파일은 error_log 에 남기고 기본 페이지를 쓴다. (LogFile::prepare 뒤에 부를 것)
+ */
+
+class ErrorPage {
+public:
+	struct Response {
+		const char*		m_Data;
+		std::size_t		m_Size;
+		std::size_t		m_HeaderSize;
+	};
+
+private:
+	typedef std::map<unsigned short, CONF::errorPageData>	errorPageMap;
+	typedef std::map<const CONF::errorPageData*, Response>	responseMap;
+	typedef std::map<unsigned short, Response>				defaultMap;
+	typedef std::map<std::string, std::string>				extensionMap;
+
+	struct pending {
+		std::size_t		m_Offset;
+		std::size_t		m_Size;
+		std::size_t		m_HeaderSize;
+	};
+
+	struct preloadContext {
+		std::string										m_Blob;
+		std::map<const CONF::errorPageData*, pending>	m_Pending;
+		std::map<unsigned short, pending>				m_PendingDefaults;
+		std::map<std::string, std::string>				m_Bodies;
+		extensionMap									m_Extensions;
+		std::string										m_DefaultType;
+	};
+
+	static char*		m_Region;
+	static std::size_t	m_RegionSize;
+	static responseMap	m_Responses;
+	static defaultMap	m_Defaults;
+
+	ErrorPage();
+	ErrorPage(const ErrorPage& other);
+	ErrorPage& operator=(const ErrorPage& other);
+	~ErrorPage();
+
+	static const std::string	contentType(const std::string& path, const extensionMap& extensions, const std::string& defaultType);
+	static const std::string	buildResponse(const unsigned short& statusCode, const std::string& type, const std::string& body, const std::string& location);
+	static const std::string	defaultBody(const unsigned short& statusCode);
+	static const std::string	resolvePath(const std::string& root, const std::string& path);
+	static bool					readBody(const std::string& path, std::string& body);
+
+	static void					collect(const std::string& root, const errorPageMap& pages, preloadContext& ctx);
+	static void					collectServer(const CONF::ServerBlock& server, void* context);
+	static void					collectLocation(const CONF::ServerBlock& server, const CONF::LocationBlock& location, const std::string& name, void* context);
+
+public:
+	static void				preload(const CONF::MainBlock& mainBlock);
+	static void				destroy();
+
+	static const Response*	get(const errorPageMap& pages, const unsigned short& statusCode);
+	static const Response&	getDefault(const unsigned short& statusCode);
+};
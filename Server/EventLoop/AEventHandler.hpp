@@ -0,0 +1,16 @@
+#pragma once
+
+#include <sys/event.h>
+
+/**
+ * @brief	EventLoop 에 등록되는 객체의 interface
+ * @details	kevent 의 udata 로 handler 포인터를 넘기고, 이벤트가 오면 handleEvent 를 호출한다.
+ *			하나의 handler 가 여러 fd (e.g. CGI stdin/stdout pipe) 를 등록할 수 있으므로
+ *			event.ident / event.filter 로 구분한다.
+ */
+class AEventHandler {
+public:
+	virtual ~AEventHandler() {}
+
+	virtual void	handleEvent(const struct kevent& event) = 0;
+};
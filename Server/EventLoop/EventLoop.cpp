@@ -0,0 +1,209 @@
+#include "EventLoop.hpp"
+#include "../../Metrics/Metrics.hpp"
+#include <cerrno>
+#include <stdexcept>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+unsigned long	EventLoop::m_Now = 0;
+unsigned long	EventLoop::m_BatchStart = 0;
+
+EventLoop::EventLoop() : m_Kq(kqueue()), m_Running(false) {
+	if (m_Kq < 0) {
+		throw std::runtime_error("EventLoop: kqueue() failed");
+	}
+	updateTime();
+}
+
+EventLoop::~EventLoop() {
+	collectGarbage();
+	close(m_Kq);
+}
+
+void	EventLoop::change(const uintptr_t& ident, const short& filter, const unsigned short& flags, const unsigned int& fflags, AEventHandler* handler) {
+	struct kevent	event;
+
+	EV_SET(&event, ident, filter, flags, fflags, 0, handler);
+	m_ChangeList.push_back(event);
+}
+
+void	EventLoop::addRead(const int& fd, AEventHandler* handler) {
+	change(fd, EVFILT_READ, EV_ADD | EV_ENABLE, 0, handler);
+}
+
+/**
+ * @brief	write filter 는 disable 상태로 등록하고, 보낼 데이터가 생기면 enableWrite 한다.
+ */
+void	EventLoop::addWrite(const int& fd, AEventHandler* handler) {
+	change(fd, EVFILT_WRITE, EV_ADD | EV_DISABLE, 0, handler);
+}
+
+void	EventLoop::enableRead(const int& fd, AEventHandler* handler) {
+	change(fd, EVFILT_READ, EV_ENABLE, 0, handler);
+}
+
+void	EventLoop::disableRead(const int& fd, AEventHandler* handler) {
+	change(fd, EVFILT_READ, EV_DISABLE, 0, handler);
+}
+
+void	EventLoop::enableWrite(const int& fd, AEventHandler* handler) {
+	change(fd, EVFILT_WRITE, EV_ENABLE, 0, handler);
+}
+
+void	EventLoop::disableWrite(const int& fd, AEventHandler* handler) {
+	change(fd, EVFILT_WRITE, EV_DISABLE, 0, handler);
+}
+
+void	EventLoop::addProcess(const pid_t& pid, AEventHandler* handler) {
+	change(pid, EVFILT_PROC, EV_ADD | EV_ONESHOT, NOTE_EXIT, handler);
+}
+
+/**
+ * @brief	signal 이 오면 handler 를 event 로 부른다. (signal handler 안에서 일하지 않는다)
+ * @details	kqueue 는 기본 동작보다 늦게 보므로, 부르는 쪽이 signal 을 SIG_IGN 으로 바꿔 둘 것.
+ */
+void	EventLoop::addSignal(const int& signo, AEventHandler* handler) {
+	change(signo, EVFILT_SIGNAL, EV_ADD | EV_ENABLE, 0, handler);
+}
+
+/**
+ * @brief	milliseconds 마다 반복되는 timer
+ * @details	timer ident 는 fd 와 별개의 namespace 이므로, 보통 handler 주소를 ident 로 쓴다.
+ */
+void	EventLoop::addTimer(const uintptr_t& ident, const int& milliseconds, AEventHandler* handler) {
+	struct kevent	event;
+
+	EV_SET(&event, ident, EVFILT_TIMER, EV_ADD | EV_ENABLE, 0, milliseconds, handler);
+	m_ChangeList.push_back(event);
+}
+
+/**
+ * @brief	한 번만 울리는 timer. 같은 ident 로 다시 부르면 처음부터 다시 센다.
+ */
+void	EventLoop::addTimeout(const uintptr_t& ident, const int& milliseconds, AEventHandler* handler) {
+	struct kevent	event;
+
+	EV_SET(&event, ident, EVFILT_TIMER, EV_ADD | EV_ENABLE | EV_ONESHOT, 0, milliseconds, handler);
+	m_ChangeList.push_back(event);
+}
+
+void	EventLoop::removeTimer(const uintptr_t& ident) {
+	change(ident, EVFILT_TIMER, EV_DELETE, 0, NULL);
+}
+
+/**
+ * @brief	fd 를 close 하기 직전에 호출한다.
+ * @details	close 된 fd 의 filter 는 kqueue 가 알아서 지우므로,
+ *			아직 반영되지 않은 변경 사항만 버리면 된다. (EBADF 방지)
+ */
+void	EventLoop::forget(const int& fd) {
+	for (std::vector<struct kevent>::iterator it = m_ChangeList.begin(); it != m_ChangeList.end();) {
+		if (it->ident == static_cast<uintptr_t>(fd) && it->filter != EVFILT_PROC && it->filter != EVFILT_TIMER && it->filter != EVFILT_SIGNAL) {
+			it = m_ChangeList.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void	EventLoop::release(AEventHandler* handler) {
+	m_Released.insert(handler);
+}
+
+void	EventLoop::collectGarbage() {
+	for (std::set<AEventHandler*>::iterator it = m_Released.begin(); it != m_Released.end(); ++it) {
+		delete *it;
+	}
+	m_Released.clear();
+}
+
+LoopProbe::LoopProbe() : m_Deadline(0) {}
+
+/**
+ * @brief	다음 kevent() 에서 반복 timer 를 건다. 처음 deadline 은 지금부터 한 주기 뒤다.
+ */
+void	LoopProbe::start(EventLoop& loop) {
+	m_Deadline = EventLoop::monotonic() + E_EVENTLOOP::PROBE_INTERVAL * 1000;
+	loop.addTimer(reinterpret_cast<uintptr_t>(this), E_EVENTLOOP::PROBE_INTERVAL, this);
+}
+
+void	LoopProbe::handleEvent(const struct kevent& event) {
+	const unsigned long	now = EventLoop::monotonic();
+	const unsigned long	missed = (event.data > 1) ? event.data - 1 : 0;
+
+	// 밀린 주기를 건너뛰고 마지막으로 울렸어야 할 시각과 비교한다.
+	m_Deadline += missed * E_EVENTLOOP::PROBE_INTERVAL * 1000;
+	Metrics::timer(now > m_Deadline ? now - m_Deadline : 0);
+	m_Deadline += E_EVENTLOOP::PROBE_INTERVAL * 1000;
+}
+
+void	EventLoop::run() {
+	struct kevent	events[E_EVENTLOOP::MAX_EVENTS];
+	unsigned long	idleStart = monotonic();
+
+	m_Running = true;
+	m_Probe.start(*this);
+	while (m_Running) {
+		const int	changeSize = static_cast<int>(m_ChangeList.size());
+		const int	eventSize = kevent(m_Kq, changeSize ? &m_ChangeList[0] : NULL, changeSize, events, E_EVENTLOOP::MAX_EVENTS, NULL);
+		m_ChangeList.clear();
+		updateTime();
+		m_BatchStart = monotonic();
+
+		if (eventSize < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw std::runtime_error("EventLoop: kevent() failed");
+		}
+		for (int i = 0; i < eventSize; i++) {
+			AEventHandler*	handler = static_cast<AEventHandler*>(events[i].udata);
+
+			if ((events[i].flags & EV_ERROR) || handler == NULL || m_Released.count(handler)) {
+				continue;
+			}
+			handler->handleEvent(events[i]);
+		}
+		collectGarbage();
+
+		const unsigned long	end = monotonic();
+		Metrics::loop(end - m_BatchStart, m_BatchStart - idleStart, eventSize);
+		idleStart = end;
+	}
+}
+
+void	EventLoop::stop() {
+	m_Running = false;
+}
+
+void	EventLoop::updateTime() {
+	struct timeval	tv;
+
+	gettimeofday(&tv, NULL);
+	m_Now = static_cast<unsigned long>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+/**
+ * @brief	마지막 kevent() 가 돌아온 시각 (epoch 기준 ms)
+ */
+const unsigned long&	EventLoop::now() {
+	return (m_Now);
+}
+
+/**
+ * @brief	부팅 뒤로 흐른 시간 (µs). 캐시하지 않으므로 부를 때마다 시계를 읽는다.
+ */
+unsigned long	EventLoop::monotonic() {
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<unsigned long>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000);
+}
+
+/**
+ * @brief	이번 kevent() 가 돌아온 뒤로 handler 들이 쓴 시간 (µs). loop 밖이면 0
+ */
+unsigned long	EventLoop::lag() {
+	return (m_BatchStart != 0 ? monotonic() - m_BatchStart : 0);
+}
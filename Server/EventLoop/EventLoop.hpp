@@ -0,0 +1,84 @@
+#pragma once
+
+#include "AEventHandler.hpp"
+#include <set>
+#include <sys/types.h>
+#include <vector>
+
+namespace E_EVENTLOOP {
+	const int	MAX_EVENTS = 1024;
+	const int	PROBE_INTERVAL = 100;
+}
+
+class EventLoop;
+
+/**
+ * @brief	PROBE_INTERVAL (ms) 마다 울리는 timer. 울렸어야 할 시각보다 얼마나 늦게 불렸는지를 Metrics 에 넘긴다. (timer lateness)
+ * @details	timer 마다 deadline 을 따로 들고 다니지 않고, 같은 loop 의 timer 를 대표해서 하나만 잰다.
+ *			kqueue 의 반복 timer 는 밀린 횟수를 event.data 로 알려 주므로 deadline 은 그만큼 건너뛴다.
+ */
+class LoopProbe : public AEventHandler {
+private:
+	unsigned long	m_Deadline;
+
+public:
+	LoopProbe();
+
+	void	handleEvent(const struct kevent& event);
+	void	start(EventLoop& loop);
+};
+
+/**
+ * @brief	kqueue event loop (worker process 하나당 하나)
+ * @details	변경 사항은 m_ChangeList 에 모았다가 다음 kevent() 호출 때 한 번에 반영한다.
+ *			release() 된 handler 는 같은 batch 의 남은 이벤트를 받지 않고,
+ *			batch 가 끝난 뒤에 delete 된다.
+ *			현재 시각 (ms) 은 kevent() 가 돌아올 때마다 한 번만 읽어 둔다. (now())
+ *			구간을 잴 때는 시계가 바뀌어도 뒤로 가지 않는 monotonic() (µs) 을 그때그때 읽는다.
+ *			lag() 는 이번 batch 가 돌아온 뒤로 흐른 시간이다. 같은 batch 의 뒤쪽 event 는 그만큼 늦게 처리된다.
+ *			batch 마다 handler 를 돌린 시간, kevent() 에서 기다린 시간, event 수를 Metrics 에 넘긴다. (loop 통계, busy ratio)
+ */
+class EventLoop {
+private:
+	int							m_Kq;
+	bool						m_Running;
+	std::vector<struct kevent>	m_ChangeList;
+	std::set<AEventHandler*>	m_Released;
+	LoopProbe					m_Probe;
+
+	static unsigned long		m_Now;
+	static unsigned long		m_BatchStart;
+
+	EventLoop(const EventLoop& other);
+	EventLoop& operator=(const EventLoop& other);
+
+	void	change(const uintptr_t& ident, const short& filter, const unsigned short& flags, const unsigned int& fflags, AEventHandler* handler);
+	void	collectGarbage();
+
+public:
+	EventLoop();
+	~EventLoop();
+
+	void	addRead(const int& fd, AEventHandler* handler);
+	void	addWrite(const int& fd, AEventHandler* handler);
+	void	enableRead(const int& fd, AEventHandler* handler);
+	void	disableRead(const int& fd, AEventHandler* handler);
+	void	enableWrite(const int& fd, AEventHandler* handler);
+	void	disableWrite(const int& fd, AEventHandler* handler);
+	void	addProcess(const pid_t& pid, AEventHandler* handler);
+	void	addSignal(const int& signo, AEventHandler* handler);
+	void	addTimer(const uintptr_t& ident, const int& milliseconds, AEventHandler* handler);
+	void	addTimeout(const uintptr_t& ident, const int& milliseconds, AEventHandler* handler);
+	void	removeTimer(const uintptr_t& ident);
+
+	void	forget(const int& fd);
+	void	release(AEventHandler* handler);
+
+	void	run();
+	void	stop();
+
+	static void					updateTime();
+	static const unsigned long&	now();
+	static unsigned long		monotonic();
+	static unsigned long		lag();
+};
@@ -1,8 +1,31 @@
 #include "MasterProcess.hpp"
+#include "../Cache/CacheZone.hpp"
+#include "../Cache/FileCache.hpp"
+#include "../Cache/MicroCache.hpp"
+#include "../Shm/ShmZone.hpp"
+#include "../Metrics/Metrics.hpp"
+#include "../Log/AccessLog.hpp"
+#include "../Log/LogFile.hpp"
+#include "../Log/RequestTrace.hpp"
+#include "../CGI/CGIEnv.hpp"
+#include "../FastCGI/FastCGIUpstream.hpp"
+#include "../Proxy/UpstreamGroup.hpp"
+#include "ErrorPage/ErrorPage.hpp"
+#include "Worker/Worker.hpp"
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
 
 // TODO: delete
 #include <iostream>
 
+MasterProcess::serverMap					MasterProcess::m_Servers;
+std::vector<ft::shared_ptr<Server> >		MasterProcess::m_ServerList;
+std::vector<pid_t>							MasterProcess::m_Workers;
+
 MasterProcess::MasterProcess(const std::string& fileName, char** env) {
 	try {
 		CONF::ConfBlock::initInstance(fileName, env);
@@ -15,9 +38,118 @@ MasterProcess::MasterProcess(const std::string& fileName, char** env) {
 
 MasterProcess::~MasterProcess() {
 	std::cout << "MasterProcess destroyed\n";
+	ErrorPage::destroy();
 	CONF::ConfBlock::getInstance()->destroy();
 }
 
+/**
+ * @brief	server block 들을 IP:port 별로 묶어서 listen socket 을 연다.
+ */
+void	MasterProcess::openServers() {
+	const CONF::HTTPBlock::serverMap	serverBlocks = CONF::ConfBlock::getInstance()->getMainBlock().getHTTPBlock().getServerMap();
+
+	for (CONF::HTTPBlock::serverMap::const_iterator it = serverBlocks.begin(); it != serverBlocks.end(); ++it) {
+		const std::pair<std::string, unsigned short>	key = std::make_pair(it->second->getIP(), it->second->getPort());
+		const serverMap::iterator						found = m_Servers.find(key);
+
+		if (found != m_Servers.end()) {
+			found->second->addServerBlock(it->second);
+		} else {
+			ft::shared_ptr<Server>	server(new Server(it->second));
+			m_Servers.insert(std::make_pair(key, server));
+			m_ServerList.push_back(server);
+		}
+	}
+}
+
+void	MasterProcess::spawnWorkers() {
+	const unsigned int&	workerProcess = CONF::ConfBlock::getInstance()->getMainBlock().getWorkerProcess();
+
+	for (unsigned int id = 0; id < workerProcess; id++) {
+		const pid_t	pid = fork();
+
+		if (pid < 0) {
+			throw std::runtime_error("MasterProcess: fork() failed");
+		}
+		if (pid == 0) {
+			// 물려받은 relaySignal 이 LogFile::start 전에 불려도 형제 worker 에게 넘기지 않도록
+			m_Workers.clear();
+			Worker	worker(id, m_ServerList);
+			worker.run();
+			std::exit(0);
+		}
+		m_Workers.push_back(pid);
+	}
+}
+
+/**
+ * @brief	proxy_cache_path 가 있으면 worker 를 기다리는 동안 cache manager 를 MANAGER_INTERVAL 마다 돌린다.
+ */
+void	MasterProcess::waitWorkers() {
+	const bool	manageCache = !CacheZone::empty();
+
+	while (!m_Workers.empty()) {
+		const pid_t	pid = waitpid(-1, NULL, manageCache ? WNOHANG : 0);
+
+		if (pid < 0) {
+			break;
+		}
+		if (pid == 0) {
+			CacheZone::manage();
+			usleep(E_CACHE::MANAGER_INTERVAL * 1000);
+			continue;
+		}
+		for (std::vector<pid_t>::iterator it = m_Workers.begin(); it != m_Workers.end(); ++it) {
+			if (*it == pid) {
+				m_Workers.erase(it);
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * @brief	master 가 받은 signal 을 모든 worker 에게 넘긴다. (e.g. log rotation 뒤 kill -USR1 master)
+ * @details	fork 전에 걸어 두므로 worker 가 자기 handler 를 걸기 전에 받아도 죽지 않는다.
+ *			SA_RESTART 이므로 waitpid 는 signal 때문에 끝나지 않는다.
+ */
+void	MasterProcess::forwardSignal(const int& signo) {
+	struct sigaction	action;
+
+	std::memset(&action, 0, sizeof(action));
+	action.sa_handler = relaySignal;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	sigaction(signo, &action, NULL);
+}
+
+void	MasterProcess::relaySignal(int signo) {
+	for (std::vector<pid_t>::const_iterator it = m_Workers.begin(); it != m_Workers.end(); ++it) {
+		kill(*it, signo);
+	}
+}
+
 void	MasterProcess::start() {
 	CONF::ConfBlock::getInstance()->print();
-}
\ No newline at end of file
+
+	// 아래 prepare 들의 실패도 error_log 에 남도록 log 파일을 먼저 연다.
+	LogFile::prepare(CONF::ConfBlock::getInstance()->getMainBlock());
+	// worker fork 전에 error page 응답을 공유 메모리에 미리 만들어 둔다.
+	ErrorPage::preload(CONF::ConfBlock::getInstance()->getMainBlock());
+	CGIEnv::prepare(CONF::ConfBlock::getInstance()->getMainBlock());
+	FastCGIUpstream::prepare(CONF::ConfBlock::getInstance()->getMainBlock());
+	UpstreamGroup::prepare(CONF::ConfBlock::getInstance()->getMainBlock());
+	CacheZone::prepare(CONF::ConfBlock::getInstance()->getMainBlock());
+	ShmZone::prepare(CONF::ConfBlock::getInstance()->getMainBlock());
+	Metrics::prepare(CONF::ConfBlock::getInstance()->getMainBlock());
+	MicroCache::prepare(CONF::ConfBlock::getInstance()->getMainBlock());
+	FileCache::prepare(CONF::ConfBlock::getInstance()->getMainBlock());
+	AccessLog::prepare(CONF::ConfBlock::getInstance()->getMainBlock());
+	RequestTrace::prepare(CONF::ConfBlock::getInstance()->getMainBlock());
+	LogFile::drainAll();
+
+	openServers();
+	forwardSignal(E_LOG_FILE::REOPEN_SIGNAL);
+	spawnWorkers();
+	waitWorkers();
+}
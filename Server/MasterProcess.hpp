@@ -3,19 +3,27 @@
 #include "../Parser/ConfParser/ConfData/ConfBlock.hpp"
 #include "../Utils/Singleton.hpp"
 #include "Server/Server.hpp"
+#include <vector>
 
 class MasterProcess : public Singleton<MasterProcess> {
-public: typedef std::map<std::vector<std::string>, ft::shared_ptr<Server> > serverMap;
+public: typedef std::map<std::pair<std::string, unsigned short>, ft::shared_ptr<Server> > serverMap;
 private:
-	// static serverMap	m_Servers;
-
+	static serverMap							m_Servers;
+	static std::vector<ft::shared_ptr<Server> >	m_ServerList;
+	static std::vector<pid_t>					m_Workers;
 
 	MasterProcess(const MasterProcess& other);
 	MasterProcess& operator=(const MasterProcess& other);
 
+	static void	openServers();
+	static void	spawnWorkers();
+	static void	waitWorkers();
+	static void	forwardSignal(const int& signo);
+	static void	relaySignal(int signo);
+
 public:
 	MasterProcess(const std::string& fileName, char** env);
 	~MasterProcess();
 
 	static void	start();
-};
\ No newline at end of file
+};
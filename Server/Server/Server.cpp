@@ -1,11 +1,89 @@
 #include "Server.hpp"
+#include "../Client/Client.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
 
 Server::Server(const ft::shared_ptr<CONF::ServerBlock>& block)
-  : m_ServerBlock(block),
+  : m_Socket(block->getIP(), block->getPort()),
+	m_Loop(NULL)
 {
-	
+	m_ServerBlock.push_back(block);
 }
 
 Server::~Server() {
 
-}
\ No newline at end of file
+}
+
+void	Server::addServerBlock(const ft::shared_ptr<CONF::ServerBlock>& block) {
+	for (serverBlockVec::const_iterator it = m_ServerBlock.begin(); it != m_ServerBlock.end(); ++it) {
+		if (it->get() == block.get()) {
+			return ;
+		}
+	}
+	m_ServerBlock.push_back(block);
+}
+
+void	Server::attach(EventLoop& loop) {
+	m_Loop = &loop;
+	m_Loop->addRead(m_Socket.getFd(), this);
+}
+
+/**
+ * @brief	accept 가능한 connection 을 모두 받아서 Client 로 등록한다.
+ */
+void	Server::handleEvent(const struct kevent& event) {
+	static_cast<void>(event);
+
+	while (true) {
+		struct sockaddr_in	addr;
+		socklen_t			addrLen = sizeof(addr);
+		const int			fd = accept(m_Socket.getFd(), reinterpret_cast<struct sockaddr*>(&addr), &addrLen);
+
+		if (fd < 0) {
+			return ;
+		}
+		fcntl(fd, F_SETFL, O_NONBLOCK);
+		fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+		Client*	client = new Client(fd, inet_ntoa(addr.sin_addr), *m_Loop, *this);
+		m_Loop->addRead(fd, client);
+		m_Loop->addWrite(fd, client);
+	}
+}
+
+const CONF::ServerBlock&	Server::findServerBlock(const std::string& host) const {
+	const std::string	name = host.substr(0, host.find(':'));
+
+	for (serverBlockVec::const_iterator it = m_ServerBlock.begin(); it != m_ServerBlock.end(); ++it) {
+		if ((*it)->getServerNames().count(name)) {
+			return (*(it->get()));
+		}
+	}
+	return (*(m_ServerBlock.front().get()));
+}
+
+/**
+ * @brief	prefix 가 가장 길게 일치하는 location (nested location 포함)
+ * @param	matched	일치한 prefix 길이 (proxy_pass URI 치환에 쓴다)
+ */
+const CONF::LocationBlock*	Server::findLocation(const CONF::ServerBlock& server, const std::string& path, std::size_t& matched) {
+	const CONF::LocationBlock*							found = NULL;
+	const std::map<std::string, CONF::LocationBlock>*	locations = &server.getLocationMap();
+
+	matched = 0;
+	while (locations != NULL) {
+		const std::map<std::string, CONF::LocationBlock>*	next = NULL;
+
+		for (std::map<std::string, CONF::LocationBlock>::const_iterator it = locations->begin(); it != locations->end(); ++it) {
+			if (it->first.size() >= matched && path.compare(0, it->first.size(), it->first) == 0) {
+				found = &it->second;
+				matched = it->first.size();
+				next = &it->second.getLocationBlock();
+			}
+		}
+		locations = (next != NULL && !next->empty()) ? next : NULL;
+	}
+	return (found);
+}
@@ -2,11 +2,21 @@
 
 #include "../../FileDescriptor/Socket/ServerSocket.hpp"
 #include "../../Parser/ConfParser/ConfData/ConfServerBlock.hpp"
+#include "../EventLoop/EventLoop.hpp"
+#include <vector>
 
-class Server {
+/**
+ * @brief	listen socket 하나 (IP:port)
+ * @details	같은 IP:port 로 listen 하는 server block (virtual host) 들을 가지고 있고,
+ *			첫번째로 등록된 block 이 default server 가 된다.
+ */
+class Server : public AEventHandler {
 private:
-	ft::shared_ptr<CONF::ServerBlock>	m_ServerBlock;
+	typedef std::vector<ft::shared_ptr<CONF::ServerBlock> >	serverBlockVec;
+
+	serverBlockVec						m_ServerBlock;
 	ServerSocket						m_Socket;
+	EventLoop*							m_Loop;
 
 	Server(const Server& other);
 	Server& operator=(const Server& other);
@@ -15,4 +25,10 @@ public:
 	Server(const ft::shared_ptr<CONF::ServerBlock>& block);
 	~Server();
 
-};
\ No newline at end of file
+	void	addServerBlock(const ft::shared_ptr<CONF::ServerBlock>& block);
+	void	attach(EventLoop& loop);
+	void	handleEvent(const struct kevent& event);
+
+	const CONF::ServerBlock&			findServerBlock(const std::string& host) const;
+	static const CONF::LocationBlock*	findLocation(const CONF::ServerBlock& server, const std::string& path, std::size_t& matched);
+};
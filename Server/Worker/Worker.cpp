@@ -0,0 +1,39 @@
+#include "Worker.hpp"
+#include "../../CGI/CGIPool.hpp"
+#include "../../Log/LogFile.hpp"
+#include "../../Metrics/Metrics.hpp"
+#include "../../Proxy/UpstreamGroup.hpp"
+#include <csignal>
+
+Worker::Worker(const unsigned int& id, const serverVec& servers)
+  : m_Id(id),
+	m_Servers(servers)
+{}
+
+Worker::~Worker() {}
+
+void	Worker::run() {
+	// client / CGI pipe 가 먼저 닫혀도 worker 가 죽지 않도록
+	signal(SIGPIPE, SIG_IGN);
+	Metrics::attach(m_Id);
+
+	for (serverVec::const_iterator it = m_Servers.begin(); it != m_Servers.end(); ++it) {
+		(*it)->attach(m_Loop);
+	}
+	// master 는 waitpid 에서 막혀 있으므로 active health check 는 첫 worker 가 맡는다. (결과는 shm 으로 공유)
+	if (m_Id == 0) {
+		UpstreamGroup::startHealthChecks(m_Loop);
+	}
+	LogFile::start(m_Loop);
+	m_Loop.run();
+	CGIPool::destroy();
+	LogFile::finish();
+}
+
+const unsigned int&	Worker::getId() const {
+	return (this->m_Id);
+}
+
+EventLoop&	Worker::getLoop() {
+	return (this->m_Loop);
+}
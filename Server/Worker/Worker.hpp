@@ -0,0 +1,32 @@
+#pragma once
+
+#include "../EventLoop/EventLoop.hpp"
+#include "../Server/Server.hpp"
+#include <vector>
+
+/**
+ * @brief	worker process 하나
+ * @details	MasterProcess 가 fork 한 뒤에 만들어진다.
+ *			listen socket 은 모든 worker 가 공유하고, event loop 는 worker 마다 따로 가진다.
+ */
+class Worker {
+public:
+	typedef std::vector<ft::shared_ptr<Server> >	serverVec;
+
+private:
+	const unsigned int	m_Id;
+	EventLoop			m_Loop;
+	const serverVec&	m_Servers;
+
+	Worker(const Worker& other);
+	Worker& operator=(const Worker& other);
+
+public:
+	Worker(const unsigned int& id, const serverVec& servers);
+	~Worker();
+
+	void				run();
+
+	const unsigned int&	getId() const;
+	EventLoop&			getLoop();
+};
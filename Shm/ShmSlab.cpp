@@ -0,0 +1,168 @@
+#include "ShmSlab.hpp"
+
+#include <cstring>
+
+ShmSlab::ShmSlab()
+  : m_Header(NULL),
+	m_PageClass(NULL),
+	m_PageUsed(NULL),
+	m_Pages(NULL)
+{}
+
+ShmSlab::ShmSlab(const ShmSlab& other) {
+	*this = other;
+}
+
+ShmSlab&	ShmSlab::operator=(const ShmSlab& other) {
+	if (this != &other) {
+		m_Header = other.m_Header;
+		m_PageClass = other.m_PageClass;
+		m_PageUsed = other.m_PageUsed;
+		m_Pages = other.m_Pages;
+	}
+	return (*this);
+}
+
+ShmSlab::~ShmSlab() {}
+
+/**
+ * @brief	[header][page class 배열][page 별 사용 chunk 수] 를 cache line 에 맞춘 크기
+ */
+std::size_t	ShmSlab::metaSize(const std::size_t& pages) {
+	const std::size_t	size = E_SHM_SLAB::CACHE_LINE + (pages + sizeof(unsigned int) - 1) / sizeof(unsigned int) * sizeof(unsigned int)
+								+ pages * sizeof(unsigned int);
+	return ((size + E_SHM_SLAB::CACHE_LINE - 1) / E_SHM_SLAB::CACHE_LINE * E_SHM_SLAB::CACHE_LINE);
+}
+
+/**
+ * @brief	size byte 를 page 로 나눠 쓰는 데 필요한 영역 크기 (metadata 포함)
+ */
+std::size_t	ShmSlab::regionSize(const std::size_t& size) {
+	const std::size_t	pages = size / E_SHM_SLAB::PAGE_SIZE;
+	return (metaSize(pages) + pages * E_SHM_SLAB::PAGE_SIZE);
+}
+
+std::size_t	ShmSlab::maxSize() {
+	return (E_SHM_SLAB::PAGE_SIZE);
+}
+
+unsigned int	ShmSlab::sizeClass(const std::size_t& size) {
+	unsigned int	result = 0;
+
+	while ((E_SHM_SLAB::MIN_CHUNK << result) < size) {
+		result++;
+	}
+	return (result);
+}
+
+/**
+ * @brief	fork 전에 한 번. region 은 regionSize(size) byte 여야 한다.
+ */
+void	ShmSlab::create(void* region, const std::size_t& size) {
+	const std::size_t	pages = size / E_SHM_SLAB::PAGE_SIZE;
+
+	m_Header = static_cast<ShmSlabHeader*>(region);
+	m_PageClass = static_cast<unsigned char*>(region) + E_SHM_SLAB::CACHE_LINE;
+	m_PageUsed = reinterpret_cast<unsigned int*>(m_PageClass + (pages + sizeof(unsigned int) - 1) / sizeof(unsigned int) * sizeof(unsigned int));
+	m_Pages = static_cast<char*>(region) + metaSize(pages);
+
+	m_Header->m_Pages = pages;
+	m_Header->m_NextPage = 0;
+	m_Header->m_FreePages = E_SHM_SLAB::NIL;
+	m_Header->m_Used = 0;
+	for (unsigned int i = 0; i < E_SHM_SLAB::CLASSES; i++) {
+		m_Header->m_Free[i] = E_SHM_SLAB::NIL;
+	}
+	std::memset(m_PageClass, E_SHM_SLAB::NO_CLASS, pages);
+	std::memset(m_PageUsed, 0, pages * sizeof(unsigned int));
+}
+
+void	ShmSlab::splitPage(const unsigned int& page, const unsigned int& sizeClass) {
+	const std::size_t	chunkSize = E_SHM_SLAB::MIN_CHUNK << sizeClass;
+	const std::size_t	first = page * (E_SHM_SLAB::PAGE_SIZE / E_SHM_SLAB::MIN_CHUNK);
+
+	m_PageClass[page] = sizeClass;
+	for (std::size_t offset = E_SHM_SLAB::PAGE_SIZE; offset > 0; offset -= chunkSize) {
+		const unsigned int	ref = first + (offset - chunkSize) / E_SHM_SLAB::MIN_CHUNK;
+		*static_cast<unsigned int*>(address(ref)) = m_Header->m_Free[sizeClass];
+		m_Header->m_Free[sizeClass] = ref;
+	}
+}
+
+/**
+ * @brief	chunk 가 모두 돌아온 page 를 class 의 free 목록에서 빼고 빈 page 목록에 넣는다.
+ */
+void	ShmSlab::releasePage(const unsigned int& page) {
+	const unsigned int	first = page * (E_SHM_SLAB::PAGE_SIZE / E_SHM_SLAB::MIN_CHUNK);
+	const unsigned int	last = first + E_SHM_SLAB::PAGE_SIZE / E_SHM_SLAB::MIN_CHUNK;
+	unsigned int*		link = &m_Header->m_Free[m_PageClass[page]];
+
+	while (*link != E_SHM_SLAB::NIL) {
+		if (*link >= first && *link < last) {
+			*link = *static_cast<unsigned int*>(address(*link));
+		} else {
+			link = static_cast<unsigned int*>(address(*link));
+		}
+	}
+	m_PageClass[page] = E_SHM_SLAB::NO_CLASS;
+	*static_cast<unsigned int*>(address(first)) = m_Header->m_FreePages;
+	m_Header->m_FreePages = page;
+}
+
+/**
+ * @return	size byte 이상의 chunk. 자리가 없거나 PAGE_SIZE 보다 크면 NIL
+ */
+unsigned int	ShmSlab::allocate(const std::size_t& size) {
+	if (size == 0 || size > E_SHM_SLAB::PAGE_SIZE) {
+		return (E_SHM_SLAB::NIL);
+	}
+	const unsigned int	wanted = sizeClass(size);
+
+	if (m_Header->m_Free[wanted] == E_SHM_SLAB::NIL) {
+		unsigned int	page;
+		if (m_Header->m_FreePages != E_SHM_SLAB::NIL) {
+			page = m_Header->m_FreePages;
+			m_Header->m_FreePages = *static_cast<unsigned int*>(address(page * (E_SHM_SLAB::PAGE_SIZE / E_SHM_SLAB::MIN_CHUNK)));
+		} else if (m_Header->m_NextPage < m_Header->m_Pages) {
+			page = m_Header->m_NextPage++;
+		} else {
+			return (E_SHM_SLAB::NIL);
+		}
+		splitPage(page, wanted);
+	}
+	const unsigned int	ref = m_Header->m_Free[wanted];
+	m_Header->m_Free[wanted] = *static_cast<unsigned int*>(address(ref));
+	m_PageUsed[static_cast<std::size_t>(ref) * E_SHM_SLAB::MIN_CHUNK / E_SHM_SLAB::PAGE_SIZE]++;
+	m_Header->m_Used += E_SHM_SLAB::MIN_CHUNK << wanted;
+	return (ref);
+}
+
+void	ShmSlab::free(const unsigned int& ref) {
+	const unsigned int	page = static_cast<std::size_t>(ref) * E_SHM_SLAB::MIN_CHUNK / E_SHM_SLAB::PAGE_SIZE;
+	const unsigned int	sizeClass = m_PageClass[page];
+
+	*static_cast<unsigned int*>(address(ref)) = m_Header->m_Free[sizeClass];
+	m_Header->m_Free[sizeClass] = ref;
+	m_Header->m_Used -= E_SHM_SLAB::MIN_CHUNK << sizeClass;
+	if (--m_PageUsed[page] == 0) {
+		releasePage(page);
+	}
+}
+
+void*	ShmSlab::address(const unsigned int& ref) const {
+	return (m_Pages + static_cast<std::size_t>(ref) * E_SHM_SLAB::MIN_CHUNK);
+}
+
+/**
+ * @brief	[ref, ref + size) 가 영역 안인지. (seqlock 으로 읽은 값을 쓰기 전에 확인한다)
+ */
+bool	ShmSlab::contains(const unsigned int& ref, const std::size_t& size) const {
+	const std::size_t	end = static_cast<std::size_t>(m_Header->m_Pages) * E_SHM_SLAB::PAGE_SIZE;
+	const std::size_t	offset = static_cast<std::size_t>(ref) * E_SHM_SLAB::MIN_CHUNK;
+
+	return (offset < end && size <= end - offset);
+}
+
+std::size_t	ShmSlab::used() const {
+	return (m_Header->m_Used);
+}
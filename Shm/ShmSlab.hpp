@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+
+namespace E_SHM_SLAB {
+	const std::size_t	CACHE_LINE = 64;
+	const unsigned int	NIL = 0xffffffff;
+	const std::size_t	PAGE_SIZE = 262144;
+	const std::size_t	MIN_CHUNK = 256;
+	const unsigned int	CLASSES = 11;
+	const unsigned char	NO_CLASS = 0xff;
+}
+
+struct ShmSlabHeader {
+	unsigned int	m_Pages;
+	unsigned int	m_NextPage;
+	unsigned int	m_FreePages;
+	unsigned int	m_Free[E_SHM_SLAB::CLASSES];
+	unsigned long	m_Used;
+};
+
+/**
+ * @brief	공유 메모리 영역 하나를 나눠 주는 slab allocator
+ * @details	영역을 PAGE_SIZE 단위 page 로 나누고, page 는 처음 필요할 때 크기 class 하나에 배정해서
+ *			같은 크기 (MIN_CHUNK * 2^class) 의 chunk 로 자른다.
+ *			page 의 chunk 가 모두 돌아오면 page 도 class 에서 떼어 내서 다른 class 가 쓸 수 있게 한다.
+ *			chunk 는 영역 시작에서의 거리 / MIN_CHUNK (unsigned int) 로 가리키므로 worker 마다 주소가 달라도 된다.
+ *			lock 은 없다. 쓰는 쪽이 잡고 부를 것.
+ */
+class ShmSlab {
+private:
+	ShmSlabHeader*	m_Header;
+	unsigned char*	m_PageClass;
+	unsigned int*	m_PageUsed;
+	char*			m_Pages;
+
+	void	splitPage(const unsigned int& page, const unsigned int& sizeClass);
+	void	releasePage(const unsigned int& page);
+
+	static std::size_t	metaSize(const std::size_t& pages);
+	static unsigned int	sizeClass(const std::size_t& size);
+
+public:
+	ShmSlab();
+	ShmSlab(const ShmSlab& other);
+	ShmSlab& operator=(const ShmSlab& other);
+	~ShmSlab();
+
+	void			create(void* region, const std::size_t& size);
+	unsigned int	allocate(const std::size_t& size);
+	void			free(const unsigned int& ref);
+	void*			address(const unsigned int& ref) const;
+	bool			contains(const unsigned int& ref, const std::size_t& size) const;
+	std::size_t		used() const;
+
+	static std::size_t	regionSize(const std::size_t& size);
+	static std::size_t	maxSize();
+};
@@ -0,0 +1,138 @@
+#include "ShmZone.hpp"
+
+#include <stdexcept>
+#include <sys/mman.h>
+
+ShmZone::zoneMap	ShmZone::m_Zones;
+
+ShmZone::ShmZone()
+  : m_Size(0),
+	m_Header(NULL),
+	m_Data(NULL)
+{}
+
+ShmZone::ShmZone(const ShmZone& other) {
+	*this = other;
+}
+
+ShmZone&	ShmZone::operator=(const ShmZone& other) {
+	if (this != &other) {
+		m_Name = other.m_Name;
+		m_Size = other.m_Size;
+		m_Header = other.m_Header;
+		m_Data = other.m_Data;
+		m_Slab = other.m_Slab;
+	}
+	return (*this);
+}
+
+ShmZone::~ShmZone() {}
+
+/**
+ *			worker (slab 은 lock() 을 잡고 부를 것)
+ */
+
+volatile int*	ShmZone::lock() {
+	return (&m_Header->m_Lock);
+}
+
+void*	ShmZone::data() const {
+	return (m_Data);
+}
+
+/**
+ * @return	size byte 이상의 chunk. 자리가 없으면 E_SHM_SLAB::NIL
+ */
+unsigned int	ShmZone::allocate(const std::size_t& size) {
+	return (m_Slab.allocate(size));
+}
+
+void	ShmZone::free(const unsigned int& ref) {
+	m_Slab.free(ref);
+}
+
+void*	ShmZone::address(const unsigned int& ref) const {
+	return (m_Slab.address(ref));
+}
+
+bool	ShmZone::contains(const unsigned int& ref, const std::size_t& size) const {
+	return (m_Slab.contains(ref, size));
+}
+
+std::size_t	ShmZone::used() const {
+	return (m_Slab.used());
+}
+
+const std::string&	ShmZone::name() const {
+	return (m_Name);
+}
+
+const std::size_t&	ShmZone::size() const {
+	return (m_Size);
+}
+
+std::size_t	ShmZone::maxSize() {
+	return (ShmSlab::maxSize());
+}
+
+/**
+ *			setup (master, fork 전)
+ */
+
+/**
+ * @brief	[header][reserve][slab] 을 한 번에 mmap 한다. reserve 는 cache line 단위로 올린다.
+ */
+void	ShmZone::map(const std::size_t& reserve) {
+	if (m_Size < ShmSlab::maxSize()) {
+		throw std::runtime_error("shm zone " + m_Name + " is smaller than one page");
+	}
+	const std::size_t	reserveSize = (reserve + E_SHM_ZONE::CACHE_LINE - 1) / E_SHM_ZONE::CACHE_LINE * E_SHM_ZONE::CACHE_LINE;
+	char*				region = static_cast<char*>(mmap(NULL, E_SHM_ZONE::CACHE_LINE + reserveSize + ShmSlab::regionSize(m_Size),
+															PROT_READ | PROT_WRITE, MAP_ANON | MAP_SHARED, -1, 0));
+
+	if (region == MAP_FAILED) {
+		throw std::runtime_error("ShmZone::prepare(): mmap failed");
+	}
+	m_Header = reinterpret_cast<ShmZoneHeader*>(region);
+	m_Data = region + E_SHM_ZONE::CACHE_LINE;
+	m_Slab.create(m_Data + reserveSize, m_Size);
+	m_Header->m_Lock = 0;
+}
+
+/**
+ * @brief	zone 을 만들어 목록에 넣는다. (fork 전에만)
+ * @param	size	slab 크기 (PAGE_SIZE 이상)
+ * @param	reserve	data() 로 받을 고정 영역 크기 (0 이면 없음). mmap 이 0 으로 채워 둔다.
+ */
+ShmZone&	ShmZone::create(const std::string& name, const std::size_t& size, const std::size_t& reserve) {
+	if (m_Zones.find(name) != m_Zones.end()) {
+		throw std::runtime_error("shm zone " + name + " is duplicated");
+	}
+	ShmZone&	zone = m_Zones[name];
+
+	zone.m_Name = name;
+	zone.m_Size = size;
+	try {
+		zone.map(reserve);
+	} catch (...) {
+		m_Zones.erase(name);
+		throw ;
+	}
+	return (zone);
+}
+
+/**
+ * @brief	shm_zone 으로 선언한 zone 을 만든다. 다른 모듈의 prepare 보다 먼저 부를 것.
+ */
+void	ShmZone::prepare(const CONF::MainBlock& mainBlock) {
+	const CONF::HTTPBlock::shmZoneMap&	zones = mainBlock.getHTTPBlock().getShm_zone();
+
+	for (CONF::HTTPBlock::shmZoneMap::const_iterator it = zones.begin(); it != zones.end(); ++it) {
+		create(it->first, it->second, 0);
+	}
+}
+
+ShmZone*	ShmZone::find(const std::string& name) {
+	const zoneMap::iterator	it = m_Zones.find(name);
+	return (it != m_Zones.end() ? &it->second : NULL);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ShmSlab.hpp"
+#include "../Parser/ConfParser/ConfData/ConfMainBlock.hpp"
+#include <map>
+#include <string>
+
+namespace E_SHM_ZONE {
+	const std::size_t	CACHE_LINE = 64;
+}
+
+struct ShmZoneHeader {
+	volatile int	m_Lock;
+};
+
+/**
+ * @brief	모든 worker 가 같이 쓰는 이름 있는 공유 메모리 zone
+ * @details	fork 전에 master 가 mmap (MAP_ANON | MAP_SHARED) 하므로 worker 는 같은 page 를 본다.
+ *			영역은 [header][reserve][slab] 이다.
+ *			- reserve: 만든 쪽이 고정 크기 구조 (hash bucket, slot 배열 ...) 를 두는 곳. data() 로 받는다.
+ *			- slab: ShmSlab 으로 크기 class 별 chunk 를 나눠 준다. chunk 는 unsigned int ref 로 가리킨다.
+ *			- lock(): zone 전체 mutex. ft::SpinLock 으로 잡는다. (kqueue 환경에는 futex 가 없으므로 오래 기다리면 sched_yield)
+ *			http 블록의 shm_zone name size; 로 선언한 zone 과, 다른 모듈이 prepare 에서 create() 로 만든 zone 이 같은 목록에 있다.
+ */
+class ShmZone {
+private:
+	typedef std::map<std::string, ShmZone>	zoneMap;
+
+	std::string		m_Name;
+	std::size_t		m_Size;
+	ShmZoneHeader*	m_Header;
+	char*			m_Data;
+	ShmSlab			m_Slab;
+
+	static zoneMap	m_Zones;
+
+	void	map(const std::size_t& reserve);
+
+public:
+	ShmZone();
+	ShmZone(const ShmZone& other);
+	ShmZone& operator=(const ShmZone& other);
+	~ShmZone();
+
+	volatile int*		lock();
+	void*				data() const;
+	unsigned int		allocate(const std::size_t& size);
+	void				free(const unsigned int& ref);
+	void*				address(const unsigned int& ref) const;
+	bool				contains(const unsigned int& ref, const std::size_t& size) const;
+	std::size_t			used() const;
+	const std::string&	name() const;
+	const std::size_t&	size() const;
+
+	static std::size_t	maxSize();
+
+	static ShmZone&		create(const std::string& name, const std::size_t& size, const std::size_t& reserve);
+	static void			prepare(const CONF::MainBlock& mainBlock);
+	static ShmZone*		find(const std::string& name);
+};
@@ -0,0 +1,99 @@
+#include "unitTest.hpp"
+#include "../../HTTP/Chunked.hpp"
+
+#include <string>
+
+static void	appendTest() {
+	std::string	out;
+
+	HTTP::appendChunk(out, "hello", 5);
+	UNIT_CHECK(out == "5\r\nhello\r\n");
+	HTTP::appendChunk(out, "", 0);
+	UNIT_CHECK(out == "5\r\nhello\r\n");
+
+	const std::string	data(255, 'x');
+	out.clear();
+	HTTP::appendChunk(out, data.data(), data.size());
+	UNIT_CHECK(out == "ff\r\n" + data + "\r\n");
+}
+
+static void	scanTest() {
+	const std::string	body = "4\r\nWiki\r\n5;name=value\r\npedia\r\nE\r\n in\r\n\r\nchunks.\r\n0\r\nX-Trailer: a\r\n\r\n";
+	const std::string	next = "GET / HTTP/1.1\r\n";
+	HTTP::ChunkedScanner	scanner;
+	std::string			out;
+
+	// 한 번에: 다음 메시지 앞에서 멈춘다.
+	UNIT_CHECK(scanner.decode((body + next).data(), body.size() + next.size(), out) == body.size());
+	UNIT_CHECK(scanner.isDone() && !scanner.isError());
+	UNIT_CHECK(out == "Wikipedia in\r\n\r\nchunks.");
+
+	// byte 하나씩
+	scanner.clear();
+	out.clear();
+	for (std::size_t i = 0; i < body.size(); i++) {
+		UNIT_CHECK(!scanner.isDone());
+		UNIT_CHECK(scanner.decode(body.data() + i, 1, out) == 1);
+	}
+	UNIT_CHECK(scanner.isDone());
+	UNIT_CHECK(out == "Wikipedia in\r\n\r\nchunks.");
+
+	// scan 은 길이만 본다.
+	scanner.clear();
+	UNIT_CHECK(scanner.scan(body.data(), body.size()) == body.size() && scanner.isDone());
+
+	// 대문자 HEXDIG, size 뒤의 BWS 와 chunk-ext
+	const std::string	upper = "A ;x=1\r\n0123456789\r\n0\r\n\r\n";
+	scanner.clear();
+	UNIT_CHECK(scanner.scan(upper.data(), upper.size()) == upper.size() && scanner.isDone());
+
+	// appendChunk 로 만든 것을 다시 풀면 그대로다.
+	std::string	encoded;
+	HTTP::appendChunk(encoded, "abc", 3);
+	HTTP::appendChunk(encoded, body.data(), body.size());
+	encoded += "0\r\n\r\n";
+	scanner.clear();
+	out.clear();
+	UNIT_CHECK(scanner.decode(encoded.data(), encoded.size(), out) == encoded.size());
+	UNIT_CHECK(scanner.isDone() && out == "abc" + body);
+}
+
+static void	errorTest() {
+	const char* const	invalid[] = {
+		"zz\r\nab\r\n0\r\n\r\n",		// chunk-size 가 16 진수가 아니다
+		"3\r\nabcX\r\n0\r\n\r\n",		// chunk-data 뒤에 CRLF 가 없다
+		"\r\n0\r\n\r\n",					// chunk-size 가 비었다
+		"-1\r\nab\r\n0\r\n\r\n",		// 부호
+		"+2\r\nab\r\n0\r\n\r\n",
+		"0x2\r\nab\r\n0\r\n\r\n",		// 0x
+		" 2\r\nab\r\n0\r\n\r\n",		// 앞의 공백
+		"2 x\r\nab\r\n0\r\n\r\n",		// size 뒤에 ';' 가 아닌 것
+		"100000000\r\n",					// MAX_SIZE 를 넘는다
+		"10000000000000002\r\nab\r\n",	// unsigned long 을 넘는다
+		"2\r\nab\r\r\n0\r\n\r\n",		// chunk-data 뒤에 CR 이 여럿
+		"2\nab\r\n0\r\n\r\n",			// LF 만
+		"2\r\r\nab\r\n0\r\n\r\n",		// 줄 안의 CR
+		"2\r\nab\r\n0\r\n\n"				// trailer 끝이 LF 만
+	};
+
+	for (std::size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+		HTTP::ChunkedScanner	scanner;
+		const std::string		body = invalid[i];
+
+		scanner.scan(body.data(), body.size());
+		UNIT_CHECK(scanner.isError() && !scanner.isDone());
+	}
+
+	HTTP::ChunkedScanner	scanner;
+	const std::string		longLine = "1;" + std::string(E_CHUNKED::MAX_LINE, 'x');
+	scanner.scan(longLine.data(), longLine.size());
+	UNIT_CHECK(scanner.isError());
+	scanner.clear();
+	UNIT_CHECK(!scanner.isError() && !scanner.isDone());
+}
+
+void	chunkedTest() {
+	appendTest();
+	scanTest();
+	errorTest();
+}
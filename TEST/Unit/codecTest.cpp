@@ -0,0 +1,174 @@
+#include "unitTest.hpp"
+#include "../../Log/BinaryLogCodec.hpp"
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static BinaryLogRecord	sampleRecord() {
+	BinaryLogRecord	record;
+	const unsigned char	addr[4] = { 10, 0, 0, 1 };
+
+	record.m_Method = BinaryLogCodec::methodCode("GET");
+	record.m_Status = 200;
+	record.m_Time = 10;
+	record.m_Msec = 250;
+	std::memcpy(record.m_Addr, addr, sizeof(addr));
+	record.m_Pid = 42;
+	record.m_RequestTime = 7;
+	record.m_BytesSent = 512;
+	record.m_BodyBytesSent = 100;
+	record.m_Host = 1;
+	record.m_Location = E_BINARY_LOG::INLINE;
+	record.m_LocationInline = "/api/";
+	record.m_Uri = "/api/x?y=1";
+	return (record);
+}
+
+static void	varintTest() {
+	const unsigned long	values[] = { 0, 1, 127, 128, 300, 16383, 16384, 0xffffffffUL, ULONG_MAX };
+
+	for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+		std::string		out;
+		unsigned long	value;
+
+		BinaryLogCodec::appendVarint(out, values[i]);
+		const char*	pos = out.data();
+		const char*	end = out.data() + out.size();
+		UNIT_CHECK(BinaryLogCodec::readVarint(pos, end, value));
+		UNIT_CHECK(value == values[i]);
+		UNIT_CHECK(pos == end);
+
+		// 덜 왔으면 false 이고 pos 는 그대로
+		const char*	cut = out.data();
+		UNIT_CHECK(out.size() == 1 || !BinaryLogCodec::readVarint(cut, end - 1, value));
+		UNIT_CHECK(cut == out.data() || out.size() == 1);
+	}
+
+	std::string	out;
+	BinaryLogCodec::appendVarint(out, 127);
+	UNIT_CHECK(out.size() == 1);
+	out.clear();
+	BinaryLogCodec::appendVarint(out, 128);
+	UNIT_CHECK(out.size() == 2);
+	out.clear();
+	BinaryLogCodec::appendVarint(out, ULONG_MAX);
+	UNIT_CHECK(out.size() <= E_BINARY_LOG::MAX_VARINT);
+}
+
+static void	fixedTest() {
+	std::string		out;
+	unsigned long	value;
+
+	BinaryLogCodec::appendFixed(out, 0x12345678UL, 4);
+	UNIT_CHECK(out.size() == 4 && static_cast<unsigned char>(out[0]) == 0x78);	// little endian
+	const char*	pos = out.data();
+	UNIT_CHECK(BinaryLogCodec::readFixed(pos, out.data() + out.size(), 4, value) && value == 0x12345678UL);
+	pos = out.data();
+	UNIT_CHECK(!BinaryLogCodec::readFixed(pos, out.data() + 3, 4, value) && pos == out.data());
+}
+
+static void	recordTest() {
+	const BinaryLogRecord	record = sampleRecord();
+	BinaryLogRecord			decoded;
+	std::string				out;
+
+	BinaryLogCodec::appendRequest(out, record);
+	UNIT_CHECK(out[0] == E_BINARY_LOG::TAG_REQUEST);
+
+	const char*	pos = out.data() + 1;
+	const char*	end = out.data() + out.size();
+	UNIT_CHECK(BinaryLogCodec::readRequest(pos, end, decoded));
+	UNIT_CHECK(pos == end);
+	UNIT_CHECK(decoded.m_Method == record.m_Method);
+	UNIT_CHECK(decoded.m_Status == record.m_Status);
+	UNIT_CHECK(decoded.m_Time == record.m_Time && decoded.m_Msec == record.m_Msec);
+	UNIT_CHECK(std::memcmp(decoded.m_Addr, record.m_Addr, 4) == 0);
+	UNIT_CHECK(decoded.m_Pid == record.m_Pid);
+	UNIT_CHECK(decoded.m_RequestTime == record.m_RequestTime);
+	UNIT_CHECK(decoded.m_BytesSent == record.m_BytesSent && decoded.m_BodyBytesSent == record.m_BodyBytesSent);
+	UNIT_CHECK(decoded.m_Host == 1 && decoded.m_HostInline.empty());
+	UNIT_CHECK(decoded.m_Location == E_BINARY_LOG::INLINE && decoded.m_LocationInline == "/api/");
+	UNIT_CHECK(decoded.m_Uri == record.m_Uri);
+
+	// 잘린 record 는 어디서 잘려도 false 이고 pos 는 그대로
+	for (std::size_t size = 1; size < out.size(); size++) {
+		const char*	cut = out.data() + 1;
+		UNIT_CHECK(!BinaryLogCodec::readRequest(cut, out.data() + size, decoded));
+		UNIT_CHECK(cut == out.data() + 1);
+	}
+}
+
+static void	methodTest() {
+	for (unsigned char code = 0; code < E_BINARY_LOG::METHOD_COUNT; code++) {
+		UNIT_CHECK(BinaryLogCodec::methodCode(BinaryLogCodec::methodName(code)) == code);
+	}
+	UNIT_CHECK(BinaryLogCodec::methodCode("BREW") == E_BINARY_LOG::OTHER);
+	UNIT_CHECK(std::strcmp(BinaryLogCodec::methodName(200), "-") == 0);
+}
+
+void	codecTest() {
+	varintTest();
+	fixedTest();
+	recordTest();
+	methodTest();
+}
+
+/**
+ * @brief	logdecode 를 돌려서 stdout 을 돌려준다.
+ * @param	status	종료 코드
+ */
+static std::string	runDecoder(const std::string& command, int& status) {
+	std::FILE*	pipe = popen(command.c_str(), "r");
+	std::string	output;
+	char		buf[256];
+	std::size_t	readSize;
+
+	if (pipe == NULL) {
+		status = -1;
+		return (output);
+	}
+	while ((readSize = std::fread(buf, 1, sizeof(buf), pipe)) > 0) {
+		output.append(buf, readSize);
+	}
+	const int	result = pclose(pipe);
+	status = WIFEXITED(result) ? WEXITSTATUS(result) : -1;
+	return (output);
+}
+
+static bool	writeFile(const std::string& path, const std::string& data) {
+	std::FILE*	file = std::fopen(path.c_str(), "wb");
+
+	if (file == NULL) {
+		return false;
+	}
+	const bool	written = (std::fwrite(data.data(), 1, data.size(), file) == data.size());
+	return (std::fclose(file) == 0 && written);
+}
+
+/**
+ * @brief	'S' 정의 + 그것을 가리키는 'R' record 를 파일로 써서 logdecode -csv 의 줄과 비교한다.
+ */
+void	decodeTest(const char* logdecode) {
+	const std::string	path = "unit_binary.log";
+	std::string			data;
+	int					status;
+
+	BinaryLogCodec::appendString(data, 42, 1, "example.com");
+	BinaryLogCodec::appendRequest(data, sampleRecord());
+	UNIT_CHECK(writeFile(path, data));
+
+	const std::string	output = runDecoder(std::string(logdecode) + " -csv " + path, status);
+	UNIT_CHECK(status == 0);
+	UNIT_CHECK(output == "time,remote_addr,method,host,location,uri,status,bytes_sent,body_bytes_sent,request_time_ms\n"
+						 "1970-01-01T00:00:10.250Z,10.0.0.1,GET,\"example.com\",\"/api/\",\"/api/x?y=1\",200,512,100,7\n");
+
+	// 모르는 tag 로 시작하면 binary log 가 아니다.
+	UNIT_CHECK(writeFile(path, "GET / HTTP/1.1\r\n"));
+	runDecoder(std::string(logdecode) + " " + path + " 2>/dev/null", status);
+	UNIT_CHECK(status == 1);
+	unlink(path.c_str());
+}
@@ -0,0 +1,60 @@
+#include "unitTest.hpp"
+#include "../../Metrics/Histogram.hpp"
+
+#include <cstring>
+
+static void	indexTest() {
+	unsigned int	previous = 0;
+
+	for (unsigned long value = 0; value < E_HISTOGRAM::SUB_COUNT; value++) {
+		UNIT_CHECK(Histogram::index(value) == value);
+		UNIT_CHECK(Histogram::highest(value) == value);
+	}
+	// bucket 은 값 순서대로이고, bucket 의 가장 큰 값은 값보다 작지 않고 1/SUB_COUNT 이상 벗어나지 않는다.
+	for (unsigned long value = 1; value < (1UL << E_HISTOGRAM::MAX_BITS); value += value / 7 + 1) {
+		const unsigned int	index = Histogram::index(value);
+		const unsigned long	highest = Histogram::highest(index);
+
+		UNIT_CHECK(index >= previous);
+		UNIT_CHECK(index < E_HISTOGRAM::BUCKETS);
+		UNIT_CHECK(highest >= value);
+		UNIT_CHECK(highest - value <= value / E_HISTOGRAM::SUB_COUNT);
+		previous = index;
+	}
+	UNIT_CHECK(Histogram::index(16) == 16 && Histogram::index(31) == 31);
+	UNIT_CHECK(Histogram::index(32) == Histogram::index(33));
+	UNIT_CHECK(Histogram::index(1UL << E_HISTOGRAM::MAX_BITS) == E_HISTOGRAM::BUCKETS - 1);
+	UNIT_CHECK(Histogram::index(1UL << (E_HISTOGRAM::MAX_BITS + 8)) == E_HISTOGRAM::BUCKETS - 1);
+}
+
+static void	quantileTest() {
+	Histogram	histogram;
+	Histogram	other;
+
+	std::memset(&histogram, 0, sizeof(histogram));
+	std::memset(&other, 0, sizeof(other));
+	UNIT_CHECK(histogram.quantile(0.5) == 0);
+
+	for (unsigned long value = 1; value <= 100; value++) {
+		histogram.record(value);
+	}
+	UNIT_CHECK(histogram.m_Count == 100 && histogram.m_Sum == 5050);
+	UNIT_CHECK(histogram.quantile(0) == 1);
+	UNIT_CHECK(histogram.quantile(0.5) >= 50 && histogram.quantile(0.5) <= 53);
+	UNIT_CHECK(histogram.quantile(0.99) >= 99 && histogram.quantile(0.99) <= 103);
+	UNIT_CHECK(histogram.quantile(1) >= 100 && histogram.quantile(1) <= 106);
+
+	// 큰 값 100 개를 더하면 중앙값이 그쪽 경계로 간다.
+	for (unsigned long i = 0; i < 100; i++) {
+		other.record(1000000);
+	}
+	histogram.merge(other);
+	UNIT_CHECK(histogram.m_Count == 200);
+	UNIT_CHECK(histogram.quantile(0.5) <= 106);
+	UNIT_CHECK(histogram.quantile(0.51) >= 1000000 && histogram.quantile(0.51) <= 1000000 + 1000000 / E_HISTOGRAM::SUB_COUNT);
+}
+
+void	histogramTest() {
+	indexTest();
+	quantileTest();
+}
@@ -0,0 +1,43 @@
+#include "unitTest.hpp"
+#include "../../Log/LogFormat.hpp"
+
+#include <stdexcept>
+#include <string>
+
+static bool	rejects(const std::string& pattern) {
+	try {
+		LogFormat	format(pattern);
+	} catch (std::runtime_error& e) {
+		return true;
+	}
+	return false;
+}
+
+void	logFormatTest() {
+	LogFormat	format(E_LOG_FORMAT::COMBINED);
+
+	UNIT_CHECK(format.pattern() == "${remote_addr} - ${remote_user} [${time_local}] \"${request}\" ${status} ${body_bytes_sent}"
+								   " \"${http_referer}\" \"${http_user_agent}\"");
+
+	// 이름은 대소문자를 가리지 않고, {} 로 감싸면 바로 뒤에 글자를 붙일 수 있다.
+	format.compile("${STATUS}ms$Request_Time");
+	UNIT_CHECK(format.pattern() == "${status}ms${request_time}");
+
+	format.compile("$http_x_forwarded_for|$msec|$time_iso8601");
+	UNIT_CHECK(format.pattern() == "${http_x_forwarded_for}|${msec}|${time_iso8601}");
+
+	// 다시 compile 하면 앞의 것은 남지 않는다.
+	format.compile("plain text");
+	UNIT_CHECK(format.pattern() == "plain text");
+	format.compile("");
+	UNIT_CHECK(format.pattern().empty());
+
+	const LogFormat	copy(format);
+	UNIT_CHECK(copy.pattern() == format.pattern());
+
+	UNIT_CHECK(rejects("$nope"));
+	UNIT_CHECK(rejects("${status"));
+	UNIT_CHECK(rejects("100$"));
+	UNIT_CHECK(rejects("$http_"));
+	UNIT_CHECK(!rejects("$host$uri$args"));
+}
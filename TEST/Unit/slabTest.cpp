@@ -0,0 +1,73 @@
+#include "unitTest.hpp"
+#include "../../Shm/ShmSlab.hpp"
+
+#include <set>
+#include <vector>
+
+/**
+ * @brief	page 하나짜리 영역: class 에 배정된 page 는 chunk 가 다 돌아와야 (releasePage) 다른 class 가 쓸 수 있다.
+ */
+static void	releaseTest() {
+	std::vector<unsigned long>	memory(ShmSlab::regionSize(E_SHM_SLAB::PAGE_SIZE) / sizeof(unsigned long) + 1);
+	ShmSlab						slab;
+
+	slab.create(&memory[0], E_SHM_SLAB::PAGE_SIZE);
+	UNIT_CHECK(slab.allocate(0) == E_SHM_SLAB::NIL);
+	UNIT_CHECK(slab.allocate(ShmSlab::maxSize() + 1) == E_SHM_SLAB::NIL);
+
+	const unsigned int	first = slab.allocate(100);
+	const unsigned int	second = slab.allocate(E_SHM_SLAB::MIN_CHUNK);
+	UNIT_CHECK(first != E_SHM_SLAB::NIL && second != E_SHM_SLAB::NIL && first != second);
+	UNIT_CHECK(slab.used() == 2 * E_SHM_SLAB::MIN_CHUNK);
+	UNIT_CHECK(slab.contains(first, 100) && slab.contains(second, E_SHM_SLAB::MIN_CHUNK));
+
+	// 하나뿐인 page 가 작은 class 에 묶여 있다.
+	UNIT_CHECK(slab.allocate(E_SHM_SLAB::PAGE_SIZE) == E_SHM_SLAB::NIL);
+	slab.free(first);
+	UNIT_CHECK(slab.allocate(E_SHM_SLAB::PAGE_SIZE) == E_SHM_SLAB::NIL);
+	slab.free(second);
+	UNIT_CHECK(slab.used() == 0);
+
+	const unsigned int	page = slab.allocate(E_SHM_SLAB::PAGE_SIZE);
+	UNIT_CHECK(page != E_SHM_SLAB::NIL);
+	UNIT_CHECK(slab.used() == E_SHM_SLAB::PAGE_SIZE);
+	UNIT_CHECK(slab.contains(page, E_SHM_SLAB::PAGE_SIZE) && !slab.contains(page, E_SHM_SLAB::PAGE_SIZE + 1));
+	// 빈 page 를 뗄 때 작은 class 의 free 목록에서 그 page 의 chunk 도 빠졌어야 한다.
+	UNIT_CHECK(slab.allocate(E_SHM_SLAB::MIN_CHUNK) == E_SHM_SLAB::NIL);
+	slab.free(page);
+	UNIT_CHECK(slab.allocate(E_SHM_SLAB::MIN_CHUNK) != E_SHM_SLAB::NIL);
+}
+
+/**
+ * @brief	page 를 chunk 로 다 나눠 주면 겹치지 않고, 그다음은 NIL 이다.
+ */
+static void	fillTest() {
+	const std::size_t			pages = 2;
+	const std::size_t			chunkSize = E_SHM_SLAB::MIN_CHUNK * 4;
+	std::vector<unsigned long>	memory(ShmSlab::regionSize(pages * E_SHM_SLAB::PAGE_SIZE) / sizeof(unsigned long) + 1);
+	std::set<unsigned int>		refs;
+	ShmSlab						slab;
+
+	slab.create(&memory[0], pages * E_SHM_SLAB::PAGE_SIZE);
+	for (std::size_t i = 0; i < pages * E_SHM_SLAB::PAGE_SIZE / chunkSize; i++) {
+		const unsigned int	ref = slab.allocate(chunkSize - 1);
+		UNIT_CHECK(ref != E_SHM_SLAB::NIL);
+		UNIT_CHECK(ref % (chunkSize / E_SHM_SLAB::MIN_CHUNK) == 0);
+		refs.insert(ref);
+	}
+	UNIT_CHECK(refs.size() == pages * E_SHM_SLAB::PAGE_SIZE / chunkSize);
+	UNIT_CHECK(slab.allocate(1) == E_SHM_SLAB::NIL);
+	UNIT_CHECK(slab.used() == pages * E_SHM_SLAB::PAGE_SIZE);
+
+	for (std::set<unsigned int>::iterator it = refs.begin(); it != refs.end(); ++it) {
+		slab.free(*it);
+	}
+	UNIT_CHECK(slab.used() == 0);
+	UNIT_CHECK(slab.allocate(E_SHM_SLAB::PAGE_SIZE) != E_SHM_SLAB::NIL);
+	UNIT_CHECK(slab.allocate(E_SHM_SLAB::PAGE_SIZE) != E_SHM_SLAB::NIL);
+}
+
+void	slabTest() {
+	releaseTest();
+	fillTest();
+}
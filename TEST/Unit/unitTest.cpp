@@ -0,0 +1,35 @@
+#include "unitTest.hpp"
+
+int	UNIT::failures = 0;
+
+/**
+ * @brief	usage: unitTest [logdecode]	(make run 은 ../../logdecode 를 만들어서 넘긴다)
+ */
+int	main(int argc, char** argv) {
+	const struct {
+		const char*	m_Name;
+		void		(*m_Run)();
+	}	tests[] = {
+		{ "BinaryLogCodec", codecTest },
+		{ "ShmSlab", slabTest },
+		{ "Histogram", histogramTest },
+		{ "ChunkedScanner", chunkedTest },
+		{ "LogFormat", logFormatTest }
+	};
+
+	for (std::size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+		const int	before = UNIT::failures;
+		tests[i].m_Run();
+		std::cout << tests[i].m_Name << ": " << (UNIT::failures == before ? "ok" : "FAILED") << std::endl;
+	}
+
+	int	before = UNIT::failures;
+	upstreamTest("unit.conf");
+	std::cout << "UpstreamGroup: " << (UNIT::failures == before ? "ok" : "FAILED") << std::endl;
+	if (argc > 1) {
+		before = UNIT::failures;
+		decodeTest(argv[1]);
+		std::cout << "logdecode: " << (UNIT::failures == before ? "ok" : "FAILED") << std::endl;
+	}
+	return (UNIT::failures == 0 ? 0 : 1);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <iostream>
+
+/**
+ * @brief	server 를 띄우지 않고 볼 수 있는 부분 (binary log codec, slab allocator, histogram, chunked, log_format, balancer) 의 test
+ * @details	UNIT_CHECK 가 틀리면 file:line 과 식을 찍고 센다. main 은 틀린 수가 있으면 1 로 끝난다.
+ */
+namespace UNIT {
+	extern int	failures;
+}
+
+#define UNIT_CHECK(expr) \
+	do { \
+		if (!(expr)) { \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": " << #expr << std::endl; \
+			UNIT::failures++; \
+		} \
+	} while (0)
+
+void	codecTest();
+void	decodeTest(const char* logdecode);
+void	slabTest();
+void	histogramTest();
+void	chunkedTest();
+void	logFormatTest();
+void	upstreamTest(const char* conf);
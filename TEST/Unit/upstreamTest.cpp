@@ -0,0 +1,111 @@
+#include "unitTest.hpp"
+#include "../../Parser/ConfParser/ConfData/ConfBlock.hpp"
+#include "../../Proxy/ProxyUpstream.hpp"
+#include "../../Proxy/UpstreamGroup.hpp"
+
+#include <map>
+#include <sstream>
+#include <string>
+
+typedef std::map<std::string, const CONF::LocationBlock*>	locationMap;
+
+static void	collectLocation(const CONF::ServerBlock&, const CONF::LocationBlock& location, const std::string& name, void* context) {
+	(*static_cast<locationMap*>(context))[name] = &location;
+}
+
+static std::string	pick(UpstreamGroup& group, const std::string& key, const unsigned long& tried) {
+	UpstreamGroup::Peer* const	peer = group.select(key, tried);
+
+	if (peer == NULL) {
+		return ("-");
+	}
+	UpstreamGroup::release(peer, E_UPSTREAM_GROUP::ABORTED);
+	return (peer->m_Upstream->getAddress());
+}
+
+static unsigned long	triedBit(UpstreamGroup& group, const std::string& key) {
+	UpstreamGroup::Peer* const	peer = group.select(key, 0);
+
+	UpstreamGroup::release(peer, E_UPSTREAM_GROUP::ABORTED);
+	return (1UL << peer->m_Index);
+}
+
+/**
+ * @brief	weight 5 : 1 : 1 의 smooth weighted round robin 은 a a b a c a a 를 되풀이한다.
+ */
+static void	roundRobinTest(UpstreamGroup& group) {
+	const char* const	expected[] = { "127.0.0.1:9001", "127.0.0.1:9001", "127.0.0.1:9002", "127.0.0.1:9001",
+									   "127.0.0.1:9003", "127.0.0.1:9001", "127.0.0.1:9001" };
+
+	for (int round = 0; round < 3; round++) {
+		for (std::size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+			UNIT_CHECK(pick(group, "", 0) == expected[i]);
+		}
+	}
+
+	// 이미 실패한 서버는 건너뛰고, 다 실패했으면 NULL
+	const unsigned long	heavy = triedBit(group, "");
+	for (int i = 0; i < 10; i++) {
+		UNIT_CHECK(pick(group, "", heavy) != "127.0.0.1:9001");
+	}
+	UNIT_CHECK(pick(group, "", 7) == "-");
+}
+
+/**
+ * @brief	ketama: 같은 key 는 같은 서버로, 고른 서버를 빼면 다른 key 는 움직이지 않는다.
+ */
+static void	ketamaTest(UpstreamGroup& group) {
+	std::map<std::string, int>	spread;
+
+	for (int i = 0; i < 300; i++) {
+		std::stringstream	key;
+		key << "10.0." << i / 256 << "." << i % 256;
+
+		const std::string	chosen = pick(group, key.str(), 0);
+		UNIT_CHECK(chosen != "-");
+		UNIT_CHECK(pick(group, key.str(), 0) == chosen);
+		spread[chosen]++;
+
+		// 다른 서버가 빠져도 그대로, 고른 서버가 빠지면 ring 의 다음 서버로
+		const unsigned long	bit = triedBit(group, key.str());
+		for (unsigned long other = 1; other < 8; other <<= 1) {
+			if (other != bit) {
+				UNIT_CHECK(pick(group, key.str(), other) == chosen);
+			}
+		}
+		const std::string	next = pick(group, key.str(), bit);
+		UNIT_CHECK(next != chosen && next != "-");
+	}
+	UNIT_CHECK(spread.size() == 3);
+	for (std::map<std::string, int>::iterator it = spread.begin(); it != spread.end(); ++it) {
+		UNIT_CHECK(it->second > 30);
+	}
+}
+
+void	upstreamTest(const char* conf) {
+	// 설정은 환경 변수도 읽는다. test 가 돌리는 쪽의 환경에 따라 달라지지 않게 고정한다.
+	char		path[] = "PATH=/usr/bin:/bin";
+	char*		env[] = { path, NULL };
+	locationMap	locations;
+
+	try {
+		CONF::ConfBlock::initInstance(conf, env);
+		const CONF::MainBlock&	mainBlock = CONF::ConfBlock::getInstance()->getMainBlock();
+		UpstreamGroup::prepare(mainBlock);
+		mainBlock.getHTTPBlock().visitLocations(NULL, collectLocation, &locations);
+	} catch (std::exception& e) {
+		std::cerr << conf << ": " << e.what() << std::endl;
+		UNIT::failures++;
+		return ;
+	}
+
+	UpstreamGroup* const	weighted = UpstreamGroup::find(locations["/rr/"]);
+	UpstreamGroup* const	ring = UpstreamGroup::find(locations["/ring/"]);
+	UNIT_CHECK(weighted != NULL && ring != NULL);
+	if (weighted != NULL) {
+		roundRobinTest(*weighted);
+	}
+	if (ring != NULL) {
+		ketamaTest(*ring);
+	}
+}
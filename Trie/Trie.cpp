@@ -1,12 +1,14 @@
 #include "Trie.hpp"
+#include <algorithm>
 #include <string>
 
 Trie::Trie() : root(ft::shared_ptr<TrieNode>(new TrieNode())) {}
 
-Trie::Trie(const Trie& other) : root(other.root) {}
+Trie::Trie(const Trie& other) : root(other.root), words(other.words) {}
 
 Trie& Trie::operator=(const Trie& other) {
 	root = other.root;
+	words = other.words;
 	return *this;
 }
 
@@ -21,6 +23,9 @@ void	Trie::insert(const std::string& key) {
 		}
 		node = node->children[key[i]];
 	}
+	if (std::find(words.begin(), words.end(), key) == words.end()) {
+		words.push_back(key);
+	}
 	node->isEndOfWord = true;
 }
 
@@ -51,4 +56,11 @@ const std::string	Trie::find(const std::string& key) const {
 		}
 	}
 	return result;
+}
+
+/**
+ * @brief	insert 한 순서대로의 단어 목록 (index 지시어는 순서대로 찾아야 한다)
+ */
+const std::vector<std::string>&	Trie::getWords() const {
+	return words;
 }
\ No newline at end of file
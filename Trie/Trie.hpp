@@ -1,10 +1,12 @@
 #pragma once
 
 #include "TrieNode.hpp"
+#include <vector>
 
 class Trie {
 private:
 	ft::shared_ptr<TrieNode>	root;
+	std::vector<std::string>	words;
 public:
 	Trie();
 	Trie(const Trie& other);
@@ -14,4 +16,5 @@ public:
 	void				insert(const std::string& key);
 	bool				search(const std::string& key);
 	const std::string	find(const std::string& key) const;
+	const std::vector<std::string>&	getWords() const;
 };
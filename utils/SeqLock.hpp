@@ -0,0 +1,45 @@
+#pragma once
+
+namespace ft {
+
+/**
+ *		Sequence Lock
+ *
+ *	공유 메모리의 counter 하나로 읽기 쪽은 잠그지 않는다.
+ *	쓰는 쪽 (다른 lock 으로 한 번에 하나만) 은 WriteGuard 로 쓰기 전후에 counter 를 올린다. (쓰는 동안은 홀수)
+ *	읽는 쪽은 readBegin() 값을 기억해 두고 복사한 뒤 readRetry() 가 false 일 때만 복사한 값을 쓴다.
+ *	복사하는 동안 내용이 바뀔 수 있으므로 읽은 길이 / 위치는 쓰기 전에 범위를 확인할 것.
+*/
+namespace SeqLock {
+	inline unsigned int	readBegin(const volatile unsigned int* seq) {
+		const unsigned int	value = *seq;
+		__sync_synchronize();
+		return (value);
+	}
+
+	inline bool	readRetry(const volatile unsigned int* seq, const unsigned int& begin) {
+		__sync_synchronize();
+		return ((begin & 1) != 0 || *seq != begin);
+	}
+
+	class WriteGuard {
+	private:
+		volatile unsigned int*	m_Seq;
+
+		WriteGuard(const WriteGuard&);
+		WriteGuard&	operator=(const WriteGuard&);
+
+	public:
+		explicit WriteGuard(volatile unsigned int* seq) : m_Seq(seq) {
+			(*m_Seq)++;
+			__sync_synchronize();
+		}
+
+		~WriteGuard() {
+			__sync_synchronize();
+			(*m_Seq)++;
+		}
+	};
+}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <sched.h>
+
+namespace ft {
+
+namespace E_SPINLOCK {
+	const unsigned int	SPIN_LIMIT = 1024;
+}
+
+/**
+ *		Spin Lock (scope guard)
+ *
+ *	fork 된 worker 끼리 공유 메모리 안의 int 하나로 잠근다.
+ *	몇십 ns 짜리 임계 구역에만 쓸 것. 오래 잡혀 있으면 CPU 를 양보한다.
+*/
+class SpinLock {
+private:
+	volatile int*	m_Lock;
+
+	SpinLock(const SpinLock&);
+	SpinLock&	operator=(const SpinLock&);
+
+public:
+	explicit SpinLock(volatile int* lock) : m_Lock(lock) {
+		unsigned int	spin = 0;
+
+		while (__sync_lock_test_and_set(m_Lock, 1) != 0) {
+			while (*m_Lock != 0) {
+				if (++spin >= E_SPINLOCK::SPIN_LIMIT) {
+					sched_yield();
+					spin = 0;
+				}
+			}
+		}
+	}
+
+	~SpinLock() {
+		__sync_lock_release(m_Lock);
+	}
+};
+
+}